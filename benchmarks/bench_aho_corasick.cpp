@@ -0,0 +1,108 @@
+// Copyright (c) 2020. Mohit Deshpande.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+// the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+// Scanning 1 MiB of text for a set of signatures: the compile-time Aho-Corasick automaton against one
+// std::string_view::find pass per pattern, with and without the rare-byte prefilter.
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <string>
+#include <string_view>
+
+#include "cx/cx_aho_corasick.h"
+
+namespace {
+
+constexpr const char* kWords[] = {"select", "union", "insert", "update", "delete", "drop", "exec", "cmd",
+                                  "passwd", "shadow", "eval", "base64", "system", "wget", "curl", "chmod",
+                                  "onload", "onerror", "alert", "cookie", "document", "window", "iframe", "script"};
+
+constexpr auto kWordTrie = cx::make_aho_corasick(
+        "select", "union", "insert", "update", "delete", "drop", "exec", "cmd",
+        "passwd", "shadow", "eval", "base64", "system", "wget", "curl", "chmod",
+        "onload", "onerror", "alert", "cookie", "document", "window", "iframe", "script");
+constexpr auto kWordScanner = kWordTrie.compact<kWordTrie.state_count(), kWordTrie.class_count()>();
+// like most real signature sets, no three bytes cover these, so asking for a prefilter would get none
+static_assert(!kWordTrie.can_prefilter(), "");
+
+constexpr const char* kTags[] = {"<script", "<iframe", "<object", "<embed", "%PDF-", "%%EOF"};
+
+// '<' and '%' cover every tag, so the prefiltered scan skips ahead to the next of them
+constexpr auto kTagTrie = cx::make_aho_corasick("<script", "<iframe", "<object", "<embed", "%PDF-", "%%EOF");
+constexpr auto kTagScanner = kTagTrie.compact<kTagTrie.state_count(), kTagTrie.class_count()>(
+        cx::aho_corasick_prefilter::rare_bytes);
+constexpr auto kTagNoSkipScanner = kTagTrie.compact<kTagTrie.state_count(), kTagTrie.class_count()>();
+
+// lowercase words and spaces with one occurrence of a pattern every ~4 KiB; tags also get a '<' every ~64 bytes
+template<std::size_t N>
+std::string make_text(const char* const (&patterns)[N], bool sprinkle_angles) {
+    std::mt19937 gen{42};
+    std::uniform_int_distribution<int> letter{'a', 'z' + 4};
+    std::uniform_int_distribution<std::size_t> pattern{0, N - 1};
+    std::string text;
+    while (text.size() < (std::size_t{1} << 20)) {
+        const int c = letter(gen);
+        text += c > 'z' ? ' ' : static_cast<char>(c);
+        if (sprinkle_angles && text.size() % 64 == 0) text += "<b>";
+        if (text.size() % 4096 == 0) text += patterns[pattern(gen)];
+    }
+    return text;
+}
+
+struct counter {
+    std::size_t n;
+    void operator()(const cx::aho_corasick_match&) { ++n; }
+};
+
+template<typename Scanner>
+void run_scan(benchmark::State& state, const Scanner& scanner, const std::string& text) {
+    for (auto _ : state) {
+        counter matches{0};
+        scanner.scan(text, matches);
+        benchmark::DoNotOptimize(matches.n);
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(text.size()));
+}
+
+template<std::size_t N>
+void run_find_each(benchmark::State& state, const char* const (&patterns)[N], const std::string& text) {
+    const std::string_view view = text;
+    for (auto _ : state) {
+        std::size_t matches = 0;
+        for (const char* p : patterns) {
+            for (auto at = view.find(p); at != std::string_view::npos; at = view.find(p, at + 1)) ++matches;
+        }
+        benchmark::DoNotOptimize(matches);
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(text.size()));
+}
+
+void BM_AhoCorasickWords(benchmark::State& state) { run_scan(state, kWordScanner, make_text(kWords, false)); }
+void BM_FindEachWord(benchmark::State& state) { run_find_each(state, kWords, make_text(kWords, false)); }
+
+void BM_AhoCorasickTags(benchmark::State& state) { run_scan(state, kTagScanner, make_text(kTags, true)); }
+void BM_AhoCorasickTagsNoPrefilter(benchmark::State& state) {
+    run_scan(state, kTagNoSkipScanner, make_text(kTags, true));
+}
+void BM_FindEachTag(benchmark::State& state) { run_find_each(state, kTags, make_text(kTags, true)); }
+
+BENCHMARK(BM_AhoCorasickWords);
+BENCHMARK(BM_FindEachWord);
+BENCHMARK(BM_AhoCorasickTags);
+BENCHMARK(BM_AhoCorasickTagsNoPrefilter);
+BENCHMARK(BM_FindEachTag);
+
+}
@@ -0,0 +1,103 @@
+// Copyright (c) 2020. Mohit Deshpande.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+// the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+// Per-vector operations on batches of small feature vectors: cx::aligned_array's vectorized equality, count, min and
+// sum against the element-by-element loops over a plain cx::array.
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "cx/cx_aligned_array.h"
+
+namespace {
+
+constexpr std::size_t kBatch = 1024;
+
+template<typename T, std::size_t N>
+std::size_t count_of(const cx::array<T, N>& a, T value) { return std::count(a.begin(), a.end(), value); }
+template<typename T, std::size_t N>
+T min_of(const cx::array<T, N>& a) { return *std::min_element(a.begin(), a.end()); }
+template<typename T, std::size_t N>
+T sum_of(const cx::array<T, N>& a) { return std::accumulate(a.begin(), a.end(), T{}); }
+
+template<typename T, std::size_t N>
+std::size_t count_of(const cx::aligned_array<T, N>& a, T value) { return a.count(value); }
+template<typename T, std::size_t N>
+T min_of(const cx::aligned_array<T, N>& a) { return a.min(); }
+template<typename T, std::size_t N>
+T sum_of(const cx::aligned_array<T, N>& a) { return a.sum(); }
+
+// kBatch random vectors followed by a copy of each, so every equality test has to look at all N elements
+template<typename Vector>
+std::vector<Vector> make_batch() {
+    using value_type = typename Vector::value_type;
+    std::mt19937 gen{42};
+    std::uniform_int_distribution<int> value{0, 255};
+    std::vector<Vector> batch(2 * kBatch);
+    for (std::size_t v = 0; v < kBatch; ++v) {
+        for (std::size_t i = 0; i < batch[v].size(); ++i) batch[v][i] = static_cast<value_type>(value(gen));
+        batch[kBatch + v] = batch[v];
+    }
+    return batch;
+}
+
+template<typename Vector>
+void BM_VectorEqual(benchmark::State& state) {
+    const auto batch = make_batch<Vector>();
+    for (auto _ : state) {
+        std::size_t equal = 0;
+        for (std::size_t v = 0; v < kBatch; ++v) equal += batch[v] == batch[kBatch + v];
+        benchmark::DoNotOptimize(equal);
+    }
+    state.SetItemsProcessed(state.iterations() * kBatch);
+}
+
+template<typename Vector>
+void BM_VectorCount(benchmark::State& state) {
+    const auto batch = make_batch<Vector>();
+    for (auto _ : state) {
+        std::size_t hits = 0;
+        for (std::size_t v = 0; v < kBatch; ++v) hits += count_of(batch[v], typename Vector::value_type{7});
+        benchmark::DoNotOptimize(hits);
+    }
+    state.SetItemsProcessed(state.iterations() * kBatch);
+}
+
+template<typename Vector>
+void BM_VectorMinAndSum(benchmark::State& state) {
+    const auto batch = make_batch<Vector>();
+    for (auto _ : state) {
+        typename Vector::value_type total{};
+        for (std::size_t v = 0; v < kBatch; ++v) total += min_of(batch[v]) + sum_of(batch[v]);
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetItemsProcessed(state.iterations() * kBatch);
+}
+
+BENCHMARK_TEMPLATE(BM_VectorEqual, cx::array<std::int32_t, 64>);
+BENCHMARK_TEMPLATE(BM_VectorEqual, cx::aligned_array<std::int32_t, 64>);
+BENCHMARK_TEMPLATE(BM_VectorCount, cx::array<std::uint8_t, 256>);
+BENCHMARK_TEMPLATE(BM_VectorCount, cx::aligned_array<std::uint8_t, 256>);
+BENCHMARK_TEMPLATE(BM_VectorMinAndSum, cx::array<std::int32_t, 64>);
+BENCHMARK_TEMPLATE(BM_VectorMinAndSum, cx::aligned_array<std::int32_t, 64>);
+BENCHMARK_TEMPLATE(BM_VectorMinAndSum, cx::array<float, 64>);
+BENCHMARK_TEMPLATE(BM_VectorMinAndSum, cx::aligned_array<float, 64>);
+
+}
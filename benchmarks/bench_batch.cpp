@@ -0,0 +1,105 @@
+// Copyright (c) 2020. Mohit Deshpande.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+// the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+// Per-key count() vs. count_batch() on cx::frozen_map tables from L2-sized (16k entries, 256 KiB) to well past the
+// last-level cache (8M entries, 128 MiB plus pilots), with the batch sizes of a packet-classification loop.
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "cx/cx_frozen_map.h"
+
+#include "bench_common.h"
+
+namespace {
+
+using table_type = cx::frozen_map<std::uint64_t, std::uint32_t>;
+
+// one table per size, built on first use and shared by every benchmark of that size
+const table_type& table_of(std::size_t n) {
+    static std::vector<std::pair<std::size_t, table_type>> tables;
+    for (const auto& table : tables) {
+        if (table.first == n) return table.second;
+    }
+    std::vector<std::pair<std::uint64_t, std::uint32_t>> entries;
+    entries.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        entries.emplace_back(bench::key_of<std::uint64_t>(i), static_cast<std::uint32_t>(i));
+    }
+    tables.emplace_back(n, cx::freeze(entries));
+    return tables.back().second;
+}
+
+// far more queries than bench::make_queries() so that they don't all end up in cache after the first pass;
+// hit_percent of them are in the table
+std::vector<std::uint64_t> make_queries(std::size_t n, std::int64_t hit_percent) {
+    std::mt19937_64 gen{42};
+    std::uniform_int_distribution<std::size_t> index{0, n - 1};
+    std::uniform_int_distribution<std::int64_t> percent{0, 99};
+    std::vector<std::uint64_t> queries(std::size_t{1} << 20);
+    for (auto& q : queries) q = bench::key_of<std::uint64_t>(percent(gen) < hit_percent ? index(gen) : n + index(gen));
+    return queries;
+}
+
+// args: table size, batch size, hit percentage
+void BM_CountPerKey(benchmark::State& state) {
+    const auto& table = table_of(static_cast<std::size_t>(state.range(0)));
+    const auto batch = static_cast<std::size_t>(state.range(1));
+    const auto queries = make_queries(table.size(), state.range(2));
+    std::unique_ptr<bool[]> found(new bool[batch]);
+    std::size_t offset = 0;
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < batch; ++i) found[i] = table.count(queries[offset + i]) != 0;
+        benchmark::DoNotOptimize(found.get());
+        benchmark::ClobberMemory();
+        offset = (offset + batch) & (queries.size() - 1);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(1));
+}
+
+void BM_CountBatch(benchmark::State& state) {
+    const auto& table = table_of(static_cast<std::size_t>(state.range(0)));
+    const auto batch = static_cast<std::size_t>(state.range(1));
+    const auto queries = make_queries(table.size(), state.range(2));
+    std::unique_ptr<bool[]> found(new bool[batch]);
+    std::size_t offset = 0;
+    for (auto _ : state) {
+        table.count_batch(queries.data() + offset, batch, found.get());
+        benchmark::DoNotOptimize(found.get());
+        benchmark::ClobberMemory();
+        offset = (offset + batch) & (queries.size() - 1);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(1));
+}
+
+void batch_args(benchmark::internal::Benchmark* b) {
+    b->ArgNames({"n", "batch", "hit%"});
+    for (std::int64_t n : {1 << 14, 1 << 20, 1 << 23}) {
+        for (std::int64_t batch : {32, 256}) {
+            b->Args({n, batch, 100});
+        }
+        b->Args({n, 256, 50});
+    }
+}
+
+BENCHMARK(BM_CountPerKey)->Apply(batch_args);
+BENCHMARK(BM_CountBatch)->Apply(batch_args);
+
+}
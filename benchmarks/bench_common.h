@@ -0,0 +1,48 @@
+// Copyright (c) 2020. Mohit Deshpande.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+// the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+// Key generation and table construction shared by the benchmark translation units.
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace bench {
+
+// an odd multiplier is a bijection on 2^k for every k, so the keys are distinct and scattered for any key width
+template<typename Key>
+constexpr Key key_of(std::size_t i) { return static_cast<Key>(i * 2654435761u); }
+
+template<template<typename, typename, std::size_t> class Map, typename Key, std::size_t... Indices>
+constexpr auto make_table(std::index_sequence<Indices...>) {
+    return Map<Key, std::uint32_t, sizeof...(Indices)>{{key_of<Key>(Indices), static_cast<std::uint32_t>(Indices)}...};
+}
+
+// 1024 lookup keys, hit_percent of them present in a table of n keys; misses are key_of(n ... 2n - 1)
+template<typename Key>
+std::vector<Key> make_queries(std::size_t n, std::int64_t hit_percent = 100) {
+    std::mt19937 gen{42};
+    std::uniform_int_distribution<std::size_t> index{0, n - 1};
+    std::uniform_int_distribution<std::int64_t> percent{0, 99};
+    std::vector<Key> queries(1024);
+    for (auto& q : queries) q = key_of<Key>(percent(gen) < hit_percent ? index(gen) : n + index(gen));
+    return queries;
+}
+
+}
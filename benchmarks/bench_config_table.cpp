@@ -0,0 +1,75 @@
+// Copyright (c) 2020. Mohit Deshpande.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+// the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+// Reading settings from a JSON config: the table cx::parse_json builds at compile time against parsing the same text
+// at startup, and lookups in it against a std::unordered_map filled from that parse.
+
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "cx/cx_config_table.h"
+
+namespace {
+
+constexpr char kJson[] = R"({
+    "server": {"host": "0.0.0.0", "port": 8080, "workers": 16, "timeout": 2.5},
+    "database": {"url": "postgres://db:5432/app", "pool": 32, "retries": [100, 200, 400]},
+    "features": {"search": true, "uploads": false, "beta": {"ratio": 0.05}},
+    "log": {"level": "info", "path": "/var/log/app.log"}
+})";
+
+constexpr auto kBuilder = cx::parse_json(kJson);
+constexpr auto kConfig = kBuilder.compact<kBuilder.entry_count(), kBuilder.blob_size()>();
+
+constexpr std::string_view kKeys[] = {"server.port", "database.pool", "features.beta.ratio", "log.level",
+                                 "database.retries.2", "server.timeout", "features.search", "database.url"};
+
+void BM_ParseAtStartup(benchmark::State& state) {
+    for (auto _ : state) {
+        const auto builder = cx::parse_json(kJson);
+        benchmark::DoNotOptimize(builder.entry_count());
+    }
+}
+
+void BM_LookupConstexprTable(benchmark::State& state) {
+    std::size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(kConfig.find(kKeys[i++ % 8]));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+void BM_LookupUnorderedMap(benchmark::State& state) {
+    std::unordered_map<std::string, std::string> config;
+    for (std::size_t i = 0; i < kConfig.size(); ++i) {
+        config.emplace(kConfig.key(i).str(), kConfig.value(i).text().str());
+    }
+    const std::string keys[] = {kKeys[0].data(), kKeys[1].data(), kKeys[2].data(), kKeys[3].data(),
+                                kKeys[4].data(), kKeys[5].data(), kKeys[6].data(), kKeys[7].data()};
+    std::size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(config.find(keys[i++ % 8]));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_ParseAtStartup);
+BENCHMARK(BM_LookupConstexprTable);
+BENCHMARK(BM_LookupUnorderedMap);
+
+}
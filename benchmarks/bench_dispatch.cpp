@@ -0,0 +1,175 @@
+// Copyright (c) 2020. Mohit Deshpande.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+// the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+// Routing 16 command names to handlers: cx::dispatch against a cx::string_map of function pointers (lookup, then an
+// indirect call), a hand-written switch on length and first byte, and std::unordered_map.
+
+#include <benchmark/benchmark.h>
+
+#include <cstring>
+#include <random>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "cx/cx_dispatch.h"
+#include "cx/cx_string_map.h"
+
+namespace {
+
+using handler = unsigned (*)(unsigned);
+
+#define CX_BENCH_HANDLER(name, k) \
+    unsigned name(unsigned x) { return x * k + 1; }
+
+CX_BENCH_HANDLER(on_get, 3)
+CX_BENCH_HANDLER(on_set, 5)
+CX_BENCH_HANDLER(on_del, 7)
+CX_BENCH_HANDLER(on_incr, 9)
+CX_BENCH_HANDLER(on_decr, 11)
+CX_BENCH_HANDLER(on_mget, 13)
+CX_BENCH_HANDLER(on_mset, 15)
+CX_BENCH_HANDLER(on_expire, 17)
+CX_BENCH_HANDLER(on_ttl, 19)
+CX_BENCH_HANDLER(on_exists, 21)
+CX_BENCH_HANDLER(on_hget, 23)
+CX_BENCH_HANDLER(on_hset, 25)
+CX_BENCH_HANDLER(on_lpush, 27)
+CX_BENCH_HANDLER(on_rpush, 29)
+CX_BENCH_HANDLER(on_lpop, 31)
+CX_BENCH_HANDLER(on_rpop, 33)
+
+constexpr const char* kCommands[] = {"get", "set", "del", "incr", "decr", "mget", "mset", "expire",
+                                     "ttl", "exists", "hget", "hset", "lpush", "rpush", "lpop", "rpop"};
+
+struct Commands {
+    static constexpr auto table() {
+        return cx::string_map<handler, 16>{
+                {"get", &on_get}, {"set", &on_set}, {"del", &on_del}, {"incr", &on_incr},
+                {"decr", &on_decr}, {"mget", &on_mget}, {"mset", &on_mset}, {"expire", &on_expire},
+                {"ttl", &on_ttl}, {"exists", &on_exists}, {"hget", &on_hget}, {"hset", &on_hset},
+                {"lpush", &on_lpush}, {"rpush", &on_rpush}, {"lpop", &on_lpop}, {"rpop", &on_rpop},
+        };
+    }
+};
+
+constexpr auto kStringMap = Commands::table();
+
+bool is(std::string_view command, const char* name) {
+    return std::memcmp(command.data(), name, command.size()) == 0;
+}
+
+unsigned route_switch(std::string_view command, unsigned x) {
+    switch (command.size()) {
+        case 3:
+            switch (command[0]) {
+                case 'g': if (is(command, "get")) return on_get(x); break;
+                case 's': if (is(command, "set")) return on_set(x); break;
+                case 'd': if (is(command, "del")) return on_del(x); break;
+                case 't': if (is(command, "ttl")) return on_ttl(x); break;
+            }
+            break;
+        case 4:
+            switch (command[0]) {
+                case 'i': if (is(command, "incr")) return on_incr(x); break;
+                case 'd': if (is(command, "decr")) return on_decr(x); break;
+                case 'm':
+                    if (is(command, "mget")) return on_mget(x);
+                    if (is(command, "mset")) return on_mset(x);
+                    break;
+                case 'h':
+                    if (is(command, "hget")) return on_hget(x);
+                    if (is(command, "hset")) return on_hset(x);
+                    break;
+                case 'l': if (is(command, "lpop")) return on_lpop(x); break;
+                case 'r': if (is(command, "rpop")) return on_rpop(x); break;
+            }
+            break;
+        case 5:
+            switch (command[0]) {
+                case 'l': if (is(command, "lpush")) return on_lpush(x); break;
+                case 'r': if (is(command, "rpush")) return on_rpush(x); break;
+            }
+            break;
+        case 6:
+            switch (command[0]) {
+                case 'e':
+                    if (is(command, "expire")) return on_expire(x);
+                    if (is(command, "exists")) return on_exists(x);
+                    break;
+            }
+            break;
+    }
+    return 0;
+}
+
+unsigned unknown(unsigned) { return 0; }
+
+std::vector<std::string_view> make_commands() {
+    std::mt19937 gen{42};
+    std::uniform_int_distribution<std::size_t> index{0, 15};
+    std::vector<std::string_view> commands(1024);
+    for (auto& command : commands) command = kCommands[index(gen)];
+    return commands;
+}
+
+template<typename Route>
+void run_routes(benchmark::State& state, Route route) {
+    const auto commands = make_commands();
+    std::size_t i = 0;
+    unsigned x = 1;
+    for (auto _ : state) {
+        x = route(commands[i++ & 1023], x);
+        benchmark::DoNotOptimize(x);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+struct dispatch_route {
+    unsigned operator()(std::string_view command, unsigned x) const {
+        return cx::dispatch<Commands>::visit_or(command, &unknown, x);
+    }
+};
+
+struct string_map_route {
+    unsigned operator()(std::string_view command, unsigned x) const {
+        const auto it = kStringMap.find(command);
+        return it == kStringMap.end() ? 0 : it->second(x);
+    }
+};
+
+struct switch_route {
+    unsigned operator()(std::string_view command, unsigned x) const { return route_switch(command, x); }
+};
+
+void BM_Dispatch(benchmark::State& state) { run_routes(state, dispatch_route{}); }
+void BM_StringMapCall(benchmark::State& state) { run_routes(state, string_map_route{}); }
+void BM_Switch(benchmark::State& state) { run_routes(state, switch_route{}); }
+
+void BM_UnorderedMapCall(benchmark::State& state) {
+    std::unordered_map<std::string_view, handler> table;
+    for (const auto& entry : kStringMap) table.emplace(entry.first, entry.second);
+    run_routes(state, [&table](std::string_view command, unsigned x) {
+        const auto it = table.find(command);
+        return it == table.end() ? 0 : it->second(x);
+    });
+}
+
+BENCHMARK(BM_Dispatch);
+BENCHMARK(BM_StringMapCall);
+BENCHMARK(BM_Switch);
+BENCHMARK(BM_UnorderedMapCall);
+
+}
@@ -0,0 +1,101 @@
+// Copyright (c) 2020. Mohit Deshpande.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+// the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+// A metrics exporter line, name{host="...",code="..."} value timestamp, built with cx::format into a stack buffer
+// against std::to_string concatenation, std::ostringstream and snprintf.
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <string_view>
+
+#include "cx/cx_format.h"
+
+namespace {
+
+constexpr std::string_view kHosts[] = {"web-1", "web-2", "db-primary", "cache-eu-west-3"};
+constexpr int kCodes[] = {200, 404, 500, 301};
+
+constexpr auto kLineBuilder = cx::make_format(cx::lit("http_requests_total{{host=\"{}\",code=\"{}\"}} {:.3f} {}\n"));
+constexpr auto kLine = kLineBuilder.compile<kLineBuilder.signature()>();
+constexpr char kPrintfLine[] = "http_requests_total{host=\"%.*s\",code=\"%d\"} %.3f %lld\n";
+
+double value_of(std::size_t i) { return static_cast<double>(i % 100000) * 0.731; }
+std::int64_t timestamp_of(std::size_t i) { return 1700000000000 + static_cast<std::int64_t>(i); }
+
+void BM_MetricsLineCxFormat(benchmark::State& state) {
+    char buffer[256];
+    std::size_t i = 0;
+    for (auto _ : state) {
+        const std::size_t size = kLine.format_to(buffer, sizeof(buffer), kHosts[i % 4], kCodes[(i / 4) % 4],
+                                                 value_of(i), timestamp_of(i));
+        benchmark::DoNotOptimize(size);
+        benchmark::ClobberMemory();
+        ++i;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+void BM_MetricsLineSnprintf(benchmark::State& state) {
+    char buffer[256];
+    std::size_t i = 0;
+    for (auto _ : state) {
+        const std::string_view host = kHosts[i % 4];
+        const int size = std::snprintf(buffer, sizeof(buffer), kPrintfLine, static_cast<int>(host.size()), host.data(),
+                                       kCodes[(i / 4) % 4], value_of(i), static_cast<long long>(timestamp_of(i)));
+        benchmark::DoNotOptimize(size);
+        benchmark::ClobberMemory();
+        ++i;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// std::to_string(double) always prints six digits, so this one rounds differently; it's here for the allocations
+void BM_MetricsLineToString(benchmark::State& state) {
+    std::size_t i = 0;
+    for (auto _ : state) {
+        std::string line = "http_requests_total{host=\"";
+        line += kHosts[i % 4];
+        line += "\",code=\"" + std::to_string(kCodes[(i / 4) % 4]) + "\"} ";
+        line += std::to_string(value_of(i)) + ' ' + std::to_string(timestamp_of(i)) + '\n';
+        benchmark::DoNotOptimize(line.data());
+        ++i;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+void BM_MetricsLineOstringstream(benchmark::State& state) {
+    std::size_t i = 0;
+    for (auto _ : state) {
+        std::ostringstream out;
+        out << "http_requests_total{host=\"" << kHosts[i % 4] << "\",code=\"" << kCodes[(i / 4) % 4] << "\"} "
+            << std::fixed << std::setprecision(3) << value_of(i) << ' ' << timestamp_of(i) << '\n';
+        const std::string line = out.str();
+        benchmark::DoNotOptimize(line.data());
+        ++i;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_MetricsLineCxFormat);
+BENCHMARK(BM_MetricsLineSnprintf);
+BENCHMARK(BM_MetricsLineToString);
+BENCHMARK(BM_MetricsLineOstringstream);
+
+}
@@ -0,0 +1,55 @@
+// Copyright (c) 2020. Mohit Deshpande.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+// the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+// Building a request-log line from a handful of pieces: cx::inline_string against std::string, which goes to the
+// heap once the line outgrows its small-string buffer.
+
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <string_view>
+
+#include "cx/cx_inline_string.h"
+
+namespace {
+
+constexpr std::string_view kMethods[] = {"GET", "POST", "PUT", "DELETE"};
+constexpr std::string_view kPaths[] = {"/", "/api/v1/items", "/api/v1/items/42/reviews", "/static/app.js"};
+
+template<typename String>
+String make_line(std::size_t i) {
+    String line;
+    line += kMethods[i % 4];
+    line += ' ';
+    line += kPaths[(i / 4) % 4];
+    line += " HTTP/1.1 status=200 upstream=";
+    line += kPaths[(i / 16) % 4];
+    return line;
+}
+
+template<typename String>
+void BM_LogLine(benchmark::State& state) {
+    std::size_t i = 0;
+    for (auto _ : state) {
+        const String line = make_line<String>(i++);
+        benchmark::DoNotOptimize(line.data());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK_TEMPLATE(BM_LogLine, std::string);
+BENCHMARK_TEMPLATE(BM_LogLine, cx::inline_string<128>);
+
+}
@@ -0,0 +1,223 @@
+// Copyright (c) 2020. Mohit Deshpande.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+// the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+// cx::map::at/count and the other cx maps against std::map, std::unordered_map, a sorted std::vector and a
+// hand-written switch, over table size, key type and the fraction of lookups that hit.
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "cx/cx_frozen_map.h"
+#include "cx/cx_map.h"
+#include "cx/cx_perfect_map.h"
+#include "cx/cx_soa_map.h"
+#include "cx/cx_sorted_map.h"
+
+#include "bench_common.h"
+
+namespace {
+
+template<typename Key, typename T, std::size_t N>
+using perfect_map = cx::perfect_map<Key, T, N>;
+
+template<typename Key, typename T, std::size_t N>
+using sorted_map = cx::sorted_map<Key, T, N>;
+
+template<template<typename, typename, std::size_t> class Map, typename Key, std::size_t N>
+constexpr auto kTable = bench::make_table<Map, Key>(std::make_index_sequence<N>());
+
+// every table below is built from key_of(0 ... N - 1) mapping to 0 ... N - 1
+
+template<template<typename, typename, std::size_t> class Map>
+struct cx_table {
+    template<typename Key, std::size_t N>
+    struct type {
+        const decltype(kTable<Map, Key, N>)& table = kTable<Map, Key, N>;
+        std::uint32_t at(Key key) const { return table.at(key); }
+        std::size_t count(Key key) const { return table.count(key); }
+    };
+};
+
+template<typename Key, std::size_t N> using CxMap = cx_table<cx::map>::type<Key, N>;
+template<typename Key, std::size_t N> using CxPerfectMap = cx_table<perfect_map>::type<Key, N>;
+template<typename Key, std::size_t N> using CxSortedMap = cx_table<sorted_map>::type<Key, N>;
+template<typename Key, std::size_t N> using CxSoaMap = cx_table<cx::soa_map>::type<Key, N>;
+
+template<typename Key, std::size_t N>
+struct CxFrozenMap {
+    cx::frozen_map<Key, std::uint32_t> table;
+    CxFrozenMap() {
+        std::vector<std::pair<Key, std::uint32_t>> entries;
+        for (std::size_t i = 0; i < N; ++i) entries.emplace_back(bench::key_of<Key>(i), static_cast<std::uint32_t>(i));
+        table = cx::freeze(entries);
+    }
+    std::uint32_t at(Key key) const { return table.at(key); }
+    std::size_t count(Key key) const { return table.count(key); }
+};
+
+template<typename Key, std::size_t N>
+struct StdMap {
+    std::map<Key, std::uint32_t> table;
+    StdMap() {
+        for (std::size_t i = 0; i < N; ++i) table.emplace(bench::key_of<Key>(i), static_cast<std::uint32_t>(i));
+    }
+    std::uint32_t at(Key key) const { return table.at(key); }
+    std::size_t count(Key key) const { return table.count(key); }
+};
+
+template<typename Key, std::size_t N>
+struct StdUnorderedMap {
+    std::unordered_map<Key, std::uint32_t> table;
+    StdUnorderedMap() {
+        for (std::size_t i = 0; i < N; ++i) table.emplace(bench::key_of<Key>(i), static_cast<std::uint32_t>(i));
+    }
+    std::uint32_t at(Key key) const { return table.at(key); }
+    std::size_t count(Key key) const { return table.count(key); }
+};
+
+template<typename Key, std::size_t N>
+struct SortedVector {
+    std::vector<std::pair<Key, std::uint32_t>> table;
+    SortedVector() {
+        for (std::size_t i = 0; i < N; ++i) table.emplace_back(bench::key_of<Key>(i), static_cast<std::uint32_t>(i));
+        std::sort(table.begin(), table.end());
+    }
+    typename std::vector<std::pair<Key, std::uint32_t>>::const_iterator find(Key key) const {
+        const auto it = std::lower_bound(table.begin(), table.end(), key,
+                                         [](const std::pair<Key, std::uint32_t>& e, Key k) { return e.first < k; });
+        return it != table.end() && it->first == key ? it : table.end();
+    }
+    std::uint32_t at(Key key) const {
+        const auto it = find(key);
+        if (it == table.end()) throw std::out_of_range("SortedVector::at");
+        return it->second;
+    }
+    std::size_t count(Key key) const { return find(key) == table.end() ? 0 : 1; }
+};
+
+// what a table would be written as by hand; only the 16-entry version exists
+template<typename Key, std::size_t N>
+struct Switch {
+    static_assert(N == 16, "Switch is only written out for 16 keys");
+
+#define CX_BENCH_CASE(i) case bench::key_of<Key>(i): return i
+    static std::int64_t lookup(Key key) {
+        switch (key) {
+            CX_BENCH_CASE(0); CX_BENCH_CASE(1); CX_BENCH_CASE(2); CX_BENCH_CASE(3);
+            CX_BENCH_CASE(4); CX_BENCH_CASE(5); CX_BENCH_CASE(6); CX_BENCH_CASE(7);
+            CX_BENCH_CASE(8); CX_BENCH_CASE(9); CX_BENCH_CASE(10); CX_BENCH_CASE(11);
+            CX_BENCH_CASE(12); CX_BENCH_CASE(13); CX_BENCH_CASE(14); CX_BENCH_CASE(15);
+            default: return -1;
+        }
+    }
+#undef CX_BENCH_CASE
+
+    std::uint32_t at(Key key) const {
+        const std::int64_t value = lookup(key);
+        if (value < 0) throw std::out_of_range("Switch::at");
+        return static_cast<std::uint32_t>(value);
+    }
+    std::size_t count(Key key) const { return lookup(key) < 0 ? 0 : 1; }
+};
+
+template<typename Key, typename Lookup>
+void run_lookups(benchmark::State& state, std::size_t n, Lookup lookup) {
+    const auto queries = bench::make_queries<Key>(n, state.range(0));
+    std::size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(lookup(queries[i++ & 1023]));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+template<template<typename, std::size_t> class Table, typename Key, std::size_t N>
+void BM_At(benchmark::State& state) {
+    const Table<Key, N> table;
+    run_lookups<Key>(state, N, [&](Key key) { return table.at(key); });
+}
+
+template<template<typename, std::size_t> class Table, typename Key, std::size_t N>
+void BM_Count(benchmark::State& state) {
+    const Table<Key, N> table;
+    run_lookups<Key>(state, N, [&](Key key) { return table.count(key); });
+}
+
+// at() throws on a miss, so it only runs on hits
+#define CX_BENCH_TABLE(Table, Key, N) \
+    BENCHMARK_TEMPLATE(BM_At, Table, Key, N)->ArgName("hit_percent")->Arg(100); \
+    BENCHMARK_TEMPLATE(BM_Count, Table, Key, N)->ArgName("hit_percent")->Arg(100)->Arg(50)->Arg(0)
+
+#define CX_BENCH_SIZES(Table, Key) \
+    CX_BENCH_TABLE(Table, Key, 16); \
+    CX_BENCH_TABLE(Table, Key, 128); \
+    CX_BENCH_TABLE(Table, Key, 1024)
+
+#define CX_BENCH_KEYS(Table) \
+    CX_BENCH_SIZES(Table, std::uint16_t); \
+    CX_BENCH_SIZES(Table, std::uint32_t); \
+    CX_BENCH_SIZES(Table, std::uint64_t)
+
+CX_BENCH_KEYS(CxMap);
+CX_BENCH_KEYS(CxPerfectMap);
+CX_BENCH_KEYS(CxSortedMap);
+CX_BENCH_KEYS(CxSoaMap);
+CX_BENCH_KEYS(CxFrozenMap);
+CX_BENCH_KEYS(StdMap);
+CX_BENCH_KEYS(StdUnorderedMap);
+CX_BENCH_KEYS(SortedVector);
+
+CX_BENCH_TABLE(Switch, std::uint16_t, 16);
+CX_BENCH_TABLE(Switch, std::uint32_t, 16);
+CX_BENCH_TABLE(Switch, std::uint64_t, 16);
+
+// building a frozen_map at runtime, against filling a std::unordered_map with the same entries
+std::vector<std::pair<std::uint64_t, std::uint32_t>> make_entries(std::size_t n) {
+    std::vector<std::pair<std::uint64_t, std::uint32_t>> entries;
+    entries.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) entries.emplace_back(bench::key_of<std::uint64_t>(i) * 0x9e3779b97f4a7c15ULL, i);
+    return entries;
+}
+
+void BM_Freeze(benchmark::State& state) {
+    const auto entries = make_entries(static_cast<std::size_t>(state.range(0)));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(cx::freeze(entries, static_cast<std::size_t>(state.range(1))));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_FillUnorderedMap(benchmark::State& state) {
+    const auto entries = make_entries(static_cast<std::size_t>(state.range(0)));
+    for (auto _ : state) {
+        std::unordered_map<std::uint64_t, std::uint32_t> table(entries.begin(), entries.end());
+        benchmark::DoNotOptimize(table);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_Freeze)->ArgNames({"n", "threads"})->Args({1 << 20, 1})->Args({1 << 20, 4})->Args({10 << 20, 1})
+        ->Args({10 << 20, static_cast<std::int64_t>(std::thread::hardware_concurrency())})
+        ->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_FillUnorderedMap)->ArgName("n")->Arg(1 << 20)->Arg(10 << 20)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+}
@@ -0,0 +1,129 @@
+// Copyright (c) 2020. Mohit Deshpande.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+// the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+// Read throughput of cx::overlay_map while a writer keeps publishing overrides, against a std::unordered_map behind a
+// std::mutex or std::shared_mutex. Run with increasing thread counts; the overlay's reads should scale with cores.
+
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+
+#include "cx/cx_map.h"
+#include "cx/cx_overlay_map.h"
+
+#include "bench_common.h"
+
+namespace {
+
+constexpr std::size_t kBaseSize = 64;
+
+constexpr auto kBase = bench::make_table<cx::map, std::uint32_t>(std::make_index_sequence<kBaseSize>());
+
+// keeps rewriting a handful of overrides until stopped, a thousand times a second
+class background_writer {
+public:
+    template<typename Write>
+    void start(Write write) {
+        stop_ = false;
+        thread_ = std::thread([this, write] {
+            for (std::uint32_t i = 0; !stop_.load(); ++i) {
+                write(bench::key_of<std::uint32_t>(i % 8), i);
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        });
+    }
+
+    void stop() {
+        stop_ = true;
+        thread_.join();
+    }
+
+private:
+    std::atomic<bool> stop_{false};
+    std::thread thread_;
+};
+
+cx::overlay_map<std::remove_const_t<decltype(kBase)>> overlay{kBase};
+
+std::unordered_map<std::uint32_t, std::uint32_t> make_locked_table() {
+    std::unordered_map<std::uint32_t, std::uint32_t> table;
+    for (const auto& entry : kBase) table.emplace(entry.first, entry.second);
+    return table;
+}
+
+std::unordered_map<std::uint32_t, std::uint32_t> locked_table = make_locked_table();
+std::mutex table_mutex;
+std::shared_mutex table_shared_mutex;
+
+background_writer writer;
+
+template<typename Lookup>
+void run_reads(benchmark::State& state, Lookup lookup) {
+    const auto queries = bench::make_queries<std::uint32_t>(kBaseSize);
+    std::size_t i = static_cast<std::size_t>(state.thread_index()) * 97;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(lookup(queries[i++ & 1023]));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+void BM_OverlayRead(benchmark::State& state) {
+    if (state.thread_index() == 0) {
+        writer.start([](std::uint32_t key, std::uint32_t value) { overlay.set(key, value); });
+    }
+    run_reads(state, [](std::uint32_t key) { return overlay.at(key); });
+    if (state.thread_index() == 0) writer.stop();
+}
+
+void BM_MutexMapRead(benchmark::State& state) {
+    if (state.thread_index() == 0) {
+        writer.start([](std::uint32_t key, std::uint32_t value) {
+            std::lock_guard<std::mutex> lock{table_mutex};
+            locked_table[key] = value;
+        });
+    }
+    run_reads(state, [](std::uint32_t key) {
+        std::lock_guard<std::mutex> lock{table_mutex};
+        return locked_table.at(key);
+    });
+    if (state.thread_index() == 0) writer.stop();
+}
+
+void BM_SharedMutexMapRead(benchmark::State& state) {
+    if (state.thread_index() == 0) {
+        writer.start([](std::uint32_t key, std::uint32_t value) {
+            std::unique_lock<std::shared_mutex> lock{table_shared_mutex};
+            locked_table[key] = value;
+        });
+    }
+    run_reads(state, [](std::uint32_t key) {
+        std::shared_lock<std::shared_mutex> lock{table_shared_mutex};
+        return locked_table.at(key);
+    });
+    if (state.thread_index() == 0) writer.stop();
+}
+
+BENCHMARK(BM_OverlayRead)->ThreadRange(1, 64)->UseRealTime();
+BENCHMARK(BM_MutexMapRead)->ThreadRange(1, 64)->UseRealTime();
+BENCHMARK(BM_SharedMutexMapRead)->ThreadRange(1, 64)->UseRealTime();
+
+}
@@ -0,0 +1,69 @@
+// Copyright (c) 2020. Mohit Deshpande.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+// the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+// Linear cx::map::at vs. cx::perfect_map::at over N = 8 ... 4096 to find where hashing starts paying off.
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+
+#include "cx/cx_map.h"
+#include "cx/cx_perfect_map.h"
+
+#include "bench_common.h"
+
+namespace {
+
+template<typename Key, typename T, std::size_t N>
+using perfect_map = cx::perfect_map<Key, T, N>;
+
+template<std::size_t N>
+constexpr auto kLinear = bench::make_table<cx::map, std::uint32_t>(std::make_index_sequence<N>());
+
+template<std::size_t N>
+constexpr auto kPerfect = bench::make_table<perfect_map, std::uint32_t>(std::make_index_sequence<N>());
+
+template<typename Map>
+void run_lookups(benchmark::State& state, const Map& map, std::size_t n) {
+    const auto queries = bench::make_queries<std::uint32_t>(n);
+    std::size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(map.at(queries[i++ & 1023]));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+template<std::size_t N>
+void BM_LinearAt(benchmark::State& state) { run_lookups(state, kLinear<N>, N); }
+
+template<std::size_t N>
+void BM_PerfectAt(benchmark::State& state) { run_lookups(state, kPerfect<N>, N); }
+
+#define CX_BENCH_SIZES(bm) \
+    BENCHMARK_TEMPLATE(bm, 8); \
+    BENCHMARK_TEMPLATE(bm, 16); \
+    BENCHMARK_TEMPLATE(bm, 32); \
+    BENCHMARK_TEMPLATE(bm, 64); \
+    BENCHMARK_TEMPLATE(bm, 128); \
+    BENCHMARK_TEMPLATE(bm, 256); \
+    BENCHMARK_TEMPLATE(bm, 512); \
+    BENCHMARK_TEMPLATE(bm, 1024); \
+    BENCHMARK_TEMPLATE(bm, 2048); \
+    BENCHMARK_TEMPLATE(bm, 4096)
+
+CX_BENCH_SIZES(BM_LinearAt);
+CX_BENCH_SIZES(BM_PerfectAt);
+
+}
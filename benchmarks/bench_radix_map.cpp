@@ -0,0 +1,85 @@
+// Copyright (c) 2020. Mohit Deshpande.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+// the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+// Longest-prefix routing of URL paths over 24 routes: cx::radix_map against probing a std::unordered_map with every
+// prefix of the path, longest first.
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "cx/cx_radix_map.h"
+
+namespace {
+
+constexpr cx::radix_map<int, 24> kRoutes{
+        {"/", 0}, {"/api", 1}, {"/api/v1", 2}, {"/api/v1/users", 3},
+        {"/api/v1/users/me", 4}, {"/api/v1/orders", 5}, {"/api/v1/orders/export", 6}, {"/api/v1/products", 7},
+        {"/api/v2", 8}, {"/api/v2/users", 9}, {"/api/v2/orders", 10}, {"/api/v2/search", 11},
+        {"/static", 12}, {"/static/css", 13}, {"/static/js", 14}, {"/static/img", 15},
+        {"/health", 16}, {"/metrics", 17}, {"/login", 18}, {"/logout", 19},
+        {"/admin", 20}, {"/admin/users", 21}, {"/admin/settings", 22}, {"/docs", 23},
+};
+
+std::vector<std::string> make_paths() {
+    const char* suffixes[] = {"", "/42", "/42/history", "/app.min.js", "?page=2", "/x/y/z"};
+    std::mt19937 gen{42};
+    std::uniform_int_distribution<std::size_t> route{0, kRoutes.size() - 1};
+    std::uniform_int_distribution<std::size_t> suffix{0, 5};
+    std::vector<std::string> paths(1024);
+    for (auto& path : paths) path = kRoutes.begin()[route(gen)].first.str() + suffixes[suffix(gen)];
+    return paths;
+}
+
+void BM_RadixLongestPrefix(benchmark::State& state) {
+    const auto paths = make_paths();
+    std::size_t i = 0;
+    for (auto _ : state) {
+        const auto it = kRoutes.longest_prefix(paths[i++ & 1023]);
+        benchmark::DoNotOptimize(it);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+void BM_UnorderedMapLongestPrefix(benchmark::State& state) {
+    std::unordered_map<std::string_view, int> routes;
+    for (const auto& entry : kRoutes) {
+        routes.emplace(std::string_view(entry.first.data(), entry.first.size()), entry.second);
+    }
+    const auto paths = make_paths();
+    std::size_t i = 0;
+    for (auto _ : state) {
+        const std::string_view path = paths[i++ & 1023];
+        int value = -1;
+        for (std::size_t n = path.size() + 1; n-- > 0;) {
+            const auto it = routes.find(path.substr(0, n));
+            if (it != routes.end()) {
+                value = it->second;
+                break;
+            }
+        }
+        benchmark::DoNotOptimize(value);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_RadixLongestPrefix);
+BENCHMARK(BM_UnorderedMapLongestPrefix);
+
+}
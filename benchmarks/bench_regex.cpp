@@ -0,0 +1,103 @@
+// Copyright (c) 2020. Mohit Deshpande.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+// the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+// Validating header values against a pattern: cx::regex (a DFA built at compile time) against std::regex_match and a
+// hand-written matcher for the same language. The pattern is a media type with an optional charset parameter, e.g.
+// "application/json; charset=utf-8".
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <regex>
+#include <string>
+#include <vector>
+
+#include "cx/cx_regex.h"
+
+namespace {
+
+#define CX_BENCH_MEDIA_TYPE "[a-z]+/[a-z0-9.+-]+(; ?charset=[A-Za-z0-9-]+)?"
+
+constexpr auto kMediaTypeBuilder = cx::make_regex(CX_BENCH_MEDIA_TYPE);
+constexpr auto kMediaType = kMediaTypeBuilder.compact<kMediaTypeBuilder.state_count(),
+                                                      kMediaTypeBuilder.class_count()>();
+
+bool is_lower(char c) { return c >= 'a' && c <= 'z'; }
+bool is_digit(char c) { return c >= '0' && c <= '9'; }
+bool is_subtype(char c) { return is_lower(c) || is_digit(c) || c == '.' || c == '+' || c == '-'; }
+bool is_charset(char c) { return is_lower(c) || (c >= 'A' && c <= 'Z') || is_digit(c) || c == '-'; }
+
+bool match_by_hand(const std::string& s) {
+    std::size_t i = 0;
+    const std::size_t n = s.size();
+    const std::size_t type = i;
+    while (i < n && is_lower(s[i])) ++i;
+    if (i == type || i == n || s[i++] != '/') return false;
+    const std::size_t subtype = i;
+    while (i < n && is_subtype(s[i])) ++i;
+    if (i == subtype) return false;
+    if (i == n) return true;
+    if (s[i++] != ';') return false;
+    if (i < n && s[i] == ' ') ++i;
+    if (s.compare(i, 8, "charset=") != 0) return false;
+    i += 8;
+    const std::size_t charset = i;
+    while (i < n && is_charset(s[i])) ++i;
+    return i != charset && i == n;
+}
+
+// three quarters valid media types, the rest with one byte corrupted
+std::vector<std::string> make_values() {
+    const char* valid[] = {"application/json", "text/html; charset=UTF-8", "image/svg+xml",
+                           "application/vnd.api+json;charset=utf-8", "text/plain; charset=us-ascii",
+                           "multipart/form-data", "application/octet-stream", "font/woff2"};
+    std::mt19937 gen{42};
+    std::uniform_int_distribution<std::size_t> pick{0, 7};
+    std::uniform_int_distribution<int> percent{0, 99};
+    std::vector<std::string> values(1024);
+    for (auto& value : values) {
+        value = valid[pick(gen)];
+        if (percent(gen) < 25) value[std::uniform_int_distribution<std::size_t>{0, value.size() - 1}(gen)] = '@';
+    }
+    return values;
+}
+
+template<typename Matcher>
+void run_matches(benchmark::State& state, Matcher matches) {
+    const auto values = make_values();
+    std::size_t i = 0;
+    for (auto _ : state) {
+        const bool ok = matches(values[i++ & 1023]);
+        benchmark::DoNotOptimize(ok);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+void BM_RegexDfa(benchmark::State& state) {
+    run_matches(state, [](const std::string& s) { return kMediaType.match(s); });
+}
+
+void BM_StdRegex(benchmark::State& state) {
+    const std::regex re(CX_BENCH_MEDIA_TYPE);
+    run_matches(state, [&re](const std::string& s) { return std::regex_match(s, re); });
+}
+
+void BM_HandWritten(benchmark::State& state) { run_matches(state, match_by_hand); }
+
+BENCHMARK(BM_RegexDfa);
+BENCHMARK(BM_StdRegex);
+BENCHMARK(BM_HandWritten);
+
+}
@@ -0,0 +1,133 @@
+// Copyright (c) 2020. Mohit Deshpande.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+// the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+// Finding every occurrence of a short, a medium and a long needle in 1 MiB of log lines: cx::searcher against
+// std::string_view::find and std::boyer_moore_horspool_searcher. The periodic case is the worst one for searches that
+// compare the whole needle at each candidate: 31 'a's, a 'b' and 32 'a's in 1 MiB of 'a's.
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <functional>
+#include <random>
+#include <string>
+#include <string_view>
+
+#include "cx/cx_searcher.h"
+
+namespace {
+
+constexpr auto kShort = cx::make_searcher("id=");
+constexpr auto kMedium = cx::make_searcher("status=503");
+constexpr auto kLong = cx::make_searcher("upstream connect error or disconnect/reset before headers");
+constexpr auto kPeriodic = cx::make_searcher("aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaabaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa");
+
+// access-log-like lines; one in ~64 carries the needle
+std::string make_log_lines(std::string_view needle) {
+    std::mt19937 gen{42};
+    std::uniform_int_distribution<int> status{200, 502};
+    std::uniform_int_distribution<int> latency{1, 999};
+    std::uniform_int_distribution<int> rare{0, 63};
+    std::string log;
+    while (log.size() < (std::size_t{1} << 20)) {
+        log += "2020-06-01T12:00:00Z GET /api/v1/items?page=";
+        log += std::to_string(latency(gen));
+        log += " status=" + std::to_string(status(gen));
+        log += " latency_ms=" + std::to_string(latency(gen));
+        if (rare(gen) == 0) {
+            log += ' ';
+            log += needle;
+        }
+        log += '\n';
+    }
+    return log;
+}
+
+// a needle of 'a's around one 'b' matches its first and last bytes everywhere in a run of 'a's
+std::string make_log(std::string_view needle) {
+    return needle.find_first_not_of('a') == needle.find_last_not_of('a') ? std::string(std::size_t{1} << 20, 'a')
+                                                                         : make_log_lines(needle);
+}
+
+template<std::size_t N>
+void run_searcher(benchmark::State& state, const cx::searcher<N>& searcher) {
+    const std::string log = make_log(std::string_view(searcher.needle().c_str(), N));
+    for (auto _ : state) {
+        std::size_t matches = 0;
+        for (auto at = searcher.find(log); at != searcher.npos; at = searcher.find(log, at + N)) ++matches;
+        benchmark::DoNotOptimize(matches);
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(log.size()));
+}
+
+void run_string_view(benchmark::State& state, std::string_view needle) {
+    const std::string log = make_log(needle);
+    const std::string_view view = log;
+    for (auto _ : state) {
+        std::size_t matches = 0;
+        for (auto at = view.find(needle); at != view.npos; at = view.find(needle, at + needle.size())) ++matches;
+        benchmark::DoNotOptimize(matches);
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(log.size()));
+}
+
+void run_std_horspool(benchmark::State& state, std::string_view needle) {
+    const std::string log = make_log(needle);
+    const std::boyer_moore_horspool_searcher<std::string_view::const_iterator> searcher(needle.begin(), needle.end());
+    for (auto _ : state) {
+        std::size_t matches = 0;
+        for (auto it = log.begin(); (it = std::search(it, log.end(), searcher)) != log.end(); it += needle.size()) {
+            ++matches;
+        }
+        benchmark::DoNotOptimize(matches);
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(log.size()));
+}
+
+constexpr std::string_view kShortNeedle = "id=";
+constexpr std::string_view kMediumNeedle = "status=503";
+constexpr std::string_view kLongNeedle = "upstream connect error or disconnect/reset before headers";
+constexpr std::string_view kPeriodicNeedle(kPeriodic.needle().c_str(), kPeriodic.size());
+
+void BM_SearcherShort(benchmark::State& state) { run_searcher(state, kShort); }
+void BM_StringViewFindShort(benchmark::State& state) { run_string_view(state, kShortNeedle); }
+void BM_StdHorspoolShort(benchmark::State& state) { run_std_horspool(state, kShortNeedle); }
+
+void BM_SearcherMedium(benchmark::State& state) { run_searcher(state, kMedium); }
+void BM_StringViewFindMedium(benchmark::State& state) { run_string_view(state, kMediumNeedle); }
+void BM_StdHorspoolMedium(benchmark::State& state) { run_std_horspool(state, kMediumNeedle); }
+
+void BM_SearcherLong(benchmark::State& state) { run_searcher(state, kLong); }
+void BM_StringViewFindLong(benchmark::State& state) { run_string_view(state, kLongNeedle); }
+void BM_StdHorspoolLong(benchmark::State& state) { run_std_horspool(state, kLongNeedle); }
+
+void BM_SearcherPeriodic(benchmark::State& state) { run_searcher(state, kPeriodic); }
+void BM_StringViewFindPeriodic(benchmark::State& state) { run_string_view(state, kPeriodicNeedle); }
+void BM_StdHorspoolPeriodic(benchmark::State& state) { run_std_horspool(state, kPeriodicNeedle); }
+
+BENCHMARK(BM_SearcherShort);
+BENCHMARK(BM_StringViewFindShort);
+BENCHMARK(BM_StdHorspoolShort);
+BENCHMARK(BM_SearcherMedium);
+BENCHMARK(BM_StringViewFindMedium);
+BENCHMARK(BM_StdHorspoolMedium);
+BENCHMARK(BM_SearcherLong);
+BENCHMARK(BM_StringViewFindLong);
+BENCHMARK(BM_StdHorspoolLong);
+BENCHMARK(BM_SearcherPeriodic);
+BENCHMARK(BM_StringViewFindPeriodic);
+BENCHMARK(BM_StdHorspoolPeriodic);
+
+}
@@ -0,0 +1,102 @@
+// Copyright (c) 2020. Mohit Deshpande.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+// the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+// cx::string operator== and operator+ against std::string and std::string_view, for equal strings and strings that
+// differ only in their last character. std::string_view has no operator+, so concatenation only compares with
+// std::string.
+
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "cx/cx_string.h"
+
+namespace {
+
+template<std::size_t... Indices>
+constexpr cx::string<sizeof...(Indices)> make_string(char last, std::index_sequence<Indices...>) {
+    return cx::string<sizeof...(Indices)>(
+            (Indices + 1 == sizeof...(Indices) ? last : static_cast<char>('a' + Indices % 26))...);
+}
+
+template<std::size_t L>
+constexpr auto kLhs = make_string('z', std::make_index_sequence<L>());
+
+template<std::size_t L>
+constexpr auto kSame = make_string('z', std::make_index_sequence<L>());
+
+template<std::size_t L>
+constexpr auto kDifferent = make_string('y', std::make_index_sequence<L>());
+
+// hides the operands from the optimizer so the comparison isn't folded away
+template<typename String, typename Op>
+void run_binary_op(benchmark::State& state, const String& lhs, const String& rhs, Op op) {
+    for (auto _ : state) {
+        const String* l = &lhs;
+        const String* r = &rhs;
+        benchmark::DoNotOptimize(l);
+        benchmark::DoNotOptimize(r);
+        benchmark::DoNotOptimize(op(*l, *r));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+template<std::size_t L>
+void BM_CxStringEqual(benchmark::State& state) {
+    run_binary_op(state, kLhs<L>, state.range(0) ? kSame<L> : kDifferent<L>,
+                  [](const cx::string<L>& a, const cx::string<L>& b) { return a == b; });
+}
+
+template<std::size_t L>
+void BM_StdStringEqual(benchmark::State& state) {
+    const std::string lhs = kLhs<L>.str();
+    const std::string rhs = state.range(0) ? kSame<L>.str() : kDifferent<L>.str();
+    run_binary_op(state, lhs, rhs, [](const std::string& a, const std::string& b) { return a == b; });
+}
+
+template<std::size_t L>
+void BM_StringViewEqual(benchmark::State& state) {
+    const std::string_view lhs{kLhs<L>.c_str(), L};
+    const std::string_view rhs{state.range(0) ? kSame<L>.c_str() : kDifferent<L>.c_str(), L};
+    run_binary_op(state, lhs, rhs, [](std::string_view a, std::string_view b) { return a == b; });
+}
+
+template<std::size_t L>
+void BM_CxStringConcat(benchmark::State& state) {
+    run_binary_op(state, kLhs<L>, kDifferent<L>,
+                  [](const cx::string<L>& a, const cx::string<L>& b) { return a + b; });
+}
+
+template<std::size_t L>
+void BM_StdStringConcat(benchmark::State& state) {
+    const std::string lhs = kLhs<L>.str();
+    const std::string rhs = kDifferent<L>.str();
+    run_binary_op(state, lhs, rhs, [](const std::string& a, const std::string& b) { return a + b; });
+}
+
+#define CX_BENCH_LENGTHS(bm, ...) \
+    BENCHMARK_TEMPLATE(bm, 8)__VA_ARGS__; \
+    BENCHMARK_TEMPLATE(bm, 32)__VA_ARGS__; \
+    BENCHMARK_TEMPLATE(bm, 128)__VA_ARGS__
+
+CX_BENCH_LENGTHS(BM_CxStringEqual, ->ArgName("equal")->Arg(1)->Arg(0));
+CX_BENCH_LENGTHS(BM_StdStringEqual, ->ArgName("equal")->Arg(1)->Arg(0));
+CX_BENCH_LENGTHS(BM_StringViewEqual, ->ArgName("equal")->Arg(1)->Arg(0));
+CX_BENCH_LENGTHS(BM_CxStringConcat);
+CX_BENCH_LENGTHS(BM_StdStringConcat);
+
+}
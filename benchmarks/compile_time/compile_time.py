@@ -0,0 +1,145 @@
+#!/usr/bin/env python3
+# Copyright (c) 2020. Mohit Deshpande.
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+# documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+# rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+# persons to whom the Software is furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+# the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+# WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+# COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+# OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+"""Compile-time cost of large constexpr tables.
+
+Generates one translation unit per (kind, N), compiles it and records the compiler's wall time and peak RSS:
+
+    map        cx::map<uint32_t, uint32_t, N>, filled by the constexpr loop
+    map_pack   the same table with a non-assignable value type, which takes the pack-expansion path
+    string     cx::lit() of an N-character literal
+
+Every translation unit ends in a static_assert that reads the last entry, so the table is really evaluated.
+
+    ./compile_time.py --cxx g++ --sizes 100,1000,10000,50000,100000 --json compile_time.json
+"""
+
+import argparse
+import json
+import os
+import subprocess
+import sys
+import tempfile
+import time
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+INCLUDE_DIR = os.path.normpath(os.path.join(HERE, '..', '..', 'include'))
+
+
+def key_of(i):
+    # same scattering as benchmarks/bench_common.h
+    return (i * 2654435761) & 0xffffffff
+
+
+def map_source(n, pack):
+    lines = ['#include <cstdint>', '#include "cx/cx_map.h"', '']
+    if pack:
+        lines += ['struct value { const std::uint32_t v; };', 'using mapped = value;']
+        entry = '{{{}u, {{{}u}}}},'
+        last = 'kTable.at({}u).v == {}u'
+    else:
+        lines += ['using mapped = std::uint32_t;']
+        entry = '{{{}u, {}u}},'
+        last = 'kTable.at({}u) == {}u'
+    lines.append('constexpr cx::map<std::uint32_t, mapped, {}> kTable = {{'.format(n))
+    lines += ['    ' + entry.format(key_of(i), i) for i in range(n)]
+    lines.append('};')
+    lines.append('static_assert({}, "");'.format(last.format(key_of(n - 1), n - 1)))
+    return '\n'.join(lines) + '\n'
+
+
+def string_source(n):
+    text = ''.join(chr(ord('a') + i % 26) for i in range(n))
+    # split the literal so no single source line is enormous; adjacent literals are concatenated
+    chunks = ['    "{}"'.format(text[i:i + 100]) for i in range(0, n, 100)]
+    return '\n'.join([
+        '#include "cx/cx_string.h"',
+        '',
+        'constexpr auto kText = cx::lit(',
+        '\n'.join(chunks),
+        ');',
+        'static_assert(kText[{}] == \'{}\', "");'.format(n - 1, text[-1]),
+    ]) + '\n'
+
+
+SOURCES = {
+    'map': lambda n: map_source(n, pack=False),
+    'map_pack': lambda n: map_source(n, pack=True),
+    'string': string_source,
+}
+
+
+def compile_once(cxx, flags, source, timeout):
+    """Returns (ok, wall seconds, peak RSS in KiB, first error line)."""
+    with tempfile.TemporaryDirectory() as tmp:
+        path = os.path.join(tmp, 'table.cpp')
+        with open(path, 'w') as f:
+            f.write(source)
+        cmd = [cxx] + flags + ['-I', INCLUDE_DIR, '-c', path, '-o', os.devnull]
+        with open(os.path.join(tmp, 'stderr'), 'w+') as err:
+            start = time.perf_counter()
+            proc = subprocess.Popen(cmd, stdout=subprocess.DEVNULL, stderr=err)
+            # wait4 rather than Popen.wait, since it also reports the child's own resource usage
+            while True:
+                pid, status, usage = os.wait4(proc.pid, os.WNOHANG)
+                if pid:
+                    break
+                if time.perf_counter() - start > timeout:
+                    proc.kill()
+                    os.wait4(proc.pid, 0)
+                    return False, time.perf_counter() - start, 0, 'timed out after {}s'.format(timeout)
+                time.sleep(0.01)
+            wall = time.perf_counter() - start
+            proc.returncode = 0  # already reaped; keep Popen from waiting on it again
+            err.seek(0)
+            error = next((line.strip() for line in err if 'error' in line), '')
+    # ru_maxrss is in KiB on Linux and bytes on macOS
+    rss = usage.ru_maxrss // 1024 if sys.platform == 'darwin' else usage.ru_maxrss
+    return os.WIFEXITED(status) and os.WEXITSTATUS(status) == 0, wall, rss, error
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('--cxx', default=os.environ.get('CXX', 'c++'))
+    parser.add_argument('--std', default='c++14')
+    parser.add_argument('--flags', default='', help='extra compiler flags, e.g. "-fconstexpr-ops-limit=1000000000"')
+    parser.add_argument('--kinds', default=','.join(SOURCES))
+    parser.add_argument('--sizes', default='100,1000,10000,50000,100000')
+    parser.add_argument('--timeout', type=float, default=600)
+    parser.add_argument('--json', help='also write the results to this file')
+    args = parser.parse_args()
+
+    flags = ['-std=' + args.std] + args.flags.split()
+    sizes = sorted(int(n) for n in args.sizes.split(','))
+    results = []
+    print('{:<10} {:>8} {:>10} {:>14}  {}'.format('kind', 'N', 'wall [s]', 'peak RSS [MiB]', 'status'))
+    for kind in args.kinds.split(','):
+        for n in sizes:
+            ok, wall, rss, error = compile_once(args.cxx, flags, SOURCES[kind](n), args.timeout)
+            results.append({'kind': kind, 'n': n, 'ok': ok, 'wall_seconds': wall, 'peak_rss_kib': rss,
+                            'error': error})
+            print('{:<10} {:>8} {:>10.2f} {:>14.1f}  {}'.format(kind, n, wall, rss / 1024.0,
+                                                                 'ok' if ok else error[:80]))
+            sys.stdout.flush()
+
+    if args.json:
+        with open(args.json, 'w') as f:
+            json.dump({'compiler': args.cxx, 'flags': flags, 'results': results}, f, indent=2)
+    return 0 if all(r['ok'] for r in results) else 1
+
+
+if __name__ == '__main__':
+    sys.exit(main())
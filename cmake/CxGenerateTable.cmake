@@ -0,0 +1,101 @@
+# Copyright (c) 2020. Mohit Deshpande.
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+# documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+# rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+# persons to whom the Software is furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+# the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+# WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+# COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+# OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+# cx_generate_table(<target>
+#                   INPUT <table.csv | table.json>
+#                   HEADER <header>
+#                   NAME <variable>
+#                   KEY_TYPE <type>
+#                   VALUE_TYPE <type>
+#                   [LAYOUT auto | string | enum | perfect | sorted | map]
+#                   [NAMESPACE <namespace>]
+#                   [KEY_COLUMN <column>] [VALUE_COLUMN <column>]
+#                   [INCLUDES <header>...])
+#
+# Generates HEADER (relative to ${CMAKE_CURRENT_BINARY_DIR}/cx_generated, which is added to <target>'s include path)
+# holding `constexpr <container> NAME = {...};` built from INPUT. The container is picked from the data unless LAYOUT
+# says otherwise: cx::string_map for "const char*" keys, cx::enum_map for enumerator keys, cx::perfect_map for unique
+# integer keys and cx::sorted_map for integer keys with duplicates. INCLUDES are headers the table needs, such as the
+# one declaring the key enum. The header is regenerated only when INPUT or the generator changes. See
+# cx_generate_table.py for the accepted CSV and JSON shapes.
+#
+#     cx_generate_table(server
+#             INPUT data/lepton_mass.csv
+#             HEADER physics/lepton_mass.h
+#             NAME kLeptonMass
+#             KEY_TYPE Lepton
+#             VALUE_TYPE double
+#             NAMESPACE physics
+#             INCLUDES physics/lepton.h)
+
+include(CMakeParseArguments)
+
+set(CX_GENERATE_TABLE_SCRIPT ${CMAKE_CURRENT_LIST_DIR}/cx_generate_table.py)
+find_program(PYTHON3_EXECUTABLE NAMES python3)
+
+function(cx_generate_table target)
+    cmake_parse_arguments(TABLE ""
+            "INPUT;HEADER;NAME;KEY_TYPE;VALUE_TYPE;LAYOUT;NAMESPACE;KEY_COLUMN;VALUE_COLUMN"
+            "INCLUDES"
+            ${ARGN})
+    foreach(required INPUT HEADER NAME KEY_TYPE VALUE_TYPE)
+        if(NOT TABLE_${required})
+            message(FATAL_ERROR "cx_generate_table: ${required} is required")
+        endif()
+    endforeach()
+    if(NOT PYTHON3_EXECUTABLE)
+        message(FATAL_ERROR "cx_generate_table: python3 was not found")
+    endif()
+
+    get_filename_component(input ${TABLE_INPUT} ABSOLUTE)
+    set(include_dir ${CMAKE_CURRENT_BINARY_DIR}/cx_generated)
+    set(header ${include_dir}/${TABLE_HEADER})
+
+    set(args --input ${input} --output ${header} --name ${TABLE_NAME}
+             --key-type ${TABLE_KEY_TYPE} --value-type ${TABLE_VALUE_TYPE})
+    if(TABLE_LAYOUT)
+        list(APPEND args --layout ${TABLE_LAYOUT})
+    endif()
+    if(TABLE_NAMESPACE)
+        list(APPEND args --namespace ${TABLE_NAMESPACE})
+    endif()
+    if(TABLE_KEY_COLUMN)
+        list(APPEND args --key-column ${TABLE_KEY_COLUMN})
+    endif()
+    if(TABLE_VALUE_COLUMN)
+        list(APPEND args --value-column ${TABLE_VALUE_COLUMN})
+    endif()
+    foreach(include ${TABLE_INCLUDES})
+        list(APPEND args --include ${include})
+    endforeach()
+
+    add_custom_command(OUTPUT ${header}
+            COMMAND ${PYTHON3_EXECUTABLE} ${CX_GENERATE_TABLE_SCRIPT} ${args}
+            DEPENDS ${input} ${CX_GENERATE_TABLE_SCRIPT}
+            COMMENT "Generating ${TABLE_HEADER} from ${TABLE_INPUT}"
+            VERBATIM)
+
+    # a custom target orders the generation before <target> compiles, whatever kind of target it is
+    string(MAKE_C_IDENTIFIER "${target}_${TABLE_HEADER}" table_target)
+    add_custom_target(${table_target} DEPENDS ${header})
+    add_dependencies(${target} ${table_target})
+
+    get_target_property(type ${target} TYPE)
+    if(type STREQUAL "INTERFACE_LIBRARY")
+        target_include_directories(${target} INTERFACE ${include_dir})
+    else()
+        target_include_directories(${target} PUBLIC ${include_dir})
+    endif()
+endfunction()
@@ -0,0 +1,271 @@
+#!/usr/bin/env python3
+# Copyright (c) 2020. Mohit Deshpande.
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+# documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+# rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+# persons to whom the Software is furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+# the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+# WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+# COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+# OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+"""Turns a CSV or JSON table into a header with a constexpr cx container, picking the layout from the data.
+
+Used by cx_generate_table() in CxGenerateTable.cmake, but can be run by hand:
+
+    ./cx_generate_table.py --input lepton_mass.csv --output lepton_mass.h --name kLeptonMass \\
+                           --key-type Lepton --value-type double --include lepton.h
+
+Input formats (chosen by file extension):
+
+    .csv    a header row, then one entry per row; the key and value columns default to the first two
+    .json   an object {"key": value, ...}, an array of [key, value] pairs, or an array of objects (the key and value
+            columns then name the fields to use)
+
+Layouts (--layout auto picks the first one that fits):
+
+    string   cx::string_map     keys are strings (--key-type "const char*")
+    enum     cx::enum_map       keys are enumerators ("kMuon" or "Lepton::kMuon"); Span is sized by cx::enum_span()
+    perfect  cx::perfect_map    unique integer keys
+    sorted   cx::sorted_map     integer keys with duplicates, or when ordered iteration is wanted
+    map      cx::map            plain linear scan, cheapest to compile
+
+Keys and values are written into the header as they are (so values can be numbers, enumerators or any constant
+expression of --value-type), except for the type "const char*", whose keys and values are quoted as string literals.
+Integer keys are cast to --key-type.
+"""
+
+import argparse
+import csv
+import json
+import os
+import sys
+
+STRING_TYPES = ('const char*', 'const char *', 'char const*', 'char const *')
+
+CONTAINERS = {
+    'string': ('cx::string_map', 'cx/cx_string_map.h'),
+    'enum': ('cx::enum_map', 'cx/cx_enum_map.h'),
+    'perfect': ('cx::perfect_map', 'cx/cx_perfect_map.h'),
+    'sorted': ('cx::sorted_map', 'cx/cx_sorted_map.h'),
+    'map': ('cx::map', 'cx/cx_map.h'),
+}
+
+
+class TableError(Exception):
+    pass
+
+
+def scalar_text(value):
+    # JSON scalars as C++ tokens; CSV cells are already text
+    if isinstance(value, bool):
+        return 'true' if value else 'false'
+    if isinstance(value, (int, float)):
+        return repr(value)
+    if isinstance(value, str):
+        return value
+    raise TableError('unsupported value {!r}: only strings, numbers and booleans can go in a table'.format(value))
+
+
+def column_index(header, column, default):
+    if column is None:
+        return default
+    if column not in header:
+        raise TableError('no column named {!r} (columns are {})'.format(column, ', '.join(header)))
+    return header.index(column)
+
+
+def read_csv(path, key_column, value_column):
+    with open(path, newline='', encoding='utf-8') as f:
+        rows = [row for row in csv.reader(f) if row]
+    if not rows:
+        raise TableError('{} has no header row'.format(path))
+    header = [name.strip() for name in rows[0]]
+    k = column_index(header, key_column, 0)
+    v = column_index(header, value_column, 1)
+    entries = []
+    for line, row in enumerate(rows[1:], start=2):
+        if max(k, v) >= len(row):
+            raise TableError('{}:{}: expected at least {} columns'.format(path, line, max(k, v) + 1))
+        entries.append((row[k].strip(), row[v].strip()))
+    return entries
+
+
+def read_json(path, key_column, value_column):
+    with open(path, encoding='utf-8') as f:
+        data = json.load(f)
+    if isinstance(data, dict):
+        return [(key, scalar_text(value)) for key, value in data.items()]
+    if not isinstance(data, list):
+        raise TableError('{}: expected an object or an array at the top level'.format(path))
+    entries = []
+    for i, item in enumerate(data):
+        if isinstance(item, list) and len(item) == 2:
+            entries.append((scalar_text(item[0]), scalar_text(item[1])))
+        elif isinstance(item, dict) and key_column and value_column:
+            if key_column not in item or value_column not in item:
+                raise TableError('{}: element {} has no {!r} or {!r} field'.format(path, i, key_column, value_column))
+            entries.append((scalar_text(item[key_column]), scalar_text(item[value_column])))
+        else:
+            raise TableError('{}: element {} is neither a [key, value] pair nor an object (objects need '
+                             '--key-column and --value-column)'.format(path, i))
+    return entries
+
+
+def parse_int(text):
+    try:
+        return int(text, 0)
+    except ValueError:
+        return None
+
+
+def quote(text):
+    out = []
+    for ch in text.encode('utf-8'):
+        if ch == 0:
+            raise TableError('strings in a table cannot contain NUL characters')
+        if ch in (ord('"'), ord('\\')):
+            out.append('\\' + chr(ch))
+        elif 0x20 <= ch < 0x7f:
+            out.append(chr(ch))
+        else:
+            # three octal digits, so a following digit can't extend the escape
+            out.append('\\{:03o}'.format(ch))
+    return '"' + ''.join(out) + '"'
+
+
+def integer_literal(value):
+    return '{}ULL'.format(value) if value > 0x7fffffffffffffff else str(value)
+
+
+def choose_layout(keys, key_type, requested):
+    is_string = key_type in STRING_TYPES
+    integers = None if is_string else [parse_int(key) for key in keys]
+    is_integer = integers is not None and all(i is not None for i in integers)
+    unique = len(set(integers if is_integer else keys)) == len(keys)
+
+    layout = requested
+    if layout == 'auto':
+        if is_string:
+            layout = 'string'
+        elif not is_integer:
+            layout = 'enum'
+        else:
+            layout = 'perfect' if unique else 'sorted'
+
+    if layout == 'string' and not is_string:
+        raise TableError('the string layout needs --key-type "const char*"')
+    if layout in ('perfect', 'sorted') and is_string:
+        raise TableError('the {} layout does not support string keys; use the string layout'.format(layout))
+    if layout in ('string', 'enum', 'perfect') and not unique:
+        raise TableError('the {} layout needs unique keys; use the sorted or map layout'.format(layout))
+    if layout == 'enum' and is_integer:
+        raise TableError('the enum layout needs enumerator keys, not integers')
+    return layout
+
+
+def key_text(key, key_type):
+    if key_type in STRING_TYPES:
+        return quote(key)
+    value = parse_int(key)
+    if value is not None:
+        # cx::pair forwards the literal as an int, which would otherwise narrow into unsigned or short keys
+        return 'static_cast<{}>({})'.format(key_type, integer_literal(value))
+    if not key:
+        raise TableError('empty key')
+    return key if '::' in key else '{}::{}'.format(key_type, key)
+
+
+def value_text(value, value_type):
+    if value_type in STRING_TYPES:
+        return quote(value)
+    if not value:
+        raise TableError('empty value; only "const char*" values may be empty')
+    return value
+
+
+def generate(entries, args):
+    if not entries:
+        raise TableError('the table is empty')
+    keys = [key for key, _ in entries]
+    layout = choose_layout(keys, args.key_type, args.layout)
+    container, header = CONTAINERS[layout]
+    key_texts = [key_text(key, args.key_type) for key in keys]
+    n = len(entries)
+
+    if layout == 'string':
+        max_length = max(len(key.encode('utf-8')) for key in keys)
+        type_name = '{}<{}, {}, {}>'.format(container, args.value_type, n, max_length)
+    elif layout == 'enum':
+        span = 'cx::enum_span({{{}}})'.format(', '.join(key_texts))
+        type_name = '{}<{}, {}, {}, {}>'.format(container, args.key_type, args.value_type, n, span)
+    else:
+        type_name = '{}<{}, {}, {}>'.format(container, args.key_type, args.value_type, n)
+
+    lines = [
+        '// Generated by cx_generate_table.py from {}. Do not edit.'.format(os.path.basename(args.input)),
+        '',
+        '#pragma once',
+        '',
+    ]
+    lines += ['#include <cstdint>', '']
+    lines += ['#include "{}"'.format(header)]
+    lines += ['#include "{}"'.format(include) for include in args.include]
+    lines.append('')
+    # one block per component: nested namespace definitions (a::b) are C++17
+    namespaces = [part for part in args.namespace.split('::') if part]
+    for part in namespaces:
+        lines += ['namespace {} {{'.format(part), '']
+    lines.append('constexpr {} {} = {{'.format(type_name, args.name))
+    for key, (_, value) in zip(key_texts, entries):
+        lines.append('        {{{}, {}}},'.format(key, value_text(value, args.value_type)))
+    lines.append('};')
+    for _ in namespaces:
+        lines += ['', '}']
+    return '\n'.join(lines) + '\n'
+
+
+def write_header(path, text):
+    directory = os.path.dirname(path)
+    if directory:
+        os.makedirs(directory, exist_ok=True)
+    with open(path, 'w', encoding='utf-8') as f:
+        f.write(text)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('--input', required=True, help='CSV or JSON table')
+    parser.add_argument('--output', required=True, help='header to write')
+    parser.add_argument('--name', required=True, help='name of the constexpr variable')
+    parser.add_argument('--key-type', required=True)
+    parser.add_argument('--value-type', required=True)
+    parser.add_argument('--layout', default='auto', choices=['auto'] + sorted(CONTAINERS))
+    parser.add_argument('--namespace', default='', help='namespace to put the table in (may be nested, a::b)')
+    parser.add_argument('--key-column', help='CSV column or JSON field holding the keys')
+    parser.add_argument('--value-column', help='CSV column or JSON field holding the values')
+    parser.add_argument('--include', action='append', default=[], help='extra header to include (repeatable)')
+    args = parser.parse_args()
+
+    try:
+        extension = os.path.splitext(args.input)[1].lower()
+        if extension == '.csv':
+            entries = read_csv(args.input, args.key_column, args.value_column)
+        elif extension == '.json':
+            entries = read_json(args.input, args.key_column, args.value_column)
+        else:
+            raise TableError('unknown input format {!r}: expected .csv or .json'.format(extension))
+        write_header(args.output, generate(entries, args))
+    except (OSError, ValueError, TableError) as e:
+        print('cx_generate_table: {}: {}'.format(args.input, e), file=sys.stderr)
+        return 1
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
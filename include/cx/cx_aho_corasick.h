@@ -0,0 +1,493 @@
+// Copyright (c) 2020. Mohit Deshpande.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+// the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+#include "cx/cx_array.h"
+#include "cx/cx_config.h"
+#include "cx/cx_simd.h"
+#include "cx/cx_string.h"
+
+#include <stdexcept>
+
+namespace cx {
+
+namespace detail {
+
+// At most this many rare bytes get a vectorized skip over text that can't hold a match
+constexpr std::size_t kAhoCorasickPrefilterBytes = 3;
+
+// Rough relative frequency of a byte in text-like payloads (words, markup, headers), for picking the rare bytes the
+// prefilter looks for: spaces and common letters high, capitals and punctuation low, other bytes lowest
+constexpr std::size_t byte_weight(unsigned char byte) noexcept {
+    constexpr const char kLetters[] = "etaoinsrhldcumfpgwybvkxjqz";
+    if (byte == ' ') return 80;
+    if (byte >= 'a' && byte <= 'z') {
+        std::size_t rank = 0;
+        while (static_cast<unsigned char>(kLetters[rank]) != byte) ++rank;
+        return 64 - 2 * rank;
+    }
+    if (byte >= '0' && byte <= '9') return 16;
+    if (byte == '\0') return 16;
+    if (byte >= 'A' && byte <= 'Z') return 8;
+    constexpr const char kPunctuation[] = ".,-_/:=;\"'()&?\n\r\t";
+    for (std::size_t i = 0; i + 1 < sizeof(kPunctuation); ++i) {
+        if (static_cast<unsigned char>(kPunctuation[i]) == byte) return 8;
+    }
+    return byte >= 0x20 && byte < 0x7f ? 4 : 2;
+}
+
+// one state per pattern byte plus the root, before any prefixes are shared
+template<typename... Patterns>
+constexpr std::size_t trie_capacity() noexcept {
+    const std::size_t sizes[] = {1, length_of<Patterns>::value...};
+    std::size_t total = 0;
+    for (std::size_t size : sizes) total += size;
+    return total;
+}
+
+}
+
+// whether an automaton skips text that holds none of its patterns' rare bytes (see aho_corasick)
+enum class aho_corasick_prefilter { none, rare_bytes };
+
+// a match of pattern (its index in the pattern list) at text[begin, end)
+struct aho_corasick_match {
+    std::size_t pattern;
+    std::size_t begin;
+    std::size_t end;
+};
+
+template<std::size_t Count, std::size_t States, std::size_t Classes>
+class aho_corasick;
+
+// The trie of Count patterns with room for Capacity states: the first step of building an aho_corasick. Like
+// string_pool, the exact number of states (and byte classes) is only known once the trie is built, so it is sized for
+// the worst case and compact<state_count(), class_count()>() turns it into the automaton. Only the automaton ends up
+// in the binary.
+template<std::size_t Count, std::size_t Capacity>
+class aho_corasick_trie {
+public:
+    using size_type = std::size_t;
+
+    // inserts patterns[i] (lengths[i] bytes each); used by make_aho_corasick()
+    constexpr aho_corasick_trie(const char* const* patterns, const std::size_t* lengths) {
+        output_[0] = Count;
+        for (std::size_t p = 0; p < Count; ++p) {
+            if (lengths[p] == 0) throw std::invalid_argument("cx::aho_corasick: empty pattern");
+            std::uint32_t s = 0;
+            for (std::size_t i = 0; i < lengths[p]; ++i) {
+                const auto byte = static_cast<unsigned char>(patterns[p][i]);
+                used_[byte] = true;
+                std::uint32_t t = first_child_[s];
+                while (t != 0 && label_[t] != byte) t = next_sibling_[t];
+                if (t == 0) {
+                    if (state_count_ == Capacity) throw std::length_error("cx::aho_corasick: trie is too small");
+                    t = static_cast<std::uint32_t>(state_count_++);
+                    label_[t] = byte;
+                    output_[t] = Count;
+                    next_sibling_[t] = first_child_[s];
+                    first_child_[s] = t;
+                }
+                s = t;
+            }
+            if (output_[s] != Count) throw std::invalid_argument("cx::aho_corasick: duplicate patterns");
+            output_[s] = static_cast<std::uint32_t>(p);
+            lengths_[p] = lengths[p];
+        }
+        for (bool used : used_) distinct_bytes_ += used;
+        choose_rare_bytes(patterns, lengths);
+    }
+
+    template<std::size_t States, std::size_t Classes>
+    constexpr aho_corasick<Count, States, Classes> compact(
+            aho_corasick_prefilter prefilter = aho_corasick_prefilter::none) const {
+        return aho_corasick<Count, States, Classes>(*this, prefilter);
+    }
+
+    // capacity
+    constexpr size_type size() const noexcept { return Count; }
+    constexpr size_type state_count() const noexcept { return state_count_; }
+    constexpr size_type capacity() const noexcept { return Capacity; }
+
+    // bytes that appear in a pattern get a class each, every other byte shares one
+    constexpr size_type class_count() const noexcept { return distinct_bytes_ + (distinct_bytes_ < 256); }
+
+    // whether kAhoCorasickPrefilterBytes rare bytes cover every pattern, so compact() can build a prefilter
+    constexpr bool can_prefilter() const noexcept { return rare_count_ != 0; }
+
+private:
+    template<std::size_t, std::size_t, std::size_t>
+    friend class aho_corasick;
+
+    // Greedy set cover: each round takes the byte with the lowest byte_weight() per pattern it newly covers, until
+    // every pattern holds a chosen byte or the prefilter has no room left (and then there is no prefilter)
+    constexpr void choose_rare_bytes(const char* const* patterns, const std::size_t* lengths) {
+        bool covered[Count ? Count : 1]{};
+        std::size_t uncovered = Count;
+        std::size_t chosen = 0;
+        while (uncovered != 0 && chosen < detail::kAhoCorasickPrefilterBytes) {
+            // patterns not yet covered that hold each byte; seen[byte] is the last pattern counted, plus one
+            std::size_t gain[256]{};
+            std::size_t seen[256]{};
+            for (std::size_t p = 0; p < Count; ++p) {
+                if (covered[p]) continue;
+                for (std::size_t i = 0; i < lengths[p]; ++i) {
+                    const auto byte = static_cast<unsigned char>(patterns[p][i]);
+                    if (seen[byte] != p + 1) {
+                        seen[byte] = p + 1;
+                        ++gain[byte];
+                    }
+                }
+            }
+            std::size_t best = 256;
+            std::size_t best_weight = 0;
+            for (std::size_t byte = 0; byte < 256; ++byte) {
+                if (gain[byte] == 0) continue;
+                const std::size_t weight = detail::byte_weight(static_cast<unsigned char>(byte));
+                if (best == 256 || weight * gain[best] < best_weight * gain[byte]) {
+                    best = byte;
+                    best_weight = weight;
+                }
+            }
+            rare_[chosen++] = static_cast<unsigned char>(best);
+            for (std::size_t p = 0; p < Count; ++p) {
+                if (!covered[p] && holds(patterns[p], lengths[p], best)) {
+                    covered[p] = true;
+                    --uncovered;
+                }
+            }
+        }
+        if (uncovered != 0) return;
+
+        // a rare byte anywhere in a pattern, not just where it was chosen, can be the one the scan lands on
+        rare_count_ = chosen;
+        for (std::size_t k = 0; k < chosen; ++k) {
+            for (std::size_t p = 0; p < Count; ++p) {
+                for (std::size_t i = 0; i < lengths[p]; ++i) {
+                    if (static_cast<unsigned char>(patterns[p][i]) == rare_[k] && i > rare_offsets_[k]) {
+                        rare_offsets_[k] = i;
+                    }
+                }
+            }
+        }
+    }
+
+    static constexpr bool holds(const char* pattern, std::size_t length, std::size_t byte) noexcept {
+        for (std::size_t i = 0; i < length; ++i) {
+            if (static_cast<unsigned char>(pattern[i]) == byte) return true;
+        }
+        return false;
+    }
+
+    // children of a state are a linked list: first_child_, then next_sibling_ until 0 (the root is nobody's child)
+    std::uint32_t first_child_[Capacity]{};
+    std::uint32_t next_sibling_[Capacity]{};
+    unsigned char label_[Capacity]{};
+    // the pattern that ends at a state, or Count
+    std::uint32_t output_[Capacity]{};
+    std::size_t lengths_[Count ? Count : 1]{};
+    bool used_[256]{};
+    std::size_t distinct_bytes_{};
+    std::size_t state_count_{1};
+    // bytes that every pattern holds one of, and the largest offset of each in any pattern; none if rare_count_ is 0
+    unsigned char rare_[detail::kAhoCorasickPrefilterBytes]{};
+    std::size_t rare_offsets_[detail::kAhoCorasickPrefilterBytes]{};
+    std::size_t rare_count_{};
+};
+
+// Aho-Corasick automaton over Count patterns, built entirely at compile time into one flat transition table: States
+// rows of Classes entries, where a byte's class is looked up in a 256-entry table. Entries are premultiplied by
+// Classes, so a step is two loads and an add, and their top bit flags states where a pattern ends, so the scan only
+// leaves its loop on a match. Matches are reported for every pattern at every position they occur, overlapping ones
+// included, in order of their end and then longest first.
+//
+// compact(aho_corasick_prefilter::rare_bytes) opts into a prefilter when up to three rare bytes cover every pattern
+// (trie.can_prefilter()): between matches the scan skips a vector at a time to the next of those bytes, then steps from
+// as far before it as the byte sits in any pattern. It pays off for a handful of patterns in text where those bytes are
+// rare; a few hundred signatures almost never share three bytes, so they get no prefilter and the plain scan.
+//
+//     constexpr auto kTrie = cx::make_aho_corasick("<script", "<iframe", "javascript:");
+//     constexpr auto kSignatures = kTrie.compact<kTrie.state_count(), kTrie.class_count()>(
+//             cx::aho_corasick_prefilter::rare_bytes);
+//     kSignatures.scan(payload, [](cx::aho_corasick_match m) { ... });
+template<std::size_t Count, std::size_t States, std::size_t Classes>
+class aho_corasick {
+public:
+    // a bunch of typedefs
+    using size_type = std::size_t;
+    using state_type = std::conditional_t<(States * Classes <= 0x7fffu), std::uint16_t, std::uint32_t>;
+    using match_type = aho_corasick_match;
+
+    // constructors and assignment
+    template<std::size_t Capacity>
+    constexpr explicit aho_corasick(const aho_corasick_trie<Count, Capacity>& trie,
+                                    aho_corasick_prefilter prefilter = aho_corasick_prefilter::none) {
+        if (trie.state_count() != States || trie.class_count() != Classes) {
+            throw std::length_error("cx::aho_corasick: wrong number of states or byte classes");
+        }
+        for (std::size_t p = 0; p < Count; ++p) lengths_[p] = trie.lengths_[p];
+
+        std::size_t next_class = trie.distinct_bytes_ < 256 ? 1 : 0;
+        for (std::size_t byte = 0; byte < 256; ++byte) {
+            classes_[byte] = static_cast<std::uint8_t>(trie.used_[byte] ? next_class++ : 0);
+        }
+
+        // goto edges first, with kNone for a missing edge; rows are state numbers until they are premultiplied below
+        constexpr state_type kNone = static_cast<state_type>(~state_type{0});
+        for (std::size_t s = 0; s < States; ++s) {
+            for (std::size_t c = 0; c < Classes; ++c) table_[s * Classes + c] = kNone;
+            outputs_[s] = trie.output_[s];
+            for (std::uint32_t t = trie.first_child_[s]; t != 0; t = trie.next_sibling_[t]) {
+                table_[s * Classes + classes_[trie.label_[t]]] = static_cast<state_type>(t);
+            }
+        }
+
+        // breadth first, so a state's failure state (which is shallower) has its row filled in before the state does
+        std::uint32_t queue[States]{};
+        std::uint32_t fail[States]{};
+        std::size_t tail = 0;
+        for (std::size_t c = 0; c < Classes; ++c) {
+            if (table_[c] == kNone) {
+                table_[c] = 0;
+            } else {
+                queue[tail++] = table_[c];
+            }
+        }
+        for (std::size_t head = 0; head < tail; ++head) {
+            const std::uint32_t s = queue[head];
+            dict_[s] = outputs_[fail[s]] != Count ? fail[s] : dict_[fail[s]];
+            for (std::size_t c = 0; c < Classes; ++c) {
+                const state_type fallback = table_[fail[s] * Classes + c];
+                if (table_[s * Classes + c] == kNone) {
+                    table_[s * Classes + c] = fallback;
+                } else {
+                    const std::uint32_t t = table_[s * Classes + c];
+                    fail[t] = fallback;
+                    queue[tail++] = t;
+                }
+            }
+        }
+
+        for (std::size_t s = 0; s < States; ++s) {
+            for (std::size_t c = 0; c < Classes; ++c) {
+                const std::size_t t = table_[s * Classes + c];
+                const bool matches = outputs_[t] != Count || dict_[t] != 0;
+                table_[s * Classes + c] = static_cast<state_type>(t * Classes | (matches ? kMatchBit : 0));
+            }
+        }
+
+        if (prefilter == aho_corasick_prefilter::rare_bytes) {
+            prefilter_count_ = trie.rare_count_;
+            for (std::size_t k = 0; k < prefilter_count_; ++k) {
+                prefilter_[k] = static_cast<char>(trie.rare_[k]);
+                prefilter_offsets_[k] = trie.rare_offsets_[k];
+            }
+        }
+    }
+
+    constexpr aho_corasick(const aho_corasick&) = default;
+    constexpr aho_corasick(aho_corasick&&) noexcept = default;
+
+    constexpr aho_corasick& operator=(const aho_corasick&) = default;
+    constexpr aho_corasick& operator=(aho_corasick&&) noexcept = default;
+
+    // capacity
+    constexpr size_type size() const noexcept { return Count; }
+    constexpr bool empty() const noexcept { return Count == 0; }
+    constexpr size_type state_count() const noexcept { return States; }
+    constexpr size_type class_count() const noexcept { return Classes; }
+    constexpr bool has_prefilter() const noexcept { return prefilter_count_ != 0; }
+
+    // element access
+    constexpr size_type pattern_length(size_type pattern) const noexcept { return lengths_[pattern]; }
+
+    // lookup: calls on_match(aho_corasick_match) for every match in text
+    template<typename F>
+    constexpr void scan(const char* data, size_type size, F&& on_match) const {
+        state_type s = 0;
+        if (!has_prefilter()) {
+            for (size_type i = 0; i < size; ++i) {
+                s = step(s, data[i]);
+                if (s & kMatchBit) report(s, i + 1, on_match);
+            }
+            return;
+        }
+        for (size_type i = 0; i < size; ++i) {
+            if (s == 0) {
+                i = skip(data, size, i);
+                if (i == size) return;
+            }
+            s = step(s, data[i]);
+            if (s & kMatchBit) report(s, i + 1, on_match);
+        }
+    }
+
+    // std::string_view, std::string and anything else with data() and size()
+    template<typename StringLike, typename F,
+             typename = decltype(std::declval<const StringLike&>().data(), std::declval<const StringLike&>().size())>
+    constexpr void scan(const StringLike& text, F&& on_match) const {
+        scan(text.data(), text.size(), on_match);
+    }
+
+    // the match that ends first (the longest one if several end there), or {size(), size, size} if there is none
+    constexpr match_type find_first(const char* data, size_type size) const noexcept {
+        state_type s = 0;
+        for (size_type i = 0; i < size; ++i) {
+            if (s == 0 && has_prefilter()) {
+                i = skip(data, size, i);
+                if (i == size) break;
+            }
+            s = step(s, data[i]);
+            if (s & kMatchBit) {
+                const std::size_t state = (s & kStateMask) / Classes;
+                const std::size_t p = outputs_[state] != Count ? outputs_[state] : outputs_[dict_[state]];
+                return {p, i + 1 - lengths_[p], i + 1};
+            }
+        }
+        return {Count, size, size};
+    }
+
+    template<typename StringLike,
+             typename = decltype(std::declval<const StringLike&>().data(), std::declval<const StringLike&>().size())>
+    constexpr match_type find_first(const StringLike& text) const noexcept {
+        return find_first(text.data(), text.size());
+    }
+
+    template<std::size_t M>
+    constexpr match_type find_first(const string<M>& text) const noexcept {
+        return find_first(text.c_str(), M);
+    }
+
+    template<std::size_t M>
+    constexpr match_type find_first(const char (&text)[M]) const noexcept {
+        return find_first(text, M - 1);
+    }
+
+    template<typename Text>
+    constexpr bool contains(const Text& text) const noexcept {
+        return find_first(text).pattern != Count;
+    }
+
+    // number of matches in text, overlapping ones included
+    constexpr size_type count(const char* data, size_type size) const noexcept {
+        counter c{};
+        scan(data, size, c);
+        return c.n;
+    }
+
+    template<typename StringLike,
+             typename = decltype(std::declval<const StringLike&>().data(), std::declval<const StringLike&>().size())>
+    constexpr size_type count(const StringLike& text) const noexcept {
+        return count(text.data(), text.size());
+    }
+
+    template<std::size_t M>
+    constexpr size_type count(const string<M>& text) const noexcept {
+        return count(text.c_str(), M);
+    }
+
+    template<std::size_t M>
+    constexpr size_type count(const char (&text)[M]) const noexcept {
+        return count(text, M - 1);
+    }
+
+private:
+    static constexpr state_type kMatchBit = static_cast<state_type>(state_type{1} << (8 * sizeof(state_type) - 1));
+    static constexpr state_type kStateMask = static_cast<state_type>(kMatchBit - 1);
+
+    // transitions of state s (row s * Classes) premultiplied by Classes, with kMatchBit set on states with a match
+    state_type table_[States * Classes]{};
+    std::uint8_t classes_[256]{};
+    // the pattern that ends at a state, or Count
+    std::uint32_t outputs_[States]{};
+    // the nearest state down the failure chain where a pattern ends, or the root
+    std::uint32_t dict_[States]{};
+    std::size_t lengths_[Count ? Count : 1]{};
+    char prefilter_[detail::kAhoCorasickPrefilterBytes]{};
+    std::size_t prefilter_offsets_[detail::kAhoCorasickPrefilterBytes]{};
+    std::size_t prefilter_count_{};
+
+    struct counter {
+        std::size_t n;
+        constexpr void operator()(const match_type&) noexcept { ++n; }
+    };
+
+    constexpr state_type step(state_type s, char byte) const noexcept {
+        return table_[(s & kStateMask) + classes_[static_cast<unsigned char>(byte)]];
+    }
+
+    // Where the scan can restart from the root, at or after i: every match holds a rare byte, so none starts before
+    // the next one (at j) less that byte's largest offset in a pattern. size if no rare byte is left.
+    constexpr size_type skip(const char* data, size_type size, size_type i) const noexcept {
+        size_type j = i;
+        std::size_t k = 0;
+        if (!CX_IS_CONSTANT_EVALUATED()) {
+            j += detail::simd_find_any(data + i, size - i, prefilter_, prefilter_count_);
+            if (j == size) return size;
+            while (data[j] != prefilter_[k]) ++k;
+        } else {
+            for (; j < size; ++j) {
+                for (k = 0; k < prefilter_count_ && data[j] != prefilter_[k]; ++k) {}
+                if (k < prefilter_count_) break;
+            }
+            if (j == size) return size;
+        }
+        return j - i > prefilter_offsets_[k] ? j - prefilter_offsets_[k] : i;
+    }
+
+    template<typename F>
+    constexpr void report(state_type s, size_type end, F& on_match) const {
+        const std::size_t state = (s & kStateMask) / Classes;
+        if (outputs_[state] != Count) on_match(match_type{outputs_[state], end - lengths_[outputs_[state]], end});
+        for (std::size_t t = dict_[state]; t != 0; t = dict_[t]) {
+            on_match(match_type{outputs_[t], end - lengths_[outputs_[t]], end});
+        }
+    }
+};
+
+// out-of-class definitions of the static members (needed before C++17)
+template<std::size_t Count, std::size_t States, std::size_t Classes>
+constexpr typename aho_corasick<Count, States, Classes>::state_type aho_corasick<Count, States, Classes>::kMatchBit;
+
+template<std::size_t Count, std::size_t States, std::size_t Classes>
+constexpr typename aho_corasick<Count, States, Classes>::state_type aho_corasick<Count, States, Classes>::kStateMask;
+
+// worst-case-sized trie of string literals and/or cx::strings; see aho_corasick_trie for how to compact it
+template<typename... Patterns>
+constexpr auto make_aho_corasick(const Patterns&... patterns) {
+    constexpr std::size_t kCount = sizeof...(Patterns);
+    constexpr std::size_t kCapacity = detail::trie_capacity<Patterns...>();
+    const char* ptrs[kCount ? kCount : 1] = {detail::c_str_of(patterns)...};
+    const std::size_t lens[kCount ? kCount : 1] = {length_of<Patterns>::value...};
+    return aho_corasick_trie<kCount, kCapacity>(ptrs, lens);
+}
+
+template<std::size_t M, std::size_t N>
+constexpr auto make_aho_corasick(const cx::array<string<M>, N>& patterns) {
+    const char* ptrs[N ? N : 1]{};
+    std::size_t lens[N ? N : 1]{};
+    for (std::size_t i = 0; i < N; ++i) {
+        ptrs[i] = patterns[i].c_str();
+        lens[i] = M;
+    }
+    return aho_corasick_trie<N, N * M + 1>(ptrs, lens);
+}
+
+}
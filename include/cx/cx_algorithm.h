@@ -0,0 +1,260 @@
+// Copyright (c) 2020. Mohit Deshpande.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+// the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <type_traits>
+
+#include "cx/cx_array.h"
+#include "cx/cx_pair.h"
+
+namespace cx {
+
+namespace detail {
+
+// stable bottom-up merge sort of the indices [0, n) into idx; less(a, b) compares the elements at indices a and b
+template<typename Less>
+constexpr void merge_sort_indices(std::size_t* idx, std::size_t* scratch, std::size_t n, const Less& less) {
+    for (std::size_t i = 0; i < n; ++i) idx[i] = i;
+
+    std::size_t* src = idx;
+    std::size_t* dst = scratch;
+    for (std::size_t width = 1; width < n; width *= 2) {
+        for (std::size_t lo = 0; lo < n; lo += 2 * width) {
+            const std::size_t mid = lo + width < n ? lo + width : n;
+            const std::size_t hi = lo + 2 * width < n ? lo + 2 * width : n;
+            std::size_t l = lo, r = mid, out = lo;
+            while (l < mid && r < hi) dst[out++] = less(src[r], src[l]) ? src[r++] : src[l++];
+            while (l < mid) dst[out++] = src[l++];
+            while (r < hi) dst[out++] = src[r++];
+        }
+        std::size_t* tmp = src;
+        src = dst;
+        dst = tmp;
+    }
+    if (src != idx) {
+        for (std::size_t i = 0; i < n; ++i) idx[i] = src[i];
+    }
+}
+
+// std::swap isn't constexpr until C++20
+template<typename T>
+constexpr void swap_values(T& a, T& b) {
+    T tmp = a;
+    a = b;
+    b = tmp;
+}
+
+template<typename T, typename Less>
+constexpr void compare_exchange(T& a, T& b, const Less& less) {
+    if (less(b, a)) swap_values(a, b);
+}
+
+// Batcher's odd-even merge network over the next power of two; comparators that reach past n would only ever meet
+// padding, so they are left out
+template<typename T, typename Less>
+constexpr void network_sort(T* first, std::size_t n, const Less& less) {
+    std::size_t width = 1;
+    while (width < n) width *= 2;
+    for (std::size_t p = 1; p < width; p *= 2) {
+        for (std::size_t k = p; k >= 1; k /= 2) {
+            for (std::size_t j = k % p; j + k < n; j += 2 * k) {
+                for (std::size_t i = 0; i < k && i + j + k < n; ++i) {
+                    if ((i + j) / (2 * p) == (i + j + k) / (2 * p)) {
+                        compare_exchange(first[i + j], first[i + j + k], less);
+                    }
+                }
+            }
+        }
+    }
+}
+
+template<typename T, typename Less>
+constexpr void insertion_sort(T* first, std::size_t n, const Less& less) {
+    for (std::size_t i = 1; i < n; ++i) {
+        T value = first[i];
+        std::size_t j = i;
+        for (; j > 0 && less(value, first[j - 1]); --j) first[j] = first[j - 1];
+        first[j] = value;
+    }
+}
+
+template<typename T, typename Less>
+constexpr void sift_down(T* first, std::size_t root, std::size_t n, const Less& less) {
+    for (std::size_t child = 2 * root + 1; child < n; child = 2 * root + 1) {
+        if (child + 1 < n && less(first[child], first[child + 1])) ++child;
+        if (!less(first[root], first[child])) return;
+        swap_values(first[root], first[child]);
+        root = child;
+    }
+}
+
+template<typename T, typename Less>
+constexpr void heap_sort(T* first, std::size_t n, const Less& less) {
+    for (std::size_t i = n / 2; i-- > 0;) sift_down(first, i, n, less);
+    for (std::size_t end = n; end-- > 1;) {
+        swap_values(first[0], first[end]);
+        sift_down(first, 0, end, less);
+    }
+}
+
+// introsort: median-of-three quicksort that recurses into the smaller side, falls back to heap sort once the depth
+// budget runs out and leaves short ranges to insertion sort
+template<typename T, typename Less>
+constexpr void intro_sort(T* first, std::size_t n, std::size_t depth, const Less& less) {
+    while (n > 16) {
+        if (depth == 0) {
+            heap_sort(first, n, less);
+            return;
+        }
+        --depth;
+
+        // the median of three becomes the pivot at first[0]; the larger one stays at first[n - 1], so both scans stop
+        const std::size_t mid = n / 2;
+        compare_exchange(first[0], first[mid], less);
+        compare_exchange(first[mid], first[n - 1], less);
+        compare_exchange(first[0], first[mid], less);
+        swap_values(first[0], first[mid]);
+
+        std::size_t l = 0, r = n;
+        for (;;) {
+            do ++l; while (less(first[l], first[0]));
+            do --r; while (less(first[0], first[r]));
+            if (l >= r) break;
+            swap_values(first[l], first[r]);
+        }
+        swap_values(first[0], first[r]);
+
+        // [0, r) <= pivot == first[r] <= [r + 1, n)
+        if (r < n - r - 1) {
+            intro_sort(first, r, depth, less);
+            first += r + 1;
+            n -= r + 1;
+        } else {
+            intro_sort(first + r + 1, n - r - 1, depth, less);
+            n = r;
+        }
+    }
+    insertion_sort(first, n, less);
+}
+
+constexpr std::size_t log2_floor(std::size_t n) noexcept {
+    std::size_t log = 0;
+    while (n >>= 1) ++log;
+    return log;
+}
+
+}
+
+// Algorithms that compute cx::arrays during constant evaluation, so lookup tables (CRC, base64, popcount, ...) are
+// built by the compiler and land in read-only data instead of being filled by init code at startup:
+//
+//     constexpr std::uint8_t popcount(std::size_t byte) { return byte ? (byte & 1) + popcount(byte >> 1) : 0; }
+//     constexpr auto kPopcount = cx::make_table<256>(popcount);
+//
+// C++14 lambdas can't be called in constant expressions, so the callables are constexpr functions or function
+// objects with a constexpr operator(). Everything returns a new array rather than working in place on iterators.
+
+// {f(0), f(1), ..., f(N - 1)}
+template<std::size_t N, typename F>
+constexpr auto make_table(const F& f) {
+    array<std::decay_t<decltype(f(std::size_t{}))>, N> table{};
+    for (std::size_t i = 0; i < N; ++i) table[i] = f(i);
+    return table;
+}
+
+// N successive calls of a (possibly stateful) generator; the generator is copied, so the caller's isn't advanced
+template<std::size_t N, typename Generator>
+constexpr auto generate(Generator g) {
+    array<std::decay_t<decltype(g())>, N> values{};
+    for (std::size_t i = 0; i < N; ++i) values[i] = g();
+    return values;
+}
+
+template<typename T, std::size_t N, typename F>
+constexpr auto transform(const array<T, N>& a, const F& f) {
+    array<std::decay_t<decltype(f(a[0]))>, N> out{};
+    for (std::size_t i = 0; i < N; ++i) out[i] = f(a[i]);
+    return out;
+}
+
+template<typename T, typename U, std::size_t N, typename F>
+constexpr auto transform(const array<T, N>& a, const array<U, N>& b, const F& f) {
+    array<std::decay_t<decltype(f(a[0], b[0]))>, N> out{};
+    for (std::size_t i = 0; i < N; ++i) out[i] = f(a[i], b[i]);
+    return out;
+}
+
+template<typename T, std::size_t N, typename U, typename BinaryOp = std::plus<>>
+constexpr U accumulate(const array<T, N>& a, U init, const BinaryOp& op = BinaryOp{}) {
+    for (std::size_t i = 0; i < N; ++i) init = op(init, a[i]);
+    return init;
+}
+
+// sorted copy; a sorting network for up to 16 elements, introsort above that (neither is stable)
+template<typename T, std::size_t N, typename Less = std::less<>>
+constexpr array<T, N> sort(array<T, N> a, const Less& less = Less{}) {
+    if (N <= 16) {
+        detail::network_sort(a.data(), N, less);
+    } else {
+        detail::intro_sort(a.data(), N, 2 * detail::log2_floor(N), less);
+    }
+    return a;
+}
+
+template<typename T, std::size_t N, typename Less = std::less<>>
+constexpr bool is_sorted(const array<T, N>& a, const Less& less = Less{}) {
+    for (std::size_t i = 1; i < N; ++i) {
+        if (less(a[i], a[i - 1])) return false;
+    }
+    return true;
+}
+
+// index of the first element equal to value, or N; an index stays valid for any table built in the same order
+template<typename T, std::size_t N, typename U>
+constexpr std::size_t find(const array<T, N>& a, const U& value) {
+    for (std::size_t i = 0; i < N; ++i) {
+        if (a[i] == value) return i;
+    }
+    return N;
+}
+
+template<typename T, std::size_t N, typename Predicate>
+constexpr std::size_t find_if(const array<T, N>& a, const Predicate& pred) {
+    for (std::size_t i = 0; i < N; ++i) {
+        if (pred(a[i])) return i;
+    }
+    return N;
+}
+
+// stable partition: the elements satisfying pred come first, in their original order, followed by the rest; second
+// is the number that satisfied pred
+template<typename T, std::size_t N, typename Predicate>
+constexpr pair<array<T, N>, std::size_t> partition(const array<T, N>& a, const Predicate& pred) {
+    array<T, N> out{};
+    std::size_t front = 0;
+    for (std::size_t i = 0; i < N; ++i) {
+        if (pred(a[i])) out[front++] = a[i];
+    }
+    std::size_t back = front;
+    for (std::size_t i = 0; i < N; ++i) {
+        if (!pred(a[i])) out[back++] = a[i];
+    }
+    return {out, front};
+}
+
+}
@@ -0,0 +1,192 @@
+// Copyright (c) 2020. Mohit Deshpande.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+// the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+
+#include "cx/cx_array.h"
+#include "cx/cx_config.h"
+#include "cx/cx_simd.h"
+
+#include <stdexcept>
+
+namespace cx {
+
+// A cx::array whose storage starts on an Align-byte boundary (a cache line by default). Because sizeof is a multiple
+// of Align, arrays of them stay aligned too, and no element straddles two lines. It adds vectorized lookups and
+// reductions on top of the usual interface. Every one of them is constexpr and runs a plain loop during constant
+// evaluation. At runtime, equality, find() and count() use SSE2/AVX2 for integral, enum and pointer elements, and
+// min(), max() and sum() use them for 32-bit integers, float and double. Other element types keep the scalar loops.
+//
+//     constexpr cx::aligned_array<float, 16> kWeights{0.5f, 0.25f, ...};
+//     const float total = features.sum();
+template<typename T, std::size_t N, std::size_t Align = 64>
+struct alignas(Align) aligned_array {
+    static_assert(Align >= alignof(T) && (Align & (Align - 1)) == 0,
+                  "cx::aligned_array: alignment must be a power of two no smaller than the element's");
+
+    // a bunch of typedefs
+    using value_type = T;
+    using pointer = value_type*;
+    using const_pointer = const value_type*;
+    using reference = value_type&;
+    using const_reference = const value_type&;
+    using iterator = value_type*;
+    using const_iterator = const value_type*;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    static constexpr size_type alignment = Align;
+
+    // all of the iterators
+    constexpr const_iterator begin() const noexcept { return const_iterator(data()); }
+    constexpr const_iterator end() const noexcept { return const_iterator(data() + N); }
+    constexpr const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+    constexpr const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+    constexpr const_iterator cbegin() const noexcept { return const_iterator(data()); }
+    constexpr const_iterator cend() const noexcept { return const_iterator(data() + N); }
+    constexpr const_reverse_iterator crbegin() const noexcept { return const_reverse_iterator(end()); }
+    constexpr const_reverse_iterator crend() const noexcept { return const_reverse_iterator(begin()); }
+
+    // capacity
+    constexpr size_type size() const noexcept { return N; }
+    constexpr size_type max_size() const noexcept { return N; }
+    [[nodiscard]] constexpr bool empty() const noexcept { return size() == 0; }
+
+    // element access
+    constexpr reference operator[](size_type i) noexcept { return elems_[i]; }
+    constexpr const_reference operator[](size_type i) const noexcept { return elems_[i]; }
+    constexpr const_reference at(size_type i) const {
+        if (i >= N) throw_out_of_range();
+        return elems_[i];
+    }
+
+    constexpr const_reference front() const noexcept { return elems_[0]; }
+    constexpr const_reference back() const noexcept { return N ? *(end() - 1) : *end(); }
+    constexpr pointer data() noexcept { return elems_; }
+    constexpr const_pointer data() const noexcept { return elems_; }
+
+    // lookup
+    // index of the first element equal to value, or N
+    constexpr size_type find(const T& value) const noexcept { return find(value, simd_comparable{}); }
+    constexpr size_type count(const T& value) const noexcept { return count(value, simd_comparable{}); }
+    constexpr bool contains(const T& value) const noexcept { return find(value) != N; }
+
+    // reductions; min() and max() need at least one element, sum() of no elements is T{}
+    constexpr T min() const noexcept {
+        static_assert(N > 0, "cx::aligned_array::min: empty array");
+        return fold(detail::fold_min<T>{});
+    }
+    constexpr T max() const noexcept {
+        static_assert(N > 0, "cx::aligned_array::max: empty array");
+        return fold(detail::fold_max<T>{});
+    }
+    constexpr T sum() const noexcept { return N ? fold(detail::fold_sum<T>{}) : T{}; }
+
+    T elems_[N];
+
+private:
+    using simd_comparable = std::integral_constant<bool, detail::is_simd_comparable<T>::value>;
+
+    constexpr size_type find(const T& value, std::true_type) const noexcept {
+        if (!CX_IS_CONSTANT_EVALUATED()) return detail::simd_find(elems_, N, value);
+        return find(value, std::false_type{});
+    }
+
+    constexpr size_type find(const T& value, std::false_type) const noexcept {
+        for (std::size_t i = 0; i < N; ++i) {
+            if (elems_[i] == value) return i;
+        }
+        return N;
+    }
+
+    constexpr size_type count(const T& value, std::true_type) const noexcept {
+        if (!CX_IS_CONSTANT_EVALUATED()) return detail::simd_count(elems_, N, value);
+        return count(value, std::false_type{});
+    }
+
+    constexpr size_type count(const T& value, std::false_type) const noexcept {
+        size_type count{};
+        for (std::size_t i = 0; i < N; ++i) {
+            if (elems_[i] == value) ++count;
+        }
+        return count;
+    }
+
+    template<typename Op>
+    constexpr T fold(const Op& op) const noexcept {
+        if (!CX_IS_CONSTANT_EVALUATED()) return detail::simd_fold(elems_, N, op);
+        T result = elems_[0];
+        for (std::size_t i = 1; i < N; ++i) result = op(result, elems_[i]);
+        return result;
+    }
+
+    constexpr void throw_out_of_range() const {
+        throw std::out_of_range("cx::aligned_array::at: index out of bounds");
+    }
+};
+
+// definition of the static constexpr member (needed before C++17)
+template<typename T, std::size_t N, std::size_t Align>
+constexpr std::size_t aligned_array<T, N, Align>::alignment;
+
+namespace detail {
+
+template<typename T, std::size_t N, std::size_t Align>
+constexpr bool equal_elements(const aligned_array<T, N, Align>& lhs, const aligned_array<T, N, Align>& rhs,
+                              std::false_type) {
+    for (std::size_t i = 0; i < N; ++i) {
+        if (lhs[i] != rhs[i]) return false;
+    }
+    return true;
+}
+
+// == on these types is bitwise, so the runtime path compares the raw bytes
+template<typename T, std::size_t N, std::size_t Align>
+constexpr bool equal_elements(const aligned_array<T, N, Align>& lhs, const aligned_array<T, N, Align>& rhs,
+                              std::true_type) {
+    if (!CX_IS_CONSTANT_EVALUATED()) {
+        return simd_equal_bytes(reinterpret_cast<const char*>(lhs.data()), reinterpret_cast<const char*>(rhs.data()),
+                                N * sizeof(T));
+    }
+    return equal_elements(lhs, rhs, std::false_type{});
+}
+
+}
+
+template<typename T, std::size_t N, std::size_t Align>
+constexpr bool operator==(const aligned_array<T, N, Align>& lhs, const aligned_array<T, N, Align>& rhs) {
+    return detail::equal_elements(lhs, rhs, std::integral_constant<bool, detail::is_simd_comparable<T>::value>{});
+}
+
+template<typename T, std::size_t N, std::size_t Align>
+constexpr bool operator!=(const aligned_array<T, N, Align>& lhs, const aligned_array<T, N, Align>& rhs) {
+    return !(lhs == rhs);
+}
+
+// aligned copy of a cx::array
+template<std::size_t Align = 64, typename T, std::size_t N>
+constexpr aligned_array<T, N, Align> make_aligned_array(const array<T, N>& a) {
+    aligned_array<T, N, Align> out{};
+    for (std::size_t i = 0; i < N; ++i) out[i] = a[i];
+    return out;
+}
+
+}
@@ -15,6 +15,10 @@
 
 #pragma once
 
+#include <cstddef>
+#include <iterator>
+#include <stdexcept>
+
 namespace cx {
 
 template<typename T, std::size_t N>
@@ -48,6 +52,7 @@ struct array {
     [[nodiscard]] constexpr bool empty() const noexcept { return size() == 0; }
 
     // element access
+    constexpr reference operator[](size_type i) noexcept { return elems_[i]; }
     constexpr const_reference operator[](size_type i) const noexcept { return elems_[i]; }
     constexpr const_reference at(size_type i) const {
         // we can't directly put the throw here since this is a core constant expression
@@ -58,9 +63,11 @@ struct array {
 
     constexpr const_reference front() const noexcept { return elems_[0]; }
     constexpr const_reference back() const noexcept { return N ? *(end() - 1) : *end(); }
+    constexpr pointer data() noexcept { return elems_; }
     constexpr const_pointer data() const noexcept { return elems_; }
 
-    const T elems_[N];
+    // not const so containers can fill their storage in a constexpr loop; a const cx::array is still immutable
+    T elems_[N];
 private:
     constexpr void throw_out_of_range() const {
         throw std::out_of_range("cx::array::at: index out of bounds");
@@ -68,12 +75,16 @@ private:
 };
 
 template<typename T, std::size_t N>
-constexpr bool operator==(cx::array<T, N> lhs, cx::array<T, N> rhs) {
-    for (int i = 0; i < N; ++i) {
+constexpr bool operator==(const cx::array<T, N>& lhs, const cx::array<T, N>& rhs) {
+    for (std::size_t i = 0; i < N; ++i) {
         if (lhs[i] != rhs[i]) return false;
     }
     return true;
 }
 
+template<typename T, std::size_t N>
+constexpr bool operator!=(const cx::array<T, N>& lhs, const cx::array<T, N>& rhs) {
+    return !(lhs == rhs);
+}
 
 }
@@ -0,0 +1,82 @@
+// Copyright (c) 2020. Mohit Deshpande.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+// the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+// Compiler feature detection shared by the containers. Everything here degrades to portable scalar code.
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__has_builtin)
+#define CX_HAS_BUILTIN(x) __has_builtin(x)
+#else
+#define CX_HAS_BUILTIN(x) 0
+#endif
+
+// Lets a constexpr function take a non-constexpr fast path (intrinsics, prefetches) at runtime. Compilers that can't
+// tell always report constant evaluation, so they just keep the portable path.
+#if CX_HAS_BUILTIN(__builtin_is_constant_evaluated) || (defined(__GNUC__) && __GNUC__ >= 9)
+#define CX_IS_CONSTANT_EVALUATED() __builtin_is_constant_evaluated()
+#define CX_HAS_IS_CONSTANT_EVALUATED 1
+#else
+#define CX_IS_CONSTANT_EVALUATED() true
+#define CX_HAS_IS_CONSTANT_EVALUATED 0
+#endif
+
+// Native byte order, for code that mixes loads computed at compile time with raw memory loads at runtime
+#if defined(__BYTE_ORDER__) && defined(__ORDER_LITTLE_ENDIAN__)
+#define CX_LITTLE_ENDIAN (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+#elif defined(_M_X64) || defined(_M_IX86) || defined(_M_ARM64)
+#define CX_LITTLE_ENDIAN 1
+#else
+#define CX_LITTLE_ENDIAN 0
+#endif
+
+// Keeps a slow path out of its caller, so a hot loop there keeps its registers
+#if defined(__GNUC__) || defined(__clang__)
+#define CX_NOINLINE __attribute__((noinline))
+#elif defined(_MSC_VER)
+#define CX_NOINLINE __declspec(noinline)
+#else
+#define CX_NOINLINE
+#endif
+
+namespace cx {
+namespace detail {
+
+// Keys per group in the find_batch() lookups: enough independent probes to keep the core's outstanding cache misses
+// overlapped, few enough that a group's hashes and slots stay in registers and L1
+constexpr std::size_t kBatchGroup = 16;
+
+inline void prefetch(const void* address) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(address);
+#else
+    (void) address;
+#endif
+}
+
+constexpr std::size_t kCacheLine = 64;
+
+// prefetches every cache line of [first, first + bytes), bytes >= 1
+inline void prefetch_range(const void* first, std::size_t bytes) noexcept {
+    const auto begin = reinterpret_cast<std::uintptr_t>(first) & ~(kCacheLine - 1);
+    const auto end = reinterpret_cast<std::uintptr_t>(first) + bytes;
+    for (std::uintptr_t line = begin; line < end; line += kCacheLine) prefetch(reinterpret_cast<const void*>(line));
+}
+
+}
+}
@@ -0,0 +1,904 @@
+// Copyright (c) 2020. Mohit Deshpande.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+// the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "cx/cx_algorithm.h"
+#include "cx/cx_array.h"
+#include "cx/cx_format.h"
+#include "cx/cx_inline_string.h"
+#include "cx/cx_map.h"
+#include "cx/cx_pair.h"
+#include "cx/cx_string.h"
+
+#include <stdexcept>
+
+namespace cx {
+
+// Malformed configuration text. offset() is where parsing stopped. During constant evaluation it's a compile error
+// instead, which reads error_at_offset[offset] so that the compiler prints the offset, under a backtrace that shows
+// the message.
+class config_error : public std::invalid_argument {
+public:
+    config_error(const char* what, std::size_t offset)
+            : std::invalid_argument(std::string("cx::config: ") + what + " at offset " + std::to_string(offset)),
+              offset_{offset} {}
+
+    std::size_t offset() const noexcept { return offset_; }
+
+private:
+    std::size_t offset_;
+};
+
+enum class config_kind : std::uint8_t { null, boolean, integer, number, string, array, object };
+
+// One value of a config_table: a scalar, or an array or object whose elements are entries of their own
+class config_value {
+public:
+    // constructors and assignment
+    constexpr config_value() noexcept = default;
+    constexpr config_value(config_kind kind, string_ref text, std::int64_t integer, double number) noexcept
+            : kind_{kind}, text_{text}, integer_{integer}, number_{number} {}
+
+    // element access
+    constexpr config_kind kind() const noexcept { return kind_; }
+    constexpr bool is_null() const noexcept { return kind_ == config_kind::null; }
+
+    // the unescaped characters of a string, or a scalar as it was written
+    constexpr string_ref text() const noexcept { return text_; }
+
+    // the elements of an array or the members of an object
+    constexpr std::size_t size() const noexcept {
+        return kind_ == config_kind::array || kind_ == config_kind::object ? static_cast<std::size_t>(integer_) : 0;
+    }
+
+    constexpr bool as_bool() const {
+        require(config_kind::boolean, "cx::config_value: not a bool");
+        return integer_ != 0;
+    }
+
+    constexpr std::int64_t as_integer() const {
+        require(config_kind::integer, "cx::config_value: not an integer");
+        return integer_;
+    }
+
+    // integers convert, rounding to the nearest double past 2^53
+    constexpr double as_number() const {
+        if (kind_ == config_kind::integer) return static_cast<double>(integer_);
+        require(config_kind::number, "cx::config_value: not a number");
+        return number_;
+    }
+
+    constexpr string_ref as_string() const {
+        require(config_kind::string, "cx::config_value: not a string");
+        return text_;
+    }
+
+    // as_bool(), as_integer() checked against T's range, as_number() or as_string() by T
+    template<typename T>
+    constexpr T as() const {
+        return as(static_cast<T*>(nullptr));
+    }
+
+private:
+    config_kind kind_{};
+    string_ref text_{};
+    std::int64_t integer_{};
+    double number_{};
+
+    constexpr bool as(bool*) const { return as_bool(); }
+    constexpr double as(double*) const { return as_number(); }
+    constexpr float as(float*) const { return static_cast<float>(as_number()); }
+    constexpr string_ref as(string_ref*) const { return as_string(); }
+
+    template<typename T, typename = std::enable_if_t<std::is_integral<T>::value>>
+    constexpr T as(T*) const {
+        const std::int64_t v = as_integer();
+        const bool fits = std::is_signed<T>::value
+                ? v >= static_cast<std::int64_t>(std::numeric_limits<T>::min())
+                  && v <= static_cast<std::int64_t>(std::numeric_limits<T>::max())
+                : v >= 0 && static_cast<std::uint64_t>(v) <= std::numeric_limits<T>::max();
+        if (!fits) throw std::out_of_range("cx::config_value::as: integer out of range");
+        return static_cast<T>(v);
+    }
+
+    constexpr void require(config_kind kind, const char* what) const {
+        if (kind_ != kind) throw std::invalid_argument(what);
+    }
+};
+
+namespace detail {
+
+constexpr std::size_t kConfigNpos = static_cast<std::size_t>(-1);
+constexpr std::size_t kMaxConfigDepth = 64;
+// significant digits a number may have, so that it fits big_uint<8> and converts exactly
+constexpr int kMaxConfigDigits = 76;
+
+struct config_cursor {
+    const char* text;
+    std::size_t size;
+    std::size_t pos;
+
+    constexpr bool done() const noexcept { return pos == size; }
+    constexpr char peek() const noexcept { return pos < size ? text[pos] : '\0'; }
+};
+
+// offsets into the blob, where keys and values are stored back to back
+struct config_entry {
+    std::size_t key{};
+    std::size_t key_size{};
+    std::size_t value{};
+    std::size_t value_size{};
+    std::size_t source{};  // where the entry starts in the text, for duplicate key errors
+    config_kind kind{};
+    std::int64_t integer{};
+    double number{};
+};
+
+constexpr bool is_config_digit(char c) noexcept { return c >= '0' && c <= '9'; }
+constexpr bool is_config_blank(char c) noexcept { return c == ' ' || c == '\t' || c == '\r'; }
+
+constexpr bool config_text_equals(const char* text, std::size_t begin, std::size_t end, const char* word,
+                                  std::size_t size) noexcept {
+    return end - begin == size && equal_chars(text + begin, size, word, size);
+}
+
+// ---------- numbers ----------
+
+// digits * 10^exponent, with digits holding count significant digits
+struct config_decimal {
+    big_uint<8> digits{};
+    int count{};
+    int exponent{};
+
+    constexpr bool push(char c, bool fraction) noexcept {
+        if (fraction) --exponent;
+        if (count == 0 && c == '0') return true;
+        if (count == kMaxConfigDigits) return false;
+        digits.multiply(10);
+        digits.add(static_cast<std::uint32_t>(c - '0'));
+        ++count;
+        return true;
+    }
+};
+
+// The nearest double to digits * 10^exponent, ties to even. The value is scaled to at least 55 bits in a big integer
+// (multiplied by 10^exponent, or shifted up and divided by 10^-exponent with the remainder kept as a sticky bit), then
+// rounded once to the precision the result has: 53 bits, or fewer for subnormals.
+constexpr double decimal_to_double(const config_decimal& d) noexcept {
+    if (d.count == 0 || d.count + d.exponent < -323) return 0;
+    if (d.count + d.exponent > 309) return std::numeric_limits<double>::infinity();
+
+    big_uint<48> x{};
+    for (std::size_t i = 0; i < 8; ++i) x.limbs[i] = d.digits.limbs[i];
+    int exponent = 0;
+    bool sticky = false;
+    if (d.exponent >= 0) {
+        for (int i = 0; i < d.exponent; ++i) x.multiply(10);
+    } else {
+        const int divisions = -d.exponent;
+        // 3.322 > log2(10), so the quotient keeps at least 55 bits
+        const int shift = 55 + (divisions * 3322 + 999) / 1000 - static_cast<int>(d.digits.bit_length());
+        if (shift > 0) {
+            x.shift_left(static_cast<std::size_t>(shift));
+            exponent = -shift;
+        }
+        for (int i = 0; i < divisions; ++i) sticky = x.divide(10) != 0 || sticky;
+    }
+    // a set bit below everything else stands for the remainder, so it can't be mistaken for a tie
+    x.shift_left(1);
+    if (sticky) x.increment();
+    --exponent;
+
+    const int bits = static_cast<int>(x.bit_length());
+    const int top = bits - 1 + exponent;
+    if (top > 1023) return std::numeric_limits<double>::infinity();
+    const int keep = top >= -1022 ? 53 : 53 - (-1022 - top);
+    if (keep < 0) return 0;
+    const int drop = bits - keep;
+    if (drop > 0) {
+        x.shift_right_round(static_cast<std::size_t>(drop));
+    } else {
+        x.shift_left(static_cast<std::size_t>(-drop));
+    }
+    exponent += drop;
+
+    // at most 2^53, so exact; scaling by two is exact too, down to the result
+    double result = static_cast<double>(x.bits64(0));
+    for (; exponent > 0; --exponent) result *= 2;
+    for (; exponent < 0; ++exponent) result /= 2;
+    return result;
+}
+
+struct config_number {
+    std::size_t end;
+    const char* error;  // set when there's no valid number at the start
+    config_kind kind;
+    std::int64_t integer;
+    double number;
+};
+
+// a JSON number at text[i, size): integers that fit int64_t are integers, everything else is a double
+constexpr config_number parse_config_number(const char* text, std::size_t size, std::size_t i) noexcept {
+    config_number out{i, nullptr, config_kind::integer, 0, 0};
+    config_decimal d{};
+    const bool negative = i < size && text[i] == '-';
+    if (negative) ++i;
+    if (i == size || !is_config_digit(text[i])) {
+        out.error = "expected a value";
+        return out;
+    }
+    bool integral = true;
+    bool fits = true;
+    if (text[i] == '0') {
+        ++i;
+    } else {
+        for (; i < size && is_config_digit(text[i]); ++i) fits = d.push(text[i], false) && fits;
+    }
+    if (i < size && text[i] == '.') {
+        integral = false;
+        if (++i == size || !is_config_digit(text[i])) {
+            out.error = "expected a digit";
+            return out;
+        }
+        for (; i < size && is_config_digit(text[i]); ++i) fits = d.push(text[i], true) && fits;
+    }
+    if (i < size && (text[i] == 'e' || text[i] == 'E')) {
+        integral = false;
+        ++i;
+        const bool negative_exponent = i < size && text[i] == '-';
+        if (i < size && (text[i] == '-' || text[i] == '+')) ++i;
+        if (i == size || !is_config_digit(text[i])) {
+            out.error = "expected a digit";
+            return out;
+        }
+        int e = 0;
+        for (; i < size && is_config_digit(text[i]); ++i) {
+            if (e < 100000) e = e * 10 + (text[i] - '0');
+        }
+        d.exponent += negative_exponent ? -e : e;
+    }
+    if (!fits) {
+        out.error = "number has too many digits";
+        return out;
+    }
+    out.end = i;
+
+    const std::uint64_t magnitude = d.digits.bits64(0);
+    const std::uint64_t limit = negative ? std::uint64_t{1} << 63 : (std::uint64_t{1} << 63) - 1;
+    if (integral && d.count <= 19 && magnitude <= limit) {
+        // -2^63 is one past the largest positive int64_t
+        if (magnitude != 0) out.integer = negative ? -static_cast<std::int64_t>(magnitude - 1) - 1
+                                                   : static_cast<std::int64_t>(magnitude);
+        return out;
+    }
+    out.kind = config_kind::number;
+    out.number = negative ? -decimal_to_double(d) : decimal_to_double(d);
+    return out;
+}
+
+// ---------- keys ----------
+
+// a key to look up, optionally joined from head + '.' + tail, which is how array elements are found
+struct config_key {
+    string_ref head;
+    const char* tail;
+    std::size_t tail_size;
+
+    constexpr std::size_t size() const noexcept { return tail ? head.size() + 1 + tail_size : head.size(); }
+
+    constexpr char operator[](std::size_t i) const noexcept {
+        if (i < head.size()) return head[i];
+        return i == head.size() ? '.' : tail[i - head.size() - 1];
+    }
+
+    // <0, 0 or >0 like compare_chars; a plain key is compared with memcmp at runtime
+    constexpr int compare(const char* data, std::size_t size) const noexcept {
+        if (!tail && !CX_IS_CONSTANT_EVALUATED()) {
+            const std::size_t n = size < head.size() ? size : head.size();
+            const int c = n == 0 ? 0 : std::memcmp(data, head.data(), n);
+            if (c != 0) return c < 0 ? -1 : 1;
+            return size == head.size() ? 0 : (size < head.size() ? -1 : 1);
+        }
+        const std::size_t n = size < this->size() ? size : this->size();
+        for (std::size_t i = 0; i < n; ++i) {
+            const auto x = static_cast<unsigned char>(data[i]);
+            const auto y = static_cast<unsigned char>((*this)[i]);
+            if (x != y) return x < y ? -1 : 1;
+        }
+        return size == this->size() ? 0 : (size < this->size() ? -1 : 1);
+    }
+};
+
+struct config_entry_less {
+    const char* blob;
+    const config_entry* entries;
+
+    constexpr bool operator()(std::size_t a, std::size_t b) const {
+        return compare_chars(blob + entries[a].key, entries[a].key_size,
+                             blob + entries[b].key, entries[b].key_size) < 0;
+    }
+};
+
+struct json_syntax {};
+struct ini_syntax {};
+
+}
+
+template<std::size_t Count, std::size_t Size>
+class config_table;
+
+// Parsed configuration text: the first step of building a cx::config_table. The number of entries and the bytes their
+// keys and values take are only known after parsing, so like string_pool the builder measures them and
+// compact<entry_count(), blob_size()>() builds the table at its exact size. Only the table ends up in the binary.
+template<std::size_t MaxEntries, std::size_t BlobCapacity>
+class config_builder {
+public:
+    using size_type = std::size_t;
+
+    constexpr config_builder(const char* text, size_type size, detail::json_syntax) {
+        detail::config_cursor in{text, size, 0};
+        skip_space(in);
+        expect(in.peek() == '{' || in.peek() == '[', "expected '{' or '['", in.pos);
+        parse_json_value(in, detail::kConfigNpos, 0);
+        skip_space(in);
+        expect(in.done(), "unexpected characters after the value", in.pos);
+        finish();
+    }
+
+    constexpr config_builder(const char* text, size_type size, detail::ini_syntax) {
+        parse_ini(text, size);
+        finish();
+    }
+
+    template<std::size_t Count, std::size_t Size>
+    constexpr config_table<Count, Size> compact() const {
+        return config_table<Count, Size>(*this);
+    }
+
+    // capacity
+    constexpr size_type entry_count() const noexcept { return count_; }
+    constexpr size_type blob_size() const noexcept { return blob_size_; }
+
+private:
+    template<std::size_t, std::size_t>
+    friend class config_table;
+
+    char blob_[BlobCapacity + 1]{};
+    detail::config_entry entries_[MaxEntries + 1]{};
+    // entries in key order
+    size_type order_[MaxEntries + 1]{};
+    size_type count_{};
+    size_type blob_size_{};
+    // the key of the value being parsed
+    char path_[BlobCapacity + 1]{};
+    size_type path_size_{};
+
+    static constexpr void expect(bool ok, const char* what, size_type offset) {
+        if (ok) return;
+#if CX_HAS_IS_CONSTANT_EVALUATED
+        // during constant evaluation, reading past this array is the compile error, and compilers print the index
+        if (CX_IS_CONSTANT_EVALUATED()) {
+            const char error_at_offset[1]{};
+            const char c = error_at_offset[offset];
+            static_cast<void>(c);
+        }
+#endif
+        throw config_error(what, offset);
+    }
+
+    // ---------- building ----------
+
+    constexpr void put(char* out, size_type& size, char c) const {
+        if (size == BlobCapacity) throw std::length_error("cx::config: out of room for keys, raise BlobCapacity");
+        out[size++] = c;
+    }
+
+    // a new entry keyed by the current path
+    constexpr size_type add_entry(size_type source) {
+        if (count_ == MaxEntries) throw std::length_error("cx::config: too many entries, raise MaxEntries");
+        detail::config_entry& e = entries_[count_];
+        e.source = source;
+        e.key = blob_size_;
+        e.key_size = path_size_;
+        for (size_type i = 0; i < path_size_; ++i) put(blob_, blob_size_, path_[i]);
+        e.value = blob_size_;
+        return count_++;
+    }
+
+    constexpr void set_scalar(size_type entry, config_kind kind, const char* text, size_type begin, size_type end) {
+        detail::config_entry& e = entries_[entry];
+        e.kind = kind;
+        e.value = blob_size_;
+        e.value_size = end - begin;
+        for (size_type i = begin; i < end; ++i) put(blob_, blob_size_, text[i]);
+    }
+
+    constexpr void set_container(size_type entry, config_kind kind, size_type size) {
+        if (entry == detail::kConfigNpos) return;
+        entries_[entry].kind = kind;
+        entries_[entry].integer = static_cast<std::int64_t>(size);
+    }
+
+    constexpr void push_segment(const char* text, size_type begin, size_type end) {
+        if (path_size_ != 0) put(path_, path_size_, '.');
+        for (size_type i = begin; i < end; ++i) put(path_, path_size_, text[i]);
+    }
+
+    constexpr void push_index(size_type index) {
+        char digits[20]{};
+        const size_type n = detail::decimal_length(index);
+        detail::write_decimal(digits + n, index);
+        push_segment(digits, 0, n);
+    }
+
+    // sorts the entries by key and rejects duplicates
+    constexpr void finish() {
+        size_type scratch[MaxEntries + 1]{};
+        detail::merge_sort_indices(order_, scratch, count_, detail::config_entry_less{blob_, entries_});
+        for (size_type i = 1; i < count_; ++i) {
+            const detail::config_entry& a = entries_[order_[i - 1]];
+            const detail::config_entry& b = entries_[order_[i]];
+            if (detail::equal_chars(blob_ + a.key, a.key_size, blob_ + b.key, b.key_size)) {
+                expect(false, "duplicate key", a.source > b.source ? a.source : b.source);
+            }
+        }
+    }
+
+    // ---------- JSON ----------
+
+    static constexpr void skip_space(detail::config_cursor& in) noexcept {
+        while (!in.done() && (detail::is_config_blank(in.peek()) || in.peek() == '\n')) ++in.pos;
+    }
+
+    constexpr void expect_literal(detail::config_cursor& in, size_type entry, config_kind kind, const char* word,
+                                  size_type size) {
+        if (in.size - in.pos < size || !detail::equal_chars(in.text + in.pos, size, word, size)) {
+            expect(false, "expected a value", in.pos);
+        }
+        set_scalar(entry, kind, in.text, in.pos, in.pos + size);
+        if (kind == config_kind::boolean) entries_[entry].integer = size == 4;
+        in.pos += size;
+    }
+
+    constexpr void parse_json_value(detail::config_cursor& in, size_type entry, size_type depth) {
+        switch (in.peek()) {
+            case '{': return parse_json_object(in, entry, depth);
+            case '[': return parse_json_array(in, entry, depth);
+            case '"': {
+                entries_[entry].kind = config_kind::string;
+                entries_[entry].value = blob_size_;
+                parse_json_string(in, blob_, blob_size_);
+                entries_[entry].value_size = blob_size_ - entries_[entry].value;
+                return;
+            }
+            case 't': return expect_literal(in, entry, config_kind::boolean, "true", 4);
+            case 'f': return expect_literal(in, entry, config_kind::boolean, "false", 5);
+            case 'n': return expect_literal(in, entry, config_kind::null, "null", 4);
+            default: {
+                const detail::config_number n = detail::parse_config_number(in.text, in.size, in.pos);
+                expect(n.error == nullptr, n.error, in.pos);
+                set_scalar(entry, n.kind, in.text, in.pos, n.end);
+                entries_[entry].integer = n.integer;
+                entries_[entry].number = n.number;
+                in.pos = n.end;
+                return;
+            }
+        }
+    }
+
+    constexpr void parse_json_object(detail::config_cursor& in, size_type entry, size_type depth) {
+        expect(depth != detail::kMaxConfigDepth, "nested too deeply", in.pos);
+        ++in.pos;
+        skip_space(in);
+        size_type members = 0;
+        if (in.peek() == '}') {
+            ++in.pos;
+        } else {
+            for (;;) {
+                skip_space(in);
+                expect(in.peek() == '"', "expected a key", in.pos);
+                const size_type source = in.pos;
+                const size_type parent = path_size_;
+                if (path_size_ != 0) put(path_, path_size_, '.');
+                parse_json_string(in, path_, path_size_);
+                skip_space(in);
+                expect(in.peek() == ':', "expected ':'", in.pos);
+                ++in.pos;
+                skip_space(in);
+                parse_json_value(in, add_entry(source), depth + 1);
+                path_size_ = parent;
+                ++members;
+                skip_space(in);
+                if (in.peek() == ',') {
+                    ++in.pos;
+                } else if (in.peek() == '}') {
+                    ++in.pos;
+                    break;
+                } else {
+                    expect(false, "expected ',' or '}'", in.pos);
+                }
+            }
+        }
+        set_container(entry, config_kind::object, members);
+    }
+
+    constexpr void parse_json_array(detail::config_cursor& in, size_type entry, size_type depth) {
+        expect(depth != detail::kMaxConfigDepth, "nested too deeply", in.pos);
+        ++in.pos;
+        skip_space(in);
+        size_type elements = 0;
+        if (in.peek() == ']') {
+            ++in.pos;
+        } else {
+            for (;;) {
+                skip_space(in);
+                const size_type parent = path_size_;
+                push_index(elements);
+                parse_json_value(in, add_entry(in.pos), depth + 1);
+                path_size_ = parent;
+                ++elements;
+                skip_space(in);
+                if (in.peek() == ',') {
+                    ++in.pos;
+                } else if (in.peek() == ']') {
+                    ++in.pos;
+                    break;
+                } else {
+                    expect(false, "expected ',' or ']'", in.pos);
+                }
+            }
+        }
+        set_container(entry, config_kind::array, elements);
+    }
+
+    static constexpr int hex_digit(char c) noexcept {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        return c >= 'A' && c <= 'F' ? c - 'A' + 10 : -1;
+    }
+
+    constexpr std::uint32_t parse_hex4(detail::config_cursor& in) const {
+        std::uint32_t v = 0;
+        for (int i = 0; i < 4; ++i, ++in.pos) {
+            const int digit = in.pos < in.size ? hex_digit(in.text[in.pos]) : -1;
+            expect(digit >= 0, "expected four hex digits", in.pos);
+            v = v * 16 + static_cast<std::uint32_t>(digit);
+        }
+        return v;
+    }
+
+    constexpr void put_utf8(char* out, size_type& size, std::uint32_t cp) const {
+        if (cp < 0x80) return put(out, size, static_cast<char>(cp));
+        if (cp < 0x800) {
+            put(out, size, static_cast<char>(0xc0 | (cp >> 6)));
+        } else if (cp < 0x10000) {
+            put(out, size, static_cast<char>(0xe0 | (cp >> 12)));
+            put(out, size, static_cast<char>(0x80 | ((cp >> 6) & 0x3f)));
+        } else {
+            put(out, size, static_cast<char>(0xf0 | (cp >> 18)));
+            put(out, size, static_cast<char>(0x80 | ((cp >> 12) & 0x3f)));
+            put(out, size, static_cast<char>(0x80 | ((cp >> 6) & 0x3f)));
+        }
+        put(out, size, static_cast<char>(0x80 | (cp & 0x3f)));
+    }
+
+    // the string at in.pos, unescaped into out; \uXXXX escapes become UTF-8
+    constexpr void parse_json_string(detail::config_cursor& in, char* out, size_type& size) const {
+        ++in.pos;
+        for (;;) {
+            expect(!in.done(), "unterminated string", in.pos);
+            const char c = in.text[in.pos];
+            if (c == '"') break;
+            expect(static_cast<unsigned char>(c) >= 0x20, "control character in a string", in.pos);
+            if (c != '\\') {
+                put(out, size, c);
+                ++in.pos;
+                continue;
+            }
+            const size_type escape = in.pos++;
+            switch (in.peek()) {
+                case '"': put(out, size, '"'); break;
+                case '\\': put(out, size, '\\'); break;
+                case '/': put(out, size, '/'); break;
+                case 'b': put(out, size, '\b'); break;
+                case 'f': put(out, size, '\f'); break;
+                case 'n': put(out, size, '\n'); break;
+                case 'r': put(out, size, '\r'); break;
+                case 't': put(out, size, '\t'); break;
+                case 'u': {
+                    ++in.pos;
+                    std::uint32_t cp = parse_hex4(in);
+                    expect(cp < 0xdc00 || cp >= 0xe000, "unpaired surrogate", escape);
+                    if (cp >= 0xd800 && cp < 0xdc00) {
+                        if (in.size - in.pos < 2 || in.text[in.pos] != '\\' || in.text[in.pos + 1] != 'u') {
+                            expect(false, "unpaired surrogate", escape);
+                        }
+                        in.pos += 2;
+                        const std::uint32_t low = parse_hex4(in);
+                        expect(low >= 0xdc00 && low < 0xe000, "unpaired surrogate", escape);
+                        cp = 0x10000 + ((cp - 0xd800) << 10) + (low - 0xdc00);
+                    }
+                    put_utf8(out, size, cp);
+                    continue;
+                }
+                default: expect(false, "invalid escape", escape);
+            }
+            ++in.pos;
+        }
+        ++in.pos;
+    }
+
+    // ---------- INI ----------
+
+    constexpr void parse_ini(const char* text, size_type size) {
+        size_type section = detail::kConfigNpos;
+        size_type section_size = 0;
+        size_type members = 0;
+        for (size_type line = 0; line < size;) {
+            size_type next = line;
+            while (next < size && text[next] != '\n') ++next;
+            size_type begin = line;
+            size_type end = next;
+            while (begin < end && detail::is_config_blank(text[begin])) ++begin;
+            while (end > begin && detail::is_config_blank(text[end - 1])) --end;
+            line = next + 1;
+            if (begin == end || text[begin] == ';' || text[begin] == '#') continue;
+
+            if (text[begin] == '[') {
+                expect(text[end - 1] == ']', "expected ']'", end);
+                size_type name = begin + 1;
+                size_type name_end = end - 1;
+                while (name < name_end && detail::is_config_blank(text[name])) ++name;
+                while (name_end > name && detail::is_config_blank(text[name_end - 1])) --name_end;
+                expect(name != name_end, "expected a section name", begin + 1);
+                set_container(section, config_kind::object, members);
+                path_size_ = 0;
+                push_segment(text, name, name_end);
+                section_size = path_size_;
+                section = add_entry(begin);
+                members = 0;
+                continue;
+            }
+
+            size_type equals = begin;
+            while (equals < end && text[equals] != '=') ++equals;
+            expect(equals != end, "expected '='", end);
+            size_type key_end = equals;
+            while (key_end > begin && detail::is_config_blank(text[key_end - 1])) --key_end;
+            expect(key_end != begin, "expected a key", begin);
+            size_type value = equals + 1;
+            while (value < end && detail::is_config_blank(text[value])) ++value;
+
+            path_size_ = section_size;
+            push_segment(text, begin, key_end);
+            parse_ini_value(text, value, end, add_entry(begin));
+            ++members;
+        }
+        set_container(section, config_kind::object, members);
+    }
+
+    constexpr void parse_ini_value(const char* text, size_type begin, size_type end, size_type entry) {
+        if (begin < end && text[begin] == '"') {
+            detail::config_cursor in{text, end, begin};
+            entries_[entry].kind = config_kind::string;
+            entries_[entry].value = blob_size_;
+            parse_json_string(in, blob_, blob_size_);
+            entries_[entry].value_size = blob_size_ - entries_[entry].value;
+            expect(in.done(), "unexpected characters after the string", in.pos);
+            return;
+        }
+        if (detail::config_text_equals(text, begin, end, "true", 4)
+            || detail::config_text_equals(text, begin, end, "false", 5)) {
+            set_scalar(entry, config_kind::boolean, text, begin, end);
+            entries_[entry].integer = end - begin == 4;
+            return;
+        }
+        const detail::config_number n = detail::parse_config_number(text, end, begin);
+        if (!n.error && n.end == end) {
+            set_scalar(entry, n.kind, text, begin, end);
+            entries_[entry].integer = n.integer;
+            entries_[entry].number = n.number;
+            return;
+        }
+        set_scalar(entry, config_kind::string, text, begin, end);
+    }
+};
+
+// Configuration parsed during constant evaluation from a JSON subset or INI text, so that reading it at startup is
+// gone and a lookup is a binary search over a table in the binary. Nested keys are flattened with '.' and array
+// elements are numbered, so {"server": {"ports": [80, 443]}} has the entries server, server.ports, server.ports.0 and
+// server.ports.1; arrays and objects count their elements. Keys and values sit back to back in one blob.
+//
+// The JSON is RFC 8259 except that the top level has to be an object or an array and keys must be unique. Numbers that
+// fit int64_t are integers, and other numbers are correctly rounded doubles of at most 76 significant digits. INI text
+// has [section] lines, key = value lines whose keys become section.key, and ; or # comment lines. A value in double
+// quotes is a string with JSON escapes; otherwise true, false and JSON numbers are typed like in JSON and anything else
+// is the rest of the line as a string, trimmed. Malformed text throws cx::config_error with the offending offset,
+// which is a compile error that names the offset when the table is constexpr.
+//
+//     static constexpr char kDefaults[] = R"({"server": {"host": "0.0.0.0", "ports": [80, 443]}, "debug": false})";
+//     constexpr auto kConfigBuilder = cx::parse_json(kDefaults);
+//     constexpr auto kConfig = kConfigBuilder.compact<kConfigBuilder.entry_count(), kConfigBuilder.blob_size()>();
+//     static_assert(kConfig["server.ports.1"].as_integer() == 443, "");
+//     constexpr auto kHost = kConfig.string_at<kConfig["server.host"].text().size()>("server.host");   // cx::string
+//     constexpr auto kPorts = kConfig.array_at<int, 2>("server.ports");                                   // cx::array
+//     static constexpr auto kMap = kConfig.to_map();                                                      // cx::map
+template<std::size_t Count, std::size_t Size>
+class config_table {
+public:
+    // a bunch of typedefs
+    using key_type = string_ref;
+    using mapped_type = config_value;
+    using size_type = std::size_t;
+
+    static constexpr size_type npos = static_cast<size_type>(-1);
+
+    // constructors and assignment
+    template<std::size_t MaxEntries, std::size_t BlobCapacity>
+    constexpr explicit config_table(const config_builder<MaxEntries, BlobCapacity>& builder) {
+        if (builder.entry_count() != Count || builder.blob_size() != Size) {
+            throw std::length_error("cx::config_table: wrong number of entries or blob size");
+        }
+        for (size_type i = 0; i < Size; ++i) blob_[i] = builder.blob_[i];
+        for (size_type i = 0; i < Count; ++i) entries_[i] = builder.entries_[builder.order_[i]];
+    }
+
+    constexpr config_table(const config_table&) = default;
+    constexpr config_table(config_table&&) noexcept = default;
+
+    constexpr config_table& operator=(const config_table&) = default;
+    constexpr config_table& operator=(config_table&&) noexcept = default;
+
+    // element access: the i-th entry in key order
+    constexpr string_ref key(size_type i) const noexcept {
+        return string_ref(blob_ + entries_[i].key, entries_[i].key_size);
+    }
+
+    constexpr config_value value(size_type i) const noexcept {
+        const detail::config_entry& e = entries_[i];
+        return config_value(e.kind, string_ref(blob_ + e.value, e.value_size), e.integer, e.number);
+    }
+
+    constexpr config_value at(string_ref key) const {
+        const size_type i = find(key);
+        if (i == npos) throw std::out_of_range("cx::config_table::at: could not find key");
+        return value(i);
+    }
+
+    template<typename StringLike,
+             typename = decltype(std::declval<const StringLike&>().data(), std::declval<const StringLike&>().size())>
+    constexpr config_value at(const StringLike& key) const {
+        return at(string_ref(key.data(), key.size()));
+    }
+
+    constexpr config_value operator[](string_ref key) const { return at(key); }
+
+    // a string value, or any scalar's text, as a cx::string of exactly N characters
+    template<std::size_t N>
+    constexpr string<N> string_at(string_ref key) const {
+        const config_value v = at(key);
+        if (v.text().size() != N) throw std::length_error("cx::config_table::string_at: wrong size");
+        return string<N>(v.text().data(), detail::copy_tag{});
+    }
+
+    // the N elements of an array, each converted with config_value::as<T>()
+    template<typename T, std::size_t N>
+    constexpr array<T, N> array_at(string_ref key) const {
+        const config_value v = at(key);
+        if (v.kind() != config_kind::array) throw std::invalid_argument("cx::config_table::array_at: not an array");
+        if (v.size() != N) throw std::length_error("cx::config_table::array_at: wrong size");
+        array<T, N> out{};
+        for (size_type i = 0; i < N; ++i) {
+            char digits[20]{};
+            const size_type n = detail::decimal_length(i);
+            detail::write_decimal(digits + n, i);
+            out[i] = value(lower_bound(detail::config_key{key, digits, n})).template as<T>();
+        }
+        return out;
+    }
+
+    // capacity
+    constexpr bool empty() const noexcept { return Count == 0; }
+    constexpr size_type size() const noexcept { return Count; }
+    constexpr size_type max_size() const noexcept { return Count; }
+    constexpr size_type blob_size() const noexcept { return Size; }
+
+    // lookup: the entry's index in key order, or npos
+    constexpr size_type find(string_ref key) const noexcept {
+        const detail::config_key k{key, nullptr, 0};
+        const size_type i = lower_bound(k);
+        return i < Count && k.compare(blob_ + entries_[i].key, entries_[i].key_size) == 0 ? i : npos;
+    }
+
+    template<typename StringLike,
+             typename = decltype(std::declval<const StringLike&>().data(), std::declval<const StringLike&>().size())>
+    constexpr size_type find(const StringLike& key) const noexcept {
+        return find(string_ref(key.data(), key.size()));
+    }
+
+    template<typename Key>
+    constexpr bool contains(const Key& key) const noexcept { return find(key) != npos; }
+    template<typename Key>
+    constexpr size_type count(const Key& key) const noexcept { return contains(key) ? 1 : 0; }
+
+    // conversions: every entry in key order, as views into this table's blob, so keep the table alive (in a static
+    // constexpr variable to use the map during constant evaluation)
+    constexpr map<string_ref, config_value, Count> to_map() const noexcept {
+        array<pair<string_ref, config_value>, Count> entries{};
+        for (size_type i = 0; i < Count; ++i) entries[i] = pair<string_ref, config_value>(key(i), value(i));
+        return map<string_ref, config_value, Count>(entries);
+    }
+
+private:
+    char blob_[Size + 1]{};
+    detail::config_entry entries_[Count + 1]{};
+
+    // the first entry whose key isn't less than k
+    constexpr size_type lower_bound(const detail::config_key& k) const noexcept {
+        size_type lo = 0;
+        size_type hi = Count;
+        while (lo < hi) {
+            const size_type mid = lo + (hi - lo) / 2;
+            if (k.compare(blob_ + entries_[mid].key, entries_[mid].key_size) < 0) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+        return lo;
+    }
+};
+
+// definition of the static constexpr member (needed before C++17)
+template<std::size_t Count, std::size_t Size>
+constexpr typename config_table<Count, Size>::size_type config_table<Count, Size>::npos;
+
+// Parse a string literal or cx::string; see config_table for the format and config_builder for how to compact it.
+// MaxEntries defaults to one entry per two characters, which is as many as the text can have, and BlobCapacity to
+// four bytes per character, which only deeply nested keys repeated many times can run out of.
+template<std::size_t MaxEntries = 0, std::size_t BlobCapacity = 0, std::size_t M>
+constexpr auto parse_json(const string<M>& text) {
+    return config_builder<MaxEntries ? MaxEntries : M / 2 + 1, BlobCapacity ? BlobCapacity : 4 * M + 16>(
+            text.c_str(), M, detail::json_syntax{});
+}
+
+template<std::size_t MaxEntries = 0, std::size_t BlobCapacity = 0, std::size_t M>
+constexpr auto parse_json(const char (&text)[M]) {
+    return config_builder<MaxEntries ? MaxEntries : M / 2 + 1, BlobCapacity ? BlobCapacity : 4 * M + 16>(
+            text, M - 1, detail::json_syntax{});
+}
+
+template<std::size_t MaxEntries = 0, std::size_t BlobCapacity = 0, std::size_t M>
+constexpr auto parse_ini(const string<M>& text) {
+    return config_builder<MaxEntries ? MaxEntries : M / 2 + 1, BlobCapacity ? BlobCapacity : 4 * M + 16>(
+            text.c_str(), M, detail::ini_syntax{});
+}
+
+template<std::size_t MaxEntries = 0, std::size_t BlobCapacity = 0, std::size_t M>
+constexpr auto parse_ini(const char (&text)[M]) {
+    return config_builder<MaxEntries ? MaxEntries : M / 2 + 1, BlobCapacity ? BlobCapacity : 4 * M + 16>(
+            text, M - 1, detail::ini_syntax{});
+}
+
+}
@@ -0,0 +1,362 @@
+// Copyright (c) 2020. Mohit Deshpande.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+// the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+#include "cx/cx_algorithm.h"
+#include "cx/cx_hash.h"
+#include "cx/cx_perfect_map.h"
+#include "cx/cx_string.h"
+#include "cx/cx_string_map.h"
+
+#include <stdexcept>
+
+namespace cx {
+
+namespace detail {
+
+// A signature packs a key's length (8 bits) and its bytes at up to 7 chosen positions (8 bits each) into one word
+constexpr std::size_t kDispatchMaxPositions = 7;
+constexpr std::size_t kDispatchMaxLength = 255;
+
+// Tables of up to this many keys get a direct slot table of up to 16 slots per key (rounded up to a power of two);
+// bigger ones fall back to a minimal perfect hash
+constexpr std::size_t kDispatchMaxDirect = 256;
+
+constexpr std::size_t ceil_pow2(std::size_t n) noexcept {
+    std::size_t p = 1;
+    while (p < n) p *= 2;
+    return p;
+}
+
+constexpr std::size_t dispatch_slots(std::size_t n) noexcept {
+    return n <= kDispatchMaxDirect ? 16 * ceil_pow2(n) : 1;
+}
+
+// how a dispatch turns a key into an entry index; computed from the table during constant evaluation
+template<std::size_t N>
+struct dispatch_plan {
+    std::size_t max_length;
+    // keys too long or too alike for a signature are hashed whole instead
+    bool hash_whole_key;
+    std::size_t position_count;
+    std::size_t positions[kDispatchMaxPositions];
+
+    // direct: slots[(hash * multiplier) >> shift] is the entry with that hash, or N for an empty slot
+    bool direct;
+    std::uint64_t multiplier;
+    unsigned shift;
+    std::uint16_t slots[dispatch_slots(N)];
+
+    // otherwise a minimal perfect hash: entry_of_slot[pmh_slot(...)] is the entry with that hash
+    std::uint32_t pilots[N ? N : 1];
+    std::size_t entry_of_slot[N ? N : 1];
+};
+
+constexpr std::uint8_t byte_at(const char* key, std::size_t size, std::size_t position) noexcept {
+    return position < size ? static_cast<std::uint8_t>(key[position]) : 0;
+}
+
+struct word_less {
+    const std::uint64_t* words;
+    constexpr bool operator()(std::size_t a, std::size_t b) const { return words[a] < words[b]; }
+};
+
+template<std::size_t N>
+constexpr std::size_t count_distinct(const std::uint64_t* words) {
+    std::size_t order[N ? N : 1]{};
+    std::size_t scratch[N ? N : 1]{};
+    merge_sort_indices(order, scratch, N, word_less{words});
+    std::size_t distinct = N ? 1 : 0;
+    for (std::size_t i = 1; i < N; ++i) distinct += words[order[i]] != words[order[i - 1]];
+    return distinct;
+}
+
+// Looks for an odd multiplier that sends the N distinct hashes to distinct slots of the smallest power-of-two table
+// it can. A random function is injective with probability about exp(-N^2 / 2m) for m slots, so a few dozen tries per
+// table size are plenty up to kDispatchMaxDirect keys.
+template<std::size_t N>
+constexpr bool find_direct_slots(const std::uint64_t* hashes, dispatch_plan<N>& plan) {
+    constexpr std::size_t kSlots = dispatch_slots(N);
+    std::size_t stamp[kSlots]{};
+    std::size_t round = 0;
+    unsigned bits = 0;
+    while ((std::size_t{1} << bits) < kSlots / 16) ++bits;
+    std::uint64_t seed = 0x9e3779b97f4a7c15ULL;
+    for (; (std::size_t{1} << bits) <= kSlots; ++bits) {
+        for (std::size_t attempt = 0; attempt < 64; ++attempt) {
+            seed = mix64(seed + attempt);
+            const std::uint64_t multiplier = seed | 1;
+            const unsigned shift = 64 - bits;
+            ++round;
+            bool injective = true;
+            for (std::size_t i = 0; i < N && injective; ++i) {
+                const std::size_t slot = bits ? static_cast<std::size_t>((hashes[i] * multiplier) >> shift) : 0;
+                injective = stamp[slot] != round;
+                stamp[slot] = round;
+            }
+            if (!injective) continue;
+
+            plan.multiplier = multiplier;
+            plan.shift = shift;
+            for (std::size_t slot = 0; slot < kSlots; ++slot) plan.slots[slot] = static_cast<std::uint16_t>(N);
+            for (std::size_t i = 0; i < N; ++i) {
+                const std::size_t slot = bits ? static_cast<std::size_t>((hashes[i] * multiplier) >> shift) : 0;
+                plan.slots[slot] = static_cast<std::uint16_t>(i);
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+// Greedily picks byte positions until (length, bytes at the positions) tells every key apart: each round adds the
+// position that separates the most keys. Usually one or two positions are enough for a command set.
+template<std::size_t N>
+constexpr dispatch_plan<N> make_dispatch_plan(const char* const* keys, const std::size_t* sizes) {
+    dispatch_plan<N> plan{};
+    for (std::size_t i = 0; i < N; ++i) plan.max_length = sizes[i] > plan.max_length ? sizes[i] : plan.max_length;
+
+    std::uint64_t signatures[N ? N : 1]{};
+    std::uint64_t candidate[N ? N : 1]{};
+    for (std::size_t i = 0; i < N; ++i) signatures[i] = sizes[i];
+    std::size_t distinct = count_distinct<N>(signatures);
+    plan.hash_whole_key = plan.max_length > kDispatchMaxLength;
+    while (!plan.hash_whole_key && distinct < N) {
+        if (plan.position_count == kDispatchMaxPositions) {
+            plan.hash_whole_key = true;
+            break;
+        }
+        const std::size_t shift = 8 * (plan.position_count + 1);
+        std::size_t best_position = 0;
+        std::size_t best_distinct = distinct;
+        for (std::size_t p = 0; p < plan.max_length; ++p) {
+            for (std::size_t i = 0; i < N; ++i) {
+                candidate[i] = signatures[i] | std::uint64_t{byte_at(keys[i], sizes[i], p)} << shift;
+            }
+            const std::size_t d = count_distinct<N>(candidate);
+            if (d > best_distinct) {
+                best_position = p;
+                best_distinct = d;
+            }
+        }
+        // no position separates the remaining keys: they are duplicates, which is reported below
+        if (best_distinct == distinct) break;
+        for (std::size_t i = 0; i < N; ++i) {
+            signatures[i] |= std::uint64_t{byte_at(keys[i], sizes[i], best_position)} << shift;
+        }
+        plan.positions[plan.position_count++] = best_position;
+        distinct = best_distinct;
+    }
+
+    std::uint64_t hashes[N ? N : 1]{};
+    for (std::size_t i = 0; i < N; ++i) hashes[i] = plan.hash_whole_key ? wyhash(keys[i], sizes[i]) : signatures[i];
+    if (count_distinct<N>(hashes) != N) throw std::invalid_argument("cx::dispatch: duplicate keys");
+
+    plan.direct = N <= kDispatchMaxDirect && find_direct_slots<N>(hashes, plan);
+    if (plan.direct) return plan;
+
+    for (std::size_t i = 0; i < N; ++i) hashes[i] = mix64(hashes[i]);
+    std::size_t bucket_start[N + 1]{};
+    std::size_t bucket_items[N ? N : 1]{};
+    bool taken[N ? N : 1]{};
+    const auto status = pmh_build(hashes, N, plan.pilots, plan.entry_of_slot, bucket_start, bucket_items, taken);
+    if (status != pmh_status::ok) {
+        throw std::invalid_argument("cx::dispatch: could not find a perfect hash for the keys");
+    }
+    return plan;
+}
+
+// fallback of visit(): no handler for the key
+template<typename Result>
+struct dispatch_missing_key {
+    template<typename... Args>
+    Result operator()(Args&&...) const {
+        throw std::out_of_range("cx::dispatch::visit: no handler for key");
+    }
+};
+
+}
+
+// Routes string keys to the handlers of a constexpr table, at the cost of a hand-written switch. Table is a type
+// whose static constexpr table() returns the routing table: a cx::string_map, or a cx::map keyed by const char* or
+// cx::string, whose values are function pointers (or any literal callable type).
+//
+// At compile time, the dispatch picks the byte positions that tell the keys apart and a multiplier that maps
+// (length, bytes at those positions) to distinct slots of a small table, much like a compiler lays out a switch.
+// visit() reads only those bytes, looks up the slot and jumps through a table of per-entry thunks. Each thunk checks
+// the key against its entry's fixed-length string and calls the handler directly, so the compiler can inline it; an
+// empty slot jumps to the fallback. Tables of more than 256 keys use a minimal perfect hash for the slot instead.
+//
+//     struct Routes {
+//         static constexpr auto table() {
+//             return cx::string_map<void (*)(request&), 3>{{"get", &get}, {"put", &put}, {"delete", &erase}};
+//         }
+//     };
+//     cx::dispatch<Routes>::visit(command, req);
+template<typename Table>
+class dispatch {
+public:
+    // a bunch of typedefs
+    using table_type = std::decay_t<decltype(Table::table())>;
+    using handler_type = typename table_type::mapped_type;
+    using size_type = std::size_t;
+
+    template<typename... Args>
+    using result_type = decltype(std::declval<const handler_type&>()(std::declval<Args>()...));
+
+    // capacity
+    static constexpr size_type size() noexcept { return kSize; }
+
+    // lookup: the entry index of key (its position in Table::table()), or size() if there is none
+    static constexpr size_type index_of(const char* data, size_type size) noexcept {
+        const size_type i = candidate(data, size);
+        return i != kSize && kKeys.sizes[i] == size && detail::equal_bytes(kKeys.chars[i], data, size) ? i : kSize;
+    }
+
+    // std::string_view, std::string and anything else with data() and size()
+    template<typename StringLike,
+             typename = decltype(std::declval<const StringLike&>().data(), std::declval<const StringLike&>().size())>
+    static constexpr size_type index_of(const StringLike& key) noexcept {
+        return index_of(key.data(), key.size());
+    }
+
+    template<std::size_t M>
+    static constexpr size_type index_of(const string<M>& key) noexcept {
+        return index_of(key.c_str(), M);
+    }
+
+    template<std::size_t M>
+    static constexpr size_type index_of(const char (&key)[M]) noexcept {
+        return index_of(key, M - 1);
+    }
+
+    template<typename K>
+    static constexpr bool contains(const K& key) noexcept {
+        return index_of(key) != kSize;
+    }
+
+    // calls the handler for key with args; throws std::out_of_range if key has none
+    template<typename K, typename... Args>
+    static result_type<Args...> visit(const K& key, Args&&... args) {
+        return visit_or(key, detail::dispatch_missing_key<result_type<Args...>>{}, std::forward<Args>(args)...);
+    }
+
+    // calls the handler for key with args, or fallback with args if key has none
+    template<typename K, typename Fallback, typename... Args>
+    static result_type<Args...> visit_or(const K& key, Fallback&& fallback, Args&&... args) {
+        const auto view = as_view(key);
+        return jump(std::make_index_sequence<kSize>(), view.data, view.size, fallback, std::forward<Args>(args)...);
+    }
+
+private:
+    static constexpr table_type kTable = Table::table();
+    static constexpr size_type kSize = kTable.size();
+
+    // the keys of kTable in entry order, with their lengths
+    struct key_list {
+        const char* chars[kSize ? kSize : 1];
+        std::size_t sizes[kSize ? kSize : 1];
+    };
+
+    static constexpr key_list make_key_list() {
+        key_list result{};
+        for (std::size_t i = 0; i < kSize; ++i) {
+            result.chars[i] = detail::c_str_of((kTable.begin() + i)->first);
+            result.sizes[i] = detail::cstr_length(result.chars[i]);
+        }
+        return result;
+    }
+
+    static constexpr key_list kKeys = make_key_list();
+    static constexpr detail::dispatch_plan<kSize> kPlan = detail::make_dispatch_plan<kSize>(kKeys.chars, kKeys.sizes);
+
+    struct key_view {
+        const char* data;
+        size_type size;
+    };
+
+    template<typename StringLike,
+             typename = decltype(std::declval<const StringLike&>().data(), std::declval<const StringLike&>().size())>
+    static key_view as_view(const StringLike& key) noexcept { return {key.data(), key.size()}; }
+
+    template<std::size_t M>
+    static key_view as_view(const string<M>& key) noexcept { return {key.c_str(), M}; }
+
+    template<std::size_t M>
+    static key_view as_view(const char (&key)[M]) noexcept { return {key, M - 1}; }
+
+    // the only entry key can be, or kSize; the caller still has to compare the key
+    static constexpr size_type candidate(const char* data, size_type size) noexcept {
+        if (kSize == 0 || size > kPlan.max_length) return kSize;
+        std::uint64_t h = 0;
+        if (kPlan.hash_whole_key) {
+            h = wyhash(data, size);
+        } else {
+            h = size;
+            for (std::size_t k = 0; k < kPlan.position_count; ++k) {
+                h |= std::uint64_t{detail::byte_at(data, size, kPlan.positions[k])} << (8 * (k + 1));
+            }
+        }
+        if (kPlan.direct) return kPlan.slots[kPlan.shift < 64 ? (h * kPlan.multiplier) >> kPlan.shift : 0];
+        h = detail::mix64(h);
+        return kPlan.entry_of_slot[detail::pmh_slot(h, kPlan.pilots[detail::pmh_bucket(h, kSize)], kSize)];
+    }
+
+    // the key check and handler call for entry I, with the key's length and characters known at compile time
+    template<std::size_t I, typename Fallback, typename... Args>
+    static result_type<Args...> thunk(const char* data, size_type size, Fallback& fallback, Args&&... args) {
+        constexpr size_type kLength = kKeys.sizes[I];
+        // an empty key may come with a null data, which memcmp mustn't see even for no bytes
+        if (size != kLength || (kLength != 0 && std::memcmp(data, kKeys.chars[I], kLength) != 0)) {
+            return fallback(std::forward<Args>(args)...);
+        }
+        // a constant, so this is a direct call
+        constexpr handler_type handler = (kTable.begin() + I)->second;
+        return handler(std::forward<Args>(args)...);
+    }
+
+    template<typename Fallback, typename... Args>
+    static result_type<Args...> miss(const char*, size_type, Fallback& fallback, Args&&... args) {
+        return fallback(std::forward<Args>(args)...);
+    }
+
+    template<std::size_t... Indices, typename Fallback, typename... Args>
+    static result_type<Args...> jump(std::index_sequence<Indices...>, const char* data, size_type size,
+                                     Fallback& fallback, Args&&... args) {
+        using thunk_type = result_type<Args...> (*)(const char*, size_type, Fallback&, Args&&...);
+        // entry kSize is the miss, so an absent key costs no extra branch
+        static constexpr thunk_type kThunks[kSize + 1] = {&thunk<Indices, Fallback, Args...>...,
+                                                          &miss<Fallback, Args...>};
+        return kThunks[candidate(data, size)](data, size, fallback, std::forward<Args>(args)...);
+    }
+};
+
+// out-of-class definitions of the static members that lookups index at runtime (needed before C++17)
+template<typename Table>
+constexpr typename dispatch<Table>::table_type dispatch<Table>::kTable;
+
+template<typename Table>
+constexpr typename dispatch<Table>::key_list dispatch<Table>::kKeys;
+
+template<typename Table>
+constexpr detail::dispatch_plan<dispatch<Table>::kSize> dispatch<Table>::kPlan;
+
+}
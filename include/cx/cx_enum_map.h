@@ -0,0 +1,225 @@
+// Copyright (c) 2020. Mohit Deshpande.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+// the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include <cstdint>
+#include <initializer_list>
+#include <type_traits>
+
+#include "cx/cx_algorithm.h"
+#include "cx/cx_pair.h"
+#include "cx/cx_array.h"
+
+#include <stdexcept>
+
+namespace cx {
+
+// Map keyed by an enum, stored as an array indexed by the enum's underlying value. Entries are sorted and validated
+// during construction (usually at compile time), and keys must be unique. The layout follows from the keys:
+//  - keys covering a contiguous range of values index the entries directly: a subtraction, a range check and a load;
+//  - keys spanning at most Span values (the largest key minus the smallest key, plus one; see enum_span) go through a
+//    compact table of Span narrow offsets, for one more load;
+//  - sparser keys fall back to a binary search over the sorted entries, like cx::sorted_map.
+// Iteration follows the underlying values.
+template<typename Enum, typename T, std::size_t N, std::size_t Span = N>
+class enum_map {
+public:
+    static_assert(std::is_enum<Enum>::value, "cx::enum_map: keys must be an enum type");
+    static_assert(Span >= N, "cx::enum_map: Span must be at least N");
+
+    // a bunch of typedefs
+    using key_type = Enum;
+    using mapped_type = T;
+    using value_type = cx::pair<const Enum, const T>;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = value_type&;
+    using const_reference = const value_type&;
+    using pointer = value_type*;
+    using const_pointer = const value_type*;
+    using iterator = value_type*;
+    using const_iterator = const value_type*;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    // a dense map has no offset table, so it indexes contiguous keys directly and searches any others
+    static constexpr bool is_dense = Span == N;
+
+    // constructors and assignment
+    constexpr enum_map() = default;
+    constexpr enum_map(std::initializer_list<value_type> entries)
+            : enum_map(entries, make_layout(entries), std::make_index_sequence<N>(),
+                       std::make_index_sequence<offsets_size>()) {}
+
+    constexpr enum_map(const enum_map&) = default;
+    constexpr enum_map(enum_map&&) noexcept = default;
+
+    constexpr enum_map& operator=(const enum_map&) = default;
+    constexpr enum_map& operator=(enum_map&&) noexcept = default;
+
+    // iterators
+    constexpr const_iterator begin() const noexcept { return arr_.begin(); }
+    constexpr const_iterator end() const noexcept { return arr_.end(); }
+    constexpr const_reverse_iterator rbegin() const noexcept { return arr_.rbegin(); }
+    constexpr const_reverse_iterator rend() const noexcept { return arr_.rend(); }
+    constexpr const_iterator cbegin() const noexcept { return arr_.cbegin(); }
+    constexpr const_iterator cend() const noexcept { return arr_.cend(); }
+    constexpr const_reverse_iterator crbegin() const noexcept { return arr_.crbegin(); }
+    constexpr const_reverse_iterator crend() const noexcept { return arr_.crend(); }
+
+    // element access
+    constexpr const T& at(Enum key) const {
+        const std::size_t i = index_of(key);
+        // we can't directly put the throw here since this is a core constant expression
+        // (see C++ spec §5.20 [expr.const])
+        if (i == N) throw_out_of_range();
+        return arr_[i].second;
+    }
+
+    constexpr const T& operator[](Enum key) const {
+        return at(key);
+    }
+
+    // capacity
+    constexpr bool empty() const noexcept { return size() == 0; }
+    constexpr std::size_t size() const noexcept { return N; }
+    constexpr std::size_t max_size() const noexcept { return N; }
+
+    // whether lookups index the entries (directly or through the offset table) rather than search them
+    constexpr bool indexed() const noexcept { return indexed_; }
+
+    // lookup
+    constexpr size_type count(Enum key) const noexcept {
+        return index_of(key) == N ? 0 : 1;
+    }
+
+    constexpr const_iterator find(Enum key) const noexcept {
+        return begin() + index_of(key);
+    }
+
+private:
+    using underlying_type = std::underlying_type_t<Enum>;
+    using unsigned_type = std::make_unsigned_t<underlying_type>;
+    // narrowest type that can hold every entry index plus the "absent" marker N
+    using offset_type = std::conditional_t<(N < 0xffu), std::uint8_t,
+                        std::conditional_t<(N < 0xffffu), std::uint16_t, std::uint32_t>>;
+
+    static constexpr std::size_t offsets_size = is_dense ? 0 : Span;
+
+    // entries sorted by underlying value
+    const cx::array<value_type, N> arr_;
+    const cx::array<offset_type, offsets_size> offsets_{};
+    const unsigned_type min_{};
+    const bool indexed_{true};
+
+    struct layout {
+        std::size_t order[N ? N : 1];
+        offset_type offsets[offsets_size ? offsets_size : 1];
+        unsigned_type min;
+        bool indexed;
+    };
+
+    static constexpr unsigned_type bits_of(Enum key) noexcept {
+        return static_cast<unsigned_type>(static_cast<underlying_type>(key));
+    }
+
+    struct index_less {
+        const value_type* entries;
+        constexpr bool operator()(std::size_t a, std::size_t b) const {
+            return static_cast<underlying_type>(entries[a].first) < static_cast<underlying_type>(entries[b].first);
+        }
+    };
+
+    static constexpr layout make_layout(std::initializer_list<value_type> entries) {
+        if (entries.size() != N) throw std::invalid_argument("cx::enum_map: initialized with wrong number of entries!");
+
+        layout result{};
+        result.indexed = true;
+        std::size_t scratch[N ? N : 1]{};
+        detail::merge_sort_indices(result.order, scratch, N, index_less{entries.begin()});
+        if (N == 0) return result;
+
+        unsigned_type sorted[N ? N : 1]{};
+        for (std::size_t i = 0; i < N; ++i) sorted[i] = bits_of((entries.begin() + result.order[i])->first);
+        for (std::size_t i = 1; i < N; ++i) {
+            if (sorted[i - 1] == sorted[i]) throw std::invalid_argument("cx::enum_map: duplicate keys");
+        }
+
+        result.min = sorted[0];
+        const std::uint64_t range = static_cast<std::uint64_t>(static_cast<unsigned_type>(sorted[N - 1] - result.min)) + 1;
+        result.indexed = range <= Span;
+        if (result.indexed && !is_dense) {
+            for (std::size_t d = 0; d < offsets_size; ++d) result.offsets[d] = static_cast<offset_type>(N);
+            for (std::size_t i = 0; i < N; ++i) {
+                result.offsets[static_cast<unsigned_type>(sorted[i] - result.min)] = static_cast<offset_type>(i);
+            }
+        }
+        return result;
+    }
+
+    template<std::size_t... Indices, std::size_t... OffsetIndices>
+    constexpr enum_map(std::initializer_list<value_type>& entries, const layout& l, std::index_sequence<Indices...>,
+                       std::index_sequence<OffsetIndices...>)
+            : arr_{*(entries.begin() + l.order[Indices])...}, offsets_{l.offsets[OffsetIndices]...}, min_{l.min},
+              indexed_{l.indexed} {}
+
+    // entry index for key, or N if it is not in the map
+    constexpr std::size_t index_of(Enum key) const noexcept {
+        if (!indexed_) return search(key);
+        const std::size_t d = static_cast<unsigned_type>(bits_of(key) - min_);
+        if (is_dense) return d < N ? d : N;
+        return d < offsets_size ? offsets_[d] : N;
+    }
+
+    // binary search over the entries, which are sorted by underlying value
+    constexpr std::size_t search(Enum key) const noexcept {
+        const auto value = static_cast<underlying_type>(key);
+        std::size_t first = 0;
+        for (std::size_t count = N; count > 0;) {
+            const std::size_t half = count / 2;
+            if (static_cast<underlying_type>(arr_[first + half].first) < value) {
+                first += half + 1;
+                count -= half + 1;
+            } else {
+                count = half;
+            }
+        }
+        return first < N && arr_[first].first == key ? first : N;
+    }
+
+    constexpr void throw_out_of_range() const {
+        throw std::out_of_range("cx::enum_map::at: could not find entry in map");
+    }
+};
+
+// the Span an enum_map over these keys needs: the largest underlying value minus the smallest, plus one
+template<typename Enum>
+constexpr std::size_t enum_span(std::initializer_list<Enum> keys) noexcept {
+    using underlying_type = std::underlying_type_t<Enum>;
+    if (keys.size() == 0) return 0;
+    underlying_type lo = static_cast<underlying_type>(*keys.begin());
+    underlying_type hi = lo;
+    for (Enum key : keys) {
+        const auto value = static_cast<underlying_type>(key);
+        if (value < lo) lo = value;
+        if (value > hi) hi = value;
+    }
+    using unsigned_type = std::make_unsigned_t<underlying_type>;
+    const auto range = static_cast<unsigned_type>(static_cast<unsigned_type>(hi) - static_cast<unsigned_type>(lo));
+    return static_cast<std::size_t>(range) + 1;
+}
+
+}
@@ -0,0 +1,1191 @@
+// Copyright (c) 2020. Mohit Deshpande.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+// the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "cx/cx_config.h"
+#include "cx/cx_hash.h"
+#include "cx/cx_inline_string.h"
+#include "cx/cx_string.h"
+
+#include <stdexcept>
+
+namespace cx {
+
+namespace detail {
+
+// ---------- integers ----------
+
+// "00" "01" ... "99": two digits per division
+template<typename = void>
+struct digit_pairs {
+    static constexpr char value[201] =
+            "0001020304050607080910111213141516171819202122232425262728293031323334353637383940414243444546474849"
+            "5051525354555657585960616263646566676869707172737475767778798081828384858687888990919293949596979899";
+};
+
+// definition of the static constexpr member (needed before C++17)
+template<typename T>
+constexpr char digit_pairs<T>::value[201];
+
+constexpr std::size_t decimal_length(std::uint64_t v) noexcept {
+    std::size_t n = 1;
+    for (; v >= 100; v /= 100) n += 2;
+    return n + (v >= 10);
+}
+
+// writes v's decimal digits so that they end right before end
+constexpr void write_decimal(char* end, std::uint64_t v) noexcept {
+    for (; v >= 100; v /= 100) {
+        const std::size_t pair = static_cast<std::size_t>(v % 100) * 2;
+        *--end = digit_pairs<>::value[pair + 1];
+        *--end = digit_pairs<>::value[pair];
+    }
+    if (v >= 10) {
+        *--end = digit_pairs<>::value[v * 2 + 1];
+        *--end = digit_pairs<>::value[v * 2];
+    } else {
+        *--end = static_cast<char>('0' + v);
+    }
+}
+
+// ---------- arbitrary precision, for the float tables and for fixed-point output of large or precise values ----------
+
+// Unsigned integer of up to Limbs * 32 bits; only the handful of operations the conversions need
+template<std::size_t Limbs>
+struct big_uint {
+    std::uint32_t limbs[Limbs]{};
+
+    constexpr explicit big_uint(std::uint64_t v = 0) noexcept {
+        limbs[0] = static_cast<std::uint32_t>(v);
+        limbs[1] = static_cast<std::uint32_t>(v >> 32);
+    }
+
+    constexpr void multiply(std::uint32_t factor) noexcept {
+        std::uint64_t carry = 0;
+        for (std::size_t i = 0; i < Limbs; ++i) {
+            carry += static_cast<std::uint64_t>(limbs[i]) * factor;
+            limbs[i] = static_cast<std::uint32_t>(carry);
+            carry >>= 32;
+        }
+    }
+
+    // divides in place and returns the remainder
+    constexpr std::uint32_t divide(std::uint32_t divisor) noexcept {
+        std::uint64_t rem = 0;
+        for (std::size_t i = Limbs; i-- > 0;) {
+            const std::uint64_t cur = (rem << 32) | limbs[i];
+            limbs[i] = static_cast<std::uint32_t>(cur / divisor);
+            rem = cur % divisor;
+        }
+        return static_cast<std::uint32_t>(rem);
+    }
+
+    // bits [k, k + 32); bits below 0 and above the top are zero, so a negative k shifts left
+    constexpr std::uint32_t bits32(std::ptrdiff_t k) const noexcept {
+        const std::ptrdiff_t limb = k >= 0 ? k / 32 : -((-k + 31) / 32);
+        const auto offset = static_cast<unsigned>(k - limb * 32);
+        const std::uint64_t lo = limb >= 0 && limb < static_cast<std::ptrdiff_t>(Limbs) ? limbs[limb] : 0;
+        const std::uint64_t hi = limb + 1 >= 0 && limb + 1 < static_cast<std::ptrdiff_t>(Limbs) ? limbs[limb + 1] : 0;
+        return static_cast<std::uint32_t>(((hi << 32) | lo) >> offset);
+    }
+
+    constexpr std::uint64_t bits64(std::ptrdiff_t k) const noexcept {
+        return bits32(k) | (static_cast<std::uint64_t>(bits32(k + 32)) << 32);
+    }
+
+    constexpr void shift_left(std::size_t n) noexcept {
+        const big_uint copy = *this;
+        for (std::size_t i = 0; i < Limbs; ++i) {
+            limbs[i] = copy.bits32(static_cast<std::ptrdiff_t>(i * 32) - static_cast<std::ptrdiff_t>(n));
+        }
+    }
+
+    // shifts right by n, rounding half to even
+    constexpr void shift_right_round(std::size_t n) noexcept {
+        if (n == 0) return;
+        const big_uint copy = *this;
+        for (std::size_t i = 0; i < Limbs; ++i) limbs[i] = copy.bits32(static_cast<std::ptrdiff_t>(i * 32 + n));
+        // the dropped bits against one half: the bit right below the cut, then whether anything below it is set
+        const bool half = (copy.bits32(static_cast<std::ptrdiff_t>(n) - 1) & 1u) != 0;
+        bool below = false;
+        for (std::size_t bit = 0; bit + 1 < n && !below; bit += 32) {
+            std::uint32_t word = copy.bits32(static_cast<std::ptrdiff_t>(bit));
+            if (n - 1 - bit < 32) word &= (1u << (n - 1 - bit)) - 1;
+            below = word != 0;
+        }
+        if (half && (below || (limbs[0] & 1u))) increment();
+    }
+
+    constexpr void add(std::uint32_t v) noexcept {
+        std::uint64_t carry = v;
+        for (std::size_t i = 0; i < Limbs && carry != 0; ++i) {
+            carry += limbs[i];
+            limbs[i] = static_cast<std::uint32_t>(carry);
+            carry >>= 32;
+        }
+    }
+
+    constexpr void increment() noexcept {
+        for (std::size_t i = 0; i < Limbs && ++limbs[i] == 0; ++i) {}
+    }
+
+    constexpr bool is_zero() const noexcept {
+        for (std::size_t i = 0; i < Limbs; ++i) {
+            if (limbs[i]) return false;
+        }
+        return true;
+    }
+
+    constexpr std::size_t bit_length() const noexcept {
+        for (std::size_t i = Limbs; i-- > 0;) {
+            if (limbs[i] == 0) continue;
+            std::size_t n = i * 32;
+            for (std::uint32_t v = limbs[i]; v != 0; v >>= 1) ++n;
+            return n;
+        }
+        return 0;
+    }
+};
+
+// ---------- shortest round-trip floats (Ryu, Ulf Adams, PLDI 2018) ----------
+
+constexpr int kPow5Bits = 125;
+constexpr int kPow5InvBits = 125;
+constexpr std::size_t kPow5Count = 326;
+constexpr std::size_t kPow5InvCount = 342;
+
+// ceil(log2(5^e)) for 0 < e <= 3528, and 1 for e == 0
+constexpr int pow5bits(int e) noexcept {
+    return static_cast<int>((static_cast<std::uint32_t>(e) * 1217359u) >> 19) + 1;
+}
+
+// floor(log10(2^e)) and floor(log10(5^e)) for 0 <= e <= 1650
+constexpr int log10_pow2(int e) noexcept { return static_cast<int>((static_cast<std::uint32_t>(e) * 78913u) >> 18); }
+constexpr int log10_pow5(int e) noexcept { return static_cast<int>((static_cast<std::uint32_t>(e) * 732923u) >> 20); }
+
+// The 125-bit approximations of 5^i and 2^k / 5^i that Ryu multiplies by, as (low, high) words:
+//   pow5[i]     = floor(5^i / 2^(pow5bits(i) - 125))
+//   pow5_inv[i] = floor(2^(pow5bits(i) - 1 + 125) / 5^i) + 1
+// They're computed here instead of being pasted in: 5^i by repeated multiplication, and the inverses by repeatedly
+// dividing one big power of two by 5, since floor(floor(x / 5^i) / 5) == floor(x / 5^(i + 1)).
+struct ryu_table_data {
+    std::uint64_t pow5[kPow5Count][2];
+    std::uint64_t pow5_inv[kPow5InvCount][2];
+};
+
+constexpr ryu_table_data make_ryu_tables() noexcept {
+    ryu_table_data tables{};
+
+    big_uint<25> power(1);
+    for (std::size_t i = 0; i < kPow5Count; ++i) {
+        const std::ptrdiff_t shift = pow5bits(static_cast<int>(i)) - kPow5Bits;
+        tables.pow5[i][0] = power.bits64(shift);
+        tables.pow5[i][1] = power.bits64(shift + 64);
+        power.multiply(5);
+    }
+
+    // 2^960 covers the largest pow5bits(i) - 1 + 125 (916)
+    constexpr std::size_t kTop = 960;
+    big_uint<kTop / 32 + 1> inverse{};
+    inverse.limbs[kTop / 32] = 1;
+    for (std::size_t i = 0; i < kPow5InvCount; ++i) {
+        const int bits = pow5bits(static_cast<int>(i)) - 1 + kPow5InvBits;
+        const std::ptrdiff_t shift = static_cast<std::ptrdiff_t>(kTop) - bits;
+        const std::uint64_t lo = inverse.bits64(shift);
+        tables.pow5_inv[i][0] = lo + 1;
+        tables.pow5_inv[i][1] = inverse.bits64(shift + 64) + (lo + 1 == 0);
+        inverse.divide(5);
+    }
+    return tables;
+}
+
+template<typename = void>
+struct ryu_tables {
+    static constexpr ryu_table_data value = make_ryu_tables();
+};
+
+// definition of the static constexpr member (needed before C++17)
+template<typename T>
+constexpr ryu_table_data ryu_tables<T>::value;
+
+// (m * mul) >> j for a 64-bit m and a 128-bit mul, 64 < j < 128
+constexpr std::uint64_t mul_shift64(std::uint64_t m, const std::uint64_t* mul, int j) noexcept {
+    std::uint64_t b0_lo = m, b0_hi = mul[0];
+    mum(b0_lo, b0_hi);
+    std::uint64_t b2_lo = m, b2_hi = mul[1];
+    mum(b2_lo, b2_hi);
+    const std::uint64_t lo = b2_lo + b0_hi;
+    const std::uint64_t hi = b2_hi + (lo < b2_lo);
+    const int dist = j - 64;
+    return dist == 0 ? lo : (hi << (64 - dist)) | (lo >> dist);
+}
+
+// (m * factor) >> shift for a 32-bit m, 32 < shift
+constexpr std::uint32_t mul_shift32(std::uint32_t m, std::uint64_t factor, int shift) noexcept {
+    const std::uint64_t bits0 = static_cast<std::uint64_t>(m) * static_cast<std::uint32_t>(factor);
+    const std::uint64_t bits1 = static_cast<std::uint64_t>(m) * (factor >> 32);
+    return static_cast<std::uint32_t>(((bits0 >> 32) + bits1) >> (shift - 32));
+}
+
+constexpr unsigned pow5_factor(std::uint64_t v) noexcept {
+    unsigned count = 0;
+    for (; v % 5 == 0; v /= 5) ++count;
+    return count;
+}
+
+constexpr bool multiple_of_pow5(std::uint64_t v, int p) noexcept { return pow5_factor(v) >= static_cast<unsigned>(p); }
+constexpr bool multiple_of_pow2(std::uint64_t v, int p) noexcept { return (v & ((std::uint64_t{1} << p) - 1)) == 0; }
+
+// the shortest decimal that reads back as the float: digits * 10^exponent
+struct decimal_float {
+    std::uint64_t digits;
+    int exponent;
+};
+
+constexpr decimal_float shortest_decimal(std::uint64_t ieee_mantissa, std::uint32_t ieee_exponent) noexcept {
+    constexpr int kMantissaBits = 52;
+    constexpr int kBias = 1023;
+    const auto& tables = ryu_tables<>::value;
+
+    int e2 = 0;
+    std::uint64_t m2 = 0;
+    if (ieee_exponent == 0) {
+        e2 = 1 - kBias - kMantissaBits - 2;
+        m2 = ieee_mantissa;
+    } else {
+        e2 = static_cast<int>(ieee_exponent) - kBias - kMantissaBits - 2;
+        m2 = (std::uint64_t{1} << kMantissaBits) | ieee_mantissa;
+    }
+    const bool accept_bounds = (m2 & 1) == 0;
+
+    // the interval of decimals that round to this float: [4 m2 - 1 - mm_shift, 4 m2 + 2] * 2^e2
+    const std::uint64_t mv = 4 * m2;
+    const std::uint32_t mm_shift = ieee_mantissa != 0 || ieee_exponent <= 1;
+
+    std::uint64_t vr = 0, vp = 0, vm = 0;
+    int e10 = 0;
+    bool vm_trailing_zeros = false;
+    bool vr_trailing_zeros = false;
+    if (e2 >= 0) {
+        const int q = log10_pow2(e2) - (e2 > 3);
+        e10 = q;
+        const int k = kPow5InvBits + pow5bits(q) - 1;
+        const int i = -e2 + q + k;
+        vr = mul_shift64(4 * m2, tables.pow5_inv[q], i);
+        vp = mul_shift64(4 * m2 + 2, tables.pow5_inv[q], i);
+        vm = mul_shift64(4 * m2 - 1 - mm_shift, tables.pow5_inv[q], i);
+        if (q <= 21) {
+            if (mv % 5 == 0) {
+                vr_trailing_zeros = multiple_of_pow5(mv, q);
+            } else if (accept_bounds) {
+                vm_trailing_zeros = multiple_of_pow5(mv - 1 - mm_shift, q);
+            } else {
+                vp -= multiple_of_pow5(mv + 2, q);
+            }
+        }
+    } else {
+        const int q = log10_pow5(-e2) - (-e2 > 1);
+        e10 = q + e2;
+        const int i = -e2 - q;
+        const int k = pow5bits(i) - kPow5Bits;
+        const int j = q - k;
+        vr = mul_shift64(4 * m2, tables.pow5[i], j);
+        vp = mul_shift64(4 * m2 + 2, tables.pow5[i], j);
+        vm = mul_shift64(4 * m2 - 1 - mm_shift, tables.pow5[i], j);
+        if (q <= 1) {
+            vr_trailing_zeros = true;
+            if (accept_bounds) {
+                vm_trailing_zeros = mm_shift == 1;
+            } else {
+                --vp;
+            }
+        } else if (q < 63) {
+            vr_trailing_zeros = multiple_of_pow2(mv, q);
+        }
+    }
+
+    // drop digits while the interval still holds a shorter decimal
+    int removed = 0;
+    std::uint32_t last_removed = 0;
+    std::uint64_t output = 0;
+    if (vm_trailing_zeros || vr_trailing_zeros) {
+        for (; vp / 10 > vm / 10; ++removed) {
+            vm_trailing_zeros &= vm % 10 == 0;
+            vr_trailing_zeros &= last_removed == 0;
+            last_removed = static_cast<std::uint32_t>(vr % 10);
+            vr /= 10;
+            vp /= 10;
+            vm /= 10;
+        }
+        if (vm_trailing_zeros) {
+            for (; vm % 10 == 0; ++removed) {
+                vr_trailing_zeros &= last_removed == 0;
+                last_removed = static_cast<std::uint32_t>(vr % 10);
+                vr /= 10;
+                vp /= 10;
+                vm /= 10;
+            }
+        }
+        // exactly halfway: round to even
+        if (vr_trailing_zeros && last_removed == 5 && vr % 2 == 0) last_removed = 4;
+        output = vr + ((vr == vm && (!accept_bounds || !vm_trailing_zeros)) || last_removed >= 5);
+    } else {
+        // the common case: no trailing zeros to track, and usually two digits can go at once
+        bool round_up = false;
+        if (vp / 100 > vm / 100) {
+            round_up = vr % 100 >= 50;
+            vr /= 100;
+            vp /= 100;
+            vm /= 100;
+            removed += 2;
+        }
+        for (; vp / 10 > vm / 10; ++removed) {
+            round_up = vr % 10 >= 5;
+            vr /= 10;
+            vp /= 10;
+            vm /= 10;
+        }
+        output = vr + (vr == vm || round_up);
+    }
+    return {output, e10 + removed};
+}
+
+// the float version: same steps on 32 bits, with the top words of the double tables as 64-bit multipliers
+constexpr decimal_float shortest_decimal(std::uint32_t ieee_mantissa, std::uint32_t ieee_exponent) noexcept {
+    constexpr int kMantissaBits = 23;
+    constexpr int kBias = 127;
+    constexpr int kPow5InvBits32 = kPow5InvBits - 64;
+    constexpr int kPow5Bits32 = kPow5Bits - 64;
+    const auto& tables = ryu_tables<>::value;
+
+    int e2 = 0;
+    std::uint32_t m2 = 0;
+    if (ieee_exponent == 0) {
+        e2 = 1 - kBias - kMantissaBits - 2;
+        m2 = ieee_mantissa;
+    } else {
+        e2 = static_cast<int>(ieee_exponent) - kBias - kMantissaBits - 2;
+        m2 = (1u << kMantissaBits) | ieee_mantissa;
+    }
+    const bool accept_bounds = (m2 & 1) == 0;
+
+    const std::uint32_t mv = 4 * m2;
+    const std::uint32_t mp = 4 * m2 + 2;
+    const std::uint32_t mm_shift = ieee_mantissa != 0 || ieee_exponent <= 1;
+    const std::uint32_t mm = 4 * m2 - 1 - mm_shift;
+
+    std::uint32_t vr = 0, vp = 0, vm = 0;
+    int e10 = 0;
+    bool vm_trailing_zeros = false;
+    bool vr_trailing_zeros = false;
+    std::uint32_t last_removed = 0;
+    if (e2 >= 0) {
+        const int q = log10_pow2(e2);
+        e10 = q;
+        const int k = kPow5InvBits32 + pow5bits(q) - 1;
+        const int i = -e2 + q + k;
+        vr = mul_shift32(mv, tables.pow5_inv[q][1] + 1, i);
+        vp = mul_shift32(mp, tables.pow5_inv[q][1] + 1, i);
+        vm = mul_shift32(mm, tables.pow5_inv[q][1] + 1, i);
+        if (q != 0 && (vp - 1) / 10 <= vm / 10) {
+            // the loop below won't run, but rounding still needs the last digit it would have removed
+            const int l = kPow5InvBits32 + pow5bits(q - 1) - 1;
+            last_removed = mul_shift32(mv, tables.pow5_inv[q - 1][1] + 1, -e2 + q - 1 + l) % 10;
+        }
+        if (q <= 9) {
+            if (mv % 5 == 0) {
+                vr_trailing_zeros = multiple_of_pow5(mv, q);
+            } else if (accept_bounds) {
+                vm_trailing_zeros = multiple_of_pow5(mm, q);
+            } else {
+                vp -= multiple_of_pow5(mp, q);
+            }
+        }
+    } else {
+        const int q = log10_pow5(-e2);
+        e10 = q + e2;
+        const int i = -e2 - q;
+        const int k = pow5bits(i) - kPow5Bits32;
+        int j = q - k;
+        vr = mul_shift32(mv, tables.pow5[i][1], j);
+        vp = mul_shift32(mp, tables.pow5[i][1], j);
+        vm = mul_shift32(mm, tables.pow5[i][1], j);
+        if (q != 0 && (vp - 1) / 10 <= vm / 10) {
+            j = q - 1 - (pow5bits(i + 1) - kPow5Bits32);
+            last_removed = mul_shift32(mv, tables.pow5[i + 1][1], j) % 10;
+        }
+        if (q <= 1) {
+            vr_trailing_zeros = true;
+            if (accept_bounds) {
+                vm_trailing_zeros = mm_shift == 1;
+            } else {
+                --vp;
+            }
+        } else if (q < 31) {
+            vr_trailing_zeros = multiple_of_pow2(mv, q - 1);
+        }
+    }
+
+    int removed = 0;
+    std::uint32_t output = 0;
+    if (vm_trailing_zeros || vr_trailing_zeros) {
+        for (; vp / 10 > vm / 10; ++removed) {
+            vm_trailing_zeros &= vm % 10 == 0;
+            vr_trailing_zeros &= last_removed == 0;
+            last_removed = vr % 10;
+            vr /= 10;
+            vp /= 10;
+            vm /= 10;
+        }
+        if (vm_trailing_zeros) {
+            for (; vm % 10 == 0; ++removed) {
+                vr_trailing_zeros &= last_removed == 0;
+                last_removed = vr % 10;
+                vr /= 10;
+                vp /= 10;
+                vm /= 10;
+            }
+        }
+        if (vr_trailing_zeros && last_removed == 5 && vr % 2 == 0) last_removed = 4;
+        output = vr + ((vr == vm && (!accept_bounds || !vm_trailing_zeros)) || last_removed >= 5);
+    } else {
+        for (; vp / 10 > vm / 10; ++removed) {
+            last_removed = vr % 10;
+            vr /= 10;
+            vp /= 10;
+            vm /= 10;
+        }
+        output = vr + (vr == vm || last_removed >= 5);
+    }
+    return {output, e10 + removed};
+}
+
+// bit patterns without std::memcpy or bit_cast, so they work during constant evaluation
+struct float_bits {
+    bool negative;
+    std::uint64_t mantissa;
+    std::uint32_t exponent;
+};
+
+// dividing by zero to tell -0.0 apart isn't a constant expression, but the builtin is; without it -0.0 prints as 0
+constexpr bool sign_bit(double value) noexcept {
+#if defined(__GNUC__) || CX_HAS_BUILTIN(__builtin_copysign)
+    return __builtin_copysign(1.0, value) < 0;
+#else
+    return value < 0;
+#endif
+}
+
+template<typename Float>
+constexpr float_bits decompose(Float value) noexcept;
+
+template<>
+constexpr float_bits decompose(double value) noexcept {
+    if (!CX_IS_CONSTANT_EVALUATED()) {
+        std::uint64_t bits = 0;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return {(bits >> 63) != 0, bits & ((std::uint64_t{1} << 52) - 1),
+                static_cast<std::uint32_t>((bits >> 52) & 0x7ff)};
+    }
+    // normalize by powers of two; exact, since scaling by 2 never rounds
+    const bool negative = sign_bit(value);
+    if (value != value) return {negative, 1, 0x7ff};
+    if (negative) value = -value;
+    if (value == std::numeric_limits<double>::infinity()) return {negative, 0, 0x7ff};
+    if (value == 0) return {negative, 0, 0};
+    int exponent = 0;
+    while (value >= 2) {
+        value /= 2;
+        ++exponent;
+    }
+    while (value < 1 && exponent > -1022) {
+        value *= 2;
+        --exponent;
+    }
+    if (value < 1) return {negative, static_cast<std::uint64_t>(value * 4503599627370496.0), 0};
+    return {negative, static_cast<std::uint64_t>((value - 1) * 4503599627370496.0),
+            static_cast<std::uint32_t>(exponent + 1023)};
+}
+
+template<>
+constexpr float_bits decompose(float value) noexcept {
+    if (!CX_IS_CONSTANT_EVALUATED()) {
+        std::uint32_t bits = 0;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return {(bits >> 31) != 0, bits & ((1u << 23) - 1), (bits >> 23) & 0xff};
+    }
+    // every float is exactly a double; take its bits apart and rebias
+    const float_bits wide = decompose(static_cast<double>(value));
+    if (wide.exponent == 0x7ff) return {wide.negative, wide.mantissa != 0, 0xff};
+    if (wide.exponent == 0) return {wide.negative, 0, 0};
+    const int exponent = static_cast<int>(wide.exponent) - 1023 + 127;
+    if (exponent > 0) return {wide.negative, wide.mantissa >> 29, static_cast<std::uint32_t>(exponent)};
+    // subnormal float
+    return {wide.negative, ((wide.mantissa | (std::uint64_t{1} << 52)) >> (29 + 1 - exponent)), 0};
+}
+
+constexpr decimal_float shortest_decimal_of(double, const float_bits& bits) noexcept {
+    return shortest_decimal(bits.mantissa, bits.exponent);
+}
+
+constexpr decimal_float shortest_decimal_of(float, const float_bits& bits) noexcept {
+    return shortest_decimal(static_cast<std::uint32_t>(bits.mantissa), bits.exponent);
+}
+
+// the value as mantissa * 2^exponent, with the implicit bit of normal numbers put back
+struct binary_float {
+    std::uint64_t mantissa;
+    int exponent;
+};
+
+constexpr binary_float exact_value(double, const float_bits& bits) noexcept {
+    if (bits.exponent == 0) return {bits.mantissa, -1074};
+    return {bits.mantissa | (std::uint64_t{1} << 52), static_cast<int>(bits.exponent) - 1075};
+}
+
+constexpr binary_float exact_value(float, const float_bits& bits) noexcept {
+    if (bits.exponent == 0) return {bits.mantissa, -149};
+    return {bits.mantissa | (std::uint64_t{1} << 23), static_cast<int>(bits.exponent) - 150};
+}
+
+// ---------- output ----------
+
+// Appends into a caller's buffer of fixed capacity; running out of room throws std::length_error
+struct format_writer {
+    char* data;
+    std::size_t capacity;
+    std::size_t size;
+
+    constexpr void reserve(std::size_t n) const {
+        if (n > capacity - size) throw std::length_error("cx::format: output buffer is too small");
+    }
+
+    constexpr void put(char c) {
+        reserve(1);
+        data[size++] = c;
+    }
+
+    constexpr void write(const char* str, std::size_t n) {
+        reserve(n);
+        copy_chars(data + size, str, n);
+        size += n;
+    }
+
+    constexpr void fill(char c, std::size_t n) {
+        reserve(n);
+        for (std::size_t i = 0; i < n; ++i) data[size + i] = c;
+        size += n;
+    }
+
+    // room for n characters written in place (numbers are written back to front)
+    constexpr char* extend(std::size_t n) {
+        reserve(n);
+        size += n;
+        return data + size;
+    }
+
+    // pads what was written since start to width: with c inserted at start + at, or with spaces after it
+    constexpr void pad(std::size_t start, std::size_t width, std::size_t at, char c, bool left_align) {
+        const std::size_t written = size - start;
+        if (written >= width) return;
+        const std::size_t n = width - written;
+        if (left_align) return fill(' ', n);
+        reserve(n);
+        for (std::size_t i = size; i-- > start + at;) data[i + n] = data[i];
+        for (std::size_t i = 0; i < n; ++i) data[start + at + i] = c;
+        size += n;
+    }
+};
+
+constexpr void write_exponent(format_writer& out, int exponent) {
+    out.put('e');
+    out.put(exponent < 0 ? '-' : '+');
+    const auto e = static_cast<std::uint64_t>(exponent < 0 ? -exponent : exponent);
+    const std::size_t length = e < 10 ? 2 : decimal_length(e);
+    char* end = out.extend(length);
+    write_decimal(end, e);
+    if (e < 10) end[-2] = '0';
+}
+
+// digits * 10^exponent, in whichever of fixed or scientific notation is shorter (fixed on a tie), which is what
+// std::to_chars does without a format. Like std::to_chars, a large integer in fixed notation prints the exact value
+// rather than the shortest digits padded with zeros.
+constexpr void write_fixed(format_writer& out, std::uint64_t mantissa, int exponent, std::size_t precision);
+
+constexpr void write_shortest(format_writer& out, decimal_float d, binary_float exact, bool scientific) {
+    const auto n = static_cast<int>(decimal_length(d.digits));
+    const int sci_exponent = d.exponent + n - 1;
+    if (!scientific) {
+        const int fixed_length = d.exponent >= 0 ? n + d.exponent : (-d.exponent < n ? n + 1 : 2 - d.exponent);
+        const int abs_exponent = sci_exponent < 0 ? -sci_exponent : sci_exponent;
+        const int sci_length = n + (n > 1) + 2 + (abs_exponent >= 100 ? 3 : 2);
+        scientific = fixed_length > sci_length;
+    }
+
+    if (scientific) {
+        char digits[20]{};
+        write_decimal(digits + n, d.digits);
+        out.put(digits[0]);
+        if (n > 1) {
+            out.put('.');
+            out.write(digits + 1, static_cast<std::size_t>(n - 1));
+        }
+        return write_exponent(out, sci_exponent);
+    }
+    if (d.exponent > 0) return write_fixed(out, exact.mantissa, exact.exponent, 0);
+    if (d.exponent == 0) return write_decimal(out.extend(static_cast<std::size_t>(n)), d.digits);
+    const int integer_digits = n + d.exponent;
+    if (integer_digits > 0) {
+        // write all the digits, then open a gap for the point
+        char* end = out.extend(static_cast<std::size_t>(n) + 1);
+        write_decimal(end, d.digits);
+        for (int i = 0; i < integer_digits; ++i) end[-n - 1 + i] = end[-n + i];
+        end[-n - 1 + integer_digits] = '.';
+        return;
+    }
+    out.put('0');
+    out.put('.');
+    out.fill('0', static_cast<std::size_t>(-integer_digits));
+    write_decimal(out.extend(static_cast<std::size_t>(n)), d.digits);
+}
+
+// Exactly rounded fixed-point output with precision digits after the point, like printf("%.*f"). The value is
+// mantissa * 2^exponent, so value * 10^precision == mantissa * 5^precision * 2^(exponent + precision) is an integer
+// shift away. It stays in 64 bits when it fits; huge or very precise values go through big_uint.
+constexpr void write_fixed(format_writer& out, std::uint64_t mantissa, int exponent, std::size_t precision) {
+    std::uint64_t pow5 = 1;
+    for (std::size_t i = 0; i < precision && i < 27; ++i) pow5 *= 5;
+    const int shift = exponent + static_cast<int>(precision);
+
+    std::uint64_t small = 0;
+    bool fits = mantissa == 0;
+    if (!fits && precision <= 27 && mantissa <= ~std::uint64_t{0} / pow5) {
+        const std::uint64_t scaled = mantissa * pow5;
+        if (shift <= 0 && shift > -64) {
+            small = scaled >> -shift;
+            const std::uint64_t rest = scaled & ((std::uint64_t{1} << -shift) - 1);
+            const std::uint64_t half = shift == 0 ? 1 : std::uint64_t{1} << (-shift - 1);
+            if (shift != 0 && (rest > half || (rest == half && (small & 1)))) ++small;
+            fits = true;
+        } else if (shift <= -64) {
+            // at most half of the last digit: rounds to zero
+            fits = scaled < (std::uint64_t{1} << 63) || shift < -64;
+        } else if (shift < 64 && scaled <= (~std::uint64_t{0} >> shift)) {
+            small = scaled << shift;
+            fits = true;
+        }
+    }
+
+    // the rounded value as decimal digits, at least precision + 1 of them so there's an integer digit
+    if (fits) {
+        const std::size_t length = decimal_length(small);
+        const std::size_t digits = length > precision ? length : precision + 1;
+        char* end = out.extend(digits);
+        write_decimal(end, small);
+        for (std::size_t i = length; i < digits; ++i) *(end - i - 1) = '0';
+    } else {
+        // 2^1024 * 10^17 and change
+        big_uint<40> big(mantissa);
+        for (std::size_t i = 0; i < precision; ++i) big.multiply(5);
+        if (shift >= 0) {
+            big.shift_left(static_cast<std::size_t>(shift));
+        } else {
+            big.shift_right_round(static_cast<std::size_t>(-shift));
+        }
+        // nine digits per division, least significant chunk first
+        std::uint32_t chunks[40]{};
+        std::size_t count = 0;
+        do {
+            chunks[count++] = big.divide(1000000000u);
+        } while (!big.is_zero());
+        const std::size_t length = (count - 1) * 9 + decimal_length(chunks[count - 1]);
+        const std::size_t digits = length > precision ? length : precision + 1;
+        char* end = out.extend(digits);
+        for (std::size_t i = 0; i < digits; ++i) *(end - i - 1) = '0';
+        for (std::size_t c = 0; c < count; ++c) {
+            char* chunk_end = end - 9 * c;
+            std::ptrdiff_t k = 0;
+            for (std::uint32_t v = chunks[c]; v != 0; v /= 10) *(chunk_end - ++k) = static_cast<char>('0' + v % 10);
+        }
+    }
+
+    if (precision == 0) return;
+    // move the fraction one to the right for the point
+    out.extend(1);
+    char* end = out.data + out.size;
+    for (std::size_t i = 0; i < precision; ++i) *(end - i - 1) = *(end - i - 2);
+    *(end - precision - 1) = '.';
+}
+
+// ---------- placeholders ----------
+
+// what a placeholder's type accepts, two bits per placeholder in a format signature
+constexpr std::uint64_t kFormatAny = 0;
+constexpr std::uint64_t kFormatInteger = 1;
+constexpr std::uint64_t kFormatFloat = 2;
+constexpr std::uint64_t kFormatString = 3;
+
+// the low byte of a signature is the placeholder count, which leaves room for 28 of them
+constexpr std::size_t kMaxFormatArgs = 28;
+constexpr std::size_t kMaxFormatWidth = 255;
+constexpr std::size_t kMaxFormatPrecision = 30;
+
+// {:[align][0][width][.precision][type]}
+struct format_spec {
+    char type{};   // '\0', or one of d x X b o f e s
+    char align{};  // '\0', '<' or '>'
+    bool zero_pad{};
+    bool has_precision{};
+    std::uint8_t width{};
+    std::uint8_t precision{};
+
+    constexpr std::uint64_t kind() const noexcept {
+        switch (type) {
+            case 'd': case 'x': case 'X': case 'b': case 'o': return kFormatInteger;
+            case 'f': case 'e': return kFormatFloat;
+            case 's': return kFormatString;
+            default: return kFormatAny;
+        }
+    }
+
+    constexpr bool is_integer() const noexcept { return kind() == kFormatInteger; }
+};
+
+constexpr bool is_format_digit(char c) noexcept { return c >= '0' && c <= '9'; }
+
+// parses the placeholder that starts after pattern[i] == '{' and returns the index just past its '}'
+constexpr std::size_t parse_format_spec(const char* pattern, std::size_t length, std::size_t i, format_spec& spec) {
+    if (i < length && pattern[i] == ':') {
+        ++i;
+        if (i < length && (pattern[i] == '<' || pattern[i] == '>')) spec.align = pattern[i++];
+        if (i < length && pattern[i] == '0') {
+            spec.zero_pad = true;
+            ++i;
+        }
+        std::size_t width = 0;
+        for (; i < length && is_format_digit(pattern[i]); ++i) {
+            width = width * 10 + static_cast<std::size_t>(pattern[i] - '0');
+            if (width > kMaxFormatWidth) throw std::invalid_argument("cx::format: width is too large");
+        }
+        spec.width = static_cast<std::uint8_t>(width);
+        if (i < length && pattern[i] == '.') {
+            ++i;
+            if (i == length || !is_format_digit(pattern[i])) {
+                throw std::invalid_argument("cx::format: missing precision");
+            }
+            std::size_t precision = 0;
+            for (; i < length && is_format_digit(pattern[i]); ++i) {
+                precision = precision * 10 + static_cast<std::size_t>(pattern[i] - '0');
+                if (precision > kMaxFormatPrecision) throw std::invalid_argument("cx::format: precision is too large");
+            }
+            spec.has_precision = true;
+            spec.precision = static_cast<std::uint8_t>(precision);
+        }
+        if (i < length && pattern[i] != '}') spec.type = pattern[i++];
+        if (spec.type != '\0' && spec.kind() == kFormatAny) throw std::invalid_argument("cx::format: unknown type");
+        if (spec.has_precision && spec.type != 'f') throw std::invalid_argument("cx::format: precision needs type f");
+    }
+    if (i == length || pattern[i] != '}') throw std::invalid_argument("cx::format: unterminated placeholder");
+    return i + 1;
+}
+
+// ---------- arguments ----------
+
+enum class format_arg { unsupported, boolean, character, integer, floating, string };
+
+template<typename T, typename = void>
+struct has_data_and_size : std::false_type {};
+
+template<typename T>
+struct has_data_and_size<T, decltype(std::declval<const T&>().data(), std::declval<const T&>().size(), void())>
+        : std::true_type {};
+
+template<typename T>
+struct is_format_string : has_data_and_size<T> {};
+
+template<>
+struct is_format_string<const char*> : std::true_type {};
+
+template<>
+struct is_format_string<char*> : std::true_type {};
+
+template<std::size_t N>
+struct is_format_string<string<N>> : std::true_type {};
+
+// what an argument of (decayed) type T is; long double and anything else unlisted isn't supported
+template<typename T>
+struct format_arg_of : std::integral_constant<format_arg,
+        std::is_same<T, bool>::value ? format_arg::boolean :
+        std::is_same<T, char>::value ? format_arg::character :
+        std::is_integral<T>::value ? format_arg::integer :
+        std::is_same<T, float>::value || std::is_same<T, double>::value ? format_arg::floating :
+        is_format_string<T>::value ? format_arg::string : format_arg::unsupported> {};
+
+// bools and chars print as text by default and as numbers with an integer type
+constexpr bool format_accepts(format_arg arg, std::uint64_t kind) noexcept {
+    switch (kind) {
+        case kFormatInteger:
+            return arg == format_arg::boolean || arg == format_arg::character || arg == format_arg::integer;
+        case kFormatFloat: return arg == format_arg::floating;
+        case kFormatString:
+            return arg == format_arg::boolean || arg == format_arg::character || arg == format_arg::string;
+        default: return arg != format_arg::unsupported;
+    }
+}
+
+template<std::uint64_t Signature, std::size_t Index, typename Arg>
+struct format_arg_check {
+    static constexpr format_arg arg = format_arg_of<std::decay_t<Arg>>::value;
+    static_assert(arg != format_arg::unsupported, "cx::format: unsupported argument type");
+    static_assert(format_accepts(arg, (Signature >> (8 + 2 * Index)) & 3),
+                  "cx::format: argument doesn't match its placeholder's type");
+    static constexpr bool value = true;
+};
+
+// ---------- writing arguments ----------
+
+// right-aligned unless asked otherwise, zeros going after the sign
+constexpr void pad_number(format_writer& out, const format_spec& spec, std::size_t start, std::size_t sign,
+                          bool zero_allowed) {
+    if (spec.width == 0) return;
+    if (spec.align == '<') return out.pad(start, spec.width, 0, ' ', true);
+    if (spec.zero_pad && spec.align == '\0' && zero_allowed) return out.pad(start, spec.width, sign, '0', false);
+    out.pad(start, spec.width, 0, ' ', false);
+}
+
+// base 2, 8 or 16: bits per digit
+constexpr void write_radix(format_writer& out, std::uint64_t v, unsigned bits, const char* digits) {
+    std::size_t n = 1;
+    for (std::uint64_t rest = v >> bits; rest != 0; rest >>= bits) ++n;
+    char* end = out.extend(n);
+    const std::uint64_t mask = (std::uint64_t{1} << bits) - 1;
+    do {
+        *--end = digits[v & mask];
+        v >>= bits;
+    } while (v != 0);
+}
+
+constexpr void write_integer(format_writer& out, const format_spec& spec, std::uint64_t magnitude, bool negative) {
+    const std::size_t start = out.size;
+    if (negative) out.put('-');
+    switch (spec.type) {
+        case 'x': write_radix(out, magnitude, 4, "0123456789abcdef"); break;
+        case 'X': write_radix(out, magnitude, 4, "0123456789ABCDEF"); break;
+        case 'o': write_radix(out, magnitude, 3, "01234567"); break;
+        case 'b': write_radix(out, magnitude, 1, "01"); break;
+        default: write_decimal(out.extend(decimal_length(magnitude)), magnitude); break;
+    }
+    pad_number(out, spec, start, negative, true);
+}
+
+// left-aligned unless asked otherwise
+constexpr void write_text(format_writer& out, const format_spec& spec, const char* data, std::size_t size) {
+    const std::size_t start = out.size;
+    out.write(data, size);
+    if (spec.width != 0) out.pad(start, spec.width, 0, ' ', spec.align != '>');
+}
+
+// nan and inf like printf; f is fixed with 6 digits unless given, e is shortest scientific, and no type is the
+// shortest form that reads back to the same value
+template<typename Float>
+constexpr void write_floating(format_writer& out, const format_spec& spec, Float value) {
+    const float_bits bits = decompose(value);
+    const bool finite = bits.exponent != (sizeof(Float) == sizeof(double) ? 0x7ffu : 0xffu);
+    const std::size_t start = out.size;
+    if (bits.negative) out.put('-');
+    if (!finite) {
+        out.write(bits.mantissa != 0 ? "nan" : "inf", 3);
+    } else if (spec.type == 'f') {
+        const binary_float exact = exact_value(value, bits);
+        write_fixed(out, exact.mantissa, exact.exponent, spec.has_precision ? spec.precision : 6);
+    } else if (bits.mantissa == 0 && bits.exponent == 0) {
+        if (spec.type == 'e') {
+            out.write("0e+00", 5);
+        } else {
+            out.put('0');
+        }
+    } else {
+        write_shortest(out, shortest_decimal_of(value, bits), exact_value(value, bits), spec.type == 'e');
+    }
+    pad_number(out, spec, start, bits.negative, finite);
+}
+
+constexpr std::size_t c_string_length(const char* str) noexcept {
+    if (!CX_IS_CONSTANT_EVALUATED()) return std::strlen(str);
+    std::size_t n = 0;
+    while (str[n] != '\0') ++n;
+    return n;
+}
+
+template<typename T>
+constexpr void write_arg(format_writer& out, const format_spec& spec, const T& value,
+                         std::integral_constant<format_arg, format_arg::boolean>) {
+    if (spec.is_integer()) return write_integer(out, spec, value ? 1 : 0, false);
+    write_text(out, spec, value ? "true" : "false", value ? 4 : 5);
+}
+
+template<typename T>
+constexpr void write_arg(format_writer& out, const format_spec& spec, const T& value,
+                         std::integral_constant<format_arg, format_arg::character>) {
+    if (spec.is_integer()) return write_integer(out, spec, static_cast<unsigned char>(value), false);
+    write_text(out, spec, &value, 1);
+}
+
+template<typename T>
+constexpr void write_arg(format_writer& out, const format_spec& spec, const T& value,
+                         std::integral_constant<format_arg, format_arg::integer>) {
+    // the magnitude of the most negative value wraps to itself, which is right as an unsigned number
+    const bool negative = std::is_signed<T>::value && value < 0;
+    const auto wide = static_cast<std::uint64_t>(value);
+    write_integer(out, spec, negative ? 0 - wide : wide, negative);
+}
+
+template<typename T>
+constexpr void write_arg(format_writer& out, const format_spec& spec, const T& value,
+                         std::integral_constant<format_arg, format_arg::floating>) {
+    write_floating(out, spec, value);
+}
+
+constexpr void write_arg(format_writer& out, const format_spec& spec, const char* value,
+                         std::integral_constant<format_arg, format_arg::string>) {
+    write_text(out, spec, value, c_string_length(value));
+}
+
+template<std::size_t N>
+constexpr void write_arg(format_writer& out, const format_spec& spec, const string<N>& value,
+                         std::integral_constant<format_arg, format_arg::string>) {
+    write_text(out, spec, value.c_str(), N);
+}
+
+template<typename StringLike,
+         typename = decltype(std::declval<const StringLike&>().data(), std::declval<const StringLike&>().size())>
+constexpr void write_arg(format_writer& out, const format_spec& spec, const StringLike& value,
+                         std::integral_constant<format_arg, format_arg::string>) {
+    write_text(out, spec, value.data(), value.size());
+}
+
+template<typename T>
+constexpr void write_arg(format_writer& out, const format_spec& spec, const T& value) {
+    write_arg(out, spec, value, std::integral_constant<format_arg, format_arg_of<std::decay_t<T>>::value>{});
+}
+
+// resize_and_overwrite() operation that appends a formatted message after what's already in the buffer
+template<typename Formatter, typename... Args>
+struct format_append {
+    const Formatter& formatter;
+    std::size_t from;
+    std::tuple<const Args&...> args;
+
+    constexpr std::size_t operator()(char* data, std::size_t capacity) const {
+        return from + call(data + from, capacity - from, std::index_sequence_for<Args...>{});
+    }
+
+    template<std::size_t... Indices>
+    constexpr std::size_t call(char* data, std::size_t capacity, std::index_sequence<Indices...>) const {
+        return formatter.format_to(data, capacity, std::get<Indices>(args)...);
+    }
+};
+
+}
+
+template<std::size_t N, std::uint64_t Signature>
+class formatter;
+
+// A parsed format string: the first step of building a cx::formatter. C++14 can't take a string as a template
+// argument, so the placeholders' types can only reach the call sites' static_asserts as a number: signature() packs
+// the placeholder count and what each one accepts, and compile<signature()>() makes the formatter that checks them.
+template<std::size_t N>
+class format_builder {
+public:
+    using size_type = std::size_t;
+
+    constexpr format_builder(const char* pattern, size_type length) {
+        size_type i = 0;
+        while (i < length) {
+            const char c = pattern[i];
+            if (c == '{' && i + 1 < length && pattern[i + 1] == '{') {
+                text_[size_++] = '{';
+                i += 2;
+            } else if (c == '{') {
+                if (count_ == detail::kMaxFormatArgs) throw std::length_error("cx::format: too many placeholders");
+                ends_[count_] = size_;
+                i = detail::parse_format_spec(pattern, length, i + 1, specs_[count_]);
+                ++count_;
+            } else if (c == '}') {
+                if (i + 1 == length || pattern[i + 1] != '}') throw std::invalid_argument("cx::format: unmatched '}'");
+                text_[size_++] = '}';
+                i += 2;
+            } else {
+                text_[size_++] = c;
+                ++i;
+            }
+        }
+        ends_[count_] = size_;
+    }
+
+    template<std::uint64_t Signature>
+    constexpr formatter<N, Signature> compile() const {
+        return formatter<N, Signature>(*this);
+    }
+
+    // the placeholder count in the low byte, then two bits per placeholder for what it accepts
+    constexpr std::uint64_t signature() const noexcept {
+        std::uint64_t signature = count_;
+        for (size_type i = 0; i < count_; ++i) signature |= specs_[i].kind() << (8 + 2 * i);
+        return signature;
+    }
+
+    // capacity
+    constexpr size_type arg_count() const noexcept { return count_; }
+    // the literal text, with {{ and }} unescaped
+    constexpr size_type text_size() const noexcept { return size_; }
+
+private:
+    template<std::size_t, std::uint64_t>
+    friend class formatter;
+
+    // the text between placeholders, back to back; segment i ends at ends_[i] and is followed by placeholder i
+    char text_[N + 1]{};
+    size_type ends_[detail::kMaxFormatArgs + 1]{};
+    detail::format_spec specs_[detail::kMaxFormatArgs]{};
+    size_type size_{};
+    size_type count_{};
+};
+
+// A format string checked and split up during constant evaluation, which writes into a caller's buffer without
+// allocating. Placeholders are {} or {:[align][0][width][.precision][type]}, and {{ and }} are literal braces:
+//
+//     type   accepts                       prints
+//     none   anything below                the value like std::to_chars, bools as true or false
+//     d      integers, chars, bools        decimal
+//     x X    integers, chars, bools        hex, lower or upper case
+//     o b    integers, chars, bools        octal or binary
+//     f      float, double                 fixed, 6 digits after the point unless .precision says otherwise
+//     e      float, double                 scientific, shortest digits
+//     s      strings, chars, bools         text
+//
+// Strings are const char*, cx::string and anything with data() and size() (std::string_view, std::string,
+// cx::inline_string). The width pads numbers on the left, after any sign when it starts with 0, and text on the right;
+// '<' or '>' overrides that. The argument count and types are checked with static_asserts.
+//
+// Integers are written two digits at a time from a table, and floats with Ryu, whose tables are built during constant
+// evaluation, so their shortest forms are the ones std::to_chars prints; fixed output is exactly rounded like printf.
+// format_to() fills a char buffer and throws std::length_error if it's too small, append_to() appends to an
+// inline_string and format<C>() returns one. Everything works during constant evaluation, where compact() turns the
+// result into a cx::string:
+//
+//     constexpr auto kLineBuilder = cx::make_format(cx::lit("requests{{host=\"{}\"}} {} {:.3f}\n"));
+//     constexpr auto kLine = kLineBuilder.compile<kLineBuilder.signature()>();
+//     char buffer[256];
+//     const std::size_t size = kLine.format_to(buffer, sizeof(buffer), host, count, seconds);
+//
+//     constexpr auto kMessage = kLine.format<64>("example.com", 3, 0.25);
+//     constexpr auto kCompact = kMessage.compact<kMessage.size()>();
+template<std::size_t N, std::uint64_t Signature>
+class formatter {
+public:
+    // a bunch of typedefs
+    using size_type = std::size_t;
+
+    // constructors and assignment
+    constexpr explicit formatter(const format_builder<N>& builder) {
+        if (builder.signature() != Signature) throw std::invalid_argument("cx::format: wrong signature");
+        for (size_type i = 0; i < builder.size_; ++i) text_[i] = builder.text_[i];
+        for (size_type i = 0; i <= kCount; ++i) ends_[i] = builder.ends_[i];
+        for (size_type i = 0; i < kCount; ++i) specs_[i] = builder.specs_[i];
+    }
+
+    constexpr formatter(const formatter&) = default;
+    constexpr formatter(formatter&&) noexcept = default;
+
+    constexpr formatter& operator=(const formatter&) = default;
+    constexpr formatter& operator=(formatter&&) noexcept = default;
+
+    // capacity
+    constexpr size_type arg_count() const noexcept { return kCount; }
+    constexpr size_type text_size() const noexcept { return ends_[kCount]; }
+
+    // formatting: writes into data[0, capacity) and returns the size written; no null terminator is added
+    template<typename... Args>
+    constexpr size_type format_to(char* data, size_type capacity, const Args&... args) const {
+        static_assert(sizeof...(Args) == kCount, "cx::format: wrong number of arguments");
+        detail::format_writer out{data, capacity, 0};
+        write(out, std::index_sequence_for<Args...>{}, args...);
+        return out.size;
+    }
+
+    template<std::size_t Capacity, typename... Args>
+    constexpr inline_string<Capacity>& append_to(inline_string<Capacity>& str, const Args&... args) const {
+        const std::tuple<const Args&...> tied(args...);
+        str.resize_and_overwrite(Capacity, detail::format_append<formatter, Args...>{*this, str.size(), tied});
+        return str;
+    }
+
+    template<std::size_t Capacity, typename... Args>
+    constexpr inline_string<Capacity> format(const Args&... args) const {
+        inline_string<Capacity> str;
+        append_to(str, args...);
+        return str;
+    }
+
+private:
+    static constexpr size_type kCount = Signature & 0xff;
+
+    char text_[N + 1]{};
+    size_type ends_[kCount + 1]{};
+    detail::format_spec specs_[kCount + 1]{};
+
+    template<std::size_t... Indices, typename... Args>
+    constexpr void write(detail::format_writer& out, std::index_sequence<Indices...>, const Args&... args) const {
+        const bool checked[] = {true, detail::format_arg_check<Signature, Indices, Args>::value...};
+        static_cast<void>(checked);
+        // segment i then argument i, in order (braced lists are evaluated left to right)
+        const int written[] = {0, (write_segment(out, Indices), detail::write_arg(out, specs_[Indices], args), 0)...};
+        static_cast<void>(written);
+        write_segment(out, kCount);
+    }
+
+    constexpr void write_segment(detail::format_writer& out, size_type i) const {
+        const size_type begin = i == 0 ? 0 : ends_[i - 1];
+        out.write(text_ + begin, ends_[i] - begin);
+    }
+};
+
+// definition of the static constexpr member (needed before C++17)
+template<std::size_t N, std::uint64_t Signature>
+constexpr typename formatter<N, Signature>::size_type formatter<N, Signature>::kCount;
+
+// Parses a string literal or cx::string format string; see formatter for the syntax and format_builder for how to
+// compile it.
+template<std::size_t M>
+constexpr format_builder<M> make_format(const string<M>& pattern) {
+    return format_builder<M>(pattern.c_str(), M);
+}
+
+template<std::size_t M>
+constexpr format_builder<M - 1> make_format(const char (&pattern)[M]) {
+    return format_builder<M - 1>(pattern, M - 1);
+}
+
+}
@@ -0,0 +1,424 @@
+// Copyright (c) 2020. Mohit Deshpande.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+// the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "cx/cx_pair.h"
+#include "cx/cx_hash.h"
+#include "cx/cx_perfect_map.h"
+#include "cx/cx_string.h"
+
+#include <stdexcept>
+
+namespace cx {
+
+namespace detail {
+
+// Target keys per partition of a frozen_map. Each partition is an independent minimal perfect hash, small enough for
+// its build scratch to stay in cache, and partitions are what the parallel build hands out to threads.
+constexpr std::size_t kFreezePartitionSize = std::size_t{1} << 16;
+
+constexpr std::uint32_t freeze_partition(std::uint64_t h, std::size_t partitions) noexcept {
+    // the low half of the hash, since pmh_bucket() already uses the high half inside the partition
+    return fastrange32(static_cast<std::uint32_t>(h), static_cast<std::uint32_t>(partitions));
+}
+
+constexpr std::size_t align_up(std::size_t n, std::size_t alignment) noexcept {
+    return (n + alignment - 1) / alignment * alignment;
+}
+
+// the characters of a std::string key held some other way: a C string, or anything with data() and size()
+inline string_ref string_key(const char* key) noexcept { return string_ref(key, std::strlen(key)); }
+
+template<typename StringLike,
+         typename = decltype(std::declval<const StringLike&>().data(), std::declval<const StringLike&>().size())>
+string_ref string_key(const StringLike& key) noexcept { return string_ref(key.data(), key.size()); }
+
+// enables frozen_map's lookups of std::string keys by K, which need Hash to hash a string_ref too
+template<typename Key, typename Hash, typename K, typename = void>
+struct frozen_string_lookup {};
+
+template<typename Hash, typename K>
+struct frozen_string_lookup<std::string, Hash, K,
+                            decltype(std::declval<const Hash&>()(string_key(std::declval<const K&>())), void())> {
+    using type = void;
+};
+
+}
+
+// Immutable hash map built at runtime, for tables that are only known at startup. It uses the cx::perfect_map layout
+// and lookup: keys are split into partitions of about 64k by hash, and each partition is a minimal perfect hash with
+// the same pilots and slot order that cx::perfect_map computes at compile time (a table with a single partition is
+// laid out exactly like the equivalent cx::perfect_map). Entries, pilots and partition offsets live in one allocation.
+//
+// Partitions are built independently, so construction can use several threads. std::string keys can be looked up by
+// C string or by anything with data() and size() without building a std::string, as long as Hash also hashes a
+// cx::string_ref (the default cx::hash<std::string> does):
+//
+//     auto prices = cx::freeze(load_prices(), std::thread::hardware_concurrency());
+//     prices.at("AAPL");
+template<typename Key, typename T, typename Hash = cx::hash<Key>>
+class frozen_map {
+public:
+    // a bunch of typedefs
+    using key_type = Key;
+    using mapped_type = T;
+    using value_type = cx::pair<const Key, const T>;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using hasher = Hash;
+    using reference = value_type&;
+    using const_reference = const value_type&;
+    using pointer = value_type*;
+    using const_pointer = const value_type*;
+    using iterator = const value_type*;
+    using const_iterator = const value_type*;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    static_assert(alignof(value_type) <= alignof(std::max_align_t), "cx::frozen_map: over-aligned entries");
+
+    // constructors and assignment
+    frozen_map() noexcept = default;
+
+    // [first, last) is read twice, so it has to be a forward range
+    template<typename ForwardIt>
+    frozen_map(ForwardIt first, ForwardIt last, std::size_t threads = 1) {
+        build(first, last, threads);
+    }
+
+    frozen_map(std::initializer_list<value_type> entries, std::size_t threads = 1) {
+        build(entries.begin(), entries.end(), threads);
+    }
+
+    frozen_map(const frozen_map&) = delete;
+    frozen_map(frozen_map&& other) noexcept { swap(other); }
+
+    frozen_map& operator=(const frozen_map&) = delete;
+    frozen_map& operator=(frozen_map&& other) noexcept {
+        frozen_map(std::move(other)).swap(*this);
+        return *this;
+    }
+
+    ~frozen_map() {
+        for (std::size_t i = 0; i < size_; ++i) entries_[i].~value_type();
+    }
+
+    void swap(frozen_map& other) noexcept {
+        std::swap(arena_, other.arena_);
+        std::swap(entries_, other.entries_);
+        std::swap(pilots_, other.pilots_);
+        std::swap(partition_start_, other.partition_start_);
+        std::swap(size_, other.size_);
+        std::swap(partitions_, other.partitions_);
+    }
+
+    // iterators (entries are in slot order)
+    const_iterator begin() const noexcept { return entries_; }
+    const_iterator end() const noexcept { return entries_ + size_; }
+    const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+    const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+    const_iterator cbegin() const noexcept { return begin(); }
+    const_iterator cend() const noexcept { return end(); }
+    const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+    const_reverse_iterator crend() const noexcept { return rend(); }
+
+    // element access
+    const T& at(const Key& key) const {
+        const auto it = find(key);
+        if (it == end()) throw std::out_of_range("cx::frozen_map::at: could not find entry in map");
+        return it->second;
+    }
+
+    const T& operator[](const Key& key) const {
+        return at(key);
+    }
+
+    template<typename K, typename = typename detail::frozen_string_lookup<Key, Hash, K>::type>
+    const T& at(const K& key) const {
+        const auto it = find(key);
+        if (it == end()) throw std::out_of_range("cx::frozen_map::at: could not find entry in map");
+        return it->second;
+    }
+
+    template<typename K, typename = typename detail::frozen_string_lookup<Key, Hash, K>::type>
+    const T& operator[](const K& key) const {
+        return at(key);
+    }
+
+    // capacity
+    bool empty() const noexcept { return size() == 0; }
+    std::size_t size() const noexcept { return size_; }
+    std::size_t max_size() const noexcept { return size_; }
+
+    std::size_t partitions() const noexcept { return partitions_; }
+
+    // raw layout, for serializing the table (see cx_mapped_map.h): pilots()[i] belongs to slot i, and partition p owns
+    // slots [partition_starts()[p], partition_starts()[p + 1])
+    const std::uint32_t* pilots() const noexcept { return pilots_; }
+    const std::size_t* partition_starts() const noexcept { return partition_start_; }
+
+    // lookup
+    const_iterator find(const Key& key) const {
+        return find_hashed(key);
+    }
+
+    template<typename K, typename = typename detail::frozen_string_lookup<Key, Hash, K>::type>
+    const_iterator find(const K& key) const {
+        return find_hashed(detail::string_key(key));
+    }
+
+    size_type count(const Key& key) const {
+        return find(key) == end() ? 0 : 1;
+    }
+
+    template<typename K, typename = typename detail::frozen_string_lookup<Key, Hash, K>::type>
+    size_type count(const K& key) const {
+        return find(key) == end() ? 0 : 1;
+    }
+
+    // Batched find: out[i] = find(keys[i]) for the n keys, returning how many were found. Same group-at-a-time
+    // probing as cx::perfect_map::find_batch(), with the partition lookup folded into the first step.
+    size_type find_batch(const Key* keys, std::size_t n, const_iterator* out) const {
+        size_type found = 0;
+        for (std::size_t first = 0; first < n; first += detail::kBatchGroup) {
+            const std::size_t group = std::min(n - first, detail::kBatchGroup);
+            if (size_ == 0) {
+                std::fill(out + first, out + first + group, end());
+                continue;
+            }
+
+            std::uint64_t hashes[detail::kBatchGroup];
+            std::size_t starts[detail::kBatchGroup];
+            std::size_t widths[detail::kBatchGroup];
+            std::size_t slots[detail::kBatchGroup];
+            for (std::size_t g = 0; g < group; ++g) hashes[g] = Hash{}(keys[first + g]);
+            for (std::size_t g = 0; g < group; ++g) {
+                const std::uint32_t p = detail::freeze_partition(hashes[g], partitions_);
+                starts[g] = partition_start_[p];
+                widths[g] = partition_start_[p + 1] - starts[g];
+                if (widths[g] != 0) detail::prefetch(pilots_ + starts[g] + detail::pmh_bucket(hashes[g], widths[g]));
+            }
+            for (std::size_t g = 0; g < group; ++g) {
+                // an empty partition holds no keys, so this one is a miss (marked by size_)
+                if (widths[g] == 0) {
+                    slots[g] = size_;
+                    continue;
+                }
+                const std::uint32_t pilot = pilots_[starts[g] + detail::pmh_bucket(hashes[g], widths[g])];
+                slots[g] = starts[g] + detail::pmh_slot(hashes[g], pilot, widths[g]);
+                detail::prefetch(entries_ + slots[g]);
+            }
+            for (std::size_t g = 0; g < group; ++g) {
+                const bool hit = slots[g] != size_ && entries_[slots[g]].first == keys[first + g];
+                out[first + g] = hit ? begin() + slots[g] : end();
+                found += hit;
+            }
+        }
+        return found;
+    }
+
+    // out[i] = at(keys[i]) for the n keys; throws std::out_of_range if any of them is missing
+    void at_batch(const Key* keys, std::size_t n, T* out) const {
+        const_iterator its[detail::kBatchGroup];
+        for (std::size_t first = 0; first < n; first += detail::kBatchGroup) {
+            const std::size_t group = std::min(n - first, detail::kBatchGroup);
+            find_batch(keys + first, group, its);
+            for (std::size_t g = 0; g < group; ++g) {
+                if (its[g] == end()) throw std::out_of_range("cx::frozen_map::at_batch: could not find entry in map");
+                out[first + g] = its[g]->second;
+            }
+        }
+    }
+
+    // found[i] = count(keys[i]) != 0 for the n keys, returning how many were found
+    size_type count_batch(const Key* keys, std::size_t n, bool* found) const {
+        const_iterator its[detail::kBatchGroup];
+        size_type hits = 0;
+        for (std::size_t first = 0; first < n; first += detail::kBatchGroup) {
+            const std::size_t group = std::min(n - first, detail::kBatchGroup);
+            hits += find_batch(keys + first, group, its);
+            for (std::size_t g = 0; g < group; ++g) found[first + g] = its[g] != end();
+        }
+        return hits;
+    }
+
+private:
+    std::unique_ptr<unsigned char[]> arena_;
+    value_type* entries_ = nullptr;
+    std::uint32_t* pilots_ = nullptr;
+    std::size_t* partition_start_ = nullptr;
+    std::size_t size_ = 0;
+    std::size_t partitions_ = 0;
+
+    template<typename Lookup>
+    const_iterator find_hashed(const Lookup& key) const {
+        if (size_ == 0) return end();
+        const std::uint64_t h = Hash{}(key);
+        const std::uint32_t p = detail::freeze_partition(h, partitions_);
+        const std::size_t first = partition_start_[p];
+        const std::size_t n = partition_start_[p + 1] - first;
+        if (n == 0) return end();
+        const std::size_t slot = first + detail::pmh_slot(h, pilots_[first + detail::pmh_bucket(h, n)], n);
+        return same_key(entries_[slot].first, key) ? begin() + slot : end();
+    }
+
+    static bool same_key(const Key& a, const Key& b) { return a == b; }
+    static bool same_key(const std::string& a, string_ref b) noexcept { return string_ref(a.data(), a.size()) == b; }
+
+    template<typename ForwardIt>
+    void build(ForwardIt first, ForwardIt last, std::size_t threads) {
+        const auto n = static_cast<std::size_t>(std::distance(first, last));
+        if (n == 0) return;
+        if (n >= detail::kPmhDirectSlot) throw std::length_error("cx::frozen_map: too many entries");
+        const std::size_t partitions = (n + detail::kFreezePartitionSize - 1) / detail::kFreezePartitionSize;
+        threads = std::max<std::size_t>(1, std::min(threads, partitions));
+
+        std::vector<std::uint64_t> hashes(n);
+        {
+            std::size_t i = 0;
+            for (auto it = first; it != last; ++it) hashes[i++] = Hash{}(it->first);
+        }
+
+        // counting sort of the keys by partition; partition_hashes and partition_items are in that order
+        std::vector<std::size_t> partition_start(partitions + 1, 0);
+        for (std::size_t i = 0; i < n; ++i) ++partition_start[detail::freeze_partition(hashes[i], partitions) + 1];
+        for (std::size_t p = 0; p < partitions; ++p) partition_start[p + 1] += partition_start[p];
+        std::vector<std::uint64_t> partition_hashes(n);
+        std::vector<std::size_t> partition_items(n);
+        {
+            std::vector<std::size_t> cursor(partition_start.begin(), partition_start.end() - 1);
+            for (std::size_t i = 0; i < n; ++i) {
+                const std::size_t at = cursor[detail::freeze_partition(hashes[i], partitions)]++;
+                partition_hashes[at] = hashes[i];
+                partition_items[at] = i;
+            }
+        }
+        std::vector<std::uint64_t>().swap(hashes);
+
+        // each partition is an independent pmh_build over its slice; slot_of[i] is where input entry i goes
+        std::vector<std::uint32_t> pilots(n);
+        std::vector<std::size_t> slot_of(n);
+        std::vector<detail::pmh_status> status(partitions, detail::pmh_status::ok);
+        std::atomic<std::size_t> next_partition{0};
+        // an exception in a worker (say, bad_alloc for its scratch) is kept for the calling thread to rethrow, and
+        // stops the other workers from taking more partitions
+        std::vector<std::exception_ptr> failures(threads);
+        auto build_partitions = [&] {
+            std::vector<std::size_t> order, bucket_start, bucket_items;
+            std::unique_ptr<bool[]> taken;
+            std::size_t scratch_size = 0;
+            for (std::size_t p; (p = next_partition.fetch_add(1)) < partitions;) {
+                const std::size_t begin = partition_start[p];
+                const std::size_t size = partition_start[p + 1] - begin;
+                if (size > scratch_size) {
+                    scratch_size = size;
+                    order.resize(size);
+                    bucket_start.resize(size + 1);
+                    bucket_items.resize(size);
+                    taken.reset(new bool[size]);
+                }
+                status[p] = detail::pmh_build(partition_hashes.data() + begin, size, pilots.data() + begin,
+                                              order.data(), bucket_start.data(), bucket_items.data(), taken.get());
+                if (status[p] != detail::pmh_status::ok) continue;
+                for (std::size_t slot = 0; slot < size; ++slot) slot_of[partition_items[begin + order[slot]]] = begin + slot;
+            }
+        };
+        auto worker = [&](std::size_t t) {
+            try {
+                build_partitions();
+            } catch (...) {
+                failures[t] = std::current_exception();
+                next_partition = partitions;
+            }
+        };
+        std::vector<std::thread> pool;
+        pool.reserve(threads - 1);
+        try {
+            for (std::size_t t = 1; t < threads; ++t) pool.emplace_back(worker, t);
+        } catch (const std::system_error&) {
+            // no more threads to be had: the ones already running and this one share the partitions
+        }
+        worker(0);
+        for (auto& thread : pool) thread.join();
+        for (const auto& failure : failures) {
+            if (failure) std::rethrow_exception(failure);
+        }
+
+        for (const auto s : status) {
+            if (s == detail::pmh_status::duplicate_key) {
+                throw std::invalid_argument("cx::frozen_map: duplicate keys (or a 64-bit hash collision)");
+            }
+            if (s == detail::pmh_status::no_pilot_found) {
+                throw std::invalid_argument("cx::frozen_map: could not find a perfect hash for the keys");
+            }
+        }
+
+        // one allocation: entries, then pilots, then partition offsets
+        const std::size_t pilots_offset = detail::align_up(n * sizeof(value_type), alignof(std::size_t));
+        const std::size_t partition_offset = pilots_offset + detail::align_up(n * sizeof(std::uint32_t), alignof(std::size_t));
+        const std::size_t bytes = partition_offset + (partitions + 1) * sizeof(std::size_t);
+        std::unique_ptr<unsigned char[]> arena(new unsigned char[bytes]);
+        auto* entries = reinterpret_cast<value_type*>(arena.get());
+        auto* pilots_out = reinterpret_cast<std::uint32_t*>(arena.get() + pilots_offset);
+        auto* partition_out = reinterpret_cast<std::size_t*>(arena.get() + partition_offset);
+        std::copy(pilots.begin(), pilots.end(), pilots_out);
+        std::copy(partition_start.begin(), partition_start.end(), partition_out);
+
+        std::size_t constructed = 0;
+        try {
+            for (auto it = first; it != last; ++it, ++constructed) {
+                ::new (static_cast<void*>(entries + slot_of[constructed])) value_type(it->first, it->second);
+            }
+        } catch (...) {
+            for (std::size_t i = 0; i < constructed; ++i) entries[slot_of[i]].~value_type();
+            throw;
+        }
+
+        arena_ = std::move(arena);
+        entries_ = entries;
+        pilots_ = pilots_out;
+        partition_start_ = partition_out;
+        size_ = n;
+        partitions_ = partitions;
+    }
+};
+
+// frozen_map of any forward range of key/value pairs (std::map, std::unordered_map, a std::vector of pairs, ...)
+template<typename Hash = void, typename Range>
+auto freeze(const Range& range, std::size_t threads = 1) {
+    using entry_type = typename std::iterator_traits<decltype(std::begin(range))>::value_type;
+    using key_type = std::remove_const_t<decltype(std::declval<entry_type>().first)>;
+    using mapped_type = std::remove_const_t<decltype(std::declval<entry_type>().second)>;
+    using hasher = std::conditional_t<std::is_void<Hash>::value, cx::hash<key_type>, Hash>;
+    return frozen_map<key_type, mapped_type, hasher>(std::begin(range), std::end(range), threads);
+}
+
+}
@@ -0,0 +1,160 @@
+// Copyright (c) 2020. Mohit Deshpande.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+// the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace cx {
+
+namespace detail {
+
+// splitmix64 finalizer: cheap, constexpr-friendly and good enough avalanche for table hashing
+constexpr std::uint64_t mix64(std::uint64_t x) noexcept {
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+}
+
+// maps a 32-bit hash uniformly onto [0, n) with a multiply instead of a modulo (Lemire's "fastrange")
+constexpr std::uint32_t fastrange32(std::uint32_t x, std::uint32_t n) noexcept {
+    return static_cast<std::uint32_t>((static_cast<std::uint64_t>(x) * n) >> 32);
+}
+
+// full 64x64 -> 128-bit multiply, returned as (lo, hi) through the arguments
+constexpr void mum(std::uint64_t& a, std::uint64_t& b) noexcept {
+#if defined(__SIZEOF_INT128__)
+    const unsigned __int128 r = static_cast<unsigned __int128>(a) * b;
+    a = static_cast<std::uint64_t>(r);
+    b = static_cast<std::uint64_t>(r >> 64);
+#else
+    const std::uint64_t ha = a >> 32, hb = b >> 32, la = static_cast<std::uint32_t>(a), lb = static_cast<std::uint32_t>(b);
+    const std::uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb, t = rl + (rm0 << 32);
+    std::uint64_t c = t < rl;
+    const std::uint64_t lo = t + (rm1 << 32);
+    c += lo < t;
+    a = lo;
+    b = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+#endif
+}
+
+constexpr std::uint64_t mum_mix(std::uint64_t a, std::uint64_t b) noexcept {
+    mum(a, b);
+    return a ^ b;
+}
+
+// little-endian reads assembled from bytes so they work during constant evaluation; compilers fuse them into loads
+constexpr std::uint64_t read_le(const char* p, std::size_t bytes) noexcept {
+    std::uint64_t v = 0;
+    for (std::size_t i = 0; i < bytes; ++i) v |= static_cast<std::uint64_t>(static_cast<unsigned char>(p[i])) << (8 * i);
+    return v;
+}
+
+constexpr std::uint64_t read64(const char* p) noexcept { return read_le(p, 8); }
+constexpr std::uint64_t read32(const char* p) noexcept { return read_le(p, 4); }
+
+constexpr std::uint64_t kWyp0 = 0xa0761d6478bd642fULL;
+constexpr std::uint64_t kWyp1 = 0xe7037ed1a0b428dbULL;
+constexpr std::uint64_t kWyp2 = 0x8ebc6af09c88c6e3ULL;
+constexpr std::uint64_t kWyp3 = 0x589965cc75374cc3ULL;
+
+}
+
+constexpr std::uint64_t kFnv1aOffset = 0xcbf29ce484222325ULL;
+constexpr std::uint64_t kFnv1aPrime = 0x100000001b3ULL;
+
+// 64-bit FNV-1a: one multiply per byte, best for very short keys
+constexpr std::uint64_t fnv1a(const char* data, std::size_t size, std::uint64_t basis = kFnv1aOffset) noexcept {
+    std::uint64_t h = basis;
+    for (std::size_t i = 0; i < size; ++i) {
+        h ^= static_cast<unsigned char>(data[i]);
+        h *= kFnv1aPrime;
+    }
+    return h;
+}
+
+template<std::size_t N>
+constexpr std::uint64_t fnv1a(const char (&value)[N]) noexcept {
+    return fnv1a(value, N - 1);
+}
+
+// wyhash (final4 construction): 8-16 bytes per 64x64 -> 128-bit multiply, for anything past a handful of bytes
+constexpr std::uint64_t wyhash(const char* data, std::size_t size, std::uint64_t seed = 0) noexcept {
+    using namespace detail;
+    const char* p = data;
+    seed ^= mum_mix(seed ^ kWyp0, kWyp1);
+    std::uint64_t a = 0, b = 0;
+    if (size <= 16) {
+        if (size >= 4) {
+            const std::size_t shift = (size >> 3) << 2;
+            a = (read32(p) << 32) | read32(p + shift);
+            b = (read32(p + size - 4) << 32) | read32(p + size - 4 - shift);
+        } else if (size > 0) {
+            a = (static_cast<std::uint64_t>(static_cast<unsigned char>(p[0])) << 16)
+                | (static_cast<std::uint64_t>(static_cast<unsigned char>(p[size >> 1])) << 8)
+                | static_cast<unsigned char>(p[size - 1]);
+        }
+    } else {
+        std::size_t i = size;
+        if (i > 48) {
+            std::uint64_t see1 = seed, see2 = seed;
+            do {
+                seed = mum_mix(read64(p) ^ kWyp1, read64(p + 8) ^ seed);
+                see1 = mum_mix(read64(p + 16) ^ kWyp2, read64(p + 24) ^ see1);
+                see2 = mum_mix(read64(p + 32) ^ kWyp3, read64(p + 40) ^ see2);
+                p += 48;
+                i -= 48;
+            } while (i > 48);
+            seed ^= see1 ^ see2;
+        }
+        while (i > 16) {
+            seed = mum_mix(read64(p) ^ kWyp1, read64(p + 8) ^ seed);
+            i -= 16;
+            p += 16;
+        }
+        a = read64(p + i - 16);
+        b = read64(p + i - 8);
+    }
+    a ^= kWyp1;
+    b ^= seed;
+    mum(a, b);
+    return mum_mix(a ^ kWyp0 ^ size, b ^ kWyp1);
+}
+
+template<std::size_t N>
+constexpr std::uint64_t wyhash(const char (&value)[N], std::uint64_t seed = 0) noexcept {
+    return wyhash(value, N - 1, seed);
+}
+
+// constexpr hash functor used by the hashed containers; specialize it to support other key types
+template<typename Key, typename Enable = void>
+struct hash {
+    static_assert(sizeof(Key) == 0, "Must specialize cx::hash for this key type");
+};
+
+// integral and enum keys
+template<typename Key>
+struct hash<Key, std::enable_if_t<std::is_integral<Key>::value || std::is_enum<Key>::value>> {
+    constexpr std::uint64_t operator()(const Key& key, std::uint64_t seed = 0) const noexcept {
+        return detail::mix64(static_cast<std::uint64_t>(key) + seed + 0x9e3779b97f4a7c15ULL);
+    }
+};
+
+}
@@ -0,0 +1,438 @@
+// Copyright (c) 2020. Mohit Deshpande.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+// the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <string>
+#include <utility>
+
+#include "cx/cx_config.h"
+#include "cx/cx_hash.h"
+#include "cx/cx_string.h"
+
+#include <stdexcept>
+
+namespace cx {
+
+namespace detail {
+
+// memcpy at runtime, a loop during constant evaluation
+constexpr void copy_chars(char* dst, const char* src, std::size_t n) noexcept {
+    if (!CX_IS_CONSTANT_EVALUATED()) {
+        if (n) std::memcpy(dst, src, n);
+        return;
+    }
+    for (std::size_t i = 0; i < n; ++i) dst[i] = src[i];
+}
+
+// memmove at runtime, a forward loop during constant evaluation: dst may overlap src if it doesn't start after it
+constexpr void move_chars(char* dst, const char* src, std::size_t n) noexcept {
+    if (!CX_IS_CONSTANT_EVALUATED()) {
+        if (n) std::memmove(dst, src, n);
+        return;
+    }
+    for (std::size_t i = 0; i < n; ++i) dst[i] = src[i];
+}
+
+// <0, 0 or >0 like std::string::compare, bytes compared as unsigned char
+constexpr int compare_chars(const char* a, std::size_t a_size, const char* b, std::size_t b_size) noexcept {
+    const std::size_t n = a_size < b_size ? a_size : b_size;
+    for (std::size_t i = 0; i < n; ++i) {
+        const auto x = static_cast<unsigned char>(a[i]);
+        const auto y = static_cast<unsigned char>(b[i]);
+        if (x != y) return x < y ? -1 : 1;
+    }
+    return a_size == b_size ? 0 : (a_size < b_size ? -1 : 1);
+}
+
+constexpr bool equal_chars(const char* a, std::size_t a_size, const char* b, std::size_t b_size) noexcept {
+    if (a_size != b_size) return false;
+    if (!CX_IS_CONSTANT_EVALUATED()) return a_size == 0 || std::memcmp(a, b, a_size) == 0;
+    for (std::size_t i = 0; i < a_size; ++i) {
+        if (a[i] != b[i]) return false;
+    }
+    return true;
+}
+
+}
+
+// A mutable string of up to Capacity characters, stored inline with its runtime length, that never allocates. It is the
+// runtime companion of cx::string<N>: build and edit one in a hot path (append, +=, resize, substr) where a std::string
+// would call malloc. Growing past Capacity throws std::length_error. It compares with and concatenates to cx::strings,
+// string literals, other inline_strings and anything with data() and size() (std::string_view, cx::string_ref), and
+// everything works during constant evaluation.
+//
+//     cx::inline_string<64> line{"GET "};
+//     line += path;
+//     line += cx::lit(" HTTP/1.1");
+template<std::size_t Capacity>
+class inline_string {
+public:
+    // a bunch of typedefs
+    using value_type = char;
+    using pointer = char*;
+    using const_pointer = const char*;
+    using reference = char&;
+    using const_reference = const char&;
+    using iterator = char*;
+    using const_iterator = const char*;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    static constexpr size_type npos = static_cast<size_type>(-1);
+
+    // constructors and assignment
+    constexpr inline_string() noexcept = default;
+
+    constexpr inline_string(const char* data, size_type size) { append(data, size); }
+
+    constexpr inline_string(size_type count, char c) { append(count, c); }
+
+    template<std::size_t M>
+    constexpr inline_string(const char (&str)[M]) noexcept {
+        static_assert(M - 1 <= Capacity, "cx::inline_string: literal is longer than the capacity");
+        detail::copy_chars(str_, str, M - 1);
+        size_ = M - 1;
+    }
+
+    template<std::size_t N>
+    constexpr inline_string(const string<N>& str) noexcept {
+        static_assert(N <= Capacity, "cx::inline_string: cx::string is longer than the capacity");
+        detail::copy_chars(str_, str.c_str(), N);
+        size_ = N;
+    }
+
+    // from a smaller or larger inline_string; throws if the contents don't fit
+    template<std::size_t OtherCapacity>
+    constexpr inline_string(const inline_string<OtherCapacity>& str) { append(str.data(), str.size()); }
+
+    // std::string_view, std::string, cx::string_ref and anything else with data() and size()
+    template<typename StringLike,
+             typename = decltype(std::declval<const StringLike&>().data(), std::declval<const StringLike&>().size())>
+    constexpr explicit inline_string(const StringLike& str) { append(str.data(), str.size()); }
+
+    constexpr inline_string(const inline_string&) = default;
+    constexpr inline_string& operator=(const inline_string&) = default;
+
+    template<typename String>
+    constexpr inline_string& operator=(const String& str) { return assign(str); }
+
+    // iterators
+    constexpr iterator begin() noexcept { return str_; }
+    constexpr const_iterator begin() const noexcept { return str_; }
+    constexpr iterator end() noexcept { return str_ + size_; }
+    constexpr const_iterator end() const noexcept { return str_ + size_; }
+    constexpr const_iterator cbegin() const noexcept { return begin(); }
+    constexpr const_iterator cend() const noexcept { return end(); }
+    constexpr reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+    constexpr const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+    constexpr reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+    constexpr const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+
+    // element access
+    constexpr reference operator[](size_type i) noexcept { return str_[i]; }
+    constexpr const_reference operator[](size_type i) const noexcept { return str_[i]; }
+    constexpr const_reference at(size_type i) const {
+        if (i >= size_) throw_out_of_range("cx::inline_string::at: index out of range");
+        return str_[i];
+    }
+
+    constexpr reference front() noexcept { return str_[0]; }
+    constexpr const_reference front() const noexcept { return str_[0]; }
+    constexpr reference back() noexcept { return str_[size_ - 1]; }
+    constexpr const_reference back() const noexcept { return str_[size_ - 1]; }
+    constexpr pointer data() noexcept { return str_; }
+    constexpr const_pointer data() const noexcept { return str_; }
+    constexpr const_pointer c_str() const noexcept { return str_; }
+
+    // capacity
+    constexpr size_type size() const noexcept { return size_; }
+    constexpr size_type length() const noexcept { return size_; }
+    constexpr bool empty() const noexcept { return size_ == 0; }
+    constexpr size_type capacity() const noexcept { return Capacity; }
+    constexpr size_type max_size() const noexcept { return Capacity; }
+
+    // modifiers
+    constexpr void clear() noexcept { set_size(0); }
+
+    constexpr void push_back(char c) {
+        if (size_ == Capacity) throw_length_error();
+        str_[size_] = c;
+        set_size(size_ + 1);
+    }
+
+    constexpr void pop_back() noexcept { set_size(size_ - 1); }
+
+    // replaces the contents; str may view this string's own characters, as in s = cx::string_ref(s.data() + 2, 3)
+    constexpr inline_string& assign(const char* data, size_type size) {
+        if (size > Capacity) throw_length_error();
+        detail::move_chars(str_, data, size);
+        set_size(size);
+        return *this;
+    }
+
+    template<std::size_t M>
+    constexpr inline_string& assign(const char (&str)[M]) { return assign(str, M - 1); }
+
+    template<std::size_t N>
+    constexpr inline_string& assign(const string<N>& str) { return assign(str.c_str(), N); }
+
+    template<typename StringLike,
+             typename = decltype(std::declval<const StringLike&>().data(), std::declval<const StringLike&>().size())>
+    constexpr inline_string& assign(const StringLike& str) { return assign(str.data(), str.size()); }
+
+    constexpr inline_string& append(const char* data, size_type size) {
+        if (size > Capacity - size_) throw_length_error();
+        detail::copy_chars(str_ + size_, data, size);
+        set_size(size_ + size);
+        return *this;
+    }
+
+    constexpr inline_string& append(size_type count, char c) {
+        if (count > Capacity - size_) throw_length_error();
+        for (size_type i = 0; i < count; ++i) str_[size_ + i] = c;
+        set_size(size_ + count);
+        return *this;
+    }
+
+    template<std::size_t M>
+    constexpr inline_string& append(const char (&str)[M]) { return append(str, M - 1); }
+
+    template<std::size_t N>
+    constexpr inline_string& append(const string<N>& str) { return append(str.c_str(), N); }
+
+    template<typename StringLike,
+             typename = decltype(std::declval<const StringLike&>().data(), std::declval<const StringLike&>().size())>
+    constexpr inline_string& append(const StringLike& str) { return append(str.data(), str.size()); }
+
+    template<typename String>
+    constexpr inline_string& operator+=(const String& str) { return append(str); }
+
+    constexpr inline_string& operator+=(char c) {
+        push_back(c);
+        return *this;
+    }
+
+    // grows with c or truncates to count characters
+    constexpr void resize(size_type count, char c = '\0') {
+        if (count > Capacity) throw_length_error();
+        for (size_type i = size_; i < count; ++i) str_[i] = c;
+        set_size(count);
+    }
+
+    // like C++23's std::string::resize_and_overwrite: op(data(), count) writes into the buffer, whose first
+    // min(size(), count) characters are kept, and returns the new size, at most count. If op throws or returns more
+    // than count, the string keeps its size and is null-terminated there again.
+    template<typename Operation>
+    constexpr void resize_and_overwrite(size_type count, Operation op) {
+        if (count > Capacity) throw_length_error();
+        const size_type size = CX_IS_CONSTANT_EVALUATED() ? op(str_, count) : overwrite(count, op);
+        if (size > count) {
+            set_size(size_);
+            throw_length_error();
+        }
+        set_size(size);
+    }
+
+    // operations
+    constexpr inline_string substr(size_type pos = 0, size_type count = npos) const {
+        if (pos > size_) throw_out_of_range("cx::inline_string::substr: position out of range");
+        inline_string out;
+        const size_type n = count < size_ - pos ? count : size_ - pos;
+        detail::copy_chars(out.str_, str_ + pos, n);
+        out.set_size(n);
+        return out;
+    }
+
+    constexpr int compare(string_ref other) const noexcept {
+        return detail::compare_chars(str_, size_, other.data(), other.size());
+    }
+
+    constexpr size_type find(char c, size_type pos = 0) const noexcept {
+        for (size_type i = pos; i < size_; ++i) {
+            if (str_[i] == c) return i;
+        }
+        return npos;
+    }
+
+    // conversions
+    constexpr operator string_ref() const noexcept { return string_ref(str_, size_); }
+    std::string str() const { return std::string(str_, size_); }
+
+    // the contents as a cx::string of exactly N characters, e.g. s.compact<s.size()>() on a constexpr inline_string
+    template<std::size_t N>
+    constexpr string<N> compact() const {
+        if (N != size_) throw std::length_error("cx::inline_string::compact: wrong size");
+        return string<N>(str_, detail::copy_tag{});
+    }
+
+private:
+    // always null-terminated, so c_str() is just the buffer
+    char str_[Capacity + 1]{};
+    size_type size_{};
+
+    template<std::size_t OtherCapacity>
+    friend class inline_string;
+
+    constexpr void set_size(size_type size) noexcept {
+        size_ = size;
+        str_[size_] = '\0';
+    }
+
+    // op(str_, count) at runtime, putting back the terminator op may have written over if it throws
+    template<typename Operation>
+    size_type overwrite(size_type count, Operation& op) {
+        try {
+            return op(str_, count);
+        } catch (...) {
+            set_size(size_);
+            throw;
+        }
+    }
+
+    constexpr void throw_length_error() const {
+        throw std::length_error("cx::inline_string: capacity exceeded");
+    }
+
+    constexpr void throw_out_of_range(const char* what) const {
+        throw std::out_of_range(what);
+    }
+};
+
+// definition of the static constexpr member (needed before C++17)
+template<std::size_t Capacity>
+constexpr typename inline_string<Capacity>::size_type inline_string<Capacity>::npos;
+
+// comparisons with other inline_strings, cx::strings, string literals and anything with data() and size()
+template<std::size_t C1, std::size_t C2>
+constexpr bool operator==(const inline_string<C1>& lhs, const inline_string<C2>& rhs) noexcept {
+    return detail::equal_chars(lhs.data(), lhs.size(), rhs.data(), rhs.size());
+}
+
+template<std::size_t C, std::size_t N>
+constexpr bool operator==(const inline_string<C>& lhs, const string<N>& rhs) noexcept {
+    return detail::equal_chars(lhs.data(), lhs.size(), rhs.c_str(), N);
+}
+
+template<std::size_t C, std::size_t N>
+constexpr bool operator==(const string<N>& lhs, const inline_string<C>& rhs) noexcept { return rhs == lhs; }
+
+template<std::size_t C, std::size_t M>
+constexpr bool operator==(const inline_string<C>& lhs, const char (&rhs)[M]) noexcept {
+    return detail::equal_chars(lhs.data(), lhs.size(), rhs, M - 1);
+}
+
+template<std::size_t C, std::size_t M>
+constexpr bool operator==(const char (&lhs)[M], const inline_string<C>& rhs) noexcept { return rhs == lhs; }
+
+template<std::size_t C, typename StringLike,
+         typename = decltype(std::declval<const StringLike&>().data(), std::declval<const StringLike&>().size())>
+constexpr bool operator==(const inline_string<C>& lhs, const StringLike& rhs) noexcept {
+    return detail::equal_chars(lhs.data(), lhs.size(), rhs.data(), rhs.size());
+}
+
+template<std::size_t C, typename StringLike,
+         typename = decltype(std::declval<const StringLike&>().data(), std::declval<const StringLike&>().size())>
+constexpr bool operator==(const StringLike& lhs, const inline_string<C>& rhs) noexcept { return rhs == lhs; }
+
+template<std::size_t C, typename Other>
+constexpr bool operator!=(const inline_string<C>& lhs, const Other& rhs) noexcept { return !(lhs == rhs); }
+
+template<std::size_t C, typename Other>
+constexpr bool operator!=(const Other& lhs, const inline_string<C>& rhs) noexcept { return !(rhs == lhs); }
+
+template<std::size_t C1, std::size_t C2>
+constexpr bool operator!=(const inline_string<C1>& lhs, const inline_string<C2>& rhs) noexcept {
+    return !(lhs == rhs);
+}
+
+template<std::size_t C1, std::size_t C2>
+constexpr bool operator<(const inline_string<C1>& lhs, const inline_string<C2>& rhs) noexcept {
+    return detail::compare_chars(lhs.data(), lhs.size(), rhs.data(), rhs.size()) < 0;
+}
+
+// concatenation: the result's capacity is the sum of the operands', so it can't overflow; a std::string_view or other
+// runtime-sized operand has no capacity, so that result keeps the inline_string's and throws if it doesn't fit
+template<std::size_t C1, std::size_t C2>
+constexpr inline_string<C1 + C2> operator+(const inline_string<C1>& lhs, const inline_string<C2>& rhs) {
+    inline_string<C1 + C2> out{lhs};
+    return out.append(rhs.data(), rhs.size());
+}
+
+template<std::size_t C, std::size_t N>
+constexpr inline_string<C + N> operator+(const inline_string<C>& lhs, const string<N>& rhs) {
+    inline_string<C + N> out{lhs};
+    return out.append(rhs);
+}
+
+template<std::size_t C, std::size_t N>
+constexpr inline_string<C + N> operator+(const string<N>& lhs, const inline_string<C>& rhs) {
+    inline_string<C + N> out{lhs};
+    return out.append(rhs.data(), rhs.size());
+}
+
+template<std::size_t C, std::size_t M>
+constexpr inline_string<C + M - 1> operator+(const inline_string<C>& lhs, const char (&rhs)[M]) {
+    inline_string<C + M - 1> out{lhs};
+    return out.append(rhs);
+}
+
+template<std::size_t C, std::size_t M>
+constexpr inline_string<C + M - 1> operator+(const char (&lhs)[M], const inline_string<C>& rhs) {
+    inline_string<C + M - 1> out{lhs};
+    return out.append(rhs.data(), rhs.size());
+}
+
+template<std::size_t C>
+constexpr inline_string<C + 1> operator+(const inline_string<C>& lhs, char rhs) {
+    inline_string<C + 1> out{lhs};
+    out.push_back(rhs);
+    return out;
+}
+
+template<std::size_t C>
+constexpr inline_string<C + 1> operator+(char lhs, const inline_string<C>& rhs) {
+    inline_string<C + 1> out(1, lhs);
+    return out.append(rhs.data(), rhs.size());
+}
+
+template<std::size_t C, typename StringLike,
+         typename = decltype(std::declval<const StringLike&>().data(), std::declval<const StringLike&>().size())>
+constexpr inline_string<C> operator+(const inline_string<C>& lhs, const StringLike& rhs) {
+    inline_string<C> out{lhs};
+    return out.append(rhs.data(), rhs.size());
+}
+
+template<std::size_t C, typename StringLike,
+         typename = decltype(std::declval<const StringLike&>().data(), std::declval<const StringLike&>().size())>
+constexpr inline_string<C> operator+(const StringLike& lhs, const inline_string<C>& rhs) {
+    inline_string<C> out{lhs.data(), lhs.size()};
+    return out.append(rhs.data(), rhs.size());
+}
+
+template<std::size_t C>
+struct hash<inline_string<C>> {
+    constexpr std::uint64_t operator()(const inline_string<C>& key, std::uint64_t seed = 0) const noexcept {
+        return wyhash(key.data(), key.size(), seed);
+    }
+};
+
+}
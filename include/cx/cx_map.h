@@ -16,11 +16,14 @@
 #pragma once
 
 #include <initializer_list>
+#include <type_traits>
+#include <utility>
 
+#include "cx/cx_config.h"
 #include "cx/cx_pair.h"
 #include "cx/cx_array.h"
 
-#include <exception>
+#include <stdexcept>
 
 namespace cx {
 
@@ -30,7 +33,8 @@ public:
     // a bunch of typedefs
     using key_type = Key;
     using mapped_type = T;
-    using value_type = cx::pair<const Key, const T>;
+    // not pair<const Key, const T>, so the table can be filled by assignment; entries are only ever handed out const
+    using value_type = cx::pair<Key, T>;
     using size_type = std::size_t;
     using difference_type = std::ptrdiff_t;
     using reference = value_type&;
@@ -45,10 +49,13 @@ public:
     // constructors and assignment
     constexpr map() = default;
     constexpr map(std::initializer_list<value_type> entries)
-            : map(entries, std::make_index_sequence<N>()) {
+            : map(entries, fill_by_assignment{}) {
         if (entries.size() != N) throw std::invalid_argument("cx::map: initialized with wrong number of entries!");
     }
 
+    // entries built elsewhere, e.g. in a constexpr loop
+    constexpr explicit map(const cx::array<value_type, N>& entries) : arr_{entries} {}
+
     constexpr map(const map&) = default;
     constexpr map(map&&) noexcept = default;
 
@@ -67,7 +74,7 @@ public:
 
     // element access
     constexpr const T& at(const Key& key) const {
-        for (int i = 0; i < arr_.size(); ++i) {
+        for (std::size_t i = 0; i < N; ++i) {
             if (arr_[i].first == key) return arr_[i].second;
         }
         // we can't directly put the throw here since this is a core constant expression
@@ -88,7 +95,7 @@ public:
     template<typename K>
     constexpr size_type count(const K& key) const {
        size_type count{};
-        for (int i = 0; i < arr_.size(); ++i) {
+        for (std::size_t i = 0; i < N; ++i) {
             if (arr_[i].first == key) ++count;
         }
        return count;
@@ -98,8 +105,77 @@ public:
         return count<Key>(key);
     }
 
+    constexpr const_iterator find(const Key& key) const noexcept {
+        for (std::size_t i = 0; i < N; ++i) {
+            if (arr_[i].first == key) return begin() + i;
+        }
+        return end();
+    }
+
+    // Batched find: out[i] = find(keys[i]) for the n keys, returning how many were found. Each group of
+    // detail::kBatchGroup keys shares one scan of the entries, so a table that doesn't fit in cache is streamed once
+    // per group instead of once per key.
+    constexpr size_type find_batch(const Key* keys, std::size_t n, const_iterator* out) const {
+        size_type found = 0;
+        for (std::size_t first = 0; first < n; first += detail::kBatchGroup) {
+            const std::size_t group = n - first < detail::kBatchGroup ? n - first : detail::kBatchGroup;
+            for (std::size_t g = 0; g < group; ++g) out[first + g] = end();
+
+            std::size_t pending = group;
+            for (std::size_t i = 0; i < N && pending != 0; ++i) {
+                for (std::size_t g = 0; g < group; ++g) {
+                    if (out[first + g] == end() && arr_[i].first == keys[first + g]) {
+                        out[first + g] = begin() + i;
+                        --pending;
+                    }
+                }
+            }
+            found += group - pending;
+        }
+        return found;
+    }
+
+    // out[i] = at(keys[i]) for the n keys; throws std::out_of_range if any of them is missing
+    constexpr void at_batch(const Key* keys, std::size_t n, T* out) const {
+        const_iterator its[detail::kBatchGroup]{};
+        for (std::size_t first = 0; first < n; first += detail::kBatchGroup) {
+            const std::size_t group = n - first < detail::kBatchGroup ? n - first : detail::kBatchGroup;
+            find_batch(keys + first, group, its);
+            for (std::size_t g = 0; g < group; ++g) {
+                if (its[g] == end()) throw_out_of_range();
+                out[first + g] = its[g]->second;
+            }
+        }
+    }
+
+    // found[i] = count(keys[i]) != 0 for the n keys, returning how many were found
+    constexpr size_type count_batch(const Key* keys, std::size_t n, bool* found) const {
+        const_iterator its[detail::kBatchGroup]{};
+        size_type hits = 0;
+        for (std::size_t first = 0; first < n; first += detail::kBatchGroup) {
+            const std::size_t group = n - first < detail::kBatchGroup ? n - first : detail::kBatchGroup;
+            hits += find_batch(keys + first, group, its);
+            for (std::size_t g = 0; g < group; ++g) found[first + g] = its[g] != end();
+        }
+        return hits;
+    }
+
 private:
-    const cx::array<value_type, N> arr_;
+    cx::array<value_type, N> arr_;
+
+    // Copying the entries in a loop keeps compile time and memory roughly linear in N, whereas the pack expansion
+    // below instantiates an N-element mem-initializer and runs into compiler limits at a few thousand entries. The
+    // loop needs default-constructible, assignable keys and values; anything else goes through the pack expansion.
+    using fill_by_assignment = std::integral_constant<bool,
+            std::is_default_constructible<Key>::value && std::is_copy_assignable<Key>::value
+            && std::is_default_constructible<T>::value && std::is_copy_assignable<T>::value>;
+
+    constexpr map(std::initializer_list<value_type>& entries, std::true_type) : arr_{} {
+        for (std::size_t i = 0; i < N && i < entries.size(); ++i) arr_[i] = *(entries.begin() + i);
+    }
+
+    constexpr map(std::initializer_list<value_type>& entries, std::false_type)
+            : map(entries, std::make_index_sequence<N>()) {}
 
     // we need this roundabout way since std::array is an aggregate type with no constructor and we can't directly
     // convert a std::initializer_list into a no-constructor aggregate type without some std::index_sequence indirection
@@ -0,0 +1,477 @@
+// Copyright (c) 2020. Mohit Deshpande.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+// the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "cx/cx_config.h"
+#include "cx/cx_frozen_map.h"
+#include "cx/cx_hash.h"
+#include "cx/cx_packed_map.h"
+#include "cx/cx_pair.h"
+#include "cx/cx_perfect_map.h"
+#include "cx/cx_string.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <cerrno>
+#include <system_error>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define CX_HAS_MMAP 1
+#endif
+
+#include <stdexcept>
+
+// A file format for frozen tables that is read in place. write_mapped_map() stores a cx::frozen_map (partition
+// offsets, pilots, keys, values and a string blob) in one little-endian file, and cx::mapped_map maps that file and
+// serves lookups straight from the mapped pages: opening it reads the header and nothing else, and processes mapping
+// the same file share its pages.
+//
+// Keys can be integers, enums or std::string; values can also be floating point. Strings live in the blob and come
+// back as cx::string_ref views into the mapping.
+//
+// File layout (every section starts on an 8-byte boundary):
+//
+//     mapped_header                      (fixed 112 bytes, see below)
+//     uint64_t partition_starts[partitions + 1]
+//     uint32_t pilots[size]
+//     key      keys[size]                (in slot order; strings are {uint32_t offset, uint32_t size} into the blob)
+//     value    values[size]
+//     char     blob[blob_size]
+
+namespace cx {
+
+namespace detail {
+
+constexpr std::uint32_t kMappedVersion = 1;
+// bump when cx::hash or the perfect hash construction changes, since old files were laid out with the old functions
+constexpr std::uint32_t kMappedHashVersion = 1;
+constexpr char kMappedMagic[8] = {'C', 'X', 'T', 'A', 'B', 'L', 'E', '\0'};
+constexpr std::uint32_t kMappedByteOrderMark = 0x01020304u;
+
+enum class mapped_kind : std::uint32_t {
+    unsigned_integer = 1,
+    signed_integer = 2,
+    floating_point = 3,
+    string = 4,
+};
+
+struct mapped_header {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t byte_order;
+    std::uint32_t hash_version;
+    std::uint32_t key_kind;
+    std::uint32_t key_size;
+    std::uint32_t value_kind;
+    std::uint32_t value_size;
+    std::uint32_t reserved;
+    std::uint64_t size;
+    std::uint64_t partitions;
+    std::uint64_t partitions_offset;
+    std::uint64_t pilots_offset;
+    std::uint64_t keys_offset;
+    std::uint64_t values_offset;
+    std::uint64_t blob_offset;
+    std::uint64_t blob_size;
+    std::uint64_t file_size;
+};
+
+static_assert(sizeof(mapped_header) == 112, "cx::mapped_map: header layout changed");
+
+struct blob_ref {
+    std::uint32_t offset;
+    std::uint32_t size;
+};
+
+// whether count elements of elem_size bytes fit in [offset, end), without the multiplication overflowing
+constexpr bool section_fits(std::uint64_t offset, std::uint64_t count, std::uint64_t elem_size,
+                            std::uint64_t end) noexcept {
+    return offset <= end && count <= (end - offset) / elem_size;
+}
+
+// scalars are written little-endian whatever the host is
+template<typename T>
+void append_le(std::string& out, const T& value) {
+    char bytes[sizeof(T)];
+    std::memcpy(bytes, &value, sizeof(T));
+#if !CX_LITTLE_ENDIAN
+    for (std::size_t i = 0; i < sizeof(T) / 2; ++i) std::swap(bytes[i], bytes[sizeof(T) - 1 - i]);
+#endif
+    out.append(bytes, sizeof(T));
+}
+
+inline void pad_to(std::string& out, std::size_t alignment) {
+    out.append(align_up(out.size(), alignment) - out.size(), '\0');
+}
+
+// how each key and value type is stored in the file and handed back to readers
+template<typename T, typename Enable = void>
+struct mapped_field {
+    static_assert(std::is_arithmetic<T>::value || std::is_enum<T>::value,
+                  "cx::mapped_map: keys and values must be arithmetic, enum or std::string");
+
+    using stored_type = T;
+    using view_type = T;
+    using lookup_type = T;
+
+    static constexpr mapped_kind kind = std::is_floating_point<T>::value ? mapped_kind::floating_point
+            : std::is_signed<typename packed_traits<T>::underlying_type>::value ? mapped_kind::signed_integer
+            : mapped_kind::unsigned_integer;
+
+    static void append(std::string& out, std::string&, const T& value) { append_le(out, value); }
+    static view_type view(const stored_type& stored, string_ref) noexcept { return stored; }
+
+    static std::uint64_t hash(const T& key) noexcept { return cx::hash<T>{}(key); }
+    static bool equal(const stored_type& stored, string_ref, const T& key) noexcept { return stored == key; }
+};
+
+template<>
+struct mapped_field<std::string> {
+    using stored_type = blob_ref;
+    using view_type = string_ref;
+    using lookup_type = string_ref;
+
+    static constexpr mapped_kind kind = mapped_kind::string;
+
+    static void append(std::string& out, std::string& blob, const std::string& value) {
+        if (blob.size() + value.size() > 0xffffffffu) throw std::length_error("cx::mapped_map: string blob over 4 GiB");
+        append_le(out, static_cast<std::uint32_t>(blob.size()));
+        append_le(out, static_cast<std::uint32_t>(value.size()));
+        blob += value;
+    }
+    // a reference past the end of the blob (a corrupt file) reads as the empty string
+    static bool in_blob(const stored_type& stored, string_ref blob) noexcept {
+        return stored.offset <= blob.size() && stored.size <= blob.size() - stored.offset;
+    }
+    static view_type view(const stored_type& stored, string_ref blob) noexcept {
+        return in_blob(stored, blob) ? string_ref(blob.data() + stored.offset, stored.size) : string_ref();
+    }
+
+    static std::uint64_t hash(string_ref key) noexcept { return wyhash(key.data(), key.size()); }
+    static bool equal(const stored_type& stored, string_ref blob, string_ref key) noexcept {
+        return stored.size == key.size() && in_blob(stored, blob)
+               && (key.empty() || std::memcmp(blob.data() + stored.offset, key.data(), key.size()) == 0);
+    }
+};
+
+// read-only mapping of a whole file, or a heap copy where mmap isn't available
+class mapped_file {
+public:
+    mapped_file() noexcept = default;
+
+    explicit mapped_file(const std::string& path) {
+#if CX_HAS_MMAP
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) throw std::system_error(errno, std::generic_category(), "cx::mapped_map: cannot open " + path);
+        struct stat info{};
+        if (::fstat(fd, &info) != 0) {
+            const int error = errno;
+            ::close(fd);
+            throw std::system_error(error, std::generic_category(), "cx::mapped_map: cannot stat " + path);
+        }
+        size_ = static_cast<std::size_t>(info.st_size);
+        if (size_ != 0) {
+            void* data = ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+            if (data == MAP_FAILED) {
+                const int error = errno;
+                ::close(fd);
+                throw std::system_error(error, std::generic_category(), "cx::mapped_map: cannot map " + path);
+            }
+            data_ = data;
+        }
+        ::close(fd);
+#else
+        std::ifstream in(path, std::ios::binary | std::ios::ate);
+        if (!in) throw std::runtime_error("cx::mapped_map: cannot open " + path);
+        size_ = static_cast<std::size_t>(in.tellg());
+        copy_.reset(new std::uint64_t[(size_ + 7) / 8]);
+        in.seekg(0);
+        in.read(reinterpret_cast<char*>(copy_.get()), static_cast<std::streamsize>(size_));
+        data_ = copy_.get();
+#endif
+    }
+
+    mapped_file(const mapped_file&) = delete;
+    mapped_file& operator=(const mapped_file&) = delete;
+
+    mapped_file(mapped_file&& other) noexcept { swap(other); }
+    mapped_file& operator=(mapped_file&& other) noexcept {
+        mapped_file(std::move(other)).swap(*this);
+        return *this;
+    }
+
+    ~mapped_file() {
+#if CX_HAS_MMAP
+        if (data_) ::munmap(data_, size_);
+#endif
+    }
+
+    void swap(mapped_file& other) noexcept {
+        std::swap(data_, other.data_);
+        std::swap(size_, other.size_);
+#if !CX_HAS_MMAP
+        std::swap(copy_, other.copy_);
+#endif
+    }
+
+    const void* data() const noexcept { return data_; }
+    std::size_t size() const noexcept { return size_; }
+
+private:
+    void* data_ = nullptr;
+    std::size_t size_ = 0;
+#if !CX_HAS_MMAP
+    std::unique_ptr<std::uint64_t[]> copy_;
+#endif
+};
+
+}
+
+// the bytes of a mapped table file holding map (see write_mapped_map)
+template<typename Key, typename T>
+std::string to_mapped_bytes(const frozen_map<Key, T>& map) {
+    using key_field = detail::mapped_field<Key>;
+    using value_field = detail::mapped_field<T>;
+
+    std::string out(sizeof(detail::mapped_header), '\0');
+    std::string blob;
+    detail::mapped_header header{};
+    std::memcpy(header.magic, detail::kMappedMagic, sizeof(header.magic));
+    header.version = detail::kMappedVersion;
+    header.byte_order = detail::kMappedByteOrderMark;
+    header.hash_version = detail::kMappedHashVersion;
+    header.key_kind = static_cast<std::uint32_t>(key_field::kind);
+    header.key_size = sizeof(typename key_field::stored_type);
+    header.value_kind = static_cast<std::uint32_t>(value_field::kind);
+    header.value_size = sizeof(typename value_field::stored_type);
+    header.size = map.size();
+    header.partitions = map.partitions();
+
+    header.partitions_offset = out.size();
+    for (std::size_t p = 0; p <= map.partitions() && !map.empty(); ++p) {
+        detail::append_le(out, static_cast<std::uint64_t>(map.partition_starts()[p]));
+    }
+    header.pilots_offset = out.size();
+    for (std::size_t i = 0; i < map.size(); ++i) detail::append_le(out, map.pilots()[i]);
+    detail::pad_to(out, 8);
+    header.keys_offset = out.size();
+    for (const auto& entry : map) key_field::append(out, blob, entry.first);
+    detail::pad_to(out, 8);
+    header.values_offset = out.size();
+    for (const auto& entry : map) value_field::append(out, blob, entry.second);
+    detail::pad_to(out, 8);
+    header.blob_offset = out.size();
+    header.blob_size = blob.size();
+    out += blob;
+    detail::pad_to(out, 8);
+    header.file_size = out.size();
+
+    // the header goes through append_le too, so it is little-endian like everything else
+    std::string header_bytes;
+    header_bytes.append(header.magic, sizeof(header.magic));
+    for (const std::uint32_t field : {header.version, header.byte_order, header.hash_version, header.key_kind,
+                                      header.key_size, header.value_kind, header.value_size, header.reserved}) {
+        detail::append_le(header_bytes, field);
+    }
+    for (const std::uint64_t field : {header.size, header.partitions, header.partitions_offset, header.pilots_offset,
+                                      header.keys_offset, header.values_offset, header.blob_offset, header.blob_size,
+                                      header.file_size}) {
+        detail::append_le(header_bytes, field);
+    }
+    out.replace(0, header_bytes.size(), header_bytes);
+    return out;
+}
+
+template<typename Key, typename T>
+void write_mapped_map(const frozen_map<Key, T>& map, const std::string& path) {
+    const std::string bytes = to_mapped_bytes(map);
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    if (!out) throw std::runtime_error("cx::write_mapped_map: cannot write " + path);
+}
+
+// Read-only view of a table written by write_mapped_map(), with the lookup API of cx::map. Keys and values come back
+// by value; strings come back as string_ref views that stay valid as long as the mapped_map does. Opening checks the
+// header (magic, version, byte order, key and value types, section bounds) but trusts the sections themselves.
+template<typename Key, typename T>
+class mapped_map {
+    using key_field = detail::mapped_field<Key>;
+    using value_field = detail::mapped_field<T>;
+
+public:
+    // a bunch of typedefs
+    using key_type = typename key_field::view_type;
+    using mapped_type = typename value_field::view_type;
+    using value_type = cx::pair<const key_type, const mapped_type>;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using const_iterator = detail::packed_iterator<mapped_map>;
+    using iterator = const_iterator;
+
+    // constructors and assignment
+    explicit mapped_map(const std::string& path) : file_{path} {
+        attach(file_.data(), file_.size());
+    }
+
+    // a table that is already in memory (embedded in the binary, received over the network, ...); data has to stay
+    // alive and 8-byte aligned
+    mapped_map(const void* data, std::size_t size) {
+        attach(data, size);
+    }
+
+    mapped_map(mapped_map&&) noexcept = default;
+    mapped_map& operator=(mapped_map&&) noexcept = default;
+
+    // iterators (entries are in slot order)
+    const_iterator begin() const noexcept { return const_iterator(this, 0); }
+    const_iterator end() const noexcept { return const_iterator(this, size_); }
+    const_iterator cbegin() const noexcept { return begin(); }
+    const_iterator cend() const noexcept { return end(); }
+
+    // element access
+    template<typename K>
+    mapped_type at(const K& key) const {
+        const std::size_t slot = slot_of(key);
+        if (slot == size_) throw std::out_of_range("cx::mapped_map::at: could not find entry in map");
+        return value_at(slot);
+    }
+
+    template<typename K>
+    mapped_type operator[](const K& key) const {
+        return at(key);
+    }
+
+    key_type key_at(std::size_t slot) const noexcept { return key_field::view(keys_[slot], blob_); }
+    mapped_type value_at(std::size_t slot) const noexcept { return value_field::view(values_[slot], blob_); }
+
+    // capacity
+    bool empty() const noexcept { return size_ == 0; }
+    std::size_t size() const noexcept { return size_; }
+    std::size_t max_size() const noexcept { return size_; }
+
+    // lookup (string keys can be looked up with anything that converts to string_ref: see lookup_key())
+    template<typename K>
+    const_iterator find(const K& key) const {
+        return const_iterator(this, slot_of(key));
+    }
+
+    template<typename K>
+    size_type count(const K& key) const {
+        return slot_of(key) == size_ ? 0 : 1;
+    }
+
+private:
+    detail::mapped_file file_;
+    const std::uint64_t* partition_starts_ = nullptr;
+    const std::uint32_t* pilots_ = nullptr;
+    const typename key_field::stored_type* keys_ = nullptr;
+    const typename value_field::stored_type* values_ = nullptr;
+    string_ref blob_;
+    std::size_t size_ = 0;
+    std::size_t partitions_ = 0;
+
+    using lookup_type = typename key_field::lookup_type;
+
+    static lookup_type lookup_key(const lookup_type& key) noexcept { return key; }
+
+    template<typename StringLike, typename K = Key,
+             typename = std::enable_if_t<std::is_same<K, std::string>::value>,
+             typename = decltype(std::declval<const StringLike&>().data(), std::declval<const StringLike&>().size())>
+    static string_ref lookup_key(const StringLike& key) noexcept { return string_ref(key.data(), key.size()); }
+
+    template<typename K = Key, typename = std::enable_if_t<std::is_same<K, std::string>::value>>
+    static string_ref lookup_key(const char* key) noexcept { return string_ref(key, std::strlen(key)); }
+
+    template<typename K>
+    std::size_t slot_of(const K& query) const {
+        if (size_ == 0) return size_;
+        const auto key = lookup_key(query);
+        const std::uint64_t h = key_field::hash(key);
+        const std::uint32_t p = detail::freeze_partition(h, partitions_);
+        const std::uint64_t first = partition_starts_[p];
+        const std::uint64_t end = partition_starts_[p + 1];
+        // partition starts aren't checked when the file is opened, so a corrupt one mustn't index past the pilots
+        if (first >= end || end > size_) return size_;
+        const auto n = static_cast<std::size_t>(end - first);
+        const auto start = static_cast<std::size_t>(first);
+        const std::size_t local = detail::pmh_slot(h, pilots_[start + detail::pmh_bucket(h, n)], n);
+        // nor are pilots, whose direct slots could point anywhere
+        if (local >= n) return size_;
+        const std::size_t slot = start + local;
+        return key_field::equal(keys_[slot], blob_, key) ? slot : size_;
+    }
+
+    void attach(const void* data, std::size_t size) {
+        if (!CX_LITTLE_ENDIAN) throw std::runtime_error("cx::mapped_map: tables are little-endian; this host is not");
+        if (size < sizeof(detail::mapped_header)) throw std::runtime_error("cx::mapped_map: file is too small");
+        if (reinterpret_cast<std::uintptr_t>(data) % 8 != 0) throw std::invalid_argument("cx::mapped_map: misaligned data");
+
+        const auto* bytes = static_cast<const char*>(data);
+        detail::mapped_header header;
+        std::memcpy(&header, bytes, sizeof(header));
+        if (std::memcmp(header.magic, detail::kMappedMagic, sizeof(header.magic)) != 0) {
+            throw std::runtime_error("cx::mapped_map: not a cx table");
+        }
+        if (header.byte_order != detail::kMappedByteOrderMark) throw std::runtime_error("cx::mapped_map: bad byte order");
+        if (header.version != detail::kMappedVersion) throw std::runtime_error("cx::mapped_map: unsupported version");
+        if (header.hash_version != detail::kMappedHashVersion) {
+            throw std::runtime_error("cx::mapped_map: table was built with a different hash function");
+        }
+        if (header.key_kind != static_cast<std::uint32_t>(key_field::kind)
+            || header.key_size != sizeof(typename key_field::stored_type)) {
+            throw std::runtime_error("cx::mapped_map: key type does not match the table");
+        }
+        if (header.value_kind != static_cast<std::uint32_t>(value_field::kind)
+            || header.value_size != sizeof(typename value_field::stored_type)) {
+            throw std::runtime_error("cx::mapped_map: value type does not match the table");
+        }
+
+        // each section has to end where the next one starts, checked in that order so no count can overflow
+        const std::uint64_t n = header.size;
+        const bool in_bounds = header.file_size <= size
+                && header.partitions_offset >= sizeof(detail::mapped_header)
+                && detail::section_fits(header.blob_offset, header.blob_size, 1, header.file_size)
+                && detail::section_fits(header.values_offset, n, header.value_size, header.blob_offset)
+                && detail::section_fits(header.keys_offset, n, header.key_size, header.values_offset)
+                && detail::section_fits(header.pilots_offset, n, 4, header.keys_offset)
+                && header.partitions <= n && (n == 0 || header.partitions != 0)
+                && detail::section_fits(header.partitions_offset, n ? header.partitions + 1 : 0, 8,
+                                        header.pilots_offset)
+                && header.partitions_offset % 8 == 0 && header.pilots_offset % 4 == 0
+                && header.keys_offset % 8 == 0 && header.values_offset % 8 == 0;
+        if (!in_bounds) throw std::runtime_error("cx::mapped_map: corrupt section offsets");
+
+        partition_starts_ = reinterpret_cast<const std::uint64_t*>(bytes + header.partitions_offset);
+        pilots_ = reinterpret_cast<const std::uint32_t*>(bytes + header.pilots_offset);
+        keys_ = reinterpret_cast<const typename key_field::stored_type*>(bytes + header.keys_offset);
+        values_ = reinterpret_cast<const typename value_field::stored_type*>(bytes + header.values_offset);
+        blob_ = string_ref(bytes + header.blob_offset, static_cast<std::size_t>(header.blob_size));
+        size_ = static_cast<std::size_t>(n);
+        partitions_ = static_cast<std::size_t>(header.partitions);
+        if (size_ != 0 && partition_starts_[partitions_] != size_) throw std::runtime_error("cx::mapped_map: corrupt table");
+    }
+};
+
+}
@@ -0,0 +1,226 @@
+// Copyright (c) 2020. Mohit Deshpande.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+// the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+
+#include "cx/cx_frozen_map.h"
+#include "cx/cx_hash.h"
+
+#include <stdexcept>
+
+namespace cx {
+
+namespace detail {
+
+// adapts cx::hash to the std::unordered_map Hash interface
+template<typename Key, typename Hash>
+struct std_hash_adapter {
+    std::size_t operator()(const Key& key) const noexcept { return static_cast<std::size_t>(Hash{}(key)); }
+};
+
+// Sleepable-RCU style read-side counters. A reader increments a counter for the current epoch parity, reads, and
+// decrements it again; that never blocks or retries. A writer that unpublished a pointer flips the parity and waits for
+// the old parity's counters to drain, twice, after which no reader can still hold the old pointer. Counters are
+// striped over cache lines so concurrent readers don't contend on one line.
+class epoch_counters {
+public:
+    static constexpr std::size_t kStripes = 64;
+
+    std::size_t enter() noexcept {
+        const std::size_t parity = epoch_.load() & 1;
+        counters_[parity][stripe()].count.fetch_add(1);
+        return parity;
+    }
+
+    void leave(std::size_t parity) noexcept {
+        counters_[parity][stripe()].count.fetch_sub(1);
+    }
+
+    // returns once every reader that entered before the call has left
+    void synchronize() noexcept {
+        for (int flip = 0; flip < 2; ++flip) {
+            const std::size_t parity = epoch_.fetch_add(1) & 1;
+            for (const auto& counter : counters_[parity]) {
+                while (counter.count.load() != 0) std::this_thread::yield();
+            }
+        }
+    }
+
+private:
+    struct alignas(64) counter {
+        std::atomic<std::ptrdiff_t> count{0};
+    };
+
+    std::atomic<std::size_t> epoch_{0};
+    counter counters_[2][kStripes];
+
+    static std::size_t stripe() noexcept {
+        static std::atomic<std::size_t> next_stripe{0};
+        static thread_local const std::size_t stripe = next_stripe.fetch_add(1) % kStripes;
+        return stripe;
+    }
+};
+
+}
+
+// A compile-time table (cx::map, cx::perfect_map, ...) with runtime overrides. The overrides are published as
+// immutable cx::frozen_map snapshots through one atomic pointer. Lookups never lock or wait: they read the current
+// snapshot under an epoch counter, fall back to the base table, and return values by copy, since a snapshot can be
+// retired as soon as the lookup is done. Writers serialize among themselves, build a new snapshot, swap it in, and
+// wait for a grace period before freeing the old one; readers are never blocked by them.
+//
+// The base table is referenced, not copied, and has to outlive the overlay (it is usually a constexpr global):
+//
+//     static constexpr cx::map<Setting, int, 3> kDefaults = {...};
+//     cx::overlay_map<decltype(kDefaults)> settings{kDefaults};
+//     settings.set(Setting::kTimeoutMs, 250);
+//     settings.at(Setting::kTimeoutMs);  // 250
+template<typename Base, typename Hash = cx::hash<typename Base::key_type>>
+class overlay_map {
+public:
+    // a bunch of typedefs
+    using base_type = Base;
+    using key_type = typename Base::key_type;
+    using mapped_type = typename Base::mapped_type;
+    using size_type = std::size_t;
+    using hasher = Hash;
+
+    // constructors and assignment
+    explicit overlay_map(const Base& base) : base_{&base}, snapshot_{new snapshot()} {}
+
+    overlay_map(const overlay_map&) = delete;
+    overlay_map& operator=(const overlay_map&) = delete;
+
+    ~overlay_map() { delete snapshot_.load(); }
+
+    // element access (wait-free apart from the lookups themselves)
+    mapped_type at(const key_type& key) const {
+        const read_guard guard{*this};
+        const auto it = guard.overrides().find(key);
+        if (it != guard.overrides().end()) return it->second;
+        const auto base_it = base_->find(key);
+        if (base_it == base_->end()) throw std::out_of_range("cx::overlay_map::at: could not find entry in map");
+        return base_it->second;
+    }
+
+    mapped_type operator[](const key_type& key) const {
+        return at(key);
+    }
+
+    // the value for key, or fallback if neither the overrides nor the base table have it
+    mapped_type get_or(const key_type& key, const mapped_type& fallback) const {
+        const read_guard guard{*this};
+        const auto it = guard.overrides().find(key);
+        if (it != guard.overrides().end()) return it->second;
+        const auto base_it = base_->find(key);
+        return base_it == base_->end() ? fallback : base_it->second;
+    }
+
+    // lookup
+    size_type count(const key_type& key) const {
+        const read_guard guard{*this};
+        return guard.overrides().count(key) ? 1 : base_->count(key) ? 1 : 0;
+    }
+
+    bool overridden(const key_type& key) const {
+        const read_guard guard{*this};
+        return guard.overrides().count(key) != 0;
+    }
+
+    // number of overrides in the current snapshot
+    size_type overrides() const {
+        const read_guard guard{*this};
+        return guard.overrides().size();
+    }
+
+    // the base table, without overrides
+    const Base& base() const noexcept { return *base_; }
+
+    // modifiers: each call publishes a new snapshot and returns once the old one has been freed
+    void set(const key_type& key, const mapped_type& value) {
+        std::lock_guard<std::mutex> lock{writer_mutex_};
+        pending_[key] = value;
+        publish();
+    }
+
+    // drops the override for key, so lookups see the base table again
+    void reset(const key_type& key) {
+        std::lock_guard<std::mutex> lock{writer_mutex_};
+        if (pending_.erase(key) == 0) return;
+        publish();
+    }
+
+    // replaces every override at once, so readers never see a half-applied batch
+    template<typename Range>
+    void assign(const Range& overrides) {
+        std::lock_guard<std::mutex> lock{writer_mutex_};
+        pending_.clear();
+        for (const auto& entry : overrides) pending_[entry.first] = entry.second;
+        publish();
+    }
+
+    void clear() {
+        std::lock_guard<std::mutex> lock{writer_mutex_};
+        pending_.clear();
+        publish();
+    }
+
+private:
+    struct snapshot {
+        cx::frozen_map<key_type, mapped_type, Hash> overrides;
+    };
+
+    class read_guard {
+    public:
+        explicit read_guard(const overlay_map& map) noexcept
+                : map_{map}, parity_{map.readers_.enter()}, snapshot_{map.snapshot_.load()} {}
+        ~read_guard() { map_.readers_.leave(parity_); }
+
+        read_guard(const read_guard&) = delete;
+        read_guard& operator=(const read_guard&) = delete;
+
+        const cx::frozen_map<key_type, mapped_type, Hash>& overrides() const noexcept { return snapshot_->overrides; }
+
+    private:
+        const overlay_map& map_;
+        const std::size_t parity_;
+        const snapshot* const snapshot_;
+    };
+
+    const Base* base_;
+    std::atomic<snapshot*> snapshot_;
+    mutable detail::epoch_counters readers_;
+
+    // writer-side copy of the overrides; guarded by writer_mutex_
+    std::mutex writer_mutex_;
+    std::unordered_map<key_type, mapped_type, detail::std_hash_adapter<key_type, Hash>> pending_;
+
+    void publish() {
+        auto* next = new snapshot{cx::frozen_map<key_type, mapped_type, Hash>(pending_.begin(), pending_.end())};
+        snapshot* previous = snapshot_.exchange(next);
+        readers_.synchronize();
+        delete previous;
+    }
+};
+
+}
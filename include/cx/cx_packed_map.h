@@ -0,0 +1,320 @@
+// Copyright (c) 2020. Mohit Deshpande.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+// the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <type_traits>
+
+#include "cx/cx_pair.h"
+#include "cx/cx_map.h"
+
+#include <stdexcept>
+
+namespace cx {
+
+namespace detail {
+
+template<typename T, bool = std::is_enum<T>::value>
+struct packed_traits {
+    using underlying_type = T;
+};
+
+template<typename T>
+struct packed_traits<T, true> {
+    using underlying_type = std::underlying_type_t<T>;
+};
+
+// integral and enum values as offsets from a frame-of-reference minimum
+template<typename T>
+struct packed_codec {
+    static_assert(std::is_integral<T>::value || std::is_enum<T>::value,
+                  "cx::packed_map: keys and values must be integral or enum types");
+
+    using underlying_type = typename packed_traits<T>::underlying_type;
+    // widened type that keeps the ordering of T
+    using wide_type = std::conditional_t<std::is_signed<underlying_type>::value, std::int64_t, std::uint64_t>;
+
+    static constexpr wide_type widen(T x) noexcept { return static_cast<wide_type>(static_cast<underlying_type>(x)); }
+
+    static constexpr std::uint64_t encode(T x, T min) noexcept {
+        return static_cast<std::uint64_t>(widen(x)) - static_cast<std::uint64_t>(widen(min));
+    }
+
+    static constexpr T decode(std::uint64_t bits, T min) noexcept {
+        return static_cast<T>(static_cast<underlying_type>(bits + static_cast<std::uint64_t>(widen(min))));
+    }
+};
+
+constexpr std::size_t bit_width(std::uint64_t x) noexcept {
+    std::size_t n = 0;
+    for (; x; x >>= 1) ++n;
+    return n;
+}
+
+constexpr std::size_t packed_words(std::size_t count, std::size_t bits) noexcept {
+    return (count * bits + 63) / 64;
+}
+
+constexpr std::uint64_t low_mask(std::size_t bits) noexcept {
+    return bits >= 64 ? ~std::uint64_t{0} : (std::uint64_t{1} << bits) - 1;
+}
+
+// the i-th Bits-wide field of a packed bit array
+constexpr std::uint64_t get_bits(const std::uint64_t* words, std::size_t i, std::size_t bits) noexcept {
+    if (bits == 0) return 0;
+    const std::size_t pos = i * bits;
+    const std::size_t word = pos / 64;
+    const std::size_t offset = pos % 64;
+    std::uint64_t v = words[word] >> offset;
+    if (offset + bits > 64) v |= words[word + 1] << (64 - offset);
+    return v & low_mask(bits);
+}
+
+constexpr void set_bits(std::uint64_t* words, std::size_t i, std::size_t bits, std::uint64_t v) noexcept {
+    if (bits == 0) return;
+    const std::size_t pos = i * bits;
+    const std::size_t word = pos / 64;
+    const std::size_t offset = pos % 64;
+    words[word] |= v << offset;
+    if (offset + bits > 64) words[word + 1] |= v >> (64 - offset);
+}
+
+// Random-access iterator over a packed map. Entries are decoded on dereference and returned by value.
+template<typename Map>
+class packed_iterator {
+public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = typename Map::value_type;
+    using difference_type = std::ptrdiff_t;
+    using reference = value_type;
+
+    struct pointer {
+        value_type entry;
+        constexpr const value_type* operator->() const noexcept { return &entry; }
+    };
+
+    constexpr packed_iterator() = default;
+    constexpr packed_iterator(const Map* map, std::size_t i) noexcept : map_{map}, i_{i} {}
+
+    constexpr reference operator*() const { return value_type{map_->key_at(i_), map_->value_at(i_)}; }
+    constexpr pointer operator->() const { return pointer{**this}; }
+    constexpr reference operator[](difference_type n) const { return *(*this + n); }
+
+    constexpr packed_iterator& operator++() noexcept { ++i_; return *this; }
+    constexpr packed_iterator& operator--() noexcept { --i_; return *this; }
+    constexpr packed_iterator operator++(int) noexcept { packed_iterator it = *this; ++i_; return it; }
+    constexpr packed_iterator operator--(int) noexcept { packed_iterator it = *this; --i_; return it; }
+    constexpr packed_iterator& operator+=(difference_type n) noexcept { i_ += n; return *this; }
+    constexpr packed_iterator& operator-=(difference_type n) noexcept { i_ -= n; return *this; }
+    constexpr packed_iterator operator+(difference_type n) const noexcept { return packed_iterator(map_, i_ + n); }
+    constexpr packed_iterator operator-(difference_type n) const noexcept { return packed_iterator(map_, i_ - n); }
+    constexpr difference_type operator-(const packed_iterator& rhs) const noexcept {
+        return static_cast<difference_type>(i_) - static_cast<difference_type>(rhs.i_);
+    }
+
+    constexpr bool operator==(const packed_iterator& rhs) const noexcept { return i_ == rhs.i_; }
+    constexpr bool operator!=(const packed_iterator& rhs) const noexcept { return i_ != rhs.i_; }
+    constexpr bool operator<(const packed_iterator& rhs) const noexcept { return i_ < rhs.i_; }
+    constexpr bool operator>(const packed_iterator& rhs) const noexcept { return i_ > rhs.i_; }
+    constexpr bool operator<=(const packed_iterator& rhs) const noexcept { return i_ <= rhs.i_; }
+    constexpr bool operator>=(const packed_iterator& rhs) const noexcept { return i_ >= rhs.i_; }
+
+private:
+    const Map* map_{};
+    std::size_t i_{};
+};
+
+}
+
+// Bit-packed variant of cx::map for integral and enum keys and values. Keys and values are stored as offsets from
+// their minimum in KeyBits- and ValueBits-wide fields of two separate bit arrays. Semantics match cx::map
+// (insertion order, linear lookup, duplicates allowed), except that entries are decoded on access, so at() returns
+// T by value.
+//
+// The widths are template arguments, so the usual way to build one is from a constexpr cx::map, letting the
+// library work out the narrowest widths; only the packed map needs to be odr-used:
+//
+//     constexpr cx::map<Lepton, int, 6> kCharges = {...};
+//     constexpr auto kPackedCharges = cx::pack<cx::packed_key_bits(kCharges), cx::packed_value_bits(kCharges)>(kCharges);
+template<typename Key, typename T, std::size_t N, std::size_t KeyBits, std::size_t ValueBits>
+class packed_map {
+public:
+    static_assert(KeyBits <= 64 && ValueBits <= 64, "cx::packed_map: fields are at most 64 bits wide");
+
+    // a bunch of typedefs
+    using key_type = Key;
+    using mapped_type = T;
+    using value_type = cx::pair<const Key, const T>;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = value_type;
+    using const_reference = value_type;
+    using iterator = detail::packed_iterator<packed_map>;
+    using const_iterator = detail::packed_iterator<packed_map>;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    // constructors and assignment
+    constexpr packed_map(std::initializer_list<value_type> entries) : packed_map(entries.begin(), entries.size()) {}
+
+    template<typename OtherKey, typename OtherT>
+    constexpr explicit packed_map(const cx::map<OtherKey, OtherT, N>& m) : packed_map(m.begin(), m.size()) {}
+
+    constexpr packed_map(const packed_map&) = default;
+    constexpr packed_map(packed_map&&) noexcept = default;
+
+    constexpr packed_map& operator=(const packed_map&) = default;
+    constexpr packed_map& operator=(packed_map&&) noexcept = default;
+
+    // iterators
+    constexpr const_iterator begin() const noexcept { return const_iterator(this, 0); }
+    constexpr const_iterator end() const noexcept { return const_iterator(this, N); }
+    constexpr const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+    constexpr const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+    constexpr const_iterator cbegin() const noexcept { return begin(); }
+    constexpr const_iterator cend() const noexcept { return end(); }
+    constexpr const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+    constexpr const_reverse_iterator crend() const noexcept { return rend(); }
+
+    // element access
+    constexpr T at(const Key& key) const {
+        const std::size_t i = index_of(key);
+        // we can't directly put the throw here since this is a core constant expression
+        // (see C++ spec §5.20 [expr.const])
+        if (i == N) throw_out_of_range();
+        return value_at(i);
+    }
+
+    constexpr T operator[](const Key& key) const {
+        return at(key);
+    }
+
+    constexpr Key key_at(std::size_t i) const noexcept {
+        return key_codec::decode(detail::get_bits(key_words_, i, KeyBits), key_min_);
+    }
+
+    constexpr T value_at(std::size_t i) const noexcept {
+        return value_codec::decode(detail::get_bits(value_words_, i, ValueBits), value_min_);
+    }
+
+    // capacity
+    constexpr bool empty() const noexcept { return size() == 0; }
+    constexpr std::size_t size() const noexcept { return N; }
+    constexpr std::size_t max_size() const noexcept { return N; }
+
+    // bytes used by the packed fields
+    static constexpr std::size_t storage_bytes() noexcept { return (key_word_count + value_word_count) * 8; }
+
+    // lookup
+    constexpr size_type count(const Key& key) const noexcept {
+        size_type count{};
+        if (!in_key_range(key)) return count;
+        const std::uint64_t bits = key_codec::encode(key, key_min_);
+        for (std::size_t i = 0; i < N; ++i) {
+            if (detail::get_bits(key_words_, i, KeyBits) == bits) ++count;
+        }
+        return count;
+    }
+
+    constexpr const_iterator find(const Key& key) const noexcept {
+        return const_iterator(this, index_of(key));
+    }
+
+private:
+    using key_codec = detail::packed_codec<Key>;
+    using value_codec = detail::packed_codec<T>;
+
+    static constexpr std::size_t key_word_count = detail::packed_words(N, KeyBits);
+    static constexpr std::size_t value_word_count = detail::packed_words(N, ValueBits);
+
+    std::uint64_t key_words_[key_word_count ? key_word_count : 1]{};
+    std::uint64_t value_words_[value_word_count ? value_word_count : 1]{};
+    Key key_min_{};
+    T value_min_{};
+
+    template<typename Entry>
+    constexpr packed_map(const Entry* entries, std::size_t size) {
+        if (size != N) throw std::invalid_argument("cx::packed_map: initialized with wrong number of entries!");
+        if (N == 0) return;
+
+        key_min_ = entries[0].first;
+        value_min_ = entries[0].second;
+        for (std::size_t i = 1; i < N; ++i) {
+            if (key_codec::widen(entries[i].first) < key_codec::widen(key_min_)) key_min_ = entries[i].first;
+            if (value_codec::widen(entries[i].second) < value_codec::widen(value_min_)) value_min_ = entries[i].second;
+        }
+        for (std::size_t i = 0; i < N; ++i) {
+            const std::uint64_t key_bits = key_codec::encode(entries[i].first, key_min_);
+            const std::uint64_t value_bits = value_codec::encode(entries[i].second, value_min_);
+            if (key_bits > detail::low_mask(KeyBits)) throw std::invalid_argument("cx::packed_map: KeyBits too narrow");
+            if (value_bits > detail::low_mask(ValueBits)) throw std::invalid_argument("cx::packed_map: ValueBits too narrow");
+            detail::set_bits(key_words_, i, KeyBits, key_bits);
+            detail::set_bits(value_words_, i, ValueBits, value_bits);
+        }
+    }
+
+    constexpr bool in_key_range(const Key& key) const noexcept {
+        return N != 0 && key_codec::widen(key) >= key_codec::widen(key_min_)
+               && key_codec::encode(key, key_min_) <= detail::low_mask(KeyBits);
+    }
+
+    constexpr std::size_t index_of(const Key& key) const noexcept {
+        if (!in_key_range(key)) return N;
+        const std::uint64_t bits = key_codec::encode(key, key_min_);
+        for (std::size_t i = 0; i < N; ++i) {
+            if (detail::get_bits(key_words_, i, KeyBits) == bits) return i;
+        }
+        return N;
+    }
+
+    constexpr void throw_out_of_range() const {
+        throw std::out_of_range("cx::packed_map::at: could not find entry in map");
+    }
+};
+
+// narrowest field widths that hold every key/value of a map as an offset from the minimum
+template<typename Map>
+constexpr std::size_t packed_key_bits(const Map& m) noexcept {
+    using codec = detail::packed_codec<typename Map::key_type>;
+    if (m.empty()) return 0;
+    auto min = codec::widen(m.begin()->first), max = min;
+    for (const auto& entry : m) {
+        if (codec::widen(entry.first) < min) min = codec::widen(entry.first);
+        if (codec::widen(entry.first) > max) max = codec::widen(entry.first);
+    }
+    return detail::bit_width(static_cast<std::uint64_t>(max) - static_cast<std::uint64_t>(min));
+}
+
+template<typename Map>
+constexpr std::size_t packed_value_bits(const Map& m) noexcept {
+    using codec = detail::packed_codec<typename Map::mapped_type>;
+    if (m.empty()) return 0;
+    auto min = codec::widen(m.begin()->second), max = min;
+    for (const auto& entry : m) {
+        if (codec::widen(entry.second) < min) min = codec::widen(entry.second);
+        if (codec::widen(entry.second) > max) max = codec::widen(entry.second);
+    }
+    return detail::bit_width(static_cast<std::uint64_t>(max) - static_cast<std::uint64_t>(min));
+}
+
+template<std::size_t KeyBits, std::size_t ValueBits, typename Key, typename T, std::size_t N>
+constexpr packed_map<Key, T, N, KeyBits, ValueBits> pack(const cx::map<Key, T, N>& m) {
+    return packed_map<Key, T, N, KeyBits, ValueBits>(m);
+}
+
+}
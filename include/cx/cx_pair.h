@@ -44,23 +44,27 @@ struct pair {
     constexpr pair& operator=(const pair& other) {
         first = other.first;
         second = other.second;
+        return *this;
     }
 
     template<typename U1, typename U2>
     constexpr pair& operator=(const pair<U1, U2>& other) {
         first = other.first;
         second = other.second;
+        return *this;
     }
 
     constexpr pair& operator=(pair&& other) noexcept {
         first = std::move(other.first);
         second = std::move(other.second);
+        return *this;
     }
 
     template<typename U1, typename U2>
     constexpr pair& operator=(pair<U1, U2>&& other) noexcept {
         first = std::forward<U1>(other.first);
         second = std::forward<U2>(other.second);
+        return *this;
     }
 
     T1 first;
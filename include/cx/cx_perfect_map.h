@@ -0,0 +1,294 @@
+// Copyright (c) 2020. Mohit Deshpande.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+// the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include <cstdint>
+#include <initializer_list>
+
+#include "cx/cx_config.h"
+#include "cx/cx_pair.h"
+#include "cx/cx_array.h"
+#include "cx/cx_hash.h"
+
+#include <stdexcept>
+
+namespace cx {
+
+namespace detail {
+
+// a pilot with this bit set stores the slot of a single-key bucket directly instead of a hash seed
+constexpr std::uint32_t kPmhDirectSlot = 0x80000000u;
+constexpr std::uint32_t kPmhMaxPilot = 1u << 24;
+
+enum class pmh_status {
+    ok,
+    duplicate_key,
+    no_pilot_found,
+};
+
+constexpr std::uint32_t pmh_bucket(std::uint64_t h, std::size_t buckets) noexcept {
+    return fastrange32(static_cast<std::uint32_t>(h >> 32), static_cast<std::uint32_t>(buckets));
+}
+
+constexpr std::uint32_t pmh_slot(std::uint64_t h, std::uint32_t pilot, std::size_t n) noexcept {
+    return (pilot & kPmhDirectSlot)
+           ? pilot & ~kPmhDirectSlot
+           : fastrange32(static_cast<std::uint32_t>(mix64(h ^ (pilot * 0x9e3779b97f4a7c15ULL))),
+                         static_cast<std::uint32_t>(n));
+}
+
+// Builds a minimal perfect hash (PTHash-style pilots, one bucket per key) over n precomputed key hashes. On success,
+// order[slot] holds the index of the key that lands in that slot. Everything works on caller-provided storage so the
+// same code runs during constant evaluation and at runtime: pilots, order, bucket_items and taken must hold n
+// elements and bucket_start must hold n + 1.
+constexpr pmh_status pmh_build(const std::uint64_t* hashes, std::size_t n,
+                               std::uint32_t* pilots, std::size_t* order,
+                               std::size_t* bucket_start, std::size_t* bucket_items, bool* taken) {
+    // bucket the keys (counting sort into bucket_items, using order as the per-bucket cursor)
+    for (std::size_t b = 0; b <= n; ++b) bucket_start[b] = 0;
+    for (std::size_t i = 0; i < n; ++i) ++bucket_start[pmh_bucket(hashes[i], n) + 1];
+    std::size_t max_size = 0;
+    for (std::size_t b = 0; b < n; ++b) {
+        if (bucket_start[b + 1] > max_size) max_size = bucket_start[b + 1];
+        bucket_start[b + 1] += bucket_start[b];
+    }
+    for (std::size_t b = 0; b < n; ++b) order[b] = bucket_start[b];
+    for (std::size_t i = 0; i < n; ++i) bucket_items[order[pmh_bucket(hashes[i], n)]++] = i;
+
+    for (std::size_t s = 0; s < n; ++s) {
+        pilots[s] = 0;
+        taken[s] = false;
+    }
+
+    // place the largest buckets first while the table is still mostly empty
+    for (std::size_t size = max_size; size > 1; --size) {
+        for (std::size_t b = 0; b < n; ++b) {
+            const std::size_t first = bucket_start[b];
+            const std::size_t last = bucket_start[b + 1];
+            if (last - first != size) continue;
+
+            for (std::size_t i = first; i < last; ++i) {
+                for (std::size_t j = i + 1; j < last; ++j) {
+                    if (hashes[bucket_items[i]] == hashes[bucket_items[j]]) return pmh_status::duplicate_key;
+                }
+            }
+
+            std::uint32_t pilot = 0;
+            for (; pilot < kPmhMaxPilot; ++pilot) {
+                std::size_t placed = first;
+                for (; placed < last; ++placed) {
+                    const auto slot = pmh_slot(hashes[bucket_items[placed]], pilot, n);
+                    if (taken[slot]) break;
+                    taken[slot] = true;
+                }
+                if (placed == last) break;
+                // roll back the partial placement and try the next pilot
+                for (std::size_t i = first; i < placed; ++i) taken[pmh_slot(hashes[bucket_items[i]], pilot, n)] = false;
+            }
+            if (pilot == kPmhMaxPilot) return pmh_status::no_pilot_found;
+
+            pilots[b] = pilot;
+            for (std::size_t i = first; i < last; ++i) order[pmh_slot(hashes[bucket_items[i]], pilot, n)] = bucket_items[i];
+        }
+    }
+
+    // single-key buckets can go anywhere, so hand them the remaining free slots directly
+    std::size_t free_slot = 0;
+    for (std::size_t b = 0; b < n; ++b) {
+        if (bucket_start[b + 1] - bucket_start[b] != 1) continue;
+        while (taken[free_slot]) ++free_slot;
+        taken[free_slot] = true;
+        pilots[b] = kPmhDirectSlot | static_cast<std::uint32_t>(free_slot);
+        order[free_slot] = bucket_items[bucket_start[b]];
+    }
+    return pmh_status::ok;
+}
+
+}
+
+// Immutable hash map whose slots are laid out by a minimal perfect hash computed during construction (usually at
+// compile time). A lookup is one hash, one pilot load and one key compare regardless of N. Unlike cx::map, keys must
+// be unique and iteration follows slot order rather than insertion order.
+template<typename Key, typename T, std::size_t N, typename Hash = cx::hash<Key>>
+class perfect_map {
+public:
+    // a bunch of typedefs
+    using key_type = Key;
+    using mapped_type = T;
+    using value_type = cx::pair<const Key, const T>;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using hasher = Hash;
+    using reference = value_type&;
+    using const_reference = const value_type&;
+    using pointer = value_type*;
+    using const_pointer = const value_type*;
+    using iterator = value_type*;
+    using const_iterator = const value_type*;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    static_assert(N < detail::kPmhDirectSlot, "cx::perfect_map: too many entries");
+
+    // constructors and assignment
+    constexpr perfect_map() = default;
+    constexpr perfect_map(std::initializer_list<value_type> entries)
+            : perfect_map(entries, make_layout(entries), std::make_index_sequence<N>()) {}
+
+    constexpr perfect_map(const perfect_map&) = default;
+    constexpr perfect_map(perfect_map&&) noexcept = default;
+
+    constexpr perfect_map& operator=(const perfect_map&) = default;
+    constexpr perfect_map& operator=(perfect_map&&) noexcept = default;
+
+    // iterators
+    constexpr const_iterator begin() const noexcept { return arr_.begin(); }
+    constexpr const_iterator end() const noexcept { return arr_.end(); }
+    constexpr const_reverse_iterator rbegin() const noexcept { return arr_.rbegin(); }
+    constexpr const_reverse_iterator rend() const noexcept { return arr_.rend(); }
+    constexpr const_iterator cbegin() const noexcept { return arr_.cbegin(); }
+    constexpr const_iterator cend() const noexcept { return arr_.cend(); }
+    constexpr const_reverse_iterator crbegin() const noexcept { return arr_.crbegin(); }
+    constexpr const_reverse_iterator crend() const noexcept { return arr_.crend(); }
+
+    // element access
+    constexpr const T& at(const Key& key) const {
+        const auto it = find(key);
+        // we can't directly put the throw here since this is a core constant expression
+        // (see C++ spec §5.20 [expr.const])
+        if (it == end()) throw_out_of_range();
+        return it->second;
+    }
+
+    constexpr const T& operator[](const Key& key) const {
+        return at(key);
+    }
+
+    // capacity
+    constexpr bool empty() const noexcept { return size() == 0; }
+    constexpr std::size_t size() const noexcept { return N; }
+    constexpr std::size_t max_size() const noexcept { return N; }
+
+    // lookup
+    constexpr const_iterator find(const Key& key) const noexcept {
+        if (N == 0) return end();
+        const std::uint64_t h = Hash{}(key);
+        const std::uint32_t slot = detail::pmh_slot(h, pilots_[detail::pmh_bucket(h, N)], N);
+        return arr_[slot].first == key ? begin() + slot : end();
+    }
+
+    constexpr size_type count(const Key& key) const noexcept {
+        return find(key) == end() ? 0 : 1;
+    }
+
+    // Batched find: out[i] = find(keys[i]) for the n keys, returning how many were found. Keys go through in groups
+    // of detail::kBatchGroup one step at a time (hash every key and prefetch its pilot, then every slot and prefetch
+    // its entry, then compare), so the cache misses of a whole group overlap instead of each lookup waiting on its
+    // own. Hashing a group is a plain loop over an array, which the compiler vectorizes where the target has 64-bit
+    // vector multiplies.
+    constexpr size_type find_batch(const Key* keys, std::size_t n, const_iterator* out) const noexcept {
+        size_type found = 0;
+        for (std::size_t first = 0; first < n; first += detail::kBatchGroup) {
+            const std::size_t group = n - first < detail::kBatchGroup ? n - first : detail::kBatchGroup;
+            if (N == 0) {
+                for (std::size_t g = 0; g < group; ++g) out[first + g] = end();
+                continue;
+            }
+
+            std::uint64_t hashes[detail::kBatchGroup]{};
+            std::uint32_t slots[detail::kBatchGroup]{};
+            for (std::size_t g = 0; g < group; ++g) hashes[g] = Hash{}(keys[first + g]);
+            if (!CX_IS_CONSTANT_EVALUATED()) {
+                for (std::size_t g = 0; g < group; ++g) detail::prefetch(&pilots_[detail::pmh_bucket(hashes[g], N)]);
+            }
+            for (std::size_t g = 0; g < group; ++g) {
+                slots[g] = detail::pmh_slot(hashes[g], pilots_[detail::pmh_bucket(hashes[g], N)], N);
+                if (!CX_IS_CONSTANT_EVALUATED()) detail::prefetch(&arr_[slots[g]]);
+            }
+            for (std::size_t g = 0; g < group; ++g) {
+                const bool hit = arr_[slots[g]].first == keys[first + g];
+                out[first + g] = hit ? begin() + slots[g] : end();
+                found += hit;
+            }
+        }
+        return found;
+    }
+
+    // out[i] = at(keys[i]) for the n keys; throws std::out_of_range if any of them is missing
+    constexpr void at_batch(const Key* keys, std::size_t n, T* out) const {
+        const_iterator its[detail::kBatchGroup]{};
+        for (std::size_t first = 0; first < n; first += detail::kBatchGroup) {
+            const std::size_t group = n - first < detail::kBatchGroup ? n - first : detail::kBatchGroup;
+            find_batch(keys + first, group, its);
+            for (std::size_t g = 0; g < group; ++g) {
+                if (its[g] == end()) throw_out_of_range();
+                out[first + g] = its[g]->second;
+            }
+        }
+    }
+
+    // found[i] = count(keys[i]) != 0 for the n keys, returning how many were found
+    constexpr size_type count_batch(const Key* keys, std::size_t n, bool* found) const noexcept {
+        const_iterator its[detail::kBatchGroup]{};
+        size_type hits = 0;
+        for (std::size_t first = 0; first < n; first += detail::kBatchGroup) {
+            const std::size_t group = n - first < detail::kBatchGroup ? n - first : detail::kBatchGroup;
+            hits += find_batch(keys + first, group, its);
+            for (std::size_t g = 0; g < group; ++g) found[first + g] = its[g] != end();
+        }
+        return hits;
+    }
+
+private:
+    const cx::array<value_type, N> arr_;
+    const cx::array<std::uint32_t, N> pilots_{};
+
+    struct layout {
+        std::uint32_t pilots[N ? N : 1];
+        std::size_t order[N ? N : 1];
+    };
+
+    static constexpr layout make_layout(std::initializer_list<value_type> entries) {
+        if (entries.size() != N) throw std::invalid_argument("cx::perfect_map: initialized with wrong number of entries!");
+
+        layout result{};
+        std::uint64_t hashes[N ? N : 1]{};
+        std::size_t bucket_start[N + 1]{};
+        std::size_t bucket_items[N ? N : 1]{};
+        bool taken[N ? N : 1]{};
+        for (std::size_t i = 0; i < N; ++i) hashes[i] = Hash{}((entries.begin() + i)->first);
+
+        const auto status = detail::pmh_build(hashes, N, result.pilots, result.order, bucket_start, bucket_items, taken);
+        if (status == detail::pmh_status::duplicate_key) {
+            throw std::invalid_argument("cx::perfect_map: duplicate keys (or a 64-bit hash collision)");
+        }
+        if (status == detail::pmh_status::no_pilot_found) {
+            throw std::invalid_argument("cx::perfect_map: could not find a perfect hash for the keys");
+        }
+        return result;
+    }
+
+    // same index_sequence trick as cx::map, except entries are pulled in slot order
+    template<std::size_t... Indices>
+    constexpr perfect_map(std::initializer_list<value_type>& entries, const layout& l, std::index_sequence<Indices...>)
+            : arr_{*(entries.begin() + l.order[Indices])...}, pilots_{l.pilots[Indices]...} {}
+
+    constexpr void throw_out_of_range() const {
+        throw std::out_of_range("cx::perfect_map::at: could not find entry in map");
+    }
+};
+
+}
@@ -0,0 +1,342 @@
+// Copyright (c) 2020. Mohit Deshpande.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+// the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#pragma once
+
+#include <cstdint>
+#include <initializer_list>
+#include <utility>
+
+#include "cx/cx_algorithm.h"
+#include "cx/cx_array.h"
+#include "cx/cx_config.h"
+#include "cx/cx_pair.h"
+#include "cx/cx_simd.h"
+#include "cx/cx_string.h"
+#include "cx/cx_string_map.h"
+
+#include <stdexcept>
+
+namespace cx {
+
+namespace detail {
+
+// one node of a radix_map: the edge label into it, the entry whose key ends at it and where its children are
+struct radix_node {
+    // points into the key of some entry below the node; the root's label is the prefix every key shares
+    const char* label;
+    std::uint32_t length;
+    // children are nodes [first_child, first_child + child_count), ordered by the first byte of their labels
+    std::uint32_t first_child;
+    std::uint32_t child_count;
+    // the entry whose key ends here, or N
+    std::uint32_t entry;
+    // every entry below the node (its own one included) is in [first_entry, last_entry)
+    std::uint32_t first_entry;
+    std::uint32_t last_entry;
+};
+
+// one entry of a radix_map's initializer list. The map keeps views of the keys rather than copies, so a key must
+// outlive the map: a string literal, a cx::string_ref or a cx::string stored in a variable. A temporary cx::string
+// (cx::lit("/api") written in the list) would dangle, so it doesn't compile.
+template<typename T>
+struct radix_entry {
+    template<std::size_t M>
+    constexpr radix_entry(const char (&key)[M], const T& value) : key{key}, value{value} {}
+
+    constexpr radix_entry(string_ref key, const T& value) : key{key}, value{value} {}
+
+    template<std::size_t M>
+    constexpr radix_entry(const string<M>& key, const T& value) : key{key}, value{value} {}
+
+    template<std::size_t M>
+    radix_entry(const string<M>&& key, const T& value) = delete;
+
+    string_ref key;
+    T value;
+};
+
+// a tree whose inner nodes all have two or more children has fewer than 2N nodes
+constexpr std::size_t radix_capacity(std::size_t n) noexcept { return n ? 2 * n - 1 : 1; }
+
+// byte order, shorter keys first, which is also the order of a depth-first walk of the tree
+constexpr bool key_less(string_ref a, string_ref b) noexcept {
+    const std::size_t n = a.size() < b.size() ? a.size() : b.size();
+    const int c = compare_bytes(a.data(), b.data(), n);
+    return c != 0 ? c < 0 : a.size() < b.size();
+}
+
+}
+
+// Immutable map from byte strings to T for prefix lookups: longest_prefix() finds the entry with the longest key that
+// starts a query (URL routes, byte-aligned IP prefixes), find() the exact key and prefix_range() every entry under a
+// prefix. Keys are string literals, cx::strings or cx::string_refs; a literal's terminator is not part of the key, so
+// keys can hold '\0' bytes ("\x0a\x00" is 10.0/16). Keys are viewed, not copied (see detail::radix_entry).
+//
+// The map is a radix tree laid out in one array during constant evaluation. Chains of single-child nodes are merged
+// into one edge whose label points into a key, siblings are stored next to each other, and their first bytes are kept
+// in a separate array so that picking a child reads a few contiguous bytes. Entries are stored in key order, so the
+// entries under any node are a contiguous range. A lookup touches one node, one label and one run of branch bytes per
+// level and never allocates.
+template<typename T, std::size_t N>
+class radix_map {
+public:
+    // a bunch of typedefs
+    using key_type = string_ref;
+    using mapped_type = T;
+    using value_type = cx::pair<const string_ref, const T>;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = value_type&;
+    using const_reference = const value_type&;
+    using pointer = value_type*;
+    using const_pointer = const value_type*;
+    using iterator = value_type*;
+    using const_iterator = const value_type*;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    // constructors and assignment
+    constexpr radix_map(std::initializer_list<detail::radix_entry<T>> entries)
+            : radix_map(entries, make_layout(entries), std::make_index_sequence<N>(),
+                        std::make_index_sequence<kCapacity>()) {}
+
+    constexpr radix_map(const radix_map&) = default;
+    constexpr radix_map(radix_map&&) noexcept = default;
+
+    constexpr radix_map& operator=(const radix_map&) = default;
+    constexpr radix_map& operator=(radix_map&&) noexcept = default;
+
+    // iterators (entries are in key order)
+    constexpr const_iterator begin() const noexcept { return arr_.begin(); }
+    constexpr const_iterator end() const noexcept { return arr_.end(); }
+    constexpr const_reverse_iterator rbegin() const noexcept { return arr_.rbegin(); }
+    constexpr const_reverse_iterator rend() const noexcept { return arr_.rend(); }
+    constexpr const_iterator cbegin() const noexcept { return arr_.cbegin(); }
+    constexpr const_iterator cend() const noexcept { return arr_.cend(); }
+    constexpr const_reverse_iterator crbegin() const noexcept { return arr_.crbegin(); }
+    constexpr const_reverse_iterator crend() const noexcept { return arr_.crend(); }
+
+    // element access
+    template<typename K>
+    constexpr const T& at(const K& key) const {
+        const auto it = find(key);
+        // we can't directly put the throw here since this is a core constant expression
+        // (see C++ spec §5.20 [expr.const])
+        if (it == end()) throw_out_of_range();
+        return it->second;
+    }
+
+    template<typename K>
+    constexpr const T& operator[](const K& key) const {
+        return at(key);
+    }
+
+    // capacity
+    constexpr bool empty() const noexcept { return size() == 0; }
+    constexpr std::size_t size() const noexcept { return N; }
+    constexpr std::size_t max_size() const noexcept { return N; }
+    constexpr std::size_t node_count() const noexcept { return node_count_; }
+
+    // lookup: keys are anything with data() and size() (std::string_view, std::string, cx::string_ref), cx::strings
+    // or string literals
+    template<typename K>
+    constexpr size_type count(const K& key) const noexcept {
+        return find(key) == end() ? 0 : 1;
+    }
+
+    template<typename K>
+    constexpr const_iterator find(const K& key) const noexcept {
+        const string_ref query = as_ref(key);
+        std::size_t node = 0;
+        std::size_t pos = 0;
+        while (node != kNoNode) {
+            const detail::radix_node& n = nodes_[node];
+            if (query.size() - pos < n.length || !detail::equal_bytes(n.label, query.data() + pos, n.length)) break;
+            pos += n.length;
+            if (pos == query.size()) return n.entry != N ? begin() + n.entry : end();
+            node = child(n, query[pos]);
+        }
+        return end();
+    }
+
+    // the entry with the longest key that is a prefix of key, or end()
+    template<typename K>
+    constexpr const_iterator longest_prefix(const K& key) const noexcept {
+        const string_ref query = as_ref(key);
+        const_iterator best = end();
+        std::size_t node = 0;
+        std::size_t pos = 0;
+        while (node != kNoNode) {
+            const detail::radix_node& n = nodes_[node];
+            if (query.size() - pos < n.length || !detail::equal_bytes(n.label, query.data() + pos, n.length)) break;
+            pos += n.length;
+            if (n.entry != N) best = begin() + n.entry;
+            if (pos == query.size()) break;
+            node = child(n, query[pos]);
+        }
+        return best;
+    }
+
+    // the entries whose keys start with prefix, in key order
+    template<typename K>
+    constexpr cx::pair<const_iterator, const_iterator> prefix_range(const K& prefix) const noexcept {
+        const string_ref query = as_ref(prefix);
+        std::size_t node = 0;
+        std::size_t pos = 0;
+        while (node != kNoNode) {
+            const detail::radix_node& n = nodes_[node];
+            // the prefix can end partway down an edge
+            const std::size_t length = query.size() - pos < n.length ? query.size() - pos : n.length;
+            if (!detail::equal_bytes(n.label, query.data() + pos, length)) break;
+            pos += length;
+            if (pos == query.size()) return {begin() + n.first_entry, begin() + n.last_entry};
+            node = child(n, query[pos]);
+        }
+        return {end(), end()};
+    }
+
+private:
+    static constexpr std::size_t kCapacity = detail::radix_capacity(N);
+    static constexpr std::size_t kNoNode = kCapacity;
+
+    // entries in key order
+    const cx::array<value_type, N> arr_;
+    // nodes in breadth-first order, so the children of a node are next to each other; nodes_[0] is the root
+    const cx::array<detail::radix_node, kCapacity> nodes_;
+    // the first byte of each node's label, to pick a child without touching the nodes
+    const cx::array<unsigned char, kCapacity> branch_;
+    const std::size_t node_count_;
+
+    struct layout {
+        std::size_t order[N ? N : 1];
+        detail::radix_node nodes[kCapacity];
+        unsigned char branch[kCapacity];
+        std::size_t node_count;
+    };
+
+    struct index_less {
+        const detail::radix_entry<T>* entries;
+        constexpr bool operator()(std::size_t a, std::size_t b) const {
+            return detail::key_less(entries[a].key, entries[b].key);
+        }
+    };
+
+    static constexpr layout make_layout(std::initializer_list<detail::radix_entry<T>> entries) {
+        if (entries.size() != N) {
+            throw std::invalid_argument("cx::radix_map: initialized with wrong number of entries!");
+        }
+
+        layout result{};
+        std::size_t scratch[N ? N : 1]{};
+        detail::merge_sort_indices(result.order, scratch, N, index_less{entries.begin()});
+
+        string_ref keys[N ? N : 1]{};
+        for (std::size_t i = 0; i < N; ++i) {
+            keys[i] = (entries.begin() + result.order[i])->key;
+            if (i > 0 && !detail::key_less(keys[i - 1], keys[i])) {
+                throw std::invalid_argument("cx::radix_map: duplicate keys");
+            }
+        }
+
+        // Each node covers a run of keys [lo, hi) that share their first depth bytes; its label runs from there to the
+        // end of the longest prefix the run shares (the first and last key's common prefix, since the run is sorted).
+        // Nodes are handed out in the order they are queued, so the array is its own breadth-first queue.
+        std::size_t lo[kCapacity]{};
+        std::size_t hi[kCapacity]{};
+        std::size_t depth[kCapacity]{};
+        hi[0] = N;
+        result.node_count = 1;
+        for (std::size_t i = 0; i < result.node_count; ++i) {
+            detail::radix_node& node = result.nodes[i];
+            node.entry = static_cast<std::uint32_t>(N);
+            node.first_entry = static_cast<std::uint32_t>(lo[i]);
+            node.last_entry = static_cast<std::uint32_t>(hi[i]);
+            node.first_child = static_cast<std::uint32_t>(result.node_count);
+            if (lo[i] == hi[i]) continue;
+
+            const string_ref first = keys[lo[i]];
+            const string_ref last = keys[hi[i] - 1];
+            std::size_t end = depth[i];
+            while (end < first.size() && end < last.size() && first[end] == last[end]) ++end;
+            node.label = first.data() + depth[i];
+            node.length = static_cast<std::uint32_t>(end - depth[i]);
+
+            // a key that ends here sorts first; every other key in the run is longer
+            std::size_t k = lo[i];
+            if (first.size() == end) node.entry = static_cast<std::uint32_t>(k++);
+            while (k < hi[i]) {
+                const char byte = keys[k][end];
+                const std::size_t child = result.node_count++;
+                lo[child] = k;
+                while (k < hi[i] && keys[k][end] == byte) ++k;
+                hi[child] = k;
+                depth[child] = end;
+                result.branch[child] = static_cast<unsigned char>(byte);
+            }
+            node.child_count = static_cast<std::uint32_t>(result.node_count - node.first_child);
+        }
+        return result;
+    }
+
+    template<std::size_t... Indices, std::size_t... NodeIndices>
+    constexpr radix_map(std::initializer_list<detail::radix_entry<T>>& entries, const layout& l,
+                        std::index_sequence<Indices...>, std::index_sequence<NodeIndices...>)
+            : arr_{entry(entries, l.order[Indices])...},
+              nodes_{l.nodes[NodeIndices]...},
+              branch_{l.branch[NodeIndices]...},
+              node_count_{l.node_count} {}
+
+    static constexpr value_type entry(std::initializer_list<detail::radix_entry<T>>& entries, std::size_t i) {
+        return value_type{(entries.begin() + i)->key, (entries.begin() + i)->value};
+    }
+
+    template<typename StringLike,
+             typename = decltype(std::declval<const StringLike&>().data(), std::declval<const StringLike&>().size())>
+    static constexpr string_ref as_ref(const StringLike& key) noexcept { return {key.data(), key.size()}; }
+
+    template<std::size_t M>
+    static constexpr string_ref as_ref(const string<M>& key) noexcept { return key; }
+
+    template<std::size_t M>
+    static constexpr string_ref as_ref(const char (&key)[M]) noexcept { return key; }
+
+    // the child of n whose label starts with byte, or kNoNode
+    constexpr std::size_t child(const detail::radix_node& n, char byte) const noexcept {
+        const unsigned char* first = branch_.data() + n.first_child;
+        const auto b = static_cast<unsigned char>(byte);
+        std::size_t i = 0;
+        if (!CX_IS_CONSTANT_EVALUATED()) {
+            i = detail::simd_find(first, n.child_count, b);
+        } else {
+            while (i < n.child_count && first[i] != b) ++i;
+        }
+        return i == n.child_count ? kNoNode : n.first_child + i;
+    }
+
+    constexpr void throw_out_of_range() const {
+        throw std::out_of_range("cx::radix_map::at: could not find entry in map");
+    }
+};
+
+// out-of-class definitions of the static members (needed before C++17)
+template<typename T, std::size_t N>
+constexpr std::size_t radix_map<T, N>::kCapacity;
+
+template<typename T, std::size_t N>
+constexpr std::size_t radix_map<T, N>::kNoNode;
+
+}
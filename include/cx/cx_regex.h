@@ -0,0 +1,721 @@
+// Copyright (c) 2020. Mohit Deshpande.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+// the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#pragma once
+
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+#include "cx/cx_array.h"
+#include "cx/cx_string.h"
+
+#include <stdexcept>
+
+namespace cx {
+
+namespace detail {
+
+constexpr std::uint32_t kRegexNone = 0xffffffffu;
+
+// a set of bytes, one bit each
+struct byte_set {
+    std::uint64_t bits[4];
+
+    constexpr void add(unsigned char b) noexcept { bits[b >> 6] |= std::uint64_t{1} << (b & 63); }
+    constexpr void add_range(unsigned char lo, unsigned char hi) noexcept {
+        for (unsigned b = lo; b <= hi; ++b) add(static_cast<unsigned char>(b));
+    }
+    constexpr void add_all(const byte_set& other) noexcept {
+        for (std::size_t i = 0; i < 4; ++i) bits[i] |= other.bits[i];
+    }
+    constexpr void invert() noexcept {
+        for (auto& word : bits) word = ~word;
+    }
+    constexpr bool contains(unsigned char b) const noexcept { return (bits[b >> 6] >> (b & 63)) & 1; }
+
+    // the only byte in the set, or -1
+    constexpr int single() const noexcept {
+        int found = -1;
+        for (unsigned b = 0; b < 256; ++b) {
+            if (!contains(static_cast<unsigned char>(b))) continue;
+            if (found != -1) return -1;
+            found = static_cast<int>(b);
+        }
+        return found;
+    }
+};
+
+// A Thompson NFA state: either it consumes a byte in set and moves to next, or it moves to next and/or alt without
+// consuming anything
+struct regex_nfa_state {
+    byte_set set;
+    bool consumes;
+    std::uint32_t next;
+    std::uint32_t alt;
+};
+
+// an NFA fragment: start, and an end state whose next and alt are still unset
+struct regex_fragment {
+    std::uint32_t start;
+    std::uint32_t end;
+};
+
+template<std::size_t Capacity>
+struct regex_nfa {
+    regex_nfa_state states[Capacity];
+    std::size_t size;
+    std::uint32_t start;
+    std::uint32_t accept;
+
+    constexpr std::uint32_t add() {
+        if (size == Capacity) throw std::length_error("cx::regex: pattern needs more NFA states than NfaCapacity");
+        states[size] = regex_nfa_state{{}, false, kRegexNone, kRegexNone};
+        return static_cast<std::uint32_t>(size++);
+    }
+
+    constexpr regex_fragment empty() {
+        const std::uint32_t s = add();
+        return {s, s};
+    }
+
+    constexpr regex_fragment bytes(const byte_set& set) {
+        const std::uint32_t s = add();
+        const std::uint32_t e = add();
+        states[s].set = set;
+        states[s].consumes = true;
+        states[s].next = e;
+        return {s, e};
+    }
+
+    constexpr regex_fragment concat(regex_fragment a, regex_fragment b) {
+        states[a.end].next = b.start;
+        return {a.start, b.end};
+    }
+
+    constexpr regex_fragment either(regex_fragment a, regex_fragment b) {
+        const std::uint32_t s = add();
+        const std::uint32_t e = add();
+        states[s].next = a.start;
+        states[s].alt = b.start;
+        states[a.end].next = e;
+        states[b.end].next = e;
+        return {s, e};
+    }
+
+    constexpr regex_fragment star(regex_fragment a) {
+        const std::uint32_t s = add();
+        const std::uint32_t e = add();
+        states[s].next = a.start;
+        states[s].alt = e;
+        states[a.end].next = a.start;
+        states[a.end].alt = e;
+        return {s, e};
+    }
+
+    constexpr regex_fragment plus(regex_fragment a) {
+        const std::uint32_t e = add();
+        states[a.end].next = a.start;
+        states[a.end].alt = e;
+        return {a.start, e};
+    }
+
+    constexpr regex_fragment optional(regex_fragment a) {
+        const std::uint32_t s = add();
+        const std::uint32_t e = add();
+        states[s].next = a.start;
+        states[s].alt = e;
+        states[a.end].next = e;
+        return {s, e};
+    }
+};
+
+constexpr byte_set digit_bytes() noexcept {
+    byte_set set{};
+    set.add_range('0', '9');
+    return set;
+}
+
+constexpr byte_set word_bytes() noexcept {
+    byte_set set{};
+    set.add_range('a', 'z');
+    set.add_range('A', 'Z');
+    set.add_range('0', '9');
+    set.add('_');
+    return set;
+}
+
+constexpr byte_set space_bytes() noexcept {
+    byte_set set{};
+    set.add(' ');
+    set.add_range('\t', '\r');
+    return set;
+}
+
+constexpr int hex_value(char c) noexcept {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+// Recursive descent over the pattern, building the NFA as it goes:
+//
+//     alternation := concatenation ('|' concatenation)*
+//     concatenation := repetition*
+//     repetition := atom ('*' | '+' | '?' | '{m}' | '{m,}' | '{m,n}')?
+//     atom := '(' alternation ')' | '(?:' alternation ')' | '[' class ']' | '.' | '\' escape | byte
+template<std::size_t Capacity>
+struct regex_parser {
+    regex_nfa<Capacity>& nfa;
+    const char* pattern;
+    std::size_t length;
+    std::size_t pos;
+
+    constexpr bool done() const noexcept { return pos == length; }
+    constexpr char peek() const noexcept { return pattern[pos]; }
+
+    constexpr regex_fragment parse_alternation() {
+        regex_fragment f = parse_concatenation();
+        while (!done() && peek() == '|') {
+            ++pos;
+            f = nfa.either(f, parse_concatenation());
+        }
+        return f;
+    }
+
+    constexpr regex_fragment parse_concatenation() {
+        if (done() || peek() == '|' || peek() == ')') return nfa.empty();
+        regex_fragment f = parse_repetition();
+        while (!done() && peek() != '|' && peek() != ')') f = nfa.concat(f, parse_repetition());
+        return f;
+    }
+
+    constexpr regex_fragment parse_repetition() {
+        const std::size_t atom = pos;
+        regex_fragment f = parse_atom();
+        if (done()) return f;
+        switch (peek()) {
+            case '*': ++pos; f = nfa.star(f); break;
+            case '+': ++pos; f = nfa.plus(f); break;
+            case '?': ++pos; f = nfa.optional(f); break;
+            case '{': f = parse_count(atom, f); break;
+            default: return f;
+        }
+        if (!done() && (peek() == '*' || peek() == '+' || peek() == '?' || peek() == '{')) {
+            throw std::invalid_argument("cx::regex: nested quantifier (lazy and possessive ones are not supported)");
+        }
+        return f;
+    }
+
+    // another copy of the atom at pattern[atom], for counted repetition
+    constexpr regex_fragment copy_atom(std::size_t atom) {
+        const std::size_t resume = pos;
+        pos = atom;
+        const regex_fragment f = parse_atom();
+        pos = resume;
+        return f;
+    }
+
+    constexpr std::size_t parse_number() {
+        if (done() || peek() < '0' || peek() > '9') throw std::invalid_argument("cx::regex: expected a repeat count");
+        std::size_t n = 0;
+        while (!done() && peek() >= '0' && peek() <= '9') n = n * 10 + static_cast<std::size_t>(peek() - '0'), ++pos;
+        return n;
+    }
+
+    // {m}, {m,} or {m,n}: m copies of the atom, then a starred copy or n - m optional ones
+    constexpr regex_fragment parse_count(std::size_t atom, regex_fragment first) {
+        ++pos;
+        const std::size_t min = parse_number();
+        std::size_t max = min;
+        bool unbounded = false;
+        if (!done() && peek() == ',') {
+            ++pos;
+            unbounded = done() || peek() == '}';
+            if (!unbounded) max = parse_number();
+        }
+        if (done() || peek() != '}') throw std::invalid_argument("cx::regex: missing '}'");
+        ++pos;
+        if (!unbounded && max < min) throw std::invalid_argument("cx::regex: repeat count range is backwards");
+
+        regex_fragment result = nfa.empty();
+        bool used_first = false;
+        for (std::size_t i = 0; i < min; ++i) {
+            result = nfa.concat(result, used_first ? copy_atom(atom) : first);
+            used_first = true;
+        }
+        if (unbounded) return nfa.concat(result, nfa.star(used_first ? copy_atom(atom) : first));
+        for (std::size_t i = min; i < max; ++i) {
+            result = nfa.concat(result, nfa.optional(used_first ? copy_atom(atom) : first));
+            used_first = true;
+        }
+        return result;
+    }
+
+    constexpr regex_fragment parse_atom() {
+        const char c = pattern[pos++];
+        switch (c) {
+            case '(': {
+                if (length - pos >= 2 && pattern[pos] == '?' && pattern[pos + 1] == ':') pos += 2;
+                const regex_fragment f = parse_alternation();
+                if (done() || peek() != ')') throw std::invalid_argument("cx::regex: missing ')'");
+                ++pos;
+                return f;
+            }
+            case '[':
+                return nfa.bytes(parse_class());
+            case '.': {
+                byte_set any{};
+                any.add('\n');
+                any.invert();
+                return nfa.bytes(any);
+            }
+            case '\\':
+                return nfa.bytes(parse_escape());
+            case '*': case '+': case '?': case '{':
+                throw std::invalid_argument("cx::regex: nothing to repeat");
+            case '^': case '$':
+                throw std::invalid_argument("cx::regex: anchors are not supported; match() is anchored, search() not");
+            default: {
+                byte_set one{};
+                one.add(static_cast<unsigned char>(c));
+                return nfa.bytes(one);
+            }
+        }
+    }
+
+    // the escape after a backslash: \d \w \s (and \D \W \S), \n \t \r \f \v \0, \xHH or an escaped punctuation byte
+    constexpr byte_set parse_escape() {
+        if (done()) throw std::invalid_argument("cx::regex: trailing backslash");
+        const char c = pattern[pos++];
+        byte_set set{};
+        switch (c) {
+            case 'd': return digit_bytes();
+            case 'w': return word_bytes();
+            case 's': return space_bytes();
+            case 'D': set = digit_bytes(); set.invert(); return set;
+            case 'W': set = word_bytes(); set.invert(); return set;
+            case 'S': set = space_bytes(); set.invert(); return set;
+            case 'n': set.add('\n'); return set;
+            case 't': set.add('\t'); return set;
+            case 'r': set.add('\r'); return set;
+            case 'f': set.add('\f'); return set;
+            case 'v': set.add('\v'); return set;
+            case '0': set.add('\0'); return set;
+            case 'x': {
+                if (length - pos < 2 || hex_value(pattern[pos]) < 0 || hex_value(pattern[pos + 1]) < 0) {
+                    throw std::invalid_argument("cx::regex: \\x needs two hex digits");
+                }
+                set.add(static_cast<unsigned char>(hex_value(pattern[pos]) * 16 + hex_value(pattern[pos + 1])));
+                pos += 2;
+                return set;
+            }
+            default:
+                if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9')) {
+                    throw std::invalid_argument("cx::regex: unknown escape");
+                }
+                set.add(static_cast<unsigned char>(c));
+                return set;
+        }
+    }
+
+    // one class member: a byte, or an escape (which can be a whole set like \d)
+    constexpr byte_set parse_class_member() {
+        if (peek() == '\\') {
+            ++pos;
+            return parse_escape();
+        }
+        byte_set one{};
+        one.add(static_cast<unsigned char>(pattern[pos++]));
+        return one;
+    }
+
+    // [abc], [a-z0-9_], [^\s,]; a ']' first or a '-' first or last is literal
+    constexpr byte_set parse_class() {
+        byte_set set{};
+        bool negate = false;
+        if (!done() && peek() == '^') {
+            negate = true;
+            ++pos;
+        }
+        for (bool first = true;; first = false) {
+            if (done()) throw std::invalid_argument("cx::regex: missing ']'");
+            if (peek() == ']' && !first) {
+                ++pos;
+                break;
+            }
+            const byte_set lo = parse_class_member();
+            if (length - pos >= 2 && peek() == '-' && pattern[pos + 1] != ']') {
+                ++pos;
+                const byte_set hi = parse_class_member();
+                if (lo.single() < 0 || hi.single() < 0 || lo.single() > hi.single()) {
+                    throw std::invalid_argument("cx::regex: bad character range");
+                }
+                set.add_range(static_cast<unsigned char>(lo.single()), static_cast<unsigned char>(hi.single()));
+            } else {
+                set.add_all(lo);
+            }
+        }
+        if (negate) set.invert();
+        return set;
+    }
+};
+
+// Splits the bytes into classes that every set in the NFA either contains whole or not at all, so the DFA needs one
+// column per class instead of 256. Returns the number of classes.
+template<std::size_t Capacity>
+constexpr std::size_t regex_byte_classes(const regex_nfa<Capacity>& nfa, std::uint8_t* class_of) {
+    for (std::size_t b = 0; b < 256; ++b) class_of[b] = 0;
+    std::size_t count = 1;
+    for (std::size_t s = 0; s < nfa.size; ++s) {
+        if (!nfa.states[s].consumes) continue;
+        bool inside[256]{};
+        bool outside[256]{};
+        for (std::size_t b = 0; b < 256; ++b) {
+            (nfa.states[s].set.contains(static_cast<unsigned char>(b)) ? inside : outside)[class_of[b]] = true;
+        }
+        // a class with bytes on both sides of the set splits: the bytes inside get a new class
+        std::size_t split[256]{};
+        for (std::size_t k = 0; k < count; ++k) split[k] = inside[k] && outside[k] ? count++ : k;
+        for (std::size_t b = 0; b < 256; ++b) {
+            if (nfa.states[s].set.contains(static_cast<unsigned char>(b))) {
+                class_of[b] = static_cast<std::uint8_t>(split[class_of[b]]);
+            }
+        }
+    }
+    return count;
+}
+
+// A DFA with up to MaxStates states over 256 class columns; next[s * 256 + c] is the state after a byte of class c
+template<std::size_t MaxStates>
+struct regex_dfa {
+    std::uint32_t next[MaxStates * 256];
+    bool accepting[MaxStates];
+    std::size_t size;
+    std::uint32_t match_start;
+    std::uint32_t search_start;
+};
+
+// adds every state reachable from set without consuming a byte
+template<std::size_t Capacity>
+constexpr void regex_closure(const regex_nfa<Capacity>& nfa, std::uint64_t* set) {
+    std::uint32_t stack[Capacity]{};
+    std::size_t top = 0;
+    for (std::uint32_t s = 0; s < nfa.size; ++s) {
+        if ((set[s >> 6] >> (s & 63)) & 1) stack[top++] = s;
+    }
+    while (top > 0) {
+        const regex_nfa_state& state = nfa.states[stack[--top]];
+        if (state.consumes) continue;
+        const std::uint32_t targets[] = {state.next, state.alt};
+        for (std::uint32_t t : targets) {
+            if (t == kRegexNone || ((set[t >> 6] >> (t & 63)) & 1)) continue;
+            set[t >> 6] |= std::uint64_t{1} << (t & 63);
+            stack[top++] = t;
+        }
+    }
+}
+
+// Subset construction of two automata into one table: the match automaton for the pattern, and the search automaton
+// for any bytes followed by the pattern (the start set is added back after every byte), whose accepting states are
+// absorbing since a search stops at its first match. Moore's partition refinement then merges equivalent states of
+// both. MaxStates bounds the states before minimization.
+template<std::size_t Capacity, std::size_t MaxStates>
+constexpr regex_dfa<MaxStates> make_regex_dfa(const regex_nfa<Capacity>& nfa, const std::uint8_t* class_of,
+                                              std::size_t classes) {
+    constexpr std::size_t kWords = (Capacity + 63) / 64;
+    regex_dfa<MaxStates> dfa{};
+    std::uint64_t sets[MaxStates * kWords]{};
+    std::uint64_t hashes[MaxStates]{};
+    bool unanchored[MaxStates]{};
+
+    unsigned char representative[256]{};
+    for (std::size_t b = 0; b < 256; ++b) representative[class_of[b]] = static_cast<unsigned char>(b);
+
+    std::uint64_t start[kWords]{};
+    start[nfa.start >> 6] |= std::uint64_t{1} << (nfa.start & 63);
+    regex_closure(nfa, start);
+
+    // the state for (set, mode), added if it's new
+    struct state_table {
+        const regex_nfa<Capacity>& nfa;
+        regex_dfa<MaxStates>& dfa;
+        std::uint64_t* sets;
+        std::uint64_t* hashes;
+        bool* unanchored;
+
+        constexpr std::uint32_t find_or_add(const std::uint64_t* set, bool search) {
+            std::uint64_t h = search;
+            for (std::size_t w = 0; w < kWords; ++w) h = (h ^ set[w]) * 0x100000001b3ULL;
+            for (std::size_t i = 0; i < dfa.size; ++i) {
+                if (hashes[i] != h || unanchored[i] != search) continue;
+                bool same = true;
+                for (std::size_t w = 0; w < kWords && same; ++w) same = sets[i * kWords + w] == set[w];
+                if (same) return static_cast<std::uint32_t>(i);
+            }
+            if (dfa.size == MaxStates) throw std::length_error("cx::regex: the DFA needs more than MaxStates states");
+            const std::size_t i = dfa.size++;
+            for (std::size_t w = 0; w < kWords; ++w) sets[i * kWords + w] = set[w];
+            hashes[i] = h;
+            unanchored[i] = search;
+            dfa.accepting[i] = (set[nfa.accept >> 6] >> (nfa.accept & 63)) & 1;
+            return static_cast<std::uint32_t>(i);
+        }
+    };
+    state_table states{nfa, dfa, sets, hashes, unanchored};
+    dfa.match_start = states.find_or_add(start, false);
+    dfa.search_start = states.find_or_add(start, true);
+
+    for (std::size_t i = 0; i < dfa.size; ++i) {
+        for (std::size_t c = 0; c < classes; ++c) {
+            if (unanchored[i] && dfa.accepting[i]) {
+                dfa.next[i * 256 + c] = static_cast<std::uint32_t>(i);
+                continue;
+            }
+            std::uint64_t moved[kWords]{};
+            for (std::uint32_t s = 0; s < nfa.size; ++s) {
+                if (!((sets[i * kWords + (s >> 6)] >> (s & 63)) & 1)) continue;
+                const regex_nfa_state& state = nfa.states[s];
+                if (state.consumes && state.set.contains(representative[c])) {
+                    moved[state.next >> 6] |= std::uint64_t{1} << (state.next & 63);
+                }
+            }
+            regex_closure(nfa, moved);
+            if (unanchored[i]) {
+                for (std::size_t w = 0; w < kWords; ++w) moved[w] |= start[w];
+            }
+            dfa.next[i * 256 + c] = states.find_or_add(moved, unanchored[i]);
+        }
+    }
+
+    // Moore: split blocks until every state in a block goes to the same blocks; a block is numbered after the first
+    // state in it, which is kept as its representative
+    std::uint32_t block[MaxStates]{};
+    std::uint32_t refined[MaxStates]{};
+    std::uint32_t first_of[MaxStates]{};
+    std::size_t blocks = 0;
+    for (std::size_t changed = 1; changed;) {
+        std::size_t count = 0;
+        for (std::size_t s = 0; s < dfa.size; ++s) {
+            std::size_t k = 0;
+            for (; k < count; ++k) {
+                const std::size_t r = first_of[k];
+                bool same = dfa.accepting[r] == dfa.accepting[s] && (blocks == 0 || block[r] == block[s]);
+                for (std::size_t c = 0; c < classes && same && blocks != 0; ++c) {
+                    same = block[dfa.next[r * 256 + c]] == block[dfa.next[s * 256 + c]];
+                }
+                if (same) break;
+            }
+            if (k == count) first_of[count++] = static_cast<std::uint32_t>(s);
+            refined[s] = static_cast<std::uint32_t>(k);
+        }
+        changed = count != blocks;
+        blocks = count;
+        for (std::size_t s = 0; s < dfa.size; ++s) block[s] = refined[s];
+    }
+
+    regex_dfa<MaxStates> minimal{};
+    minimal.size = blocks;
+    for (std::size_t k = 0; k < blocks; ++k) {
+        const std::size_t r = first_of[k];
+        minimal.accepting[k] = dfa.accepting[r];
+        for (std::size_t c = 0; c < classes; ++c) minimal.next[k * 256 + c] = block[dfa.next[r * 256 + c]];
+    }
+    minimal.match_start = block[dfa.match_start];
+    minimal.search_start = block[dfa.search_start];
+    return minimal;
+}
+
+}
+
+template<std::size_t States, std::size_t Classes>
+class regex;
+
+// A parsed pattern: the first step of building a cx::regex. Like string_pool, the DFA's size is only known once it
+// has been built, so the builder measures it and compact<state_count(), class_count()>() builds the table at its exact
+// size. Only the regex ends up in the binary.
+template<std::size_t NfaCapacity, std::size_t MaxStates>
+class regex_builder {
+public:
+    using size_type = std::size_t;
+
+    constexpr regex_builder(const char* pattern, std::size_t length) {
+        detail::regex_parser<NfaCapacity> parser{nfa_, pattern, length, 0};
+        const detail::regex_fragment f = parser.parse_alternation();
+        if (!parser.done()) throw std::invalid_argument("cx::regex: unmatched ')'");
+        nfa_.start = f.start;
+        nfa_.accept = f.end;
+        class_count_ = detail::regex_byte_classes(nfa_, class_of_);
+        state_count_ = detail::make_regex_dfa<NfaCapacity, MaxStates>(nfa_, class_of_, class_count_).size;
+    }
+
+    template<std::size_t States, std::size_t Classes>
+    constexpr regex<States, Classes> compact() const {
+        return regex<States, Classes>(*this);
+    }
+
+    // capacity
+    constexpr size_type state_count() const noexcept { return state_count_; }
+    constexpr size_type class_count() const noexcept { return class_count_; }
+    constexpr size_type nfa_size() const noexcept { return nfa_.size; }
+
+private:
+    template<std::size_t, std::size_t>
+    friend class regex;
+
+    detail::regex_nfa<NfaCapacity> nfa_{};
+    std::uint8_t class_of_[256]{};
+    std::size_t class_count_{};
+    std::size_t state_count_{};
+};
+
+// A regular expression compiled during constant evaluation into a minimal DFA: States rows of Classes entries, where
+// a byte's class is looked up in a 256-entry table. match() tells whether the whole text matches and search() whether
+// some part of it does; both run one table lookup per byte and never allocate or backtrack.
+//
+// The syntax is the common subset that a DFA can run: literals, '.', classes ([a-z_], [^,], \d \w \s \D \W \S),
+// escapes (\n \t \r \f \v \0 \xHH), groups ((...) and (?:...), which capture nothing), '|', and the quantifiers '*',
+// '+', '?', {m}, {m,} and {m,n}. Anchors, backreferences and lazy quantifiers are not supported. '.' matches any byte
+// but '\n'; classes and escapes are bytes, not UTF-8 code points.
+//
+// Entries are premultiplied by Classes, so a step is two loads and an add, and accepting states are numbered last, so
+// telling whether a state accepts is one compare. The match and search automata share one table, so states the two
+// have in common are stored once.
+//
+//     constexpr auto kTokenBuilder = cx::make_regex(cx::lit("[A-Za-z0-9-]+(\\.[A-Za-z0-9-]+)*"));
+//     constexpr auto kToken = kTokenBuilder.compact<kTokenBuilder.state_count(), kTokenBuilder.class_count()>();
+//     kToken.match(host);
+template<std::size_t States, std::size_t Classes>
+class regex {
+public:
+    // a bunch of typedefs
+    using size_type = std::size_t;
+    using state_type = std::conditional_t<(States * Classes <= 0xffffu), std::uint16_t, std::uint32_t>;
+
+    // constructors and assignment
+    template<std::size_t NfaCapacity, std::size_t MaxStates>
+    constexpr explicit regex(const regex_builder<NfaCapacity, MaxStates>& builder) {
+        if (builder.state_count() != States || builder.class_count() != Classes) {
+            throw std::length_error("cx::regex: wrong number of states or byte classes");
+        }
+        for (std::size_t b = 0; b < 256; ++b) classes_[b] = builder.class_of_[b];
+        const auto dfa = detail::make_regex_dfa<NfaCapacity, MaxStates>(builder.nfa_, builder.class_of_, Classes);
+
+        // accepting states go last, so a state is accepting when its row starts at accept_from_ or later
+        std::size_t row[States]{};
+        std::size_t rows = 0;
+        for (std::size_t s = 0; s < States; ++s) {
+            if (!dfa.accepting[s]) row[s] = rows++;
+        }
+        accept_from_ = static_cast<state_type>(rows * Classes);
+        for (std::size_t s = 0; s < States; ++s) {
+            if (dfa.accepting[s]) row[s] = rows++;
+        }
+        for (std::size_t s = 0; s < States; ++s) {
+            for (std::size_t c = 0; c < Classes; ++c) {
+                table_[row[s] * Classes + c] = static_cast<state_type>(row[dfa.next[s * 256 + c]] * Classes);
+            }
+        }
+        match_start_ = static_cast<state_type>(row[dfa.match_start] * Classes);
+        search_start_ = static_cast<state_type>(row[dfa.search_start] * Classes);
+    }
+
+    constexpr regex(const regex&) = default;
+    constexpr regex(regex&&) noexcept = default;
+
+    constexpr regex& operator=(const regex&) = default;
+    constexpr regex& operator=(regex&&) noexcept = default;
+
+    // capacity
+    constexpr size_type state_count() const noexcept { return States; }
+    constexpr size_type class_count() const noexcept { return Classes; }
+
+    // lookup: whether all of text matches
+    constexpr bool match(const char* data, size_type size) const noexcept {
+        state_type s = match_start_;
+        for (size_type i = 0; i < size; ++i) s = step(s, data[i]);
+        return s >= accept_from_;
+    }
+
+    // whether some part of text matches
+    constexpr bool search(const char* data, size_type size) const noexcept {
+        state_type s = search_start_;
+        for (size_type i = 0; i < size && s < accept_from_; ++i) s = step(s, data[i]);
+        return s >= accept_from_;
+    }
+
+    // std::string_view, std::string and anything else with data() and size()
+    template<typename StringLike,
+             typename = decltype(std::declval<const StringLike&>().data(), std::declval<const StringLike&>().size())>
+    constexpr bool match(const StringLike& text) const noexcept {
+        return match(text.data(), text.size());
+    }
+
+    template<std::size_t M>
+    constexpr bool match(const string<M>& text) const noexcept {
+        return match(text.c_str(), M);
+    }
+
+    template<std::size_t M>
+    constexpr bool match(const char (&text)[M]) const noexcept {
+        return match(text, M - 1);
+    }
+
+    template<typename StringLike,
+             typename = decltype(std::declval<const StringLike&>().data(), std::declval<const StringLike&>().size())>
+    constexpr bool search(const StringLike& text) const noexcept {
+        return search(text.data(), text.size());
+    }
+
+    template<std::size_t M>
+    constexpr bool search(const string<M>& text) const noexcept {
+        return search(text.c_str(), M);
+    }
+
+    template<std::size_t M>
+    constexpr bool search(const char (&text)[M]) const noexcept {
+        return search(text, M - 1);
+    }
+
+private:
+    // transitions of state s (row s * Classes) premultiplied by Classes; accepting states are the last rows
+    cx::array<state_type, States * Classes> table_{};
+    cx::array<std::uint8_t, 256> classes_{};
+    state_type match_start_{};
+    state_type search_start_{};
+    state_type accept_from_{};
+
+    constexpr state_type step(state_type s, char byte) const noexcept {
+        return table_[s + classes_[static_cast<unsigned char>(byte)]];
+    }
+};
+
+// Parses a string literal or cx::string pattern; see regex for the syntax and regex_builder for how to compact it.
+// NfaCapacity defaults to 16 NFA states per pattern byte, which only counted repetition like a{100} can run out of.
+template<std::size_t MaxStates = 256, std::size_t NfaCapacity = 0, std::size_t M>
+constexpr auto make_regex(const string<M>& pattern) {
+    constexpr std::size_t kCapacity = NfaCapacity ? NfaCapacity : 16 * (M + 1);
+    return regex_builder<kCapacity, MaxStates>(pattern.c_str(), M);
+}
+
+template<std::size_t MaxStates = 256, std::size_t NfaCapacity = 0, std::size_t M>
+constexpr auto make_regex(const char (&pattern)[M]) {
+    constexpr std::size_t kCapacity = NfaCapacity ? NfaCapacity : 16 * M;
+    return regex_builder<kCapacity, MaxStates>(pattern, M - 1);
+}
+
+}
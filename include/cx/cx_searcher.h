@@ -0,0 +1,243 @@
+// Copyright (c) 2020. Mohit Deshpande.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+// the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#pragma once
+
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+#include "cx/cx_config.h"
+#include "cx/cx_simd.h"
+#include "cx/cx_string.h"
+#include "cx/cx_string_map.h"
+
+#include <stdexcept>
+
+namespace cx {
+
+namespace detail {
+
+// where the maximal suffix of x[0, n) starts (minus one, wrapping to SIZE_MAX for the whole string) and its period,
+// with bytes ordered normally or reversed: the two halves of the two-way algorithm's critical factorization
+struct maximal_suffix_result {
+    std::size_t start;
+    std::size_t period;
+};
+
+constexpr maximal_suffix_result maximal_suffix(const char* x, std::size_t n, bool reversed) noexcept {
+    std::size_t start = static_cast<std::size_t>(-1);
+    std::size_t j = 0;
+    std::size_t k = 1;
+    std::size_t period = 1;
+    while (j + k < n) {
+        const auto a = static_cast<unsigned char>(x[j + k]);
+        const auto b = static_cast<unsigned char>(x[start + k]);
+        if (reversed ? a > b : a < b) {
+            j += k;
+            k = 1;
+            period = j - start;
+        } else if (a == b) {
+            if (k != period) {
+                ++k;
+            } else {
+                j += period;
+                k = 1;
+            }
+        } else {
+            start = j++;
+            k = period = 1;
+        }
+    }
+    return {start, period};
+}
+
+}
+
+// Finds a fixed N-byte needle in runtime buffers. The needle's Boyer-Moore-Horspool shift table (how far the window
+// can move for each byte under its last position) is computed when the searcher is built, so a constexpr searcher
+// costs nothing at startup.
+//
+// At runtime, needles of two bytes or more are found a vector at a time: the candidate first and last bytes of 16 (32
+// with AVX2) windows are compared at once and only windows where both match compare the middle of the needle, whose
+// length is a constant. The Horspool table covers constant evaluation and the last partial vector. A single-byte
+// needle is a vectorized byte search.
+//
+// Both of those compare the whole needle at every candidate, so text that keeps matching part of a periodic needle
+// ("aaaa...ab" in a run of 'a's) makes them O(size * N). Once the comparisons that failed cost more than a few bytes
+// per byte of text, the rest of the search is the two-way algorithm, whose critical factorization of the needle is
+// also computed when the searcher is built: it is linear in the text and needs no more tables.
+//
+//     constexpr auto kMarker = cx::make_searcher("request_id=");
+//     for (auto at = kMarker.find(log); at != kMarker.npos; at = kMarker.find(log, at + kMarker.size())) { ... }
+template<std::size_t N>
+class searcher {
+public:
+    // a bunch of typedefs
+    using size_type = std::size_t;
+    using shift_type = std::conditional_t<(N < 256), std::uint8_t, std::uint32_t>;
+
+    static constexpr size_type npos = static_cast<size_type>(-1);
+
+    // constructors and assignment
+    constexpr explicit searcher(const string<N>& needle) : needle_{needle} {
+        for (auto& shift : shift_) shift = static_cast<shift_type>(N ? N : 1);
+        for (std::size_t i = 0; i + 1 < N; ++i) {
+            shift_[static_cast<unsigned char>(needle[i])] = static_cast<shift_type>(N - 1 - i);
+        }
+
+        // the critical factorization is the later of the two maximal suffixes
+        const auto forward = detail::maximal_suffix(needle_.c_str(), N, false);
+        const auto reversed = detail::maximal_suffix(needle_.c_str(), N, true);
+        const bool use_forward = reversed.start + 1 < forward.start + 1;
+        suffix_ = (use_forward ? forward.start : reversed.start) + 1;
+        period_ = use_forward ? forward.period : reversed.period;
+        periodic_ = suffix_ + period_ <= N && detail::compare_bytes(needle_.c_str(), needle_.c_str() + period_,
+                                                                    suffix_) == 0;
+        // without a period to remember, the needle can move past the longer half of the factorization
+        if (!periodic_) period_ = (suffix_ > N - suffix_ ? suffix_ : N - suffix_) + 1;
+    }
+
+    constexpr searcher(const searcher&) = default;
+    constexpr searcher(searcher&&) noexcept = default;
+
+    constexpr searcher& operator=(const searcher&) = default;
+    constexpr searcher& operator=(searcher&&) noexcept = default;
+
+    // element access
+    constexpr const string<N>& needle() const noexcept { return needle_; }
+    constexpr size_type shift(unsigned char byte) const noexcept { return shift_[byte]; }
+
+    // the two-way search's critical position and the shift after a full match (the needle's period if it is
+    // periodic)
+    constexpr size_type critical_position() const noexcept { return suffix_; }
+    constexpr size_type period() const noexcept { return period_; }
+    constexpr bool periodic() const noexcept { return periodic_; }
+
+    // capacity
+    constexpr size_type size() const noexcept { return N; }
+
+    // lookup: index of the first occurrence of the needle in data[from, size), or npos (from is not optional here, so a
+    // string literal and an offset can't be taken for a pointer and a length)
+    constexpr size_type find(const char* data, size_type size, size_type from) const noexcept {
+        if (from > size || size - from < N) return npos;
+        if (N == 0) return from;
+        if (!CX_IS_CONSTANT_EVALUATED()) {
+            if (N == 1) {
+                const size_type at = detail::simd_find(data + from, size - from, needle_.c_str()[0]);
+                return at == size - from ? npos : from + at;
+            }
+            size_type done = 0;
+            const size_type at = detail::simd_find_needle<(N >= 2 ? N : 2)>(data + from, size - from,
+                                                                           needle_.c_str(), done);
+            if (at != size - from) return from + at;
+            from += done;
+        }
+        return horspool(data, size, from);
+    }
+
+    // std::string_view, std::string and anything else with data() and size()
+    template<typename StringLike,
+             typename = decltype(std::declval<const StringLike&>().data(), std::declval<const StringLike&>().size())>
+    constexpr size_type find(const StringLike& text, size_type from = 0) const noexcept {
+        return find(text.data(), text.size(), from);
+    }
+
+    template<std::size_t M>
+    constexpr size_type find(const string<M>& text, size_type from = 0) const noexcept {
+        return find(text.c_str(), M, from);
+    }
+
+    template<std::size_t M>
+    constexpr size_type find(const char (&text)[M], size_type from = 0) const noexcept {
+        return find(text, M - 1, from);
+    }
+
+    template<typename Text>
+    constexpr bool contains(const Text& text) const noexcept {
+        return find(text) != npos;
+    }
+
+    // number of non-overlapping occurrences, counted left to right
+    template<typename Text>
+    constexpr size_type count(const Text& text) const noexcept {
+        size_type n = 0;
+        for (size_type at = find(text); at != npos; at = find(text, at + (N ? N : 1))) ++n;
+        return n;
+    }
+
+private:
+    const string<N> needle_;
+    shift_type shift_[256]{};
+    size_type suffix_{};
+    size_type period_{};
+    bool periodic_{};
+
+    // the scalar search: falls back on two_way() once the windows it compared in full cost more than
+    // kNeedleVerifyBudget bytes per byte it moved
+    CX_NOINLINE constexpr size_type horspool(const char* data, size_type size, size_type from) const noexcept {
+        size_type work = 0;
+        for (size_type i = from; i + N <= size;) {
+            const char last = data[i + N - 1];
+            if (last == needle_.c_str()[N - 1]) {
+                if (detail::compare_bytes(data + i, needle_.c_str(), N - 1) == 0) return i;
+                work += N - 1;
+                if (work > detail::kNeedleVerifyBudget * (i - from) + 4 * N) return two_way(data, size, i + 1);
+            }
+            i += shift_[static_cast<unsigned char>(last)];
+        }
+        return npos;
+    }
+
+    // Crochemore and Perrin's two-way search: match the right half of the factorization left to right, then the left
+    // half right to left. A periodic needle remembers how much of its prefix the last shift kept matched.
+    constexpr size_type two_way(const char* data, size_type size, size_type from) const noexcept {
+        const char* x = needle_.c_str();
+        size_type memory = 0;
+        for (size_type j = from; j + N <= size;) {
+            size_type i = suffix_ > memory ? suffix_ : memory;
+            while (i < N && x[i] == data[i + j]) ++i;
+            if (i < N) {
+                j += i - suffix_ + 1;
+                memory = 0;
+                continue;
+            }
+            // i counts down through the left half and wraps past 0; reaching memory means the whole needle matched
+            i = suffix_ - 1;
+            while (memory < i + 1 && x[i] == data[i + j]) --i;
+            if (i + 1 < memory + 1) return j;
+            j += period_;
+            memory = periodic_ ? N - period_ : 0;
+        }
+        return npos;
+    }
+};
+
+// out-of-class definition of npos (needed before C++17)
+template<std::size_t N>
+constexpr typename searcher<N>::size_type searcher<N>::npos;
+
+template<std::size_t N>
+constexpr searcher<N> make_searcher(const string<N>& needle) {
+    return searcher<N>(needle);
+}
+
+template<std::size_t M>
+constexpr searcher<M - 1> make_searcher(const char (&needle)[M]) {
+    return searcher<M - 1>(lit(needle));
+}
+
+}
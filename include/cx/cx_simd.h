@@ -0,0 +1,486 @@
+// Copyright (c) 2020. Mohit Deshpande.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+// the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+// Runtime-only vector kernels. Callers are constexpr functions that switch to these with CX_IS_CONSTANT_EVALUATED()
+// and keep a scalar loop for constant evaluation. The instruction set is picked at compile time (-msse2, -mavx2, ...);
+// anything else falls back to the scalar loop.
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include "cx/cx_config.h"
+
+#if defined(__AVX2__) || defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#define CX_SIMD_SSE2 1
+#endif
+
+#if defined(__AVX2__)
+#define CX_SIMD_AVX2 1
+#endif
+
+namespace cx {
+namespace detail {
+
+// types whose == is plain bitwise equality, so a lane compare gives the same answer
+template<typename T>
+struct is_simd_comparable
+        : std::integral_constant<bool, (std::is_integral<T>::value || std::is_enum<T>::value || std::is_pointer<T>::value)
+                                       && (sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8)> {};
+
+inline unsigned countr_zero32(std::uint32_t x) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<unsigned>(__builtin_ctz(x));
+#else
+    unsigned n = 0;
+    for (; !(x & 1); x >>= 1) ++n;
+    return n;
+#endif
+}
+
+inline unsigned popcount32(std::uint32_t x) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<unsigned>(__builtin_popcount(x));
+#else
+    unsigned n = 0;
+    for (; x; x &= x - 1) ++n;
+    return n;
+#endif
+}
+
+#if CX_SIMD_SSE2
+template<std::size_t Size> struct simd_lane;
+
+template<> struct simd_lane<1> {
+    static __m128i splat(const void* v) noexcept { std::int8_t x; std::memcpy(&x, v, 1); return _mm_set1_epi8(x); }
+    static __m128i eq(__m128i a, __m128i b) noexcept { return _mm_cmpeq_epi8(a, b); }
+#if CX_SIMD_AVX2
+    static __m256i splat256(const void* v) noexcept { std::int8_t x; std::memcpy(&x, v, 1); return _mm256_set1_epi8(x); }
+    static __m256i eq(__m256i a, __m256i b) noexcept { return _mm256_cmpeq_epi8(a, b); }
+#endif
+};
+
+template<> struct simd_lane<2> {
+    static __m128i splat(const void* v) noexcept { std::int16_t x; std::memcpy(&x, v, 2); return _mm_set1_epi16(x); }
+    static __m128i eq(__m128i a, __m128i b) noexcept { return _mm_cmpeq_epi16(a, b); }
+#if CX_SIMD_AVX2
+    static __m256i splat256(const void* v) noexcept { std::int16_t x; std::memcpy(&x, v, 2); return _mm256_set1_epi16(x); }
+    static __m256i eq(__m256i a, __m256i b) noexcept { return _mm256_cmpeq_epi16(a, b); }
+#endif
+};
+
+template<> struct simd_lane<4> {
+    static __m128i splat(const void* v) noexcept { std::int32_t x; std::memcpy(&x, v, 4); return _mm_set1_epi32(x); }
+    static __m128i eq(__m128i a, __m128i b) noexcept { return _mm_cmpeq_epi32(a, b); }
+#if CX_SIMD_AVX2
+    static __m256i splat256(const void* v) noexcept { std::int32_t x; std::memcpy(&x, v, 4); return _mm256_set1_epi32(x); }
+    static __m256i eq(__m256i a, __m256i b) noexcept { return _mm256_cmpeq_epi32(a, b); }
+#endif
+};
+
+template<> struct simd_lane<8> {
+    static __m128i splat(const void* v) noexcept { long long x; std::memcpy(&x, v, 8); return _mm_set1_epi64x(x); }
+    static __m128i eq(__m128i a, __m128i b) noexcept {
+        // SSE2 has no 64-bit compare: a qword matches when both of its dwords do
+        const __m128i dwords = _mm_cmpeq_epi32(a, b);
+        return _mm_and_si128(dwords, _mm_shuffle_epi32(dwords, _MM_SHUFFLE(2, 3, 0, 1)));
+    }
+#if CX_SIMD_AVX2
+    static __m256i splat256(const void* v) noexcept { long long x; std::memcpy(&x, v, 8); return _mm256_set1_epi64x(x); }
+    static __m256i eq(__m256i a, __m256i b) noexcept { return _mm256_cmpeq_epi64(a, b); }
+#endif
+};
+#endif
+
+// index of the first element equal to value, or n
+template<typename T>
+inline std::size_t simd_find(const T* data, std::size_t n, const T& value) noexcept {
+    static_assert(is_simd_comparable<T>::value, "cx::detail::simd_find: unsupported element type");
+    std::size_t i = 0;
+#if CX_SIMD_SSE2
+    using lane = simd_lane<sizeof(T)>;
+#if CX_SIMD_AVX2
+    constexpr std::size_t kWide = 32 / sizeof(T);
+    const __m256i needle256 = lane::splat256(&value);
+    for (; i + kWide <= n; i += kWide) {
+        const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        const auto mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(lane::eq(block, needle256)));
+        if (mask) return i + countr_zero32(mask) / sizeof(T);
+    }
+#endif
+    constexpr std::size_t kLanes = 16 / sizeof(T);
+    const __m128i needle = lane::splat(&value);
+    for (; i + kLanes <= n; i += kLanes) {
+        const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        const auto mask = static_cast<std::uint32_t>(_mm_movemask_epi8(lane::eq(block, needle)));
+        if (mask) return i + countr_zero32(mask) / sizeof(T);
+    }
+#endif
+    for (; i < n; ++i) {
+        if (data[i] == value) return i;
+    }
+    return n;
+}
+
+// number of elements equal to value
+template<typename T>
+inline std::size_t simd_count(const T* data, std::size_t n, const T& value) noexcept {
+    static_assert(is_simd_comparable<T>::value, "cx::detail::simd_count: unsupported element type");
+    std::size_t i = 0;
+    std::size_t count = 0;
+#if CX_SIMD_SSE2
+    // A matching element sets sizeof(T) bytes of the compare result to 0xff, so subtracting the results counts matches
+    // per byte. Byte counters are widened with a sum of absolute differences before they can wrap.
+    using lane = simd_lane<sizeof(T)>;
+    std::uint64_t bytes = 0;
+#if CX_SIMD_AVX2
+    constexpr std::size_t kWide = 32 / sizeof(T);
+    const __m256i needle256 = lane::splat256(&value);
+    const __m256i zero256 = _mm256_setzero_si256();
+    __m256i total256 = zero256;
+    while (i + kWide <= n) {
+        __m256i counters = zero256;
+        for (std::size_t blocks = 0; blocks < 255 && i + kWide <= n; ++blocks, i += kWide) {
+            const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+            counters = _mm256_sub_epi8(counters, lane::eq(block, needle256));
+        }
+        total256 = _mm256_add_epi64(total256, _mm256_sad_epu8(counters, zero256));
+    }
+    std::uint64_t sums256[4];
+    std::memcpy(sums256, &total256, sizeof(sums256));
+    bytes += sums256[0] + sums256[1] + sums256[2] + sums256[3];
+#endif
+    constexpr std::size_t kLanes = 16 / sizeof(T);
+    const __m128i needle = lane::splat(&value);
+    const __m128i zero = _mm_setzero_si128();
+    __m128i total = zero;
+    while (i + kLanes <= n) {
+        __m128i counters = zero;
+        for (std::size_t blocks = 0; blocks < 255 && i + kLanes <= n; ++blocks, i += kLanes) {
+            const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+            counters = _mm_sub_epi8(counters, lane::eq(block, needle));
+        }
+        total = _mm_add_epi64(total, _mm_sad_epu8(counters, zero));
+    }
+    std::uint64_t sums[2];
+    std::memcpy(sums, &total, sizeof(sums));
+    bytes += sums[0] + sums[1];
+    count = static_cast<std::size_t>(bytes / sizeof(T));
+    // where the loops above stopped, spelled so the compiler can see the tail below ends at n
+    i = n - n % kLanes;
+#endif
+    for (; i < n; ++i) {
+        if (data[i] == value) ++count;
+    }
+    return count;
+}
+
+// index of the first byte equal to any of bytes[0, count), or n; count is 1 to 3
+inline std::size_t simd_find_any(const char* data, std::size_t n, const char* bytes, std::size_t count) noexcept {
+    const char b0 = bytes[0];
+    const char b1 = count > 1 ? bytes[1] : b0;
+    const char b2 = count > 2 ? bytes[2] : b0;
+    std::size_t i = 0;
+#if CX_SIMD_SSE2
+#if CX_SIMD_AVX2
+    const __m256i n0 = _mm256_set1_epi8(b0), n1 = _mm256_set1_epi8(b1), n2 = _mm256_set1_epi8(b2);
+    for (; i + 32 <= n; i += 32) {
+        const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        const __m256i any = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(block, n0), _mm256_cmpeq_epi8(block, n1)),
+                                            _mm256_cmpeq_epi8(block, n2));
+        const auto mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(any));
+        if (mask) return i + countr_zero32(mask);
+    }
+#endif
+    const __m128i m0 = _mm_set1_epi8(b0), m1 = _mm_set1_epi8(b1), m2 = _mm_set1_epi8(b2);
+    for (; i + 16 <= n; i += 16) {
+        const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        const __m128i any = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(block, m0), _mm_cmpeq_epi8(block, m1)),
+                                         _mm_cmpeq_epi8(block, m2));
+        const auto mask = static_cast<std::uint32_t>(_mm_movemask_epi8(any));
+        if (mask) return i + countr_zero32(mask);
+    }
+#endif
+    for (; i < n; ++i) {
+        if (data[i] == b0 || data[i] == b1 || data[i] == b2) return i;
+    }
+    return n;
+}
+
+// Bytes of needle the candidates in simd_find_needle() may compare per byte of text before it gives up, on text built
+// to match the needle's first and last bytes everywhere; the caller then finishes with a linear-time search.
+constexpr std::size_t kNeedleVerifyBudget = 4;
+
+// Compares the middle of the needle at each window of block that mask marks. Returns the first match's offset, or 32
+// with work raised by the bytes the others cost; kept out of line so the vector loop's state stays in registers.
+template<std::size_t N>
+CX_NOINLINE inline std::size_t simd_verify_needle(const char* block, std::uint32_t mask, const char* needle,
+                                                  std::size_t& work) noexcept {
+    for (; mask; mask &= mask - 1) {
+        const std::size_t at = countr_zero32(mask);
+        if (N == 2 || std::memcmp(block + at + 1, needle + 1, N - 2) == 0) return at;
+        work += N - 2;
+    }
+    return 32;
+}
+
+// Looks for an N-byte needle (N >= 2) by comparing a vector of candidate first bytes and a vector of candidate last
+// bytes at once, and only compares the middle of the needle where both match. Returns the match's index, or size with
+// done set to the first start position it didn't get to: the caller finishes the last partial vector, or the rest of
+// the text once the candidates that didn't match have cost more than kNeedleVerifyBudget bytes per byte.
+template<std::size_t N>
+inline std::size_t simd_find_needle(const char* data, std::size_t size, const char* needle,
+                                    std::size_t& done) noexcept {
+    static_assert(N >= 2, "cx::detail::simd_find_needle: needle needs a first and a last byte");
+    std::size_t i = 0;
+    std::size_t work = 0;
+#if CX_SIMD_SSE2
+#if CX_SIMD_AVX2
+    const __m256i first256 = _mm256_set1_epi8(needle[0]);
+    const __m256i last256 = _mm256_set1_epi8(needle[N - 1]);
+    for (; i + N - 1 + 32 <= size; i += 32) {
+        const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + N - 1));
+        auto mask = static_cast<std::uint32_t>(
+                _mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(a, first256), _mm256_cmpeq_epi8(b, last256))));
+        if (mask) {
+            const std::size_t at = simd_verify_needle<N>(data + i, mask, needle, work);
+            if (at != 32) return i + at;
+            if (work > kNeedleVerifyBudget * i + 4096) {
+                done = i + 32;
+                return size;
+            }
+        }
+    }
+#endif
+    const __m128i first = _mm_set1_epi8(needle[0]);
+    const __m128i last = _mm_set1_epi8(needle[N - 1]);
+    for (; i + N - 1 + 16 <= size; i += 16) {
+        const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + N - 1));
+        auto mask = static_cast<std::uint32_t>(
+                _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(a, first), _mm_cmpeq_epi8(b, last))));
+        if (mask) {
+            const std::size_t at = simd_verify_needle<N>(data + i, mask, needle, work);
+            if (at != 32) return i + at;
+            if (work > kNeedleVerifyBudget * i + 4096) {
+                done = i + 16;
+                return size;
+            }
+        }
+    }
+#else
+    (void) needle;
+    (void) work;
+#endif
+    done = i;
+    return size;
+}
+
+// bytewise equality of two buffers of the same length, a vector or a word at a time
+inline bool simd_equal_bytes(const char* a, const char* b, std::size_t n) noexcept {
+#if CX_SIMD_SSE2
+    if (n >= 16) {
+        std::size_t i = 0;
+        for (; i + 16 <= n; i += 16) {
+            const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+            const __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+            if (_mm_movemask_epi8(_mm_cmpeq_epi8(x, y)) != 0xffff) return false;
+        }
+        if (i == n) return true;
+        // the last block overlaps the previous one instead of falling back to a byte loop
+        const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + n - 16));
+        const __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + n - 16));
+        return _mm_movemask_epi8(_mm_cmpeq_epi8(x, y)) == 0xffff;
+    }
+#endif
+    if (n >= 8) {
+        std::uint64_t x = 0, y = 0;
+        for (std::size_t i = 0; i + 8 <= n; i += 8) {
+            std::memcpy(&x, a + i, 8);
+            std::memcpy(&y, b + i, 8);
+            if (x != y) return false;
+        }
+        std::memcpy(&x, a + n - 8, 8);
+        std::memcpy(&y, b + n - 8, 8);
+        return x == y;
+    }
+    if (n >= 4) {
+        std::uint32_t x0 = 0, y0 = 0, x1 = 0, y1 = 0;
+        std::memcpy(&x0, a, 4);
+        std::memcpy(&y0, b, 4);
+        std::memcpy(&x1, a + n - 4, 4);
+        std::memcpy(&y1, b + n - 4, 4);
+        return x0 == y0 && x1 == y1;
+    }
+    for (std::size_t i = 0; i < n; ++i) {
+        if (a[i] != b[i]) return false;
+    }
+    return true;
+}
+
+
+// Vector min/max/add for the element types the reductions support. SSE2 has no 32-bit integer min/max, so those are
+// a compare and a select; unsigned compares flip the sign bit first.
+template<typename T> struct simd_arith : std::false_type {};
+
+#if CX_SIMD_AVX2
+template<> struct simd_arith<std::int32_t> : std::true_type {
+    using vec = __m256i;
+    static constexpr std::size_t kLanes = 8;
+    static vec load(const std::int32_t* p) noexcept { return _mm256_loadu_si256(reinterpret_cast<const vec*>(p)); }
+    static void store(std::int32_t* p, vec v) noexcept { _mm256_storeu_si256(reinterpret_cast<vec*>(p), v); }
+    static vec min(vec a, vec b) noexcept { return _mm256_min_epi32(a, b); }
+    static vec max(vec a, vec b) noexcept { return _mm256_max_epi32(a, b); }
+    static vec add(vec a, vec b) noexcept { return _mm256_add_epi32(a, b); }
+};
+
+template<> struct simd_arith<std::uint32_t> : std::true_type {
+    using vec = __m256i;
+    static constexpr std::size_t kLanes = 8;
+    static vec load(const std::uint32_t* p) noexcept { return _mm256_loadu_si256(reinterpret_cast<const vec*>(p)); }
+    static void store(std::uint32_t* p, vec v) noexcept { _mm256_storeu_si256(reinterpret_cast<vec*>(p), v); }
+    static vec min(vec a, vec b) noexcept { return _mm256_min_epu32(a, b); }
+    static vec max(vec a, vec b) noexcept { return _mm256_max_epu32(a, b); }
+    static vec add(vec a, vec b) noexcept { return _mm256_add_epi32(a, b); }
+};
+
+template<> struct simd_arith<float> : std::true_type {
+    using vec = __m256;
+    static constexpr std::size_t kLanes = 8;
+    static vec load(const float* p) noexcept { return _mm256_loadu_ps(p); }
+    static void store(float* p, vec v) noexcept { _mm256_storeu_ps(p, v); }
+    static vec min(vec a, vec b) noexcept { return _mm256_min_ps(a, b); }
+    static vec max(vec a, vec b) noexcept { return _mm256_max_ps(a, b); }
+    static vec add(vec a, vec b) noexcept { return _mm256_add_ps(a, b); }
+};
+
+template<> struct simd_arith<double> : std::true_type {
+    using vec = __m256d;
+    static constexpr std::size_t kLanes = 4;
+    static vec load(const double* p) noexcept { return _mm256_loadu_pd(p); }
+    static void store(double* p, vec v) noexcept { _mm256_storeu_pd(p, v); }
+    static vec min(vec a, vec b) noexcept { return _mm256_min_pd(a, b); }
+    static vec max(vec a, vec b) noexcept { return _mm256_max_pd(a, b); }
+    static vec add(vec a, vec b) noexcept { return _mm256_add_pd(a, b); }
+};
+#elif CX_SIMD_SSE2
+template<typename T, std::uint32_t Flip> struct simd_arith_i32 : std::true_type {
+    using vec = __m128i;
+    static constexpr std::size_t kLanes = 4;
+    static vec load(const T* p) noexcept { return _mm_loadu_si128(reinterpret_cast<const vec*>(p)); }
+    static void store(T* p, vec v) noexcept { _mm_storeu_si128(reinterpret_cast<vec*>(p), v); }
+    static vec greater(vec a, vec b) noexcept {
+        const __m128i flip = _mm_set1_epi32(static_cast<std::int32_t>(Flip));
+        return _mm_cmpgt_epi32(_mm_xor_si128(a, flip), _mm_xor_si128(b, flip));
+    }
+    static vec select(vec mask, vec a, vec b) noexcept {
+        return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+    }
+    static vec min(vec a, vec b) noexcept { return select(greater(a, b), b, a); }
+    static vec max(vec a, vec b) noexcept { return select(greater(a, b), a, b); }
+    static vec add(vec a, vec b) noexcept { return _mm_add_epi32(a, b); }
+};
+
+template<> struct simd_arith<std::int32_t> : simd_arith_i32<std::int32_t, 0> {};
+template<> struct simd_arith<std::uint32_t> : simd_arith_i32<std::uint32_t, 0x80000000u> {};
+
+template<> struct simd_arith<float> : std::true_type {
+    using vec = __m128;
+    static constexpr std::size_t kLanes = 4;
+    static vec load(const float* p) noexcept { return _mm_loadu_ps(p); }
+    static void store(float* p, vec v) noexcept { _mm_storeu_ps(p, v); }
+    static vec min(vec a, vec b) noexcept { return _mm_min_ps(a, b); }
+    static vec max(vec a, vec b) noexcept { return _mm_max_ps(a, b); }
+    static vec add(vec a, vec b) noexcept { return _mm_add_ps(a, b); }
+};
+
+template<> struct simd_arith<double> : std::true_type {
+    using vec = __m128d;
+    static constexpr std::size_t kLanes = 2;
+    static vec load(const double* p) noexcept { return _mm_loadu_pd(p); }
+    static void store(double* p, vec v) noexcept { _mm_storeu_pd(p, v); }
+    static vec min(vec a, vec b) noexcept { return _mm_min_pd(a, b); }
+    static vec max(vec a, vec b) noexcept { return _mm_max_pd(a, b); }
+    static vec add(vec a, vec b) noexcept { return _mm_add_pd(a, b); }
+};
+#endif
+
+// the reductions' per-element and per-vector steps; the scalar ones match the vector instructions (min_ps returns its
+// second operand when either is NaN)
+template<typename T>
+struct fold_min {
+    constexpr T operator()(T a, T b) const noexcept { return a < b ? a : b; }
+    template<typename Vec> Vec operator()(Vec a, Vec b) const noexcept { return simd_arith<T>::min(a, b); }
+};
+
+template<typename T>
+struct fold_max {
+    constexpr T operator()(T a, T b) const noexcept { return a > b ? a : b; }
+    template<typename Vec> Vec operator()(Vec a, Vec b) const noexcept { return simd_arith<T>::max(a, b); }
+};
+
+// integers add in their unsigned type so the scalar steps wrap like the vector adds instead of overflowing
+template<typename T, bool = std::is_integral<T>::value && !std::is_same<T, bool>::value>
+struct fold_sum_type { using type = T; };
+
+template<typename T>
+struct fold_sum_type<T, true> { using type = typename std::make_unsigned<T>::type; };
+
+template<typename T>
+struct fold_sum {
+    using sum_type = typename fold_sum_type<T>::type;
+    constexpr T operator()(T a, T b) const noexcept {
+        return static_cast<T>(static_cast<sum_type>(static_cast<sum_type>(a) + static_cast<sum_type>(b)));
+    }
+    template<typename Vec> Vec operator()(Vec a, Vec b) const noexcept { return simd_arith<T>::add(a, b); }
+};
+
+// the vector part of simd_fold(): returns where the scalar tail starts, which is at most n (the vectors end at
+// n - n % kLanes, returned as such so the compiler can see the tail loop ends)
+template<typename T, typename Op>
+inline std::size_t simd_fold_vectors(const T*, std::size_t, const Op&, T&, std::false_type) noexcept { return 1; }
+
+template<typename T, typename Op>
+inline std::size_t simd_fold_vectors(const T* data, std::size_t n, const Op& op, T& result, std::true_type) noexcept {
+    using arith = simd_arith<T>;
+    constexpr std::size_t kLanes = arith::kLanes;
+    if (n < kLanes) return 1;
+    auto acc = arith::load(data);
+    for (std::size_t i = kLanes; i + kLanes <= n; i += kLanes) acc = op(acc, arith::load(data + i));
+    T lanes[kLanes];
+    arith::store(lanes, acc);
+    result = lanes[0];
+    for (std::size_t k = 1; k < kLanes; ++k) result = op(result, lanes[k]);
+    return n - n % kLanes;
+}
+
+// folds data[0, n) with op, n >= 1: one accumulator vector, then across its lanes, then the tail. Types without a
+// simd_arith specialization take the scalar loop. Floating point sums are reassociated, so they can differ from a
+// left-to-right loop in the last bits.
+template<typename T, typename Op>
+inline T simd_fold(const T* data, std::size_t n, const Op& op) noexcept {
+    T result = data[0];
+    std::size_t i = simd_fold_vectors(data, n, op, result, std::integral_constant<bool, simd_arith<T>::value>{});
+    for (; i < n; ++i) result = op(result, data[i]);
+    return result;
+}
+
+}
+}
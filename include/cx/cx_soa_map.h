@@ -0,0 +1,189 @@
+// Copyright (c) 2020. Mohit Deshpande.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+// the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include <initializer_list>
+#include <iterator>
+#include <type_traits>
+
+#include "cx/cx_config.h"
+#include "cx/cx_pair.h"
+#include "cx/cx_array.h"
+#include "cx/cx_simd.h"
+
+#include <stdexcept>
+
+namespace cx {
+
+namespace detail {
+
+// Random-access iterator over parallel key/value arrays. Dereferencing yields the entry by value since there is no
+// stored pair to point at.
+template<typename Key, typename T>
+class soa_iterator {
+public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = cx::pair<const Key, const T>;
+    using difference_type = std::ptrdiff_t;
+    using reference = value_type;
+
+    struct pointer {
+        value_type entry;
+        constexpr const value_type* operator->() const noexcept { return &entry; }
+    };
+
+    constexpr soa_iterator() = default;
+    constexpr soa_iterator(const Key* keys, const T* values, std::size_t i) noexcept
+            : keys_{keys}, values_{values}, i_{i} {}
+
+    constexpr reference operator*() const { return value_type{keys_[i_], values_[i_]}; }
+    constexpr pointer operator->() const { return pointer{**this}; }
+    constexpr reference operator[](difference_type n) const { return *(*this + n); }
+
+    constexpr soa_iterator& operator++() noexcept { ++i_; return *this; }
+    constexpr soa_iterator& operator--() noexcept { --i_; return *this; }
+    constexpr soa_iterator operator++(int) noexcept { soa_iterator it = *this; ++i_; return it; }
+    constexpr soa_iterator operator--(int) noexcept { soa_iterator it = *this; --i_; return it; }
+    constexpr soa_iterator& operator+=(difference_type n) noexcept { i_ += n; return *this; }
+    constexpr soa_iterator& operator-=(difference_type n) noexcept { i_ -= n; return *this; }
+    constexpr soa_iterator operator+(difference_type n) const noexcept { return soa_iterator(keys_, values_, i_ + n); }
+    constexpr soa_iterator operator-(difference_type n) const noexcept { return soa_iterator(keys_, values_, i_ - n); }
+    constexpr difference_type operator-(const soa_iterator& rhs) const noexcept {
+        return static_cast<difference_type>(i_) - static_cast<difference_type>(rhs.i_);
+    }
+
+    constexpr bool operator==(const soa_iterator& rhs) const noexcept { return i_ == rhs.i_; }
+    constexpr bool operator!=(const soa_iterator& rhs) const noexcept { return i_ != rhs.i_; }
+    constexpr bool operator<(const soa_iterator& rhs) const noexcept { return i_ < rhs.i_; }
+    constexpr bool operator>(const soa_iterator& rhs) const noexcept { return i_ > rhs.i_; }
+    constexpr bool operator<=(const soa_iterator& rhs) const noexcept { return i_ <= rhs.i_; }
+    constexpr bool operator>=(const soa_iterator& rhs) const noexcept { return i_ >= rhs.i_; }
+
+    constexpr std::size_t index() const noexcept { return i_; }
+
+private:
+    const Key* keys_{};
+    const T* values_{};
+    std::size_t i_{};
+};
+
+}
+
+// Same semantics as cx::map (insertion order, duplicate keys allowed), but keys and values live in separate arrays.
+// A key scan only touches the key array, and at runtime it is done with SSE2/AVX2 compares. Constant evaluation uses
+// the plain scalar loop. Keys must be integral or enum types.
+template<typename Key, typename T, std::size_t N>
+class soa_map {
+public:
+    static_assert(detail::is_simd_comparable<Key>::value, "cx::soa_map: keys must be integral or enum types");
+
+    // a bunch of typedefs
+    using key_type = Key;
+    using mapped_type = T;
+    using value_type = cx::pair<const Key, const T>;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = value_type;
+    using const_reference = value_type;
+    using iterator = detail::soa_iterator<Key, T>;
+    using const_iterator = detail::soa_iterator<Key, T>;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    // keys are aligned to a full AVX2 register
+    static constexpr std::size_t key_alignment = 32;
+
+    // constructors and assignment
+    constexpr soa_map() = default;
+    constexpr soa_map(std::initializer_list<value_type> entries)
+            : soa_map(entries, std::make_index_sequence<N>()) {
+        if (entries.size() != N) throw std::invalid_argument("cx::soa_map: initialized with wrong number of entries!");
+    }
+
+    constexpr soa_map(const soa_map&) = default;
+    constexpr soa_map(soa_map&&) noexcept = default;
+
+    constexpr soa_map& operator=(const soa_map&) = default;
+    constexpr soa_map& operator=(soa_map&&) noexcept = default;
+
+    // iterators
+    constexpr const_iterator begin() const noexcept { return const_iterator(keys_.data(), values_.data(), 0); }
+    constexpr const_iterator end() const noexcept { return const_iterator(keys_.data(), values_.data(), N); }
+    constexpr const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+    constexpr const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+    constexpr const_iterator cbegin() const noexcept { return begin(); }
+    constexpr const_iterator cend() const noexcept { return end(); }
+    constexpr const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+    constexpr const_reverse_iterator crend() const noexcept { return rend(); }
+
+    // element access
+    constexpr const T& at(const Key& key) const {
+        const std::size_t i = index_of(key);
+        // we can't directly put the throw here since this is a core constant expression
+        // (see C++ spec §5.20 [expr.const])
+        if (i == N) throw_out_of_range();
+        return values_[i];
+    }
+
+    constexpr const T& operator[](const Key& key) const {
+        return at(key);
+    }
+
+    // capacity
+    constexpr bool empty() const noexcept { return size() == 0; }
+    constexpr std::size_t size() const noexcept { return N; }
+    constexpr std::size_t max_size() const noexcept { return N; }
+
+    // lookup
+    constexpr size_type count(const Key& key) const noexcept {
+        if (!CX_IS_CONSTANT_EVALUATED()) return detail::simd_count(keys_.data(), N, key);
+        size_type count{};
+        for (std::size_t i = 0; i < N; ++i) {
+            if (keys_[i] == key) ++count;
+        }
+        return count;
+    }
+
+    constexpr const_iterator find(const Key& key) const noexcept {
+        return const_iterator(keys_.data(), values_.data(), index_of(key));
+    }
+
+    // raw views of the two arrays
+    constexpr const Key* keys() const noexcept { return keys_.data(); }
+    constexpr const T* values() const noexcept { return values_.data(); }
+
+private:
+    alignas(key_alignment) const cx::array<Key, N> keys_{};
+    const cx::array<T, N> values_{};
+
+    template<std::size_t... Indices>
+    constexpr soa_map(std::initializer_list<value_type>& entries, std::index_sequence<Indices...>)
+            : keys_{(entries.begin() + Indices)->first...}, values_{(entries.begin() + Indices)->second...} {}
+
+    constexpr std::size_t index_of(const Key& key) const noexcept {
+        if (!CX_IS_CONSTANT_EVALUATED()) return detail::simd_find(keys_.data(), N, key);
+        for (std::size_t i = 0; i < N; ++i) {
+            if (keys_[i] == key) return i;
+        }
+        return N;
+    }
+
+    constexpr void throw_out_of_range() const {
+        throw std::out_of_range("cx::soa_map::at: could not find entry in map");
+    }
+};
+
+}
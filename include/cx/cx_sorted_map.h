@@ -0,0 +1,332 @@
+// Copyright (c) 2020. Mohit Deshpande.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+// the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+
+#include "cx/cx_algorithm.h"
+#include "cx/cx_config.h"
+#include "cx/cx_pair.h"
+#include "cx/cx_array.h"
+
+#include <stdexcept>
+
+namespace cx {
+
+namespace detail {
+
+// number of trailing one bits in x
+constexpr unsigned countr_one(std::size_t x) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<unsigned>(__builtin_ctzll(~static_cast<unsigned long long>(x)));
+#else
+    unsigned n = 0;
+    for (; x & 1; x >>= 1) ++n;
+    return n;
+#endif
+}
+
+// Lays sorted[0, n) out in Eytzinger (BFS) order: out[k - 1] receives the element of the 1-based tree node k. Returns
+// the number of sorted elements consumed so far; call it with i = 0 and k = 1.
+constexpr std::size_t eytzinger_permute(const std::size_t* sorted, std::size_t* out, std::size_t i,
+                                        std::size_t k, std::size_t n) {
+    if (k <= n) {
+        i = eytzinger_permute(sorted, out, i, 2 * k, n);
+        out[k - 1] = sorted[i++];
+        i = eytzinger_permute(sorted, out, i, 2 * k + 1, n);
+    }
+    return i;
+}
+
+// In-order (i.e. sorted) iterator over an Eytzinger layout. Nodes are 1-based and node 0 is the end position.
+template<typename Value>
+class eytzinger_iterator {
+public:
+    using iterator_category = std::bidirectional_iterator_tag;
+    using value_type = Value;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const Value*;
+    using reference = const Value&;
+
+    constexpr eytzinger_iterator() = default;
+    constexpr eytzinger_iterator(const Value* base, std::size_t n, std::size_t k) noexcept
+            : base_{base}, n_{n}, k_{k} {}
+
+    constexpr reference operator*() const noexcept { return base_[k_ - 1]; }
+    constexpr pointer operator->() const noexcept { return base_ + (k_ - 1); }
+
+    constexpr eytzinger_iterator& operator++() noexcept {
+        if (2 * k_ + 1 <= n_) {
+            // leftmost node of the right subtree
+            k_ = 2 * k_ + 1;
+            while (2 * k_ <= n_) k_ *= 2;
+        } else {
+            // climb while we are a right child, then the parent is next
+            k_ >>= countr_one(k_) + 1;
+        }
+        return *this;
+    }
+
+    constexpr eytzinger_iterator operator++(int) noexcept {
+        eytzinger_iterator it = *this;
+        ++*this;
+        return it;
+    }
+
+    constexpr eytzinger_iterator& operator--() noexcept {
+        if (k_ == 0) {
+            // end() steps back to the rightmost node
+            k_ = n_ ? 1 : 0;
+            while (k_ && 2 * k_ + 1 <= n_) k_ = 2 * k_ + 1;
+        } else if (2 * k_ <= n_) {
+            // rightmost node of the left subtree
+            k_ = 2 * k_;
+            while (2 * k_ + 1 <= n_) k_ = 2 * k_ + 1;
+        } else {
+            // climb while we are a left child, then the parent is previous
+            while (k_ && !(k_ & 1)) k_ >>= 1;
+            k_ >>= 1;
+        }
+        return *this;
+    }
+
+    constexpr eytzinger_iterator operator--(int) noexcept {
+        eytzinger_iterator it = *this;
+        --*this;
+        return it;
+    }
+
+    constexpr std::size_t node() const noexcept { return k_; }
+
+    constexpr bool operator==(const eytzinger_iterator& rhs) const noexcept { return k_ == rhs.k_; }
+    constexpr bool operator!=(const eytzinger_iterator& rhs) const noexcept { return k_ != rhs.k_; }
+
+private:
+    const Value* base_{};
+    std::size_t n_{};
+    std::size_t k_{};
+};
+
+}
+
+// Immutable ordered map. Entries are sorted during construction (usually at compile time) and stored in Eytzinger
+// order so that a branchless binary search walks the array front to back and the top levels of the tree share cache
+// lines. Iteration is still in key order. Duplicate keys are allowed, as in cx::map.
+template<typename Key, typename T, std::size_t N, typename Compare = std::less<Key>>
+class sorted_map {
+public:
+    // a bunch of typedefs
+    using key_type = Key;
+    using mapped_type = T;
+    using value_type = cx::pair<const Key, const T>;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using key_compare = Compare;
+    using reference = value_type&;
+    using const_reference = const value_type&;
+    using pointer = value_type*;
+    using const_pointer = const value_type*;
+    using iterator = detail::eytzinger_iterator<value_type>;
+    using const_iterator = detail::eytzinger_iterator<value_type>;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    // constructors and assignment
+    constexpr sorted_map() = default;
+    constexpr sorted_map(std::initializer_list<value_type> entries)
+            : sorted_map(entries, make_layout(entries), std::make_index_sequence<N>()) {}
+
+    constexpr sorted_map(const sorted_map&) = default;
+    constexpr sorted_map(sorted_map&&) noexcept = default;
+
+    constexpr sorted_map& operator=(const sorted_map&) = default;
+    constexpr sorted_map& operator=(sorted_map&&) noexcept = default;
+
+    // iterators
+    constexpr const_iterator begin() const noexcept {
+        std::size_t k = N ? 1 : 0;
+        while (k && 2 * k <= N) k *= 2;
+        return node(k);
+    }
+    constexpr const_iterator end() const noexcept { return node(0); }
+    constexpr const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+    constexpr const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+    constexpr const_iterator cbegin() const noexcept { return begin(); }
+    constexpr const_iterator cend() const noexcept { return end(); }
+    constexpr const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+    constexpr const_reverse_iterator crend() const noexcept { return rend(); }
+
+    // element access
+    constexpr const T& at(const Key& key) const {
+        const auto it = find(key);
+        // we can't directly put the throw here since this is a core constant expression
+        // (see C++ spec §5.20 [expr.const])
+        if (it == end()) throw_out_of_range();
+        return it->second;
+    }
+
+    constexpr const T& operator[](const Key& key) const {
+        return at(key);
+    }
+
+    // capacity
+    constexpr bool empty() const noexcept { return size() == 0; }
+    constexpr std::size_t size() const noexcept { return N; }
+    constexpr std::size_t max_size() const noexcept { return N; }
+
+    // lookup
+    constexpr size_type count(const Key& key) const {
+        size_type count{};
+        for (auto it = lower_bound(key); it != end() && !Compare{}(key, it->first); ++it) ++count;
+        return count;
+    }
+
+    constexpr const_iterator find(const Key& key) const {
+        const auto it = lower_bound(key);
+        return it != end() && !Compare{}(key, it->first) ? it : end();
+    }
+
+    // Batched find: out[i] = find(keys[i]) for the n keys, returning how many were found. A group of
+    // detail::kBatchGroup searches descends the tree together, one level per round, so the loads (and prefetches) of
+    // different keys overlap instead of each search waiting on its own chain of misses.
+    constexpr size_type find_batch(const Key* keys, std::size_t n, const_iterator* out) const {
+        size_type found = 0;
+        for (std::size_t first = 0; first < n; first += detail::kBatchGroup) {
+            const std::size_t group = n - first < detail::kBatchGroup ? n - first : detail::kBatchGroup;
+            std::size_t nodes[detail::kBatchGroup]{};
+            for (std::size_t g = 0; g < group; ++g) nodes[g] = 1;
+
+            // searches finish within one round of each other, since every leaf is on the last level or the one above
+            for (bool descending = true; descending;) {
+                descending = false;
+                for (std::size_t g = 0; g < group; ++g) {
+                    const std::size_t k = nodes[g];
+                    if (k > N) continue;
+                    prefetch_descendants(k);
+                    nodes[g] = 2 * k + static_cast<std::size_t>(Compare{}(arr_[k - 1].first, keys[first + g]));
+                    descending = true;
+                }
+            }
+            for (std::size_t g = 0; g < group; ++g) {
+                const auto it = node(nodes[g] >> (detail::countr_one(nodes[g]) + 1));
+                const bool hit = it != end() && !Compare{}(keys[first + g], it->first);
+                out[first + g] = hit ? it : end();
+                found += hit;
+            }
+        }
+        return found;
+    }
+
+    // out[i] = at(keys[i]) for the n keys; throws std::out_of_range if any of them is missing
+    constexpr void at_batch(const Key* keys, std::size_t n, T* out) const {
+        const_iterator its[detail::kBatchGroup]{};
+        for (std::size_t first = 0; first < n; first += detail::kBatchGroup) {
+            const std::size_t group = n - first < detail::kBatchGroup ? n - first : detail::kBatchGroup;
+            find_batch(keys + first, group, its);
+            for (std::size_t g = 0; g < group; ++g) {
+                if (its[g] == end()) throw_out_of_range();
+                out[first + g] = its[g]->second;
+            }
+        }
+    }
+
+    // found[i] = count(keys[i]) != 0 for the n keys, returning how many were found
+    constexpr size_type count_batch(const Key* keys, std::size_t n, bool* found) const {
+        const_iterator its[detail::kBatchGroup]{};
+        size_type hits = 0;
+        for (std::size_t first = 0; first < n; first += detail::kBatchGroup) {
+            const std::size_t group = n - first < detail::kBatchGroup ? n - first : detail::kBatchGroup;
+            hits += find_batch(keys + first, group, its);
+            for (std::size_t g = 0; g < group; ++g) found[first + g] = its[g] != end();
+        }
+        return hits;
+    }
+
+    // first entry whose key is not less than key
+    constexpr const_iterator lower_bound(const Key& key) const {
+        std::size_t k = 1;
+        while (k <= N) {
+            prefetch_descendants(k);
+            k = 2 * k + static_cast<std::size_t>(Compare{}(arr_[k - 1].first, key));
+        }
+        // undo the right turns taken after the last left turn, which was the answer
+        return node(k >> (detail::countr_one(k) + 1));
+    }
+
+    // first entry whose key is greater than key
+    constexpr const_iterator upper_bound(const Key& key) const {
+        std::size_t k = 1;
+        while (k <= N) {
+            prefetch_descendants(k);
+            k = 2 * k + static_cast<std::size_t>(!Compare{}(key, arr_[k - 1].first));
+        }
+        return node(k >> (detail::countr_one(k) + 1));
+    }
+
+    constexpr cx::pair<const_iterator, const_iterator> equal_range(const Key& key) const {
+        return {lower_bound(key), upper_bound(key)};
+    }
+
+    constexpr key_compare key_comp() const { return key_compare{}; }
+
+private:
+    // entries in Eytzinger order: arr_[k - 1] is tree node k
+    const cx::array<value_type, N> arr_;
+
+    struct layout {
+        std::size_t order[N ? N : 1];
+    };
+
+    struct index_less {
+        const value_type* entries;
+        constexpr bool operator()(std::size_t a, std::size_t b) const {
+            return Compare{}(entries[a].first, entries[b].first);
+        }
+    };
+
+    static constexpr layout make_layout(std::initializer_list<value_type> entries) {
+        if (entries.size() != N) throw std::invalid_argument("cx::sorted_map: initialized with wrong number of entries!");
+
+        layout result{};
+        std::size_t sorted[N ? N : 1]{};
+        std::size_t scratch[N ? N : 1]{};
+        detail::merge_sort_indices(sorted, scratch, N, index_less{entries.begin()});
+        detail::eytzinger_permute(sorted, result.order, 0, 1, N);
+        return result;
+    }
+
+    template<std::size_t... Indices>
+    constexpr sorted_map(std::initializer_list<value_type>& entries, const layout& l, std::index_sequence<Indices...>)
+            : arr_{*(entries.begin() + l.order[Indices])...} {}
+
+    constexpr const_iterator node(std::size_t k) const noexcept { return const_iterator(arr_.data(), N, k); }
+
+    // the 16 descendants four levels down sit next to each other, 16 * sizeof(value_type) bytes that span one cache
+    // line only for 4-byte entries, so every line of the block is prefetched
+    constexpr void prefetch_descendants(std::size_t k) const noexcept {
+        if (CX_IS_CONSTANT_EVALUATED() || 16 * k > N) return;
+        const std::size_t count = N - (16 * k - 1) < 16 ? N - (16 * k - 1) : 16;
+        detail::prefetch_range(arr_.data() + (16 * k - 1), count * sizeof(value_type));
+    }
+
+    constexpr void throw_out_of_range() const {
+        throw std::out_of_range("cx::sorted_map::at: could not find entry in map");
+    }
+};
+
+}
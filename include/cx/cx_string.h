@@ -15,11 +15,27 @@
 
 #pragma once
 
+#include <cstdint>
 #include <cstring>
 #include <string>
 
+#include "cx/cx_config.h"
+#include "cx/cx_hash.h"
+
+#include <stdexcept>
+
 namespace cx {
 
+namespace detail {
+
+struct concat_tag {};
+struct copy_tag {};
+
+}
+
+template<typename T>
+struct length_of;
+
 // implementation heavily inspired by https://gist.github.com/dsanders11/8951887 and Jason Turner's constexpr talk
 template<std::size_t N>
 class string {
@@ -40,8 +56,23 @@ public:
     constexpr string(const char (&value)[N + 1], std::index_sequence<Indices...>)
             : string(value[Indices]...) {}
 
-    constexpr string(const char (&value)[N + 1])
-            : string(value, std::make_index_sequence<N>{}) {}
+    // copied in a loop rather than expanded into one argument per character, so long literals stay cheap to compile
+    constexpr string(const char (&value)[N + 1]) : str_{} {
+        for (std::size_t i = 0; i < N; ++i) str_[i] = value[i];
+    }
+
+    // the first N characters at data, which needn't be null-terminated
+    constexpr string(const char* data, detail::copy_tag) : str_{} {
+        for (std::size_t i = 0; i < N; ++i) str_[i] = data[i];
+    }
+
+    // lhs followed by rhs (see operator+)
+    template<typename Left, typename Right>
+    constexpr string(const Left& lhs, const Right& rhs, detail::concat_tag) : str_{} {
+        static_assert(length_of<Left>::value + length_of<Right>::value == N, "cx::string: wrong concatenated length");
+        for (std::size_t i = 0; i < length_of<Left>::value; ++i) str_[i] = lhs[i];
+        for (std::size_t i = 0; i < length_of<Right>::value; ++i) str_[length_of<Left>::value + i] = rhs[i];
+    }
 
     constexpr char operator[](const std::size_t index) const {
         return index < N ? str_[index] : throw std::out_of_range("cx::string::operator[]: index out of range");
@@ -53,7 +84,30 @@ public:
     std::string str() const { return std::string(str_); }
 
 private:
-    const char str_[N + 1];
+    char str_[N + 1];
+};
+
+// cx::string that carries its wyhash next to the characters, so equality can reject on the hash before touching bytes
+template<std::size_t N>
+class hashed_string {
+public:
+    constexpr hashed_string(const char (&value)[N + 1])
+            : str_{value}, hash_{wyhash(str_.c_str(), N)} {}
+
+    constexpr hashed_string(const string<N>& value)
+            : str_{value}, hash_{wyhash(str_.c_str(), N)} {}
+
+    constexpr char operator[](const std::size_t index) const { return str_[index]; }
+
+    constexpr std::size_t size() const { return N; }
+    constexpr std::uint64_t hash() const { return hash_; }
+
+    constexpr const char* c_str() const { return str_.c_str(); }
+    std::string str() const { return str_.str(); }
+
+private:
+    const string<N> str_;
+    const std::uint64_t hash_;
 };
 
 template<typename T>
@@ -93,10 +147,91 @@ struct length_of<const string<N>&> {
     static constexpr std::size_t value = N;
 };
 
+// cx::hashed_string specializations
+template<std::size_t N>
+struct length_of<hashed_string<N>> {
+    static constexpr std::size_t value = N;
+};
+
+template<std::size_t N>
+struct length_of<const hashed_string<N>> {
+    static constexpr std::size_t value = N;
+};
+
+template<std::size_t N>
+struct length_of<const hashed_string<N>&> {
+    static constexpr std::size_t value = N;
+};
+
+namespace detail {
+
+// characters of a string literal or cx::string, for code that takes either
+constexpr const char* c_str_of(const char* str) noexcept { return str; }
+
+template<std::size_t N>
+constexpr const char* c_str_of(const string<N>& str) noexcept { return str.c_str(); }
+
+}
+
+// Non-owning view of a string of any bytes: a string stored in a mapped table, or a key with embedded '\0' bytes
+class string_ref {
+public:
+    constexpr string_ref() noexcept = default;
+    constexpr string_ref(const char* data, std::size_t size) noexcept : data_{data}, size_{size} {}
+
+    // a string literal without its terminator, so "\x0a\x00" is two bytes
+    template<std::size_t M>
+    constexpr string_ref(const char (&str)[M]) noexcept : data_{str}, size_{M - 1} {}
+
+    template<std::size_t M>
+    constexpr string_ref(const string<M>& str) noexcept : data_{str.c_str()}, size_{M} {}
+
+    constexpr const char* data() const noexcept { return data_; }
+    constexpr std::size_t size() const noexcept { return size_; }
+    constexpr bool empty() const noexcept { return size_ == 0; }
+    constexpr char operator[](std::size_t i) const noexcept { return data_[i]; }
+
+    std::string str() const { return std::string(data_, size_); }
+
+    // memcmp at runtime, a loop during constant evaluation
+    friend constexpr bool operator==(string_ref lhs, string_ref rhs) noexcept {
+        if (lhs.size_ != rhs.size_) return false;
+        if (!CX_IS_CONSTANT_EVALUATED()) return lhs.size_ == 0 || std::memcmp(lhs.data_, rhs.data_, lhs.size_) == 0;
+        for (std::size_t i = 0; i < lhs.size_; ++i) {
+            if (lhs.data_[i] != rhs.data_[i]) return false;
+        }
+        return true;
+    }
+    friend constexpr bool operator!=(string_ref lhs, string_ref rhs) noexcept { return !(lhs == rhs); }
+
+    // more specialized than the length_of comparison below, which string_ref has no length for
+    template<std::size_t M>
+    friend constexpr bool operator==(string_ref lhs, const char (&rhs)[M]) noexcept { return lhs == string_ref(rhs); }
+    template<std::size_t M>
+    friend constexpr bool operator==(const char (&lhs)[M], string_ref rhs) noexcept { return string_ref(lhs) == rhs; }
+    template<std::size_t M>
+    friend constexpr bool operator!=(string_ref lhs, const char (&rhs)[M]) noexcept { return !(lhs == rhs); }
+    template<std::size_t M>
+    friend constexpr bool operator!=(const char (&lhs)[M], string_ref rhs) noexcept { return !(lhs == rhs); }
+
+private:
+    const char* data_ = nullptr;
+    std::size_t size_ = 0;
+};
+
+template<std::size_t N, std::size_t M>
+constexpr bool operator==(const hashed_string<N>& lhs, const hashed_string<M>& rhs) {
+    if (N != M || lhs.hash() != rhs.hash()) return false;
+    for (std::size_t i = 0; i < N; ++i) {
+        if (lhs[i] != rhs[i]) return false;
+    }
+    return true;
+}
+
 template<typename Left, typename Right>
 constexpr bool operator==(const Left& lhs, const Right& rhs) {
     if (length_of<Left>::value != length_of<Right>::value) return false;
-    for (int i = 0; i < length_of<Left>::value; ++i) {
+    for (std::size_t i = 0; i < length_of<Left>::value; ++i) {
         if (lhs[i] != rhs[i]) return false;
     }
     return true;
@@ -113,9 +248,7 @@ constexpr string<sizeof...(IndicesLeft) + sizeof...(IndicesRight)> concat_strs(
 
 template<typename Left, typename Right>
 constexpr string<length_of<Left>::value + length_of<Right>::value> concat_strs(const Left& lhs, const Right& rhs) {
-    return concat_strs(lhs, rhs,
-                       typename std::make_index_sequence<length_of<decltype(lhs)>::value>{},
-                       typename std::make_index_sequence<length_of<decltype(rhs)>::value>{});
+    return string<length_of<Left>::value + length_of<Right>::value>(lhs, rhs, detail::concat_tag{});
 }
 
 template<typename Left, typename Right>
@@ -130,7 +263,50 @@ constexpr auto lit(const char (&value)[N], std::index_sequence<Indices...>) {
 
 template<std::size_t N>
 constexpr auto lit(const char (&value)[N]) {
-    return lit(value, typename std::make_index_sequence<N - 1>{});
+    return string<N - 1>(value);
+}
+
+template<std::size_t N>
+constexpr auto hashed_lit(const char (&value)[N]) {
+    return hashed_string<N - 1>(lit(value));
+}
+
+// hashing
+template<std::size_t N>
+constexpr std::uint64_t fnv1a(const string<N>& value) noexcept {
+    return fnv1a(value.c_str(), N);
+}
+
+template<std::size_t N>
+constexpr std::uint64_t wyhash(const string<N>& value, std::uint64_t seed = 0) noexcept {
+    return wyhash(value.c_str(), N, seed);
 }
 
+template<std::size_t N>
+struct hash<string<N>> {
+    constexpr std::uint64_t operator()(const string<N>& key, std::uint64_t seed = 0) const noexcept {
+        return wyhash(key.c_str(), N, seed);
+    }
+};
+
+// for tables built at runtime (see cx::frozen_map)
+template<>
+struct hash<std::string> {
+    std::uint64_t operator()(const std::string& key, std::uint64_t seed = 0) const noexcept {
+        return wyhash(key.data(), key.size(), seed);
+    }
+
+    // the same hash for the same characters held elsewhere, so lookups needn't build a std::string
+    std::uint64_t operator()(string_ref key, std::uint64_t seed = 0) const noexcept {
+        return wyhash(key.data(), key.size(), seed);
+    }
+};
+
+template<std::size_t N>
+struct hash<hashed_string<N>> {
+    constexpr std::uint64_t operator()(const hashed_string<N>& key, std::uint64_t seed = 0) const noexcept {
+        return seed == 0 ? key.hash() : wyhash(key.c_str(), N, seed);
+    }
+};
+
 }
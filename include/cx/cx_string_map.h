@@ -0,0 +1,248 @@
+// Copyright (c) 2020. Mohit Deshpande.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+// the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <utility>
+
+#include "cx/cx_algorithm.h"
+#include "cx/cx_config.h"
+#include "cx/cx_pair.h"
+#include "cx/cx_array.h"
+#include "cx/cx_hash.h"
+#include "cx/cx_simd.h"
+#include "cx/cx_string.h"
+
+#include <stdexcept>
+
+namespace cx {
+
+namespace detail {
+
+constexpr std::size_t cstr_length(const char* str) noexcept {
+    std::size_t n = 0;
+    while (str[n] != '\0') ++n;
+    return n;
+}
+
+// three-way comparison of two buffers of the same length
+constexpr int compare_bytes(const char* a, const char* b, std::size_t n) noexcept {
+    for (std::size_t i = 0; i < n; ++i) {
+        if (a[i] != b[i]) return static_cast<unsigned char>(a[i]) < static_cast<unsigned char>(b[i]) ? -1 : 1;
+    }
+    return 0;
+}
+
+constexpr bool equal_bytes(const char* a, const char* b, std::size_t n) noexcept {
+    if (!CX_IS_CONSTANT_EVALUATED()) return simd_equal_bytes(a, b, n);
+    return compare_bytes(a, b, n) == 0;
+}
+
+// the first min(n, 8) bytes as a little-endian word
+constexpr std::uint64_t load_prefix(const char* p, std::size_t n) noexcept {
+#if CX_LITTLE_ENDIAN
+    if (!CX_IS_CONSTANT_EVALUATED() && n >= 8) {
+        std::uint64_t v = 0;
+        std::memcpy(&v, p, 8);
+        return v;
+    }
+#endif
+    return read_le(p, n < 8 ? n : 8);
+}
+
+}
+
+// Immutable map from strings of any length to T, built from string literal keys. Keys are bucketed by length during
+// construction, so a lookup indexes the bucket for the query's length, compares the first eight bytes as one word and
+// only then compares the rest a vector at a time. Lookups take anything with data()/size() (std::string_view,
+// std::string), cx::string, string literals or a pointer and length, and never allocate. Keys longer than MaxLength
+// are rejected when the map is built; longer queries miss immediately.
+template<typename T, std::size_t N, std::size_t MaxLength = 64>
+class string_map {
+public:
+    // a bunch of typedefs
+    using key_type = const char*;
+    using mapped_type = T;
+    using value_type = cx::pair<const char* const, const T>;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = value_type&;
+    using const_reference = const value_type&;
+    using pointer = value_type*;
+    using const_pointer = const value_type*;
+    using iterator = value_type*;
+    using const_iterator = const value_type*;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    // constructors and assignment
+    constexpr string_map() = default;
+    constexpr string_map(std::initializer_list<value_type> entries)
+            : string_map(entries, make_layout(entries), std::make_index_sequence<N>(),
+                         std::make_index_sequence<MaxLength + 2>()) {}
+
+    constexpr string_map(const string_map&) = default;
+    constexpr string_map(string_map&&) noexcept = default;
+
+    constexpr string_map& operator=(const string_map&) = default;
+    constexpr string_map& operator=(string_map&&) noexcept = default;
+
+    // iterators (entries are ordered by key length, then bytes)
+    constexpr const_iterator begin() const noexcept { return arr_.begin(); }
+    constexpr const_iterator end() const noexcept { return arr_.end(); }
+    constexpr const_reverse_iterator rbegin() const noexcept { return arr_.rbegin(); }
+    constexpr const_reverse_iterator rend() const noexcept { return arr_.rend(); }
+    constexpr const_iterator cbegin() const noexcept { return arr_.cbegin(); }
+    constexpr const_iterator cend() const noexcept { return arr_.cend(); }
+    constexpr const_reverse_iterator crbegin() const noexcept { return arr_.crbegin(); }
+    constexpr const_reverse_iterator crend() const noexcept { return arr_.crend(); }
+
+    // element access
+    template<typename K>
+    constexpr const T& at(const K& key) const {
+        const auto it = find(key);
+        // we can't directly put the throw here since this is a core constant expression
+        // (see C++ spec §5.20 [expr.const])
+        if (it == end()) throw_out_of_range();
+        return it->second;
+    }
+
+    constexpr const T& at(const char* data, std::size_t size) const {
+        const auto it = find(data, size);
+        if (it == end()) throw_out_of_range();
+        return it->second;
+    }
+
+    template<typename K>
+    constexpr const T& operator[](const K& key) const {
+        return at(key);
+    }
+
+    // capacity
+    constexpr bool empty() const noexcept { return size() == 0; }
+    constexpr std::size_t size() const noexcept { return N; }
+    constexpr std::size_t max_size() const noexcept { return N; }
+
+    // lookup
+    template<typename K>
+    constexpr size_type count(const K& key) const noexcept {
+        return find(key) == end() ? 0 : 1;
+    }
+
+    constexpr size_type count(const char* data, std::size_t size) const noexcept {
+        return find(data, size) == end() ? 0 : 1;
+    }
+
+    constexpr const_iterator find(const char* data, std::size_t size) const noexcept {
+        if (size > MaxLength) return end();
+        const std::size_t first = length_start_[size];
+        const std::size_t last = length_start_[size + 1];
+        if (first == last) return end();
+
+        const std::uint64_t prefix = detail::load_prefix(data, size);
+        const std::size_t head = size < 8 ? size : 8;
+        for (std::size_t i = first; i < last; ++i) {
+            if (prefixes_[i] == prefix && detail::equal_bytes(arr_[i].first + head, data + head, size - head)) {
+                return begin() + i;
+            }
+        }
+        return end();
+    }
+
+    // std::string_view, std::string and anything else with data() and size()
+    template<typename StringLike,
+             typename = decltype(std::declval<const StringLike&>().data(), std::declval<const StringLike&>().size())>
+    constexpr const_iterator find(const StringLike& key) const noexcept {
+        return find(key.data(), key.size());
+    }
+
+    template<std::size_t M>
+    constexpr const_iterator find(const string<M>& key) const noexcept {
+        return find(key.c_str(), M);
+    }
+
+    template<std::size_t M>
+    constexpr const_iterator find(const char (&key)[M]) const noexcept {
+        return find(key, M - 1);
+    }
+
+private:
+    const cx::array<value_type, N> arr_;
+    // first eight bytes of each key, little-endian, so most mismatches never touch the key itself
+    const cx::array<std::uint64_t, N> prefixes_{};
+    // keys of length L are arr_[length_start_[L], length_start_[L + 1])
+    const cx::array<std::uint32_t, MaxLength + 2> length_start_{};
+
+    struct layout {
+        std::size_t order[N ? N : 1];
+        std::uint64_t prefixes[N ? N : 1];
+        std::uint32_t length_start[MaxLength + 2];
+    };
+
+    struct index_less {
+        const value_type* entries;
+        const std::size_t* lengths;
+        constexpr bool operator()(std::size_t a, std::size_t b) const {
+            if (lengths[a] != lengths[b]) return lengths[a] < lengths[b];
+            return detail::compare_bytes(entries[a].first, entries[b].first, lengths[a]) < 0;
+        }
+    };
+
+    static constexpr layout make_layout(std::initializer_list<value_type> entries) {
+        if (entries.size() != N) throw std::invalid_argument("cx::string_map: initialized with wrong number of entries!");
+
+        layout result{};
+        std::size_t lengths[N ? N : 1]{};
+        for (std::size_t i = 0; i < N; ++i) {
+            lengths[i] = detail::cstr_length((entries.begin() + i)->first);
+            if (lengths[i] > MaxLength) throw std::invalid_argument("cx::string_map: key is longer than MaxLength");
+        }
+
+        std::size_t scratch[N ? N : 1]{};
+        detail::merge_sort_indices(result.order, scratch, N, index_less{entries.begin(), lengths});
+
+        for (std::size_t i = 0; i < N; ++i) {
+            const std::size_t e = result.order[i];
+            const char* key = (entries.begin() + e)->first;
+            if (i > 0) {
+                const std::size_t prev = result.order[i - 1];
+                if (lengths[prev] == lengths[e]
+                    && detail::compare_bytes((entries.begin() + prev)->first, key, lengths[e]) == 0) {
+                    throw std::invalid_argument("cx::string_map: duplicate keys");
+                }
+            }
+            result.prefixes[i] = detail::read_le(key, lengths[e] < 8 ? lengths[e] : 8);
+            ++result.length_start[lengths[e] + 1];
+        }
+        for (std::size_t len = 0; len <= MaxLength; ++len) result.length_start[len + 1] += result.length_start[len];
+        return result;
+    }
+
+    template<std::size_t... Indices, std::size_t... LengthIndices>
+    constexpr string_map(std::initializer_list<value_type>& entries, const layout& l, std::index_sequence<Indices...>,
+                         std::index_sequence<LengthIndices...>)
+            : arr_{*(entries.begin() + l.order[Indices])...},
+              prefixes_{l.prefixes[Indices]...},
+              length_start_{l.length_start[LengthIndices]...} {}
+
+    constexpr void throw_out_of_range() const {
+        throw std::out_of_range("cx::string_map::at: could not find entry in map");
+    }
+};
+
+}
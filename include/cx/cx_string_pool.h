@@ -0,0 +1,150 @@
+// Copyright (c) 2020. Mohit Deshpande.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+// the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include <cstdint>
+#include <type_traits>
+
+#include "cx/cx_algorithm.h"
+#include "cx/cx_string.h"
+
+#include <stdexcept>
+
+namespace cx {
+
+namespace detail {
+
+// orders strings by their reversal, which puts every string right before the strings it is a suffix of
+struct reversed_less {
+    const char* const* strs;
+    const std::size_t* lens;
+    constexpr bool operator()(std::size_t a, std::size_t b) const {
+        for (std::size_t i = 1; i <= lens[a] && i <= lens[b]; ++i) {
+            const auto x = static_cast<unsigned char>(strs[a][lens[a] - i]);
+            const auto y = static_cast<unsigned char>(strs[b][lens[b] - i]);
+            if (x != y) return x < y;
+        }
+        return lens[a] < lens[b];
+    }
+};
+
+// enough bytes to store every string with its terminator, before any sharing
+template<typename... Strings>
+constexpr std::size_t pool_capacity() noexcept {
+    const std::size_t sizes[] = {0, (length_of<Strings>::value + 1)...};
+    std::size_t total = 0;
+    for (std::size_t size : sizes) total += size;
+    return total;
+}
+
+constexpr bool is_suffix(const char* s, std::size_t s_len, const char* of, std::size_t of_len) noexcept {
+    if (s_len > of_len) return false;
+    for (std::size_t i = 1; i <= s_len; ++i) {
+        if (s[s_len - i] != of[of_len - i]) return false;
+    }
+    return true;
+}
+
+}
+
+// Packs Count null-terminated strings into one contiguous blob of Size bytes. Duplicates are stored once and a string
+// that is a suffix of another ("bar" in "foobar") points into it. Strings are addressed by index or by 16/32-bit
+// offset handles into the blob.
+//
+// Size has to be known up front, so building a pool is two steps: make_string_pool() sizes the blob for the worst
+// case, and compact<blob_size()>() copies the packed bytes into an exact-size pool. Only the second one ends up in
+// the binary:
+//
+//     constexpr auto kNamesBuilder = cx::make_string_pool("electron", "neutrino", "electron neutrino");
+//     constexpr auto kNames = kNamesBuilder.compact<kNamesBuilder.blob_size()>();
+template<std::size_t Count, std::size_t Size>
+class string_pool {
+public:
+    using handle_type = std::conditional_t<(Size <= 0xffffu), std::uint16_t, std::uint32_t>;
+    using size_type = std::size_t;
+
+    // packs strs[i] (lens[i] characters each); used by make_string_pool()
+    constexpr string_pool(const char* const* strs, const std::size_t* lens) {
+        std::size_t order[Count ? Count : 1]{};
+        std::size_t scratch[Count ? Count : 1]{};
+        detail::merge_sort_indices(order, scratch, Count, detail::reversed_less{strs, lens});
+
+        // walk from the back so a string is placed before any of its suffixes
+        std::size_t last = Count;
+        for (std::size_t k = Count; k-- > 0;) {
+            const std::size_t i = order[k];
+            if (last != Count && detail::is_suffix(strs[i], lens[i], strs[last], lens[last])) {
+                offsets_[i] = static_cast<handle_type>(offsets_[last] + lens[last] - lens[i]);
+                continue;
+            }
+            if (used_ + lens[i] + 1 > Size) throw std::length_error("cx::string_pool: blob is too small");
+            offsets_[i] = static_cast<handle_type>(used_);
+            for (std::size_t c = 0; c < lens[i]; ++c) blob_[used_++] = strs[i][c];
+            blob_[used_++] = '\0';
+            last = i;
+        }
+    }
+
+    // copies another pool's packed bytes, typically to shrink a worst-case-sized pool to its exact size
+    template<std::size_t OtherSize>
+    constexpr explicit string_pool(const string_pool<Count, OtherSize>& other) {
+        if (other.blob_size() > Size) throw std::length_error("cx::string_pool: blob is too small");
+        for (std::size_t i = 0; i < other.blob_size(); ++i) blob_[i] = other.data()[i];
+        for (std::size_t i = 0; i < Count; ++i) offsets_[i] = static_cast<handle_type>(other.handle(i));
+        used_ = other.blob_size();
+    }
+
+    template<std::size_t NewSize>
+    constexpr string_pool<Count, NewSize> compact() const {
+        return string_pool<Count, NewSize>(*this);
+    }
+
+    // element access
+    constexpr const char* operator[](size_type i) const noexcept { return blob_ + offsets_[i]; }
+    constexpr const char* at(size_type i) const {
+        if (i >= Count) throw std::out_of_range("cx::string_pool::at: index out of bounds");
+        return (*this)[i];
+    }
+
+    constexpr handle_type handle(size_type i) const noexcept { return offsets_[i]; }
+    constexpr const char* c_str(handle_type h) const noexcept { return blob_ + h; }
+
+    // capacity
+    constexpr size_type size() const noexcept { return Count; }
+    constexpr bool empty() const noexcept { return Count == 0; }
+
+    // the packed bytes
+    constexpr const char* data() const noexcept { return blob_; }
+    constexpr size_type blob_size() const noexcept { return used_; }
+    constexpr size_type capacity() const noexcept { return Size; }
+
+private:
+    char blob_[Size ? Size : 1]{};
+    handle_type offsets_[Count ? Count : 1]{};
+    std::size_t used_{};
+};
+
+// worst-case-sized pool of string literals and/or cx::strings; see string_pool for how to shrink it
+template<typename... Strings>
+constexpr auto make_string_pool(const Strings&... strs) {
+    constexpr std::size_t kCount = sizeof...(Strings);
+    constexpr std::size_t kCapacity = detail::pool_capacity<Strings...>();
+    const char* ptrs[kCount ? kCount : 1] = {detail::c_str_of(strs)...};
+    const std::size_t lens[kCount ? kCount : 1] = {length_of<Strings>::value...};
+    return string_pool<kCount, kCapacity>(ptrs, lens);
+}
+
+}
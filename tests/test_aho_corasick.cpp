@@ -0,0 +1,177 @@
+// Copyright (c) 2020. Mohit Deshpande.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+// the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include <gtest/gtest.h>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "cx/cx_aho_corasick.h"
+
+namespace {
+
+using match_list = std::vector<std::tuple<std::size_t, std::size_t, std::size_t>>;
+
+template<typename Automaton>
+match_list scan_all(const Automaton& automaton, const std::string& text) {
+    match_list matches;
+    automaton.scan(text, [&](cx::aho_corasick_match m) { matches.emplace_back(m.pattern, m.begin, m.end); });
+    return matches;
+}
+
+// every occurrence of every pattern, in the order the automaton reports them: by end, then longest first
+match_list naive_matches(const std::vector<std::string>& patterns, const std::string& text) {
+    match_list matches;
+    for (std::size_t end = 1; end <= text.size(); ++end) {
+        for (std::size_t length = end; length > 0; --length) {
+            for (std::size_t p = 0; p < patterns.size(); ++p) {
+                if (patterns[p].size() == length && text.compare(end - length, length, patterns[p]) == 0) {
+                    matches.emplace_back(p, end - length, end);
+                }
+            }
+        }
+    }
+    return matches;
+}
+
+}
+
+static constexpr auto kHersTrie = cx::make_aho_corasick("he", "she", "his", cx::lit("hers"));
+static constexpr auto kHers = kHersTrie.compact<kHersTrie.state_count(), kHersTrie.class_count()>();
+
+TEST(Constructors, Compact) {
+    static_assert(kHersTrie.capacity() == 13, "");
+    // h, he, her, hers, hi, his, s, sh, she and the root
+    static_assert(kHers.state_count() == 10, "");
+    // e, h, i, r, s and everything else
+    static_assert(kHers.class_count() == 6, "");
+    static_assert(kHers.size() == 4, "");
+    static_assert(kHers.pattern_length(3) == 4, "");
+    static_assert(std::is_same<decltype(kHers)::state_type, std::uint16_t>::value, "");
+    // every pattern holds an 'h', but the prefilter is opt-in
+    static_assert(kHersTrie.can_prefilter(), "");
+    static_assert(!kHers.has_prefilter(), "");
+}
+
+TEST(Constructors, EmptyAutomaton) {
+    constexpr auto trie = cx::make_aho_corasick();
+    constexpr auto automaton = trie.compact<trie.state_count(), trie.class_count()>();
+    static_assert(automaton.empty(), "");
+    static_assert(!automaton.contains("anything"), "");
+    static_assert(automaton.count("anything") == 0, "");
+}
+
+TEST(Constructors, BadPatterns) {
+    const char* patterns[] = {"foo", "bar", "foo"};
+    const std::size_t lengths[] = {3, 3, 3};
+    EXPECT_THROW((cx::aho_corasick_trie<3, 10>(patterns, lengths)), std::invalid_argument);
+    const std::size_t empty[] = {3, 0, 3};
+    EXPECT_THROW((cx::aho_corasick_trie<3, 10>(patterns, empty)), std::invalid_argument);
+    EXPECT_THROW((cx::aho_corasick_trie<2, 4>(patterns, lengths)), std::length_error);
+    EXPECT_THROW((kHersTrie.compact<9, 6>()), std::length_error);
+}
+
+TEST(Lookup, Overlapping) {
+    static_assert(kHers.count("ushers") == 3, "");
+    static_assert(kHers.find_first("ushers").pattern == 1, "");
+    static_assert(kHers.find_first("ushers").begin == 1, "");
+    static_assert(kHers.find_first("ushers").end == 4, "");
+    static_assert(kHers.contains(cx::lit("this")), "");
+    static_assert(!kHers.contains("hi"), "");
+    static_assert(kHers.find_first("hi").pattern == kHers.size(), "");
+
+    EXPECT_EQ(scan_all(kHers, "ushers"), (match_list{{1, 1, 4}, {0, 2, 4}, {3, 2, 6}}));
+    EXPECT_EQ(scan_all(kHers, "hishers"), naive_matches({"he", "she", "his", "hers"}, "hishers"));
+    EXPECT_TRUE(scan_all(kHers, "").empty());
+}
+
+TEST(Lookup, ArrayOfStrings) {
+    static constexpr cx::array<cx::string<3>, 4> kCodons{{cx::lit("ATG"), cx::lit("TAA"), cx::lit("TAG"),
+                                                          cx::lit("TGA")}};
+    static constexpr auto kTrie = cx::make_aho_corasick(kCodons);
+    static constexpr auto kStops = kTrie.compact<kTrie.state_count(), kTrie.class_count()>();
+    static_assert(kStops.count("ATGATAGTAA") == 4, "");
+    EXPECT_EQ(scan_all(kStops, "CATGAC"), (match_list{{0, 1, 4}, {3, 2, 5}}));
+}
+
+TEST(Lookup, Prefilter) {
+    // a prefilter on '<' and '%': the scan jumps between them
+    static constexpr auto kTrie = cx::make_aho_corasick("<script", "<iframe", "<img", "%PDF", "%%EOF");
+    static constexpr auto kTags = kTrie.compact<kTrie.state_count(), kTrie.class_count()>(
+            cx::aho_corasick_prefilter::rare_bytes);
+    static_assert(kTags.has_prefilter(), "");
+    static_assert(kTags.count("<<script><img src=x>%%EOF") == 3, "");
+
+    std::string text(4096, 'a');
+    text.replace(7, 7, "<script");
+    text.replace(100, 5, "%%EOF");
+    text.replace(4092, 4, "<img");
+    EXPECT_EQ(scan_all(kTags, text), (match_list{{0, 7, 14}, {4, 100, 105}, {2, 4092, 4096}}));
+    EXPECT_EQ(kTags.find_first(text.substr(20)).pattern, 4u);
+}
+
+TEST(Lookup, PrefilterInsidePatterns) {
+    // the rare bytes are '=' and ':', up to five bytes into a pattern
+    static constexpr auto kTrie = cx::make_aho_corasick("user=", "pass:", "token=", "x=");
+    static constexpr auto kFields = kTrie.compact<kTrie.state_count(), kTrie.class_count()>(
+            cx::aho_corasick_prefilter::rare_bytes);
+    static_assert(kFields.has_prefilter(), "");
+    static_assert(kFields.count("token=1&user=2&pass:3&ax=") == 4, "");
+    static_assert(kFields.find_first("xx user=").begin == 3, "");
+
+    std::string text(1000, 'a');
+    text.replace(0, 6, "token=");
+    text.replace(300, 6, "user=x");
+    text.replace(994, 6, "pass:=");
+    const std::vector<std::string> patterns{"user=", "pass:", "token=", "x="};
+    EXPECT_EQ(scan_all(kFields, text), naive_matches(patterns, text));
+    EXPECT_EQ(kFields.find_first(text.substr(1)).begin, 299u);
+
+    // four patterns with no byte in common need four rare bytes, one more than the prefilter has room for
+    static constexpr auto kApartTrie = cx::make_aho_corasick("ab", "cd", "ef", "gh");
+    static_assert(!kApartTrie.can_prefilter(), "");
+    static constexpr auto kApart = kApartTrie.compact<kApartTrie.state_count(), kApartTrie.class_count()>(
+            cx::aho_corasick_prefilter::rare_bytes);
+    static_assert(!kApart.has_prefilter(), "");
+    static_assert(kApart.count("abcdefgh") == 4, "");
+}
+
+TEST(Lookup, MatchesNaiveSearch) {
+    static constexpr auto kTrie = cx::make_aho_corasick("ab", "abc", "bca", "c", "aab", "bb", "cab", "abcab", "b",
+                                                        "da");
+    static constexpr auto kWords = kTrie.compact<kTrie.state_count(), kTrie.class_count()>();
+    static constexpr auto kFiltered = kTrie.compact<kTrie.state_count(), kTrie.class_count()>(
+            cx::aho_corasick_prefilter::rare_bytes);
+    static_assert(!kWords.has_prefilter(), "");
+    static_assert(kFiltered.has_prefilter(), "");
+    const std::vector<std::string> patterns{"ab", "abc", "bca", "c", "aab", "bb", "cab", "abcab", "b", "da"};
+
+    std::mt19937 gen{7};
+    std::uniform_int_distribution<int> letter{'a', 'd'};
+    for (int round = 0; round < 50; ++round) {
+        std::string text(200, ' ');
+        for (auto& c : text) c = static_cast<char>(letter(gen));
+        const auto expected = naive_matches(patterns, text);
+        EXPECT_EQ(scan_all(kWords, text), expected);
+        EXPECT_EQ(kWords.count(text), expected.size());
+        EXPECT_EQ(scan_all(kFiltered, text), expected);
+    }
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
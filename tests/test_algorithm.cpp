@@ -0,0 +1,166 @@
+// Copyright (c) 2020. Mohit Deshpande.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+// the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "cx/cx_algorithm.h"
+
+namespace {
+
+constexpr std::uint32_t crc32c_entry(std::size_t byte) {
+    std::uint32_t crc = static_cast<std::uint32_t>(byte);
+    for (int bit = 0; bit < 8; ++bit) crc = (crc >> 1) ^ (0x82f63b78u & (0u - (crc & 1u)));
+    return crc;
+}
+
+constexpr std::uint8_t popcount(std::size_t byte) {
+    return static_cast<std::uint8_t>(byte ? (byte & 1u) + popcount(byte >> 1) : 0);
+}
+
+constexpr char kBase64[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+// 0xff for bytes outside the alphabet
+struct base64_decode {
+    constexpr std::uint8_t operator()(std::size_t byte) const {
+        for (std::size_t i = 0; i < 64; ++i) {
+            if (static_cast<unsigned char>(kBase64[i]) == byte) return static_cast<std::uint8_t>(i);
+        }
+        return 0xff;
+    }
+};
+
+// a constexpr linear congruential generator, to get unsorted input without writing it out
+struct lcg {
+    std::uint32_t state;
+    constexpr int operator()() {
+        state = state * 1664525u + 1013904223u;
+        return static_cast<int>(state >> 24);
+    }
+};
+
+struct square {
+    constexpr int operator()(int x) const { return x * x; }
+};
+
+struct is_even {
+    constexpr bool operator()(int x) const { return x % 2 == 0; }
+};
+
+struct greater {
+    constexpr bool operator()(int a, int b) const { return a > b; }
+};
+
+template<std::size_t N>
+std::vector<int> to_vector(const cx::array<int, N>& a) {
+    return std::vector<int>(a.begin(), a.end());
+}
+
+}
+
+TEST(Tables, MakeTable) {
+    static constexpr auto kCrc32c = cx::make_table<256>(crc32c_entry);
+    static_assert(kCrc32c[0] == 0u, "");
+    static_assert(kCrc32c[1] == 0xf26b8303u, "");
+    static_assert(kCrc32c[255] == 0xad7d5351u, "");
+
+    static constexpr auto kPopcount = cx::make_table<256>(popcount);
+    static_assert(std::is_same<decltype(kPopcount)::value_type, std::uint8_t>::value, "");
+    static_assert(kPopcount[0xb7] == 6, "");
+    static_assert(cx::accumulate(kPopcount, 0) == 1024, "");
+
+    static constexpr auto kBase64Decode = cx::make_table<256>(base64_decode{});
+    static_assert(kBase64Decode['A'] == 0 && kBase64Decode['/'] == 63, "");
+    static_assert(kBase64Decode['='] == 0xff, "");
+    for (std::size_t i = 0; i < 64; ++i) EXPECT_EQ(kBase64Decode[static_cast<unsigned char>(kBase64[i])], i);
+}
+
+TEST(Tables, GenerateAndTransform) {
+    constexpr lcg gen{1};
+    constexpr auto a = cx::generate<4>(gen);
+    constexpr auto b = cx::generate<4>(gen);
+    static_assert(a == b, "");
+    static_assert(gen.state == 1, "");
+
+    constexpr cx::array<int, 4> small{1, 2, 3, 4};
+    constexpr auto squares = cx::transform(small, square{});
+    static_assert(squares == cx::array<int, 4>{1, 4, 9, 16}, "");
+    static_assert(cx::transform(small, squares, std::minus<>{}) == cx::array<int, 4>{0, -2, -6, -12}, "");
+    static_assert(cx::accumulate(small, 1, std::multiplies<>{}) == 24, "");
+    static_assert(cx::accumulate(cx::array<int, 0>{}, 7) == 7, "");
+}
+
+TEST(Lookup, Find) {
+    constexpr cx::array<int, 5> a{4, 8, 15, 16, 23};
+    static_assert(cx::find(a, 15) == 2, "");
+    static_assert(cx::find(a, 42) == a.size(), "");
+    static_assert(cx::find_if(a, is_even{}) == 0, "");
+    static_assert(cx::find_if(cx::array<int, 2>{1, 3}, is_even{}) == 2, "");
+}
+
+TEST(Partition, Stable) {
+    constexpr cx::array<int, 7> a{5, 2, 7, 4, 4, 1, 8};
+    constexpr auto split = cx::partition(a, is_even{});
+    static_assert(split.second == 4, "");
+    static_assert(split.first == cx::array<int, 7>{2, 4, 4, 8, 5, 7, 1}, "");
+    static_assert(cx::partition(cx::array<int, 0>{}, is_even{}).second == 0, "");
+}
+
+TEST(Sort, SortingNetwork) {
+    static_assert(cx::sort(cx::array<int, 5>{3, 1, 4, 1, 5}) == cx::array<int, 5>{1, 1, 3, 4, 5}, "");
+    static_assert(cx::sort(cx::array<int, 3>{1, 2, 3}, greater{}) == cx::array<int, 3>{3, 2, 1}, "");
+    static_assert(cx::sort(cx::array<int, 0>{}).empty(), "");
+
+    // 0-1 principle: a comparator network that sorts every 0/1 input sorts everything
+    cx::array<int, 13> bits{};
+    for (std::uint32_t mask = 0; mask < (1u << 13); ++mask) {
+        for (std::size_t i = 0; i < 13; ++i) bits[i] = (mask >> i) & 1;
+        EXPECT_TRUE(cx::is_sorted(cx::sort(bits))) << mask;
+    }
+}
+
+TEST(Sort, Introsort) {
+    static constexpr auto kShuffled = cx::generate<500>(lcg{42});
+    static constexpr auto kSorted = cx::sort(kShuffled);
+    static_assert(cx::is_sorted(kSorted), "");
+    static_assert(cx::accumulate(kSorted, 0) == cx::accumulate(kShuffled, 0), "");
+
+    auto expected = to_vector(kShuffled);
+    std::sort(expected.begin(), expected.end());
+    EXPECT_EQ(to_vector(kSorted), expected);
+
+    // already sorted, reversed and all-equal inputs
+    static_assert(cx::is_sorted(cx::sort(kSorted)), "");
+    static_assert(cx::is_sorted(cx::sort(kSorted, greater{}), greater{}), "");
+    static_assert(cx::is_sorted(cx::sort(cx::make_table<100>(popcount))), "");
+
+    std::mt19937 gen{7};
+    std::uniform_int_distribution<int> value{0, 20};
+    cx::array<int, 300> a{};
+    for (int round = 0; round < 50; ++round) {
+        for (auto& v : a.elems_) v = value(gen);
+        auto copy = to_vector(a);
+        std::sort(copy.begin(), copy.end());
+        EXPECT_EQ(to_vector(cx::sort(a)), copy);
+    }
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,134 @@
+// Copyright (c) 2020. Mohit Deshpande.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+// the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "cx/cx_aligned_array.h"
+
+namespace {
+
+enum class proto : std::uint8_t { tcp, udp, icmp };
+
+struct point {
+    int x;
+    int y;
+    constexpr bool operator==(const point& rhs) const { return x == rhs.x && y == rhs.y; }
+    constexpr bool operator!=(const point& rhs) const { return !(*this == rhs); }
+};
+
+}
+
+TEST(Constructors, Alignment) {
+    static_assert(alignof(cx::aligned_array<char, 3>) == 64, "");
+    static_assert(sizeof(cx::aligned_array<char, 3>) == 64, "");
+    static_assert(sizeof(cx::aligned_array<float, 17>) == 128, "");
+    static_assert(alignof(cx::aligned_array<int, 4, 32>) == 32, "");
+
+    cx::aligned_array<std::uint16_t, 5> arrays[3]{};
+    for (const auto& a : arrays) EXPECT_EQ(reinterpret_cast<std::uintptr_t>(a.data()) % 64, 0u);
+}
+
+TEST(Constructors, FromArray) {
+    constexpr cx::array<int, 3> a{1, 2, 3};
+    constexpr auto aligned = cx::make_aligned_array<32>(a);
+    static_assert(aligned.alignment == 32, "");
+    static_assert(aligned == cx::aligned_array<int, 3, 32>{1, 2, 3}, "");
+    static_assert(aligned.at(2) == 3, "");
+    EXPECT_THROW(aligned.at(3), std::out_of_range);
+}
+
+TEST(EqualityOperator, CompileTimeAndRuntime) {
+    constexpr cx::aligned_array<int, 3> a{1, 2, 3};
+    constexpr cx::aligned_array<int, 3> b{1, 2, 4};
+    static_assert(a == a && a != b, "");
+    static_assert(cx::aligned_array<point, 2>{{{1, 2}, {3, 4}}} != cx::aligned_array<point, 2>{{{1, 2}, {3, 5}}}, "");
+
+    cx::aligned_array<std::uint8_t, 100> x{};
+    cx::aligned_array<std::uint8_t, 100> y{};
+    for (std::size_t i = 0; i < 100; ++i) x[i] = y[i] = static_cast<std::uint8_t>(i);
+    EXPECT_TRUE(x == y);
+    for (std::size_t i = 0; i < 100; ++i) {
+        ++y[i];
+        EXPECT_TRUE(x != y) << i;
+        --y[i];
+    }
+}
+
+TEST(Lookup, FindAndCount) {
+    constexpr cx::aligned_array<proto, 5> protos{proto::tcp, proto::udp, proto::tcp, proto::icmp, proto::tcp};
+    static_assert(protos.find(proto::icmp) == 3, "");
+    static_assert(protos.count(proto::tcp) == 3, "");
+    static_assert(!cx::aligned_array<int, 0>{}.contains(0), "");
+    static_assert(cx::aligned_array<point, 2>{{{1, 2}, {3, 4}}}.find({3, 4}) == 1, "");
+
+    cx::aligned_array<std::int64_t, 77> values{};
+    for (std::size_t i = 0; i < values.size(); ++i) values[i] = static_cast<std::int64_t>(i % 10);
+    EXPECT_EQ(values.find(7), 7u);
+    EXPECT_EQ(values.count(7), 7u);
+    EXPECT_EQ(values.find(10), values.size());
+    EXPECT_TRUE(values.contains(9));
+}
+
+TEST(Reductions, CompileTime) {
+    constexpr cx::aligned_array<int, 5> a{3, -1, 4, -1, 5};
+    static_assert(a.min() == -1 && a.max() == 5 && a.sum() == 10, "");
+    static_assert(cx::aligned_array<double, 0>{}.sum() == 0.0, "");
+    static_assert(cx::aligned_array<std::uint64_t, 2>{1, 2}.sum() == 3, "");
+}
+
+TEST(Reductions, SumWraps) {
+    constexpr auto kMax = std::numeric_limits<std::int32_t>::max();
+    constexpr auto kMin = std::numeric_limits<std::int32_t>::min();
+    static_assert(cx::aligned_array<std::int32_t, 2>{kMax, 1}.sum() == kMin, "");
+    // moving the largest value puts the overflowing add in the vector body, the lane fold or the scalar tail
+    for (std::size_t at = 0; at < 9; ++at) {
+        cx::aligned_array<std::int32_t, 9> a{};
+        for (auto& v : a.elems_) v = 1;
+        a.elems_[at] = kMax;
+        EXPECT_EQ(a.sum(), kMin + 7) << at;
+    }
+}
+
+template<typename T>
+class ReductionsTyped : public ::testing::Test {};
+
+using reduction_types = ::testing::Types<std::int32_t, std::uint32_t, float, double, std::int16_t>;
+TYPED_TEST_SUITE(ReductionsTyped, reduction_types);
+
+TYPED_TEST(ReductionsTyped, MatchesScalar) {
+    std::mt19937 gen{11};
+    std::uniform_int_distribution<int> value{-1000, 1000};
+    cx::aligned_array<TypeParam, 37> a{};
+    for (int round = 0; round < 20; ++round) {
+        for (auto& v : a.elems_) v = static_cast<TypeParam>(value(gen));
+        EXPECT_EQ(a.min(), *std::min_element(a.begin(), a.end()));
+        EXPECT_EQ(a.max(), *std::max_element(a.begin(), a.end()));
+        // small integers, so float sums are exact in any order
+        EXPECT_EQ(a.sum(), std::accumulate(a.begin(), a.end(), TypeParam{}, [](TypeParam x, TypeParam y) {
+            return static_cast<TypeParam>(x + y);
+        }));
+    }
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
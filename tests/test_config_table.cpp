@@ -0,0 +1,153 @@
+// Copyright (c) 2020. Mohit Deshpande.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+// the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <type_traits>
+
+#include "cx/cx_config_table.h"
+
+namespace {
+
+// a minimal stand-in for std::string_view so the test also builds as C++14
+struct view {
+    const char* ptr;
+    std::size_t len;
+    constexpr const char* data() const { return ptr; }
+    constexpr std::size_t size() const { return len; }
+};
+
+}
+
+static constexpr char kJson[] = R"({
+    "server": {"host": "0.0.0.0", "ports": [80, 443], "timeout": 2.5},
+    "debug": false,
+    "name": "caf\u00e9 \"cx\"",
+    "limits": {"max": 9223372036854775807, "min": -9223372036854775808, "huge": 1e400, "tiny": 4.9e-324},
+    "empty": {},
+    "none": null
+})";
+
+static constexpr auto kJsonBuilder = cx::parse_json(kJson);
+static constexpr auto kConfig = kJsonBuilder.compact<kJsonBuilder.entry_count(), kJsonBuilder.blob_size()>();
+
+static constexpr char kIni[] = R"(
+; defaults
+retries = 3
+
+[server]
+host = example.com
+port=8080
+ratio = 0.75
+motd = "hello,\tworld"
+verbose = true
+path = /var/lib/cx   
+)";
+
+static constexpr auto kIniBuilder = cx::parse_ini(kIni);
+static constexpr auto kIniConfig = kIniBuilder.compact<kIniBuilder.entry_count(), kIniBuilder.blob_size()>();
+
+TEST(Json, Entries) {
+    static_assert(kConfig.size() == 15, "");
+    static_assert(kConfig.key(0) == "debug" && kConfig.key(14) == "server.timeout", "");
+    static_assert(kConfig["server"].kind() == cx::config_kind::object && kConfig["server"].size() == 3, "");
+    static_assert(kConfig["server.ports"].kind() == cx::config_kind::array && kConfig["server.ports"].size() == 2, "");
+    static_assert(kConfig["server.ports.1"].as_integer() == 443, "");
+    static_assert(kConfig["server.timeout"].as_number() == 2.5, "");
+    static_assert(!kConfig["debug"].as_bool(), "");
+    static_assert(kConfig["none"].is_null() && kConfig["empty"].size() == 0, "");
+    static_assert(kConfig["limits.max"].as_integer() == std::numeric_limits<std::int64_t>::max(), "");
+    static_assert(kConfig["limits.min"].as_integer() == std::numeric_limits<std::int64_t>::min(), "");
+    static_assert(kConfig["limits.huge"].as_number() == std::numeric_limits<double>::infinity(), "");
+    static_assert(kConfig["limits.tiny"].as_number() == std::numeric_limits<double>::denorm_min(), "");
+    static_assert(kConfig["name"].as_string() == "caf\xc3\xa9 \"cx\"", "");
+    static_assert(kConfig.contains("server.host") && !kConfig.contains("server.hos"), "");
+    static_assert(kConfig.find("missing") == kConfig.npos && kConfig.count("debug") == 1, "");
+
+    EXPECT_EQ(kConfig.at(std::string("server.host")).as_string().str(), "0.0.0.0");
+    EXPECT_EQ(kConfig.find(view{"server.portsX", 12}), kConfig.find("server.ports"));
+    EXPECT_EQ(kConfig["server.ports.0"].as<std::uint16_t>(), 80);
+    EXPECT_THROW(kConfig.at("nope"), std::out_of_range);
+    EXPECT_THROW(kConfig["server.host"].as_integer(), std::invalid_argument);
+    EXPECT_THROW(kConfig["server.timeout"].as_integer(), std::invalid_argument);
+    EXPECT_THROW(kConfig["server.ports.1"].as<std::int8_t>(), std::out_of_range);
+    EXPECT_EQ(kConfig["server.ports.1"].as_number(), 443.0);
+}
+
+TEST(Json, Structures) {
+    constexpr auto host = kConfig.string_at<kConfig["server.host"].text().size()>("server.host");
+    static_assert(std::is_same<decltype(host), const cx::string<7>>::value, "");
+    static_assert(host == cx::lit("0.0.0.0"), "");
+
+    constexpr auto ports = kConfig.array_at<int, 2>("server.ports");
+    static_assert(ports[0] == 80 && ports[1] == 443, "");
+    EXPECT_THROW((kConfig.array_at<int, 3>("server.ports")), std::length_error);
+    EXPECT_THROW((kConfig.array_at<int, 1>("server")), std::invalid_argument);
+
+    static constexpr auto kMap = kConfig.to_map();
+    static_assert(kMap.size() == kConfig.size(), "");
+    static_assert(kMap.at("server.ports.0").as_integer() == 80, "");
+    EXPECT_EQ(kMap.find("debug")->second.text(), "false");
+}
+
+TEST(Json, Errors) {
+    EXPECT_THROW(cx::parse_json("42"), cx::config_error);
+    EXPECT_THROW(cx::parse_json("{\"a\": 01}"), cx::config_error);
+    EXPECT_THROW(cx::parse_json("{\"a\": tru}"), cx::config_error);
+    EXPECT_THROW(cx::parse_json("{\"a\": \"\\x\"}"), cx::config_error);
+    EXPECT_THROW(cx::parse_json("{\"a\": \"\\ud800\"}"), cx::config_error);
+    EXPECT_THROW(cx::parse_json("{\"a\": [1, 2,]}"), cx::config_error);
+    EXPECT_THROW(cx::parse_json("{\"a\": 1} x"), cx::config_error);
+    try {
+        cx::parse_json(R"({"a": {"b": 1}, "a.b": 2})");
+        FAIL();
+    } catch (const cx::config_error& e) {
+        EXPECT_EQ(e.offset(), 16u);
+        EXPECT_STREQ(e.what(), "cx::config: duplicate key at offset 16");
+    }
+    try {
+        cx::parse_json(R"({"a": 1 "b": 2})");
+        FAIL();
+    } catch (const cx::config_error& e) {
+        EXPECT_EQ(e.offset(), 8u);
+    }
+    EXPECT_THROW((cx::parse_json<2>("[1, 2, 3]")), std::length_error);
+}
+
+TEST(Ini, Entries) {
+    static_assert(kIniConfig.size() == 8, "");
+    static_assert(kIniConfig["retries"].as_integer() == 3, "");
+    static_assert(kIniConfig["server"].size() == 6, "");
+    static_assert(kIniConfig["server.port"].as<int>() == 8080, "");
+    static_assert(kIniConfig["server.ratio"].as_number() == 0.75, "");
+    static_assert(kIniConfig["server.verbose"].as_bool(), "");
+    static_assert(kIniConfig["server.host"].as_string() == "example.com", "");
+    static_assert(kIniConfig["server.motd"].as_string() == "hello,\tworld", "");
+    static_assert(kIniConfig["server.path"].as_string() == "/var/lib/cx", "");
+
+    EXPECT_THROW(cx::parse_ini("[server\nhost = x\n"), cx::config_error);
+    EXPECT_THROW(cx::parse_ini("[]\n"), cx::config_error);
+    EXPECT_THROW(cx::parse_ini("host\n"), cx::config_error);
+    EXPECT_THROW(cx::parse_ini(" = 1\n"), cx::config_error);
+    EXPECT_THROW(cx::parse_ini("a = \"x\" y\n"), cx::config_error);
+    EXPECT_THROW(cx::parse_ini("a = 1\na = 2\n"), cx::config_error);
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,230 @@
+// Copyright (c) 2020. Mohit Deshpande.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+// the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <string>
+
+#include "cx/cx_dispatch.h"
+#include "cx/cx_map.h"
+#include "cx/cx_string.h"
+#include "cx/cx_string_map.h"
+
+struct request {
+    std::string log;
+};
+
+static int get(request& r, int id) { r.log += "get"; return id; }
+static int put(request& r, int id) { r.log += "put"; return id + 1; }
+static int erase(request& r, int id) { r.log += "delete"; return -id; }
+static int get_all(request& r, int) { r.log += "get_all"; return 0; }
+static int not_found(request& r, int) { r.log += "404"; return 404; }
+
+using handler = int (*)(request&, int);
+
+struct Routes {
+    static constexpr auto table() {
+        return cx::string_map<handler, 4>{
+                {"get", &get},
+                {"put", &put},
+                {"delete", &erase},
+                {"get_all", &get_all},
+        };
+    }
+};
+
+// same-length keys that differ in two places, so the dispatch needs more than one byte; the values don't have to be
+// callable as long as nothing visits them
+struct Opcodes {
+    static constexpr auto table() {
+        return cx::map<cx::string<6>, int, 4>{
+                {cx::lit("load_a"), 0},
+                {cx::lit("load_b"), 1},
+                {cx::lit("save_a"), 2},
+                {cx::lit("save_b"), 3},
+        };
+    }
+};
+
+struct NoRoutes {
+    static constexpr auto table() { return cx::map<const char*, handler, 0>{}; }
+};
+
+// every value is callable, not just function pointers
+struct scale {
+    int factor;
+    constexpr int operator()(int x) const { return factor * x; }
+};
+
+struct Scales {
+    static constexpr auto table() {
+        return cx::map<const char*, scale, 2>{{"double", scale{2}}, {"triple", scale{3}}};
+    }
+};
+
+// "k000" to "k299", more keys than a direct slot table takes, so the dispatch falls back to a minimal perfect hash
+struct Numbered {
+    static constexpr std::size_t kCount = 300;
+
+    static constexpr auto table() {
+        cx::array<cx::pair<cx::string<4>, scale>, kCount> entries{};
+        for (std::size_t i = 0; i < kCount; ++i) {
+            entries[i] = {cx::string<4>('k', digit(i / 100), digit(i / 10 % 10), digit(i % 10)), scale{int(i)}};
+        }
+        return cx::map<cx::string<4>, scale, kCount>(entries);
+    }
+
+    static constexpr char digit(std::size_t d) { return static_cast<char>('0' + d); }
+};
+
+// ten keys that each differ from the others in one place, which takes more byte positions than a signature holds,
+// and a key longer than a signature can describe: both are hashed whole
+struct OneHot {
+    static constexpr auto table() {
+        return cx::map<const char*, int, 10>{
+                {"100000000", 0}, {"010000000", 1}, {"001000000", 2}, {"000100000", 3}, {"000010000", 4},
+                {"000001000", 5}, {"000000100", 6}, {"000000010", 7}, {"000000001", 8}, {"000000000", 9},
+        };
+    }
+};
+
+template<std::size_t N>
+constexpr cx::string<N> repeated(char c) {
+    char chars[N]{};
+    for (auto& x : chars) x = c;
+    const char* data = chars;
+    return cx::string<N>(data, cx::detail::copy_tag{});
+}
+
+static constexpr auto kLongKey = repeated<300>('x');
+static constexpr auto kLongerKey = repeated<301>('x');
+
+struct LongKeys {
+    static constexpr auto table() {
+        return cx::map<const char*, int, 3>{{"short", 0}, {kLongKey.c_str(), 1}, {"", 2}};
+    }
+};
+
+TEST(Lookup, IndexOf) {
+    using routes = cx::dispatch<Routes>;
+    static_assert(routes::size() == 4, "");
+    static_assert(routes::contains("get"), "");
+    static_assert(routes::contains("get_all"), "");
+    static_assert(!routes::contains("gets"), "");
+    static_assert(!routes::contains("ge"), "");
+    static_assert(!routes::contains(""), "");
+    static_assert(!routes::contains("a much longer command than any route"), "");
+
+    // the index is the entry's position in the table
+    const auto table = Routes::table();
+    for (std::size_t i = 0; i < table.size(); ++i) {
+        EXPECT_EQ(routes::index_of(std::string((table.begin() + i)->first)), i);
+    }
+    EXPECT_EQ(routes::index_of(std::string("delete!")), routes::size());
+}
+
+TEST(Lookup, SimilarKeys) {
+    using opcodes = cx::dispatch<Opcodes>;
+    static_assert(opcodes::index_of("load_a") != opcodes::index_of("load_b"), "");
+    static_assert(!opcodes::contains("load_c"), "");
+    static_assert(!opcodes::contains("xoad_a"), "");
+    EXPECT_EQ(opcodes::index_of(cx::lit("save_b")), 3u);
+    EXPECT_EQ(opcodes::index_of(cx::lit("save_c")), opcodes::size());
+}
+
+TEST(Lookup, PerfectHashFallback) {
+    using numbered = cx::dispatch<Numbered>;
+    static_assert(numbered::size() == 300, "");
+    static_assert(numbered::index_of("k000") == 0, "");
+    static_assert(numbered::index_of("k299") == 299, "");
+    static_assert(!numbered::contains("k300"), "");
+    static_assert(!numbered::contains("k0000"), "");
+    for (int i = 0; i < 300; ++i) {
+        const std::string key = "k" + std::string(i < 100 ? "0" : "") + std::string(i < 10 ? "0" : "") +
+                                std::to_string(i);
+        ASSERT_EQ(numbered::index_of(key), std::size_t(i));
+        ASSERT_EQ(numbered::visit(key, 2), 2 * i);
+    }
+    EXPECT_EQ(numbered::index_of(std::string("x123")), numbered::size());
+    EXPECT_THROW(numbered::visit("k999", 1), std::out_of_range);
+}
+
+TEST(Lookup, WholeKeyHash) {
+    using one_hot = cx::dispatch<OneHot>;
+    static_assert(one_hot::index_of("000000000") == 9, "");
+    static_assert(one_hot::index_of("000010000") == 4, "");
+    static_assert(!one_hot::contains("000010001"), "");
+    static_assert(!one_hot::contains("0000000000"), "");
+    EXPECT_EQ(one_hot::index_of(std::string("000000001")), 8u);
+    EXPECT_EQ(one_hot::index_of(std::string("110000000")), one_hot::size());
+
+    using long_keys = cx::dispatch<LongKeys>;
+    static_assert(long_keys::index_of(kLongKey) == 1, "");
+    static_assert(!long_keys::contains(kLongerKey), "");
+    EXPECT_EQ(long_keys::index_of(std::string(300, 'x')), 1u);
+    EXPECT_EQ(long_keys::index_of(std::string(299, 'x') + "y"), long_keys::size());
+    EXPECT_EQ(long_keys::index_of(cx::string_ref()), 2u);
+}
+
+TEST(Visit, CallsHandler) {
+    using routes = cx::dispatch<Routes>;
+    request r;
+    EXPECT_EQ(routes::visit("get", r, 7), 7);
+    EXPECT_EQ(routes::visit(std::string("put"), r, 7), 8);
+    EXPECT_EQ(routes::visit("delete", r, 7), -7);
+    EXPECT_EQ(routes::visit("get_all", r, 7), 0);
+    EXPECT_EQ(r.log, "getputdeleteget_all");
+}
+
+TEST(Visit, MissingKey) {
+    using routes = cx::dispatch<Routes>;
+    request r;
+    EXPECT_THROW(routes::visit("post", r, 1), std::out_of_range);
+    EXPECT_EQ(routes::visit_or("post", &not_found, r, 1), 404);
+    EXPECT_EQ(routes::visit_or("put", &not_found, r, 1), 2);
+    EXPECT_EQ(r.log, "404put");
+}
+
+TEST(Visit, EmptyTable) {
+    using routes = cx::dispatch<NoRoutes>;
+    static_assert(routes::size() == 0, "");
+    static_assert(!routes::contains("get"), "");
+    request r;
+    EXPECT_THROW(routes::visit("get", r, 1), std::out_of_range);
+}
+
+TEST(Visit, CallableValues) {
+    using scales = cx::dispatch<Scales>;
+    EXPECT_EQ(scales::visit("double", 5), 10);
+    EXPECT_EQ(scales::visit("triple", 5), 15);
+}
+
+// an empty key, visited through a view with no characters at all
+struct EmptyKey {
+    static constexpr auto table() { return cx::map<const char*, scale, 2>{{"", scale{0}}, {"one", scale{1}}}; }
+};
+
+TEST(Visit, EmptyKey) {
+    using routes = cx::dispatch<EmptyKey>;
+    EXPECT_EQ(routes::visit(cx::string_ref(), 5), 0);
+    EXPECT_EQ(routes::visit(std::string(), 5), 0);
+    EXPECT_EQ(routes::visit("one", 5), 5);
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
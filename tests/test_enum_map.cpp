@@ -0,0 +1,147 @@
+// Copyright (c) 2020. Mohit Deshpande.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+// the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include <gtest/gtest.h>
+#include <cmath>
+
+#include "cx/cx_enum_map.h"
+
+static constexpr double kEpsilon = 1e-6;
+
+enum class Lepton {
+    kElectron,
+    kMuon,
+    kTau,
+    kElectronNeutrino,
+    kMuonNeutrino,
+    kTauNeutrino,
+};
+
+enum class Status : short {
+    kNegative = -3,
+    kOk = 200,
+    kNotFound = 404,
+};
+
+TEST(Constructors, EmptyMap) {
+    constexpr cx::enum_map<Lepton, const char*, 0> lepton_name = {};
+    static_assert(lepton_name.empty(), "");
+    static_assert(lepton_name.count(Lepton::kMuon) == 0, "");
+}
+
+TEST(Constructors, InitializerList) {
+    constexpr cx::enum_map<Lepton, const char*, 6> lepton_name = {
+            {Lepton::kTauNeutrino, "tau neutrino"},
+            {Lepton::kMuon, "muon"},
+            {Lepton::kTau, "tau"},
+            {Lepton::kElectronNeutrino, "electron neutrino"},
+            {Lepton::kMuonNeutrino, "muon neutrino"},
+            {Lepton::kElectron, "electron"},
+    };
+    static_assert(lepton_name.size() == 6, "");
+    static_assert(lepton_name.is_dense && lepton_name.indexed(), "");
+    static_assert(lepton_name.begin()->first == Lepton::kElectron, "");
+    static_assert((lepton_name.end() - 1)->first == Lepton::kTauNeutrino, "");
+}
+
+TEST(Constructors, InvalidEntries) {
+    auto make_duplicate = [] {
+        return cx::enum_map<Lepton, int, 2>{{Lepton::kMuon, 1}, {Lepton::kMuon, 2}};
+    };
+    EXPECT_THROW(make_duplicate(), std::invalid_argument);
+}
+
+TEST(ElementAccess, ValidLookup) {
+    constexpr cx::enum_map<Lepton, double, 6> lepton_masses = {
+            {Lepton::kElectron, 0.511},
+            {Lepton::kMuon, 105.66},
+            {Lepton::kTau, 1776.},
+            {Lepton::kElectronNeutrino, 1e-6},
+            {Lepton::kMuonNeutrino, 0.17},
+            {Lepton::kTauNeutrino, 18.2},
+    };
+    constexpr auto x = lepton_masses.at(Lepton::kTau);
+    static_assert(std::abs(x - 1776.) < kEpsilon, "");
+    static_assert(lepton_masses.find(Lepton::kMuon)->first == Lepton::kMuon, "");
+}
+
+TEST(ElementAccess, InvalidLookup) {
+    constexpr cx::enum_map<Lepton, const char*, 3> lepton_name = {
+            {Lepton::kElectron, "electron"},
+            {Lepton::kMuon, "muon"},
+            {Lepton::kTau, "tau"},
+    };
+    //constexpr auto x = lepton_name.at(Lepton::kTauNeutrino);
+    static_assert(lepton_name.count(Lepton::kTauNeutrino) == 0, "");
+    EXPECT_THROW(lepton_name.at(Lepton::kTauNeutrino), std::out_of_range);
+}
+
+TEST(Sparse, OffsetTable) {
+    constexpr cx::enum_map<Status, const char*, 3, 408> reason = {
+            {Status::kNotFound, "Not Found"},
+            {Status::kOk, "OK"},
+            {Status::kNegative, "Negative"},
+    };
+    static_assert(!reason.is_dense && reason.indexed(), "");
+    static_assert(reason.begin()->first == Status::kNegative, "");
+    static_assert(reason.at(Status::kOk)[0] == 'O', "");
+    static_assert(reason.at(Status::kNegative)[0] == 'N', "");
+    static_assert(reason.count(static_cast<Status>(201)) == 0, "");
+    static_assert(reason.count(static_cast<Status>(-4)) == 0, "");
+    static_assert(reason.count(static_cast<Status>(405)) == 0, "");
+}
+
+TEST(Sparse, Search) {
+    // not contiguous and no room for an offset table, so lookups search the sorted entries
+    constexpr cx::enum_map<Lepton, int, 2> ends = {{Lepton::kTau, 2}, {Lepton::kElectron, 1}};
+    static_assert(ends.is_dense && !ends.indexed(), "");
+    static_assert(ends.at(Lepton::kElectron) == 1, "");
+    static_assert(ends.at(Lepton::kTau) == 2, "");
+    static_assert(ends.count(Lepton::kMuon) == 0, "");
+    static_assert(ends.find(Lepton::kTauNeutrino) == ends.end(), "");
+
+    // wider than the offset table it was given
+    constexpr cx::enum_map<Status, const char*, 3, 300> reason = {
+            {Status::kNotFound, "Not Found"},
+            {Status::kOk, "OK"},
+            {Status::kNegative, "Negative"},
+    };
+    static_assert(!reason.indexed(), "");
+    static_assert(reason.begin()->first == Status::kNegative, "");
+    static_assert(reason.at(Status::kNegative)[0] == 'N', "");
+    static_assert(reason.at(Status::kNotFound)[0] == 'N', "");
+    static_assert(reason.count(static_cast<Status>(201)) == 0, "");
+    static_assert(reason.count(static_cast<Status>(-32768)) == 0, "");
+    static_assert(reason.count(static_cast<Status>(32767)) == 0, "");
+    EXPECT_THROW(reason.at(static_cast<Status>(0)), std::out_of_range);
+    EXPECT_STREQ(reason.at(Status::kOk), "OK");
+}
+
+TEST(Sparse, EnumSpan) {
+    static_assert(cx::enum_span({Status::kNotFound, Status::kOk, Status::kNegative}) == 408, "");
+    static_assert(cx::enum_span({Lepton::kMuon, Lepton::kTau}) == 2, "");
+    static_assert(cx::enum_span({Lepton::kTau}) == 1, "");
+
+    constexpr cx::enum_map<Status, int, 2, cx::enum_span({Status::kOk, Status::kNotFound})> code = {
+            {Status::kOk, 200},
+            {Status::kNotFound, 404},
+    };
+    static_assert(code.at(Status::kNotFound) == 404, "");
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,190 @@
+// Copyright (c) 2020. Mohit Deshpande.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+// the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <string>
+#include <type_traits>
+
+#include "cx/cx_format.h"
+
+namespace {
+
+// a minimal stand-in for std::string_view so the test also builds as C++14
+struct view {
+    const char* ptr;
+    std::size_t len;
+    constexpr const char* data() const { return ptr; }
+    constexpr std::size_t size() const { return len; }
+};
+
+template<typename Formatter, typename... Args>
+std::string format(const Formatter& formatter, const Args&... args) {
+    char buffer[512];
+    return std::string(buffer, formatter.format_to(buffer, sizeof(buffer), args...));
+}
+
+}
+
+static constexpr auto kLineBuilder = cx::make_format(cx::lit("requests{{host=\"{}\"}} {} {:.3f}\n"));
+static constexpr auto kLine = kLineBuilder.compile<kLineBuilder.signature()>();
+
+static constexpr auto kEmptyBuilder = cx::make_format("");
+static constexpr auto kEmpty = kEmptyBuilder.compile<kEmptyBuilder.signature()>();
+
+TEST(Builder, Parsing) {
+    static_assert(kLineBuilder.arg_count() == 3, "");
+    static_assert(kLineBuilder.text_size() == 20, "");
+    static_assert(kLineBuilder.signature() == (3 | (2 << 12)), "");
+    static_assert(kEmpty.arg_count() == 0 && kEmpty.text_size() == 0, "");
+
+    constexpr auto typed = cx::make_format("{:x}{:e}{:s}{}");
+    static_assert(typed.signature() == (4 | (1 << 8) | (2 << 10) | (3 << 12)), "");
+
+    EXPECT_THROW(cx::make_format("{"), std::invalid_argument);
+    EXPECT_THROW(cx::make_format("}"), std::invalid_argument);
+    EXPECT_THROW(cx::make_format("{:q}"), std::invalid_argument);
+    EXPECT_THROW(cx::make_format("{:3"), std::invalid_argument);
+    EXPECT_THROW(cx::make_format("{:.}"), std::invalid_argument);
+    EXPECT_THROW(cx::make_format("{:.2d}"), std::invalid_argument);
+    EXPECT_THROW(cx::make_format("{:.31f}"), std::invalid_argument);
+    EXPECT_THROW(cx::make_format("{:256}"), std::invalid_argument);
+    EXPECT_THROW(cx::make_format("{}{}{}{}{}{}{}{}{}{}{}{}{}{}{}{}{}{}{}{}{}{}{}{}{}{}{}{}{}"), std::length_error);
+    EXPECT_THROW(kLineBuilder.compile<3>(), std::invalid_argument);
+}
+
+TEST(Formatting, ConstantEvaluation) {
+    static constexpr auto kMessage = kLine.format<64>("example.com", 3, 0.25);
+    static_assert(kMessage == "requests{host=\"example.com\"} 3 0.250\n", "");
+
+    static constexpr auto kCompact = kMessage.compact<kMessage.size()>();
+    static_assert(std::is_same<decltype(kCompact), const cx::string<37>>::value, "");
+    static_assert(kCompact == cx::lit("requests{host=\"example.com\"} 3 0.250\n"), "");
+
+    constexpr auto builder = cx::make_format("{} {} {:e} {}");
+    constexpr auto formatter = builder.compile<builder.signature()>();
+    static_assert(formatter.format<64>(0.1, -0.0, 1234.5f, 5e-324) == "0.1 -0 1.2345e+03 5e-324", "");
+    static_assert(kEmpty.format<0>().empty(), "");
+}
+
+TEST(Formatting, Buffers) {
+    EXPECT_EQ(format(kLine, std::string("db-1"), 123456789012LL, 1.0 / 3),
+              "requests{host=\"db-1\"} 123456789012 0.333\n");
+
+    cx::inline_string<64> line{"> "};
+    kLine.append_to(line, view{"svc", 3}, -7, 2.5e10);
+    EXPECT_EQ(line, "> requests{host=\"svc\"} -7 25000000000.000\n");
+    EXPECT_THROW(kLine.append_to(line, "x", 1, 1.0), std::length_error);
+    EXPECT_EQ(line, "> requests{host=\"svc\"} -7 25000000000.000\n");
+    EXPECT_STREQ(line.c_str(), "> requests{host=\"svc\"} -7 25000000000.000\n");
+
+    // fails partway through the output, after writing over the terminator
+    constexpr auto builder = cx::make_format("x{}{}");
+    constexpr auto pair = builder.compile<builder.signature()>();
+    cx::inline_string<8> abc{"abc"};
+    EXPECT_THROW(pair.append_to(abc, "ab", "0123456789"), std::length_error);
+    EXPECT_EQ(abc.size(), 3u);
+    EXPECT_STREQ(abc.c_str(), "abc");
+
+    char small[8];
+    EXPECT_THROW(kLine.format_to(small, sizeof(small), "x", 1, 1.0), std::length_error);
+    EXPECT_THROW(kLine.format<16>("x", 1, 1.0), std::length_error);
+}
+
+TEST(Formatting, Integers) {
+    constexpr auto builder = cx::make_format("{}|{:d}|{:x}|{:X}|{:o}|{:b}|{:6}|{:06}|{:<6}|{:>4d}");
+    constexpr auto formatter = builder.compile<builder.signature()>();
+    EXPECT_EQ(format(formatter, 0, 'A', 255, 255u, 8, 5, 42, -42, 7, true),
+              "0|65|ff|FF|10|101|    42|-00042|7     |   1");
+    EXPECT_EQ(format(formatter, std::numeric_limits<std::int64_t>::min(), std::uint8_t{200}, -1, ~0ull, 0, 0, -5, 7,
+                     -1, false),
+              "-9223372036854775808|200|-1|FFFFFFFFFFFFFFFF|0|0|    -5|000007|-1    |   0");
+    for (std::uint64_t v = 1; v < std::numeric_limits<std::uint64_t>::max() / 7; v *= 7) {
+        const std::string decimal = std::to_string(v);
+        EXPECT_EQ(format(formatter, v, v, v, v, v, v, v, v, v, v).substr(0, decimal.size() + 1), decimal + "|");
+    }
+}
+
+TEST(Formatting, Text) {
+    constexpr auto builder = cx::make_format("[{}|{:s}|{:5}|{:>5}|{:s}|{}]");
+    constexpr auto formatter = builder.compile<builder.signature()>();
+    EXPECT_EQ(format(formatter, true, 'c', "ab", cx::lit("xy"), false, std::string("str")),
+              "[true|c|ab   |   xy|false|str]");
+    const char* pointer = "ptr";
+    char array[8] = "arr";
+    EXPECT_EQ(format(formatter, false, 'x', pointer, array, true, cx::inline_string<8>{"in"}),
+              "[false|x|ptr  |  arr|true|in]");
+}
+
+TEST(Formatting, Floats) {
+    constexpr auto builder = cx::make_format("{}|{:e}|{:f}|{:.2f}|{:08.1f}|{:8}");
+    constexpr auto formatter = builder.compile<builder.signature()>();
+    EXPECT_EQ(format(formatter, 0.1, 0.1, 0.1, 2.675, -3.14159, 1e21),
+              "0.1|1e-01|0.100000|2.67|-00003.1|   1e+21");
+    EXPECT_EQ(format(formatter, 100.0, 0.0, 0.5, 0.125, 9.96, 1.5f), "100|0e+00|0.500000|0.12|000010.0|     1.5");
+    const double inf = std::numeric_limits<double>::infinity();
+    EXPECT_EQ(format(formatter, -inf, inf, std::nan(""), 1e22, -inf, static_cast<float>(inf)),
+              "-inf|inf|nan|10000000000000000000000.00|    -inf|     inf");
+}
+
+TEST(Formatting, ShortestRoundTrips) {
+    constexpr auto builder = cx::make_format("{}");
+    constexpr auto formatter = builder.compile<builder.signature()>();
+    std::mt19937_64 generator{42};
+    for (int i = 0; i < 100000; ++i) {
+        const std::uint64_t bits = generator();
+        double d = 0;
+        std::memcpy(&d, &bits, sizeof(d));
+        float f = 0;
+        const auto bits32 = static_cast<std::uint32_t>(bits);
+        std::memcpy(&f, &bits32, sizeof(f));
+        if (std::isfinite(d)) {
+            const std::string text = format(formatter, d);
+            ASSERT_EQ(std::strtod(text.c_str(), nullptr), d) << text;
+        }
+        if (std::isfinite(f)) {
+            const std::string text = format(formatter, f);
+            ASSERT_EQ(std::strtof(text.c_str(), nullptr), f) << text;
+        }
+    }
+}
+
+TEST(Formatting, FixedMatchesPrintf) {
+    constexpr auto builder = cx::make_format("{:.0f} {:.3f} {:.9f} {:.17f} {:.30f}");
+    constexpr auto formatter = builder.compile<builder.signature()>();
+    std::mt19937_64 generator{7};
+    char expected[2048];
+    for (int i = 0; i < 20000; ++i) {
+        const std::uint64_t bits = generator();
+        double d = 0;
+        std::memcpy(&d, &bits, sizeof(d));
+        if (i % 2) d = std::ldexp(static_cast<double>(bits >> 11), static_cast<int>(generator() % 140) - 100);
+        if (!std::isfinite(d)) continue;
+        std::snprintf(expected, sizeof(expected), "%.0f %.3f %.9f %.17f %.30f", d, d, d, d, d);
+        char buffer[2048];
+        ASSERT_EQ(std::string(buffer, formatter.format_to(buffer, sizeof(buffer), d, d, d, d, d)), expected);
+    }
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
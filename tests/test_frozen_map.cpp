@@ -0,0 +1,196 @@
+// Copyright (c) 2020. Mohit Deshpande.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+// the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "cx/cx_frozen_map.h"
+
+enum class Lepton {
+    kElectron,
+    kMuon,
+    kTau,
+    kElectronNeutrino,
+    kMuonNeutrino,
+    kTauNeutrino,
+};
+
+// big_table(n) holds key_of(0 ... n - 1), so key_of(n) and up are misses
+static std::uint64_t key_of(std::size_t i) { return i * 0x9e3779b97f4a7c15ULL; }
+
+static std::vector<std::pair<std::uint64_t, std::uint32_t>> big_table(std::size_t n) {
+    std::vector<std::pair<std::uint64_t, std::uint32_t>> entries;
+    for (std::size_t i = 0; i < n; ++i) entries.emplace_back(key_of(i), static_cast<std::uint32_t>(i));
+    return entries;
+}
+
+TEST(Constructors, EmptyMap) {
+    const cx::frozen_map<int, int> empty;
+    EXPECT_TRUE(empty.empty());
+    EXPECT_EQ(empty.count(3), 0);
+    EXPECT_EQ(empty.begin(), empty.end());
+
+    const std::vector<std::pair<int, int>> none;
+    EXPECT_TRUE(cx::freeze(none).empty());
+}
+
+TEST(Constructors, InitializerList) {
+    const cx::frozen_map<Lepton, const char*> lepton_name = {
+            {Lepton::kElectron, "electron"},
+            {Lepton::kMuon, "muon"},
+            {Lepton::kTau, "tau"},
+    };
+    EXPECT_EQ(lepton_name.size(), 3);
+    EXPECT_EQ(lepton_name.partitions(), 1);
+    EXPECT_STREQ(lepton_name.at(Lepton::kMuon), "muon");
+}
+
+TEST(Constructors, SameLayoutAsPerfectMap) {
+    constexpr cx::perfect_map<Lepton, int, 6> compile_time = {
+            {Lepton::kElectron, -1},
+            {Lepton::kMuon, -1},
+            {Lepton::kTau, -1},
+            {Lepton::kElectronNeutrino, 0},
+            {Lepton::kMuonNeutrino, 0},
+            {Lepton::kTauNeutrino, 0},
+    };
+    const cx::frozen_map<Lepton, int> runtime = {
+            {Lepton::kElectron, -1},
+            {Lepton::kMuon, -1},
+            {Lepton::kTau, -1},
+            {Lepton::kElectronNeutrino, 0},
+            {Lepton::kMuonNeutrino, 0},
+            {Lepton::kTauNeutrino, 0},
+    };
+    ASSERT_EQ(runtime.size(), compile_time.size());
+    for (std::size_t slot = 0; slot < runtime.size(); ++slot) {
+        EXPECT_EQ(runtime.begin()[slot].first, compile_time.begin()[slot].first);
+    }
+}
+
+TEST(Constructors, DuplicateKeys) {
+    const std::vector<std::pair<int, int>> entries = {{1, 1}, {2, 2}, {1, 3}};
+    EXPECT_THROW(cx::freeze(entries), std::invalid_argument);
+}
+
+TEST(Constructors, MoveOnly) {
+    auto a = cx::freeze(std::map<int, std::string>{{1, "one"}, {2, "two"}});
+    cx::frozen_map<int, std::string> b = std::move(a);
+    EXPECT_TRUE(a.empty());
+    EXPECT_EQ(b.at(2), "two");
+    a = std::move(b);
+    EXPECT_EQ(a.at(1), "one");
+}
+
+TEST(ElementAccess, StringKeys) {
+    const std::map<std::string, double> masses = {{"electron", 0.511}, {"muon", 105.66}, {"tau", 1776.}};
+    const auto frozen = cx::freeze(masses);
+    EXPECT_DOUBLE_EQ(frozen.at("muon"), 105.66);
+    EXPECT_DOUBLE_EQ(frozen[std::string("tau")], 1776.);
+    EXPECT_EQ(frozen.count("proton"), 0);
+    EXPECT_THROW(frozen.at("proton"), std::out_of_range);
+
+    // looked up without building a std::string
+    const char* electron = "electron";
+    const char muon_neutrino[] = {'m', 'u', 'o', 'n', '-', 'n', 'u'};
+    EXPECT_DOUBLE_EQ(frozen.at(electron), 0.511);
+    EXPECT_DOUBLE_EQ(frozen[cx::string_ref(muon_neutrino, 4)], 105.66);
+    EXPECT_EQ(frozen.count(cx::string_ref(muon_neutrino, 7)), 0);
+    EXPECT_EQ(frozen.find(cx::string_ref("tau")), frozen.find(std::string("tau")));
+    EXPECT_EQ(frozen.find(cx::string_ref()), frozen.end());
+}
+
+// a hash that only takes std::strings, so lookups by anything else go through a temporary std::string
+struct length_hash {
+    std::uint64_t operator()(const std::string& key) const noexcept { return key.size(); }
+};
+
+TEST(ElementAccess, StringKeysCustomHash) {
+    const std::map<std::string, int> lengths = {{"a", 1}, {"bb", 2}};
+    const auto frozen = cx::freeze<length_hash>(lengths);
+    EXPECT_EQ(frozen.at("bb"), 2);
+    EXPECT_EQ(frozen.count(std::string("c")), 0);
+}
+
+TEST(ElementAccess, NonTrivialValues) {
+    auto counter = std::make_shared<int>(0);
+    {
+        const auto frozen = cx::freeze(std::map<int, std::shared_ptr<int>>{{1, counter}, {2, counter}});
+        EXPECT_EQ(counter.use_count(), 3);
+        EXPECT_EQ(frozen.at(1), counter);
+    }
+    EXPECT_EQ(counter.use_count(), 1);
+}
+
+TEST(Partitions, ParallelBuild) {
+    // several partitions, built on several threads, must find every key and nothing else
+    const auto entries = big_table(300000);
+    const auto frozen = cx::freeze(entries, 4);
+    EXPECT_GT(frozen.partitions(), 1);
+    ASSERT_EQ(frozen.size(), entries.size());
+    for (const auto& entry : entries) ASSERT_EQ(frozen.at(entry.first), entry.second);
+    for (std::size_t i = entries.size(); i < entries.size() + 10000; ++i) ASSERT_EQ(frozen.count(key_of(i)), 0);
+}
+
+TEST(Partitions, Batch) {
+    const auto entries = big_table(300000);
+    const auto frozen = cx::freeze(entries);
+    std::vector<std::uint64_t> keys;
+    for (std::size_t i = 0; i < 1000; ++i) keys.push_back(key_of(i * 599));
+    std::vector<decltype(frozen)::const_iterator> found(keys.size());
+    const std::size_t hits = frozen.find_batch(keys.data(), keys.size(), found.data());
+    std::size_t expected = 0;
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+        ASSERT_EQ(found[i], frozen.find(keys[i]));
+        expected += frozen.count(keys[i]);
+    }
+    EXPECT_EQ(hits, expected);
+    EXPECT_GT(hits, 0u);
+    EXPECT_LT(hits, keys.size());
+
+    std::unique_ptr<bool[]> flags(new bool[keys.size()]);
+    EXPECT_EQ(frozen.count_batch(keys.data(), keys.size(), flags.get()), hits);
+    std::vector<std::uint32_t> values(keys.size());
+    frozen.at_batch(keys.data(), 300, values.data());
+    EXPECT_EQ(values[299], 299u * 599);
+    EXPECT_THROW(frozen.at_batch(keys.data(), keys.size(), values.data()), std::out_of_range);
+
+    const cx::frozen_map<int, int> empty;
+    bool flag = true;
+    const int key = 1;
+    EXPECT_EQ(empty.count_batch(&key, 1, &flag), 0u);
+    EXPECT_FALSE(flag);
+}
+
+TEST(Partitions, ThreadCountDoesNotChangeLayout) {
+    const auto entries = big_table(200000);
+    const auto serial = cx::freeze(entries, 1);
+    const auto parallel = cx::freeze(entries, 8);
+    ASSERT_EQ(serial.size(), parallel.size());
+    for (std::size_t slot = 0; slot < serial.size(); ++slot) {
+        ASSERT_EQ(serial.begin()[slot].first, parallel.begin()[slot].first);
+    }
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,72 @@
+// Copyright (c) 2020. Mohit Deshpande.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+// the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <type_traits>
+
+#include "tables/generation_leptons.h"
+#include "tables/http_status.h"
+#include "tables/lepton_mass.h"
+#include "tables/lepton_mass_list.h"
+#include "tables/lepton_symbol.h"
+
+// the headers are generated from tests/data by cx_generate_table() (see CMakeLists.txt)
+
+TEST(Layout, EnumKeys) {
+    static_assert(std::is_same<std::remove_const_t<decltype(physics::kLeptonMass)>,
+                               cx::enum_map<Lepton, double, 6>>::value, "");
+    static_assert(physics::kLeptonMass.is_dense, "");
+    static_assert(physics::kLeptonMass.at(Lepton::kMuon) == 105.6583755, "");
+    static_assert(physics::kLeptonMass.at(Lepton::kTauNeutrino) == 0.0, "");
+}
+
+TEST(Layout, IntegerKeys) {
+    static_assert(std::is_same<std::remove_const_t<decltype(kHttpStatus)>,
+                               cx::perfect_map<int, const char*, 6>>::value, "");
+    static_assert(kHttpStatus.count(404) == 1, "");
+    static_assert(kHttpStatus.count(402) == 0, "");
+    EXPECT_STREQ(kHttpStatus.at(418), "I'm a teapot");
+    EXPECT_STREQ(kHttpStatus.at(503), "Service Unavailable");
+}
+
+TEST(Layout, StringKeys) {
+    static_assert(std::is_same<std::remove_const_t<decltype(kLeptonSymbol)>,
+                               cx::string_map<const char*, 6, 17>>::value, "");
+    static_assert(kLeptonSymbol.count("electron neutrino") == 1, "");
+    static_assert(kLeptonSymbol.count("photon") == 0, "");
+    EXPECT_STREQ(kLeptonSymbol.at("electron"), "e-");
+    // non-ASCII values survive the round trip through the octal escapes
+    EXPECT_STREQ(kLeptonSymbol.at("tau"), "τ-");
+}
+
+TEST(Layout, DuplicateKeys) {
+    static_assert(std::is_same<std::remove_const_t<decltype(kGenerationLeptons)>,
+                               cx::sorted_map<unsigned, Lepton, 6>>::value, "");
+    static_assert(kGenerationLeptons.count(2) == 2, "");
+    static_assert(kGenerationLeptons.count(4) == 0, "");
+}
+
+TEST(Layout, Override) {
+    static_assert(std::is_same<std::remove_const_t<decltype(physics::linear::kLeptonMass)>,
+                               cx::map<Lepton, double, 6>>::value, "");
+    static_assert(physics::linear::kLeptonMass.at(Lepton::kElectron) == 0.51099895, "");
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
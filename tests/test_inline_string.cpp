@@ -0,0 +1,189 @@
+// Copyright (c) 2020. Mohit Deshpande.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+// the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include <gtest/gtest.h>
+#include <string>
+#include <type_traits>
+
+#include "cx/cx_inline_string.h"
+
+namespace {
+
+// a minimal stand-in for std::string_view so the test also builds as C++14
+struct view {
+    const char* ptr;
+    std::size_t len;
+    constexpr const char* data() const { return ptr; }
+    constexpr std::size_t size() const { return len; }
+};
+
+constexpr cx::inline_string<32> make_request_line() {
+    cx::inline_string<32> line{"GET "};
+    line += view{"/index.html?x", 11};
+    line += ' ';
+    line += cx::lit("HTTP/1.1");
+    return line;
+}
+
+// overwrites the kept prefix's last character and appends up to two more; an empty prefix stays empty
+struct shout {
+    constexpr std::size_t operator()(char* data, std::size_t capacity) const {
+        std::size_t size = 0;
+        while (size < capacity && data[size] != '\0') ++size;
+        if (size == 0) return 0;
+        data[size - 1] = '!';
+        for (std::size_t end = size + 2; size < end && size < capacity; ++size) data[size] = '!';
+        return size;
+    }
+};
+
+constexpr cx::inline_string<8> make_shout() {
+    cx::inline_string<8> s{"hey"};
+    s.resize_and_overwrite(8, shout{});
+    return s;
+}
+
+}
+
+TEST(Constructors, Empty) {
+    constexpr cx::inline_string<8> s;
+    static_assert(s.empty() && s.size() == 0 && s.capacity() == 8, "");
+    static_assert(s.c_str()[0] == '\0', "");
+    static_assert(s == "", "");
+}
+
+TEST(Constructors, FromStrings) {
+    constexpr cx::inline_string<8> a{"abc"};
+    constexpr cx::inline_string<8> b{cx::lit("abc")};
+    constexpr cx::inline_string<8> c{view{"abcdef", 3}};
+    constexpr cx::inline_string<4> d{a};
+    constexpr cx::inline_string<5> e(3, 'x');
+    static_assert(a == b && b == c && c == d, "");
+    static_assert(e == "xxx", "");
+    static_assert(cx::inline_string<8>{"a\0b"}.size() == 3, "");
+
+    const cx::inline_string<16> long_one{"0123456789"};
+    EXPECT_THROW((cx::inline_string<4>{long_one}), std::length_error);
+    EXPECT_THROW((cx::inline_string<4>{std::string(5, 'x')}), std::length_error);
+}
+
+TEST(Modifiers, AppendAndResize) {
+    static constexpr auto kLine = make_request_line();
+    static_assert(kLine == "GET /index.html HTTP/1.1", "");
+    static_assert(kLine.size() == 24, "");
+    EXPECT_STREQ(kLine.c_str(), "GET /index.html HTTP/1.1");
+
+    cx::inline_string<8> s{"ab"};
+    s.append(3, 'c').append("de");
+    EXPECT_EQ(s.str(), "abcccde");
+    s.push_back('!');
+    EXPECT_EQ(s.size(), s.capacity());
+    EXPECT_THROW(s.push_back('?'), std::length_error);
+    EXPECT_THROW(s += "x", std::length_error);
+    EXPECT_EQ(s.str(), "abcccde!");
+
+    s.resize(3);
+    EXPECT_STREQ(s.c_str(), "abc");
+    s.resize(5, '-');
+    EXPECT_EQ(s.str(), "abc--");
+    s.pop_back();
+    s.clear();
+    EXPECT_TRUE(s.empty());
+    EXPECT_THROW(s.resize(9), std::length_error);
+
+    s = std::string("xyz");
+    EXPECT_EQ(s, "xyz");
+    s = cx::lit("12345678");
+    EXPECT_EQ(s, cx::lit("12345678"));
+
+    static_assert(make_shout() == "he!!!", "");
+    s = "ab";
+    EXPECT_THROW(s.resize_and_overwrite(9, shout{}), std::length_error);
+    s.resize_and_overwrite(2, shout{});
+    EXPECT_EQ(s, "a!");
+}
+
+// assigns a view of the string's own characters
+constexpr cx::inline_string<8> make_tail() {
+    cx::inline_string<8> s{"abcdefg"};
+    s = cx::string_ref(s.data() + 2, 3);
+    return s;
+}
+
+TEST(Modifiers, AssignFromSelf) {
+    static_assert(make_tail() == "cde", "");
+
+    cx::inline_string<8> s{"abcdefg"};
+    s = cx::string_ref(s.data() + 2, 3);
+    EXPECT_EQ(s, "cde");
+    EXPECT_STREQ(s.c_str(), "cde");
+    s = cx::string_ref(s);
+    EXPECT_EQ(s, "cde");
+    s.assign(s.data() + 1, 2);
+    EXPECT_STREQ(s.c_str(), "de");
+    EXPECT_THROW(s.assign(std::string(9, 'x')), std::length_error);
+    EXPECT_EQ(s, "de");
+}
+
+TEST(Operations, Substr) {
+    constexpr cx::inline_string<16> s{"key=value"};
+    static_assert(s.substr(0, s.find('=')) == "key", "");
+    static_assert(s.substr(s.find('=') + 1) == "value", "");
+    static_assert(s.substr(9).empty(), "");
+    static_assert(s.find('#') == s.npos, "");
+
+    constexpr auto compact = s.compact<s.size()>();
+    static_assert(std::is_same<decltype(compact), const cx::string<9>>::value, "");
+    static_assert(compact == cx::lit("key=value"), "");
+    EXPECT_THROW(s.compact<8>(), std::length_error);
+    EXPECT_THROW(s.substr(10), std::out_of_range);
+    EXPECT_THROW(s.at(9), std::out_of_range);
+}
+
+TEST(Comparison, Interop) {
+    constexpr cx::inline_string<8> s{"abc"};
+    constexpr cx::inline_string<4> t{"abd"};
+    static_assert(s == cx::lit("abc") && cx::lit("abc") == s, "");
+    static_assert("abc" == s && s != "ab" && "abcd" != s, "");
+    static_assert(s == view{"abc", 3} && view{"ab", 2} != s, "");
+    static_assert(s != t && s < t && !(t < s), "");
+    static_assert(s.compare(cx::string_ref("abd")) < 0 && s.compare(cx::string_ref("ab")) > 0, "");
+
+    EXPECT_TRUE(s == std::string("abc"));
+    EXPECT_TRUE(std::string("abd") == t);
+    EXPECT_TRUE(cx::string_ref(s) == cx::string_ref("abc"));
+    EXPECT_EQ(cx::hash<cx::inline_string<8>>{}(s), cx::wyhash("abc", 3));
+}
+
+TEST(Concatenation, Capacities) {
+    constexpr cx::inline_string<4> a{"ab"};
+    constexpr cx::inline_string<6> b{"cd"};
+    constexpr auto ab = a + b;
+    static_assert(ab.capacity() == 10 && ab == "abcd", "");
+    static_assert((a + cx::lit("xyz")).capacity() == 7, "");
+    static_assert((cx::lit("xyz") + a) == "xyzab", "");
+    static_assert(("<" + a + ">") == "<ab>", "");
+    static_assert(('(' + a + ')').capacity() == 6, "");
+    static_assert((a + view{"cd", 2}).capacity() == 4, "");
+    static_assert((a + view{"cd", 2}) == "abcd", "");
+
+    EXPECT_THROW(a + std::string("xyz"), std::length_error);
+    EXPECT_EQ((std::string("x") + b).str(), "xcd");
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -15,8 +15,10 @@
 
 #include <gtest/gtest.h>
 #include <cmath>
+#include <stdexcept>
 
 #include "cx/cx_map.h"
+#include "cx/cx_string.h"
 
 static constexpr double kEpsilon = 1e-6;
 
@@ -46,6 +48,40 @@ TEST(Constructors, InitializerList) {
     static_assert(lepton_name.size() == 6, "");
 }
 
+TEST(Constructors, StringValues) {
+    constexpr cx::map<Lepton, cx::string<3>, 2> symbol = {
+            {Lepton::kMuon, cx::lit("mu-")},
+            {Lepton::kTau, cx::lit("ta-")},
+    };
+    static_assert(symbol.at(Lepton::kTau) == "ta-", "");
+}
+
+// const members make the values non-assignable, so these are copied through the pack expansion instead of the loop
+struct Charge {
+    const int value;
+};
+
+TEST(Constructors, NonAssignableValues) {
+    constexpr cx::map<Lepton, Charge, 3> charge = {
+            {Lepton::kElectron, Charge{-1}},
+            {Lepton::kElectronNeutrino, Charge{0}},
+            {Lepton::kMuon, Charge{-1}},
+    };
+    static_assert(charge.at(Lepton::kElectronNeutrino).value == 0, "");
+    static_assert(charge.at(Lepton::kMuon).value == -1, "");
+}
+
+static constexpr cx::array<cx::pair<int, int>, 4> squares() {
+    cx::array<cx::pair<int, int>, 4> entries{};
+    for (int i = 0; i < 4; ++i) entries[i] = {i, i * i};
+    return entries;
+}
+
+TEST(Constructors, FromArray) {
+    constexpr cx::map<int, int, 4> square{squares()};
+    static_assert(square.size() == 4 && square.at(3) == 9, "");
+}
+
 TEST(ElementAccess, ValidLookup) {
     constexpr cx::map<Lepton, double, 6> lepton_masses = {
             {Lepton::kElectron, 0.511},
@@ -92,6 +128,39 @@ TEST(Lookup, TwoElements) {
     static_assert(c == 2, "");
 }
 
+TEST(Lookup, Find) {
+    static constexpr cx::map<int, double, 3> m = {
+            {3, 3.14},
+            {1, 1.41},
+            {3, 2.72}
+    };
+    static_assert(m.find(3) == m.begin(), "");
+    static_assert(m.find(1)->second == 1.41, "");
+    static_assert(m.find(2) == m.end(), "");
+}
+
+TEST(Lookup, Batch) {
+    static constexpr cx::map<int, double, 3> m = {
+            {3, 3.14},
+            {1, 1.41},
+            {3, 2.72}
+    };
+    const int keys[] = {1, 2, 3, 3, 4};
+    cx::map<int, double, 3>::const_iterator found[5]{};
+    EXPECT_EQ(m.find_batch(keys, 5, found), 3u);
+    for (std::size_t i = 0; i < 5; ++i) EXPECT_EQ(found[i], m.find(keys[i]));
+
+    bool flags[5]{};
+    EXPECT_EQ(m.count_batch(keys, 5, flags), 3u);
+    EXPECT_FALSE(flags[1]);
+    EXPECT_TRUE(flags[3]);
+
+    double values[2]{};
+    m.at_batch(keys + 2, 2, values);
+    EXPECT_EQ(values[0], 3.14);
+    EXPECT_THROW(m.at_batch(keys, 2, values), std::out_of_range);
+}
+
 int main(int argc, char** argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
@@ -0,0 +1,258 @@
+// Copyright (c) 2020. Mohit Deshpande.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+// the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "cx/cx_mapped_map.h"
+
+enum class Lepton : std::uint8_t {
+    kElectron,
+    kMuon,
+    kTau,
+};
+
+// the bytes of a table, copied somewhere 8-byte aligned like a mapping would be
+class aligned_bytes {
+public:
+    explicit aligned_bytes(const std::string& bytes) : words_((bytes.size() + 7) / 8), size_{bytes.size()} {
+        std::memcpy(words_.data(), bytes.data(), bytes.size());
+    }
+    const void* data() const { return words_.data(); }
+    std::size_t size() const { return size_; }
+    char* bytes() { return reinterpret_cast<char*>(words_.data()); }
+
+private:
+    std::vector<std::uint64_t> words_;
+    std::size_t size_;
+};
+
+static std::string temp_path(const char* name) {
+    return std::string(::testing::TempDir()) + name;
+}
+
+TEST(Constructors, EmptyMap) {
+    const aligned_bytes bytes(cx::to_mapped_bytes(cx::frozen_map<int, int>()));
+    const cx::mapped_map<int, int> empty(bytes.data(), bytes.size());
+    EXPECT_TRUE(empty.empty());
+    EXPECT_EQ(empty.count(3), 0);
+    EXPECT_EQ(empty.begin(), empty.end());
+}
+
+TEST(Constructors, FromFile) {
+    std::vector<std::pair<std::uint64_t, std::uint32_t>> entries;
+    for (std::uint32_t i = 0; i < 100000; ++i) entries.emplace_back(i * 0x9e3779b97f4a7c15ULL, i);
+    const auto frozen = cx::freeze(entries);
+    ASSERT_GT(frozen.partitions(), 1);
+
+    const std::string path = temp_path("cx_mapped_map_from_file.bin");
+    cx::write_mapped_map(frozen, path);
+    {
+        const cx::mapped_map<std::uint64_t, std::uint32_t> mapped(path);
+        ASSERT_EQ(mapped.size(), entries.size());
+        for (const auto& entry : entries) {
+            ASSERT_EQ(mapped.at(entry.first), entry.second);
+        }
+        EXPECT_EQ(mapped.count(std::uint64_t{100000} * 0x9e3779b97f4a7c15ULL), 0);
+    }
+    std::remove(path.c_str());
+}
+
+TEST(Constructors, MissingFile) {
+    using map_type = cx::mapped_map<int, int>;
+    EXPECT_THROW(map_type(temp_path("cx_mapped_map_does_not_exist.bin")), std::system_error);
+}
+
+TEST(Constructors, Move) {
+    const aligned_bytes bytes(cx::to_mapped_bytes(cx::frozen_map<int, int>{{1, 10}, {2, 20}}));
+    cx::mapped_map<int, int> mapped(bytes.data(), bytes.size());
+    const cx::mapped_map<int, int> moved(std::move(mapped));
+    EXPECT_EQ(moved.at(2), 20);
+}
+
+TEST(Validation, RejectsBadHeaders) {
+    using map_type = cx::mapped_map<int, int>;
+    const std::string good = cx::to_mapped_bytes(cx::frozen_map<int, int>{{1, 10}, {2, 20}});
+
+    aligned_bytes too_small(good.substr(0, 16));
+    EXPECT_THROW(map_type(too_small.data(), too_small.size()), std::runtime_error);
+
+    aligned_bytes bad_magic(good);
+    bad_magic.bytes()[0] = 'X';
+    EXPECT_THROW(map_type(bad_magic.data(), bad_magic.size()), std::runtime_error);
+
+    aligned_bytes bad_version(good);
+    bad_version.bytes()[8] = 99;
+    EXPECT_THROW(map_type(bad_version.data(), bad_version.size()), std::runtime_error);
+
+    aligned_bytes truncated(good.substr(0, good.size() - 8));
+    EXPECT_THROW(map_type(truncated.data(), truncated.size()), std::runtime_error);
+}
+
+// overwrites the little-endian uint64 header field at offset (size is at 40, file_size at 104)
+static aligned_bytes with_field(const std::string& bytes, std::size_t offset, std::uint64_t value) {
+    aligned_bytes patched(bytes);
+    for (std::size_t i = 0; i < 8; ++i) patched.bytes()[offset + i] = static_cast<char>(value >> (8 * i));
+    return patched;
+}
+
+TEST(Validation, RejectsCorruptSections) {
+    using map_type = cx::mapped_map<int, int>;
+    const std::string good = cx::to_mapped_bytes(cx::frozen_map<int, int>{{1, 10}, {2, 20}, {3, 30}});
+    constexpr std::size_t kSize = 40, kPartitions = 48, kPartitionsOffset = 56, kPilotsOffset = 64, kKeysOffset = 72,
+                          kBlobSize = 96;
+
+    const auto check = [](const aligned_bytes& bytes) {
+        EXPECT_THROW(map_type(bytes.data(), bytes.size()), std::runtime_error);
+    };
+    // counts whose byte sizes wrap around 2^64 back into the file
+    check(with_field(good, kSize, std::uint64_t{1} << 62));
+    check(with_field(good, kSize, (std::uint64_t{1} << 61) + 3));
+    check(with_field(good, kPartitions, ~std::uint64_t{0}));
+    check(with_field(good, kPartitions, std::uint64_t{1} << 61));
+    check(with_field(good, kBlobSize, ~std::uint64_t{0}));
+    // no partitions for a non-empty table
+    check(with_field(good, kPartitions, 0));
+    // sections overlapping the header, each other or the end of the file
+    check(with_field(good, kPartitionsOffset, 0));
+    check(with_field(good, kPilotsOffset, 8));
+    check(with_field(good, kKeysOffset, ~std::uint64_t{0} - 7));
+
+    // a partition start past the end of the pilots is a miss, not an out-of-bounds read
+    aligned_bytes bad_start(good);
+    std::uint64_t partitions_offset = 0;
+    std::memcpy(&partitions_offset, good.data() + kPartitionsOffset, sizeof(partitions_offset));
+    std::memset(bad_start.bytes() + partitions_offset, 0xff, 8);
+    const map_type mapped(bad_start.data(), bad_start.size());
+    EXPECT_EQ(mapped.count(1) + mapped.count(2) + mapped.count(3), 0);
+}
+
+// reads the little-endian uint64 header field at offset
+static std::uint64_t field_of(const std::string& bytes, std::size_t offset) {
+    std::uint64_t value = 0;
+    for (std::size_t i = 0; i < 8; ++i) value |= std::uint64_t{static_cast<unsigned char>(bytes[offset + i])} << (8 * i);
+    return value;
+}
+
+TEST(Validation, CorruptEntriesMiss) {
+    constexpr std::size_t kPilotsOffset = 64, kKeysOffset = 72, kValuesOffset = 80;
+
+    // direct-slot pilots pointing far past their partitions
+    const std::string ints = cx::to_mapped_bytes(cx::frozen_map<int, int>{{1, 10}, {2, 20}, {3, 30}});
+    aligned_bytes bad_pilots(ints);
+    std::memset(bad_pilots.bytes() + field_of(ints, kPilotsOffset), 0xff, 3 * 4);
+    const cx::mapped_map<int, int> pilots(bad_pilots.data(), bad_pilots.size());
+    EXPECT_EQ(pilots.count(1) + pilots.count(2) + pilots.count(3), 0);
+
+    // string offsets past the end of the blob
+    const std::string strings = cx::to_mapped_bytes(
+            cx::frozen_map<std::string, std::string>{{"alpha", "a"}, {"beta", "b"}});
+    aligned_bytes bad_refs(strings);
+    std::memset(bad_refs.bytes() + field_of(strings, kKeysOffset), 0xff, 2 * 8);
+    std::memset(bad_refs.bytes() + field_of(strings, kValuesOffset), 0xff, 2 * 8);
+    const cx::mapped_map<std::string, std::string> refs(bad_refs.data(), bad_refs.size());
+    EXPECT_EQ(refs.count("alpha") + refs.count("beta"), 0);
+    for (const auto& entry : refs) {
+        EXPECT_TRUE(entry.first.empty());
+        EXPECT_TRUE(entry.second.empty());
+    }
+}
+
+TEST(Validation, RejectsWrongTypes) {
+    const aligned_bytes bytes(cx::to_mapped_bytes(cx::frozen_map<int, int>{{1, 10}}));
+    using unsigned_keys = cx::mapped_map<unsigned, int>;
+    using wide_values = cx::mapped_map<int, std::int64_t>;
+    using string_values = cx::mapped_map<int, std::string>;
+    EXPECT_THROW(unsigned_keys(bytes.data(), bytes.size()), std::runtime_error);
+    EXPECT_THROW(wide_values(bytes.data(), bytes.size()), std::runtime_error);
+    EXPECT_THROW(string_values(bytes.data(), bytes.size()), std::runtime_error);
+}
+
+TEST(ElementAccess, At) {
+    const cx::frozen_map<Lepton, double> lepton_mass = {
+            {Lepton::kElectron, 0.511},
+            {Lepton::kMuon, 105.66},
+            {Lepton::kTau, 1776.86},
+    };
+    const aligned_bytes bytes(cx::to_mapped_bytes(lepton_mass));
+    const cx::mapped_map<Lepton, double> mapped(bytes.data(), bytes.size());
+
+    EXPECT_DOUBLE_EQ(mapped.at(Lepton::kElectron), 0.511);
+    EXPECT_DOUBLE_EQ(mapped[Lepton::kMuon], 105.66);
+    EXPECT_DOUBLE_EQ(mapped.at(Lepton::kTau), 1776.86);
+}
+
+TEST(ElementAccess, AtMissingKey) {
+    const aligned_bytes bytes(cx::to_mapped_bytes(cx::frozen_map<int, int>{{1, 10}}));
+    const cx::mapped_map<int, int> mapped(bytes.data(), bytes.size());
+    EXPECT_THROW(mapped.at(2), std::out_of_range);
+}
+
+TEST(Lookup, StringKeysAndValues) {
+    const cx::frozen_map<std::string, std::string> symbols = {
+            {"electron", "e-"},
+            {"muon", "mu-"},
+            {"tau", "tau-"},
+            {"", "nothing"},
+    };
+    const aligned_bytes bytes(cx::to_mapped_bytes(symbols));
+    const cx::mapped_map<std::string, std::string> mapped(bytes.data(), bytes.size());
+
+    EXPECT_EQ(mapped.at("electron").str(), "e-");
+    EXPECT_EQ(mapped.at(std::string("muon")).str(), "mu-");
+    EXPECT_EQ(mapped.at(cx::string_ref("tau", 3)).str(), "tau-");
+    EXPECT_EQ(mapped.at("").str(), "nothing");
+    EXPECT_EQ(mapped.count("neutrino"), 0);
+    EXPECT_EQ(mapped.count("ele"), 0);
+
+    const auto it = mapped.find("muon");
+    ASSERT_NE(it, mapped.end());
+    EXPECT_EQ(it->first, cx::string_ref("muon", 4));
+    EXPECT_EQ(it->second.str(), "mu-");
+}
+
+TEST(Iterators, MatchesFrozenMap) {
+    const cx::frozen_map<int, std::string> frozen = {{1, "one"}, {2, "two"}, {3, "three"}, {4, "four"}};
+    const aligned_bytes bytes(cx::to_mapped_bytes(frozen));
+    const cx::mapped_map<int, std::string> mapped(bytes.data(), bytes.size());
+
+    ASSERT_EQ(mapped.end() - mapped.begin(), 4);
+    auto it = mapped.begin();
+    for (const auto& entry : frozen) {
+        EXPECT_EQ(it->first, entry.first);
+        EXPECT_EQ(it->second.str(), entry.second);
+        ++it;
+    }
+}
+
+TEST(Format, LittleEndianHeader) {
+    const std::string bytes = cx::to_mapped_bytes(cx::frozen_map<int, int>{{1, 10}});
+    ASSERT_EQ(bytes.size() % 8, 0);
+    EXPECT_EQ(bytes.substr(0, 7), "CXTABLE");
+    // version 1 and the byte order mark, least significant byte first
+    EXPECT_EQ(bytes.substr(8, 8), std::string("\x01\x00\x00\x00\x04\x03\x02\x01", 8));
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,116 @@
+// Copyright (c) 2020. Mohit Deshpande.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+// the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <map>
+#include <thread>
+#include <vector>
+
+#include "cx/cx_map.h"
+#include "cx/cx_overlay_map.h"
+#include "cx/cx_perfect_map.h"
+
+enum class Setting {
+    kTimeoutMs,
+    kRetries,
+    kBatchSize,
+    kVerbose,
+};
+
+static constexpr cx::map<Setting, int, 3> kDefaults = {
+        {Setting::kTimeoutMs, 1000},
+        {Setting::kRetries, 3},
+        {Setting::kBatchSize, 64},
+};
+
+TEST(ElementAccess, BaseOnly) {
+    const cx::overlay_map<cx::map<Setting, int, 3>> settings{kDefaults};
+    EXPECT_EQ(settings.at(Setting::kRetries), 3);
+    EXPECT_EQ(settings[Setting::kBatchSize], 64);
+    EXPECT_EQ(settings.count(Setting::kVerbose), 0);
+    EXPECT_EQ(settings.get_or(Setting::kVerbose, 0), 0);
+    EXPECT_THROW(settings.at(Setting::kVerbose), std::out_of_range);
+    EXPECT_EQ(settings.overrides(), 0);
+}
+
+TEST(Modifiers, SetAndReset) {
+    cx::overlay_map<cx::map<Setting, int, 3>> settings{kDefaults};
+    settings.set(Setting::kTimeoutMs, 250);
+    settings.set(Setting::kVerbose, 1);
+    EXPECT_EQ(settings.at(Setting::kTimeoutMs), 250);
+    EXPECT_EQ(settings.at(Setting::kVerbose), 1);
+    EXPECT_TRUE(settings.overridden(Setting::kTimeoutMs));
+    EXPECT_FALSE(settings.overridden(Setting::kRetries));
+    EXPECT_EQ(settings.base().at(Setting::kTimeoutMs), 1000);
+
+    settings.reset(Setting::kTimeoutMs);
+    EXPECT_EQ(settings.at(Setting::kTimeoutMs), 1000);
+    settings.reset(Setting::kRetries);
+    EXPECT_EQ(settings.overrides(), 1);
+
+    settings.clear();
+    EXPECT_EQ(settings.count(Setting::kVerbose), 0);
+}
+
+TEST(Modifiers, Assign) {
+    cx::overlay_map<cx::map<Setting, int, 3>> settings{kDefaults};
+    settings.set(Setting::kVerbose, 1);
+    settings.assign(std::map<Setting, int>{{Setting::kRetries, 5}, {Setting::kBatchSize, 128}});
+    EXPECT_EQ(settings.overrides(), 2);
+    EXPECT_EQ(settings.at(Setting::kRetries), 5);
+    EXPECT_EQ(settings.at(Setting::kBatchSize), 128);
+    EXPECT_EQ(settings.count(Setting::kVerbose), 0);
+}
+
+TEST(Modifiers, PerfectMapBase) {
+    static constexpr cx::perfect_map<int, int, 3> kBase = {{1, 10}, {2, 20}, {3, 30}};
+    cx::overlay_map<cx::perfect_map<int, int, 3>> table{kBase};
+    table.set(2, 200);
+    EXPECT_EQ(table.at(1), 10);
+    EXPECT_EQ(table.at(2), 200);
+}
+
+TEST(Concurrency, ReadersSeeWholeSnapshots) {
+    // every published timeout is a multiple of 7 and every published retry count is above the default, so a reader
+    // that caught a half-built or already freed snapshot would see something else
+    cx::overlay_map<cx::map<Setting, int, 3>> settings{kDefaults};
+    std::atomic<bool> done{false};
+    std::atomic<int> bad{0};
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 4; ++r) {
+        readers.emplace_back([&] {
+            while (!done.load()) {
+                const int timeout = settings.at(Setting::kTimeoutMs);
+                if (timeout != 1000 && timeout % 7 != 0) ++bad;
+                const int retries = settings.get_or(Setting::kRetries, -1);
+                if (retries < 3) ++bad;
+            }
+        });
+    }
+    for (int i = 1; i <= 2000; ++i) {
+        settings.assign(std::map<Setting, int>{{Setting::kTimeoutMs, 7 * i}, {Setting::kRetries, 3 + i}});
+        if (i % 3 == 0) settings.clear();
+    }
+    done = true;
+    for (auto& reader : readers) reader.join();
+    EXPECT_EQ(bad.load(), 0);
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
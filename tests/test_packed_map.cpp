@@ -0,0 +1,119 @@
+// Copyright (c) 2020. Mohit Deshpande.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+// the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include <gtest/gtest.h>
+
+#include "cx/cx_packed_map.h"
+
+enum class Lepton {
+    kElectron,
+    kMuon,
+    kTau,
+    kElectronNeutrino,
+    kMuonNeutrino,
+    kTauNeutrino,
+};
+
+static constexpr cx::map<Lepton, int, 6> kCharges = {
+        {Lepton::kElectron, -1},
+        {Lepton::kMuon, -1},
+        {Lepton::kTau, -1},
+        {Lepton::kElectronNeutrino, 0},
+        {Lepton::kMuonNeutrino, 0},
+        {Lepton::kTauNeutrino, 0},
+};
+
+TEST(Constructors, InitializerList) {
+    constexpr cx::packed_map<int, int, 3, 4, 2> codes = {{1000, 7}, {1009, 5}, {1003, 6}};
+    static_assert(codes.size() == 3, "");
+    static_assert(codes.begin()->first == 1000, "");
+    static_assert((codes.end() - 1)->second == 6, "");
+    static_assert(codes.storage_bytes() == 16, "");
+}
+
+TEST(Constructors, FromMap) {
+    static_assert(cx::packed_key_bits(kCharges) == 3, "");
+    static_assert(cx::packed_value_bits(kCharges) == 1, "");
+
+    static constexpr auto charges = cx::pack<cx::packed_key_bits(kCharges), cx::packed_value_bits(kCharges)>(kCharges);
+    static_assert(charges.size() == kCharges.size(), "");
+    static_assert(charges.storage_bytes() < sizeof(kCharges), "");
+    for (std::size_t i = 0; i < kCharges.size(); ++i) {
+        EXPECT_EQ(charges.key_at(i), kCharges.begin()[i].first);
+        EXPECT_EQ(charges.value_at(i), kCharges.begin()[i].second);
+    }
+}
+
+TEST(Constructors, InvalidEntries) {
+    auto make_wrong_size = [] {
+        return cx::packed_map<int, int, 2, 8, 8>{{1, 1}};
+    };
+    EXPECT_THROW(make_wrong_size(), std::invalid_argument);
+
+    auto make_narrow = [] {
+        return cx::packed_map<int, int, 2, 8, 2>{{1, 0}, {2, 4}};
+    };
+    EXPECT_THROW(make_narrow(), std::invalid_argument);
+}
+
+TEST(ElementAccess, ValidLookup) {
+    static constexpr auto charges = cx::pack<3, 1>(kCharges);
+    static_assert(charges.at(Lepton::kMuon) == -1, "");
+    static_assert(charges[Lepton::kTauNeutrino] == 0, "");
+    static_assert(charges.find(Lepton::kTau)->first == Lepton::kTau, "");
+    static_assert(charges.count(Lepton::kElectron) == 1, "");
+}
+
+TEST(ElementAccess, InvalidLookup) {
+    constexpr cx::packed_map<int, unsigned, 2, 1, 1> bits = {{-5, 0u}, {-4, 1u}};
+    static_assert(bits.count(-6) == 0, "");
+    static_assert(bits.count(-3) == 0, "");
+    static_assert(bits.find(100) == bits.end(), "");
+    EXPECT_THROW(bits.at(0), std::out_of_range);
+}
+
+TEST(Packing, WideFieldsStraddleWords) {
+    // 60-bit keys don't line up with 64-bit words, so most fields are split across two of them
+    constexpr cx::packed_map<std::int64_t, std::uint64_t, 4, 60, 64> wide = {
+            {0, ~std::uint64_t{0}},
+            {(std::int64_t{1} << 59) + 3, 1u},
+            {(std::int64_t{1} << 60) - 1, std::uint64_t{1} << 63},
+            {12345, 0u},
+    };
+    static_assert(wide.at((std::int64_t{1} << 60) - 1) == std::uint64_t{1} << 63, "");
+    static_assert(wide.at((std::int64_t{1} << 59) + 3) == 1, "");
+    static_assert(wide.at(0) == ~std::uint64_t{0}, "");
+    static_assert(wide.key_at(3) == 12345, "");
+}
+
+TEST(Packing, ConstantValues) {
+    // every value is the same, so values take no storage at all
+    constexpr cx::packed_map<char, bool, 3, 2, 0> flags = {{'a', true}, {'b', true}, {'c', true}};
+    static_assert(flags.at('b'), "");
+    static_assert(flags.count('d') == 0, "");
+}
+
+TEST(Iterators, RangeFor) {
+    static constexpr auto charges = cx::pack<3, 1>(kCharges);
+    int total = 0;
+    for (const auto& entry : charges) total += entry.second;
+    EXPECT_EQ(total, -3);
+    EXPECT_EQ(charges.rbegin()->first, Lepton::kTauNeutrino);
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,161 @@
+// Copyright (c) 2020. Mohit Deshpande.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+// the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include "cx/cx_perfect_map.h"
+#include "cx/cx_string.h"
+
+static constexpr double kEpsilon = 1e-6;
+
+enum class Lepton {
+    kElectron,
+    kMuon,
+    kTau,
+    kElectronNeutrino,
+    kMuonNeutrino,
+    kTauNeutrino,
+};
+
+template<std::size_t... Indices>
+constexpr auto make_squares(std::index_sequence<Indices...>) {
+    return cx::perfect_map<int, int, sizeof...(Indices)>{{static_cast<int>(Indices * 7919), static_cast<int>(Indices * Indices)}...};
+}
+
+TEST(Constructors, EmptyMap) {
+    constexpr cx::perfect_map<Lepton, const char*, 0> lepton_name = {};
+    static_assert(lepton_name.empty(), "");
+    static_assert(lepton_name.count(Lepton::kMuon) == 0, "");
+}
+
+TEST(Constructors, InitializerList) {
+    constexpr cx::perfect_map<Lepton, const char*, 6> lepton_name = {
+            {Lepton::kElectron, "electron"},
+            {Lepton::kMuon, "muon"},
+            {Lepton::kTau, "tau"},
+            {Lepton::kElectronNeutrino, "electron neutrino"},
+            {Lepton::kMuonNeutrino, "muon neutrino"},
+            {Lepton::kTauNeutrino, "tau neutrino"},
+    };
+    static_assert(lepton_name.size() == 6, "");
+}
+
+TEST(Constructors, DuplicateKeys) {
+    auto make = [] {
+        return cx::perfect_map<int, double, 2>{
+                {3, 3.14},
+                {3, 2.72}
+        };
+    };
+    EXPECT_THROW(make(), std::invalid_argument);
+}
+
+TEST(ElementAccess, ValidLookup) {
+    constexpr cx::perfect_map<Lepton, double, 6> lepton_masses = {
+            {Lepton::kElectron, 0.511},
+            {Lepton::kMuon, 105.66},
+            {Lepton::kTau, 1776.},
+            {Lepton::kElectronNeutrino, 1e-6},
+            {Lepton::kMuonNeutrino, 0.17},
+            {Lepton::kTauNeutrino, 18.2},
+    };
+    constexpr auto x = lepton_masses.at(Lepton::kElectronNeutrino);
+    static_assert(std::abs(x - 1e-6) < kEpsilon, "");
+    constexpr auto y = lepton_masses[Lepton::kTau];
+    static_assert(std::abs(y - 1776.) < kEpsilon, "");
+}
+
+TEST(ElementAccess, InvalidLookup) {
+    constexpr cx::perfect_map<Lepton, const char*, 3> lepton_name = {
+            {Lepton::kElectron, "electron"},
+            {Lepton::kMuon, "muon"},
+            {Lepton::kTau, "tau"},
+    };
+    //constexpr auto x = lepton_name.at(Lepton::kTauNeutrino);
+    EXPECT_THROW(lepton_name.at(Lepton::kTauNeutrino), std::out_of_range);
+}
+
+TEST(Lookup, Find) {
+    constexpr cx::perfect_map<int, double, 2> m = {
+            {3, 3.14},
+            {4, 2.72}
+    };
+    static_assert(m.find(3) != m.end(), "");
+    static_assert(m.find(3)->first == 3, "");
+    static_assert(m.find(5) == m.end(), "");
+}
+
+TEST(Lookup, LargeTable) {
+    constexpr auto m = make_squares(std::make_index_sequence<512>());
+    static_assert(m.size() == 512, "");
+    static_assert(m.at(7919 * 511) == 511 * 511, "");
+    static_assert(m.count(7919 * 512) == 0, "");
+    for (int i = 0; i < 512; ++i) {
+        EXPECT_EQ(m.at(i * 7919), i * i);
+        EXPECT_EQ(m.count(i * 7919 + 1), 0u);
+    }
+}
+
+TEST(Lookup, HashedStringKeys) {
+    constexpr cx::perfect_map<cx::hashed_string<4>, int, 3> m = {
+            {cx::hashed_lit("host"), 1},
+            {cx::hashed_lit("date"), 2},
+            {cx::hashed_lit("etag"), 3},
+    };
+    static_assert(m.at(cx::hashed_lit("date")) == 2, "");
+    static_assert(m.count(cx::hashed_lit("data")) == 0, "");
+}
+
+// sums the values of the keys found by find_batch, so the batch can run inside a static_assert
+template<typename Map, std::size_t N>
+constexpr int batch_sum(const Map& m, const int (&keys)[N]) {
+    typename Map::const_iterator found[N]{};
+    m.find_batch(keys, N, found);
+    int sum = 0;
+    for (std::size_t i = 0; i < N; ++i) sum += found[i] == m.end() ? 0 : found[i]->second;
+    return sum;
+}
+
+TEST(Lookup, Batch) {
+    constexpr auto m = make_squares(std::make_index_sequence<512>());
+    constexpr int kQueries[] = {0, 7919, 7920, 7919 * 3, 7919 * 511};
+    static_assert(batch_sum(m, kQueries) == 1 + 9 + 511 * 511, "");
+
+    // more keys than one group, half of them misses
+    std::vector<int> keys;
+    for (int i = 0; i < 100; ++i) keys.push_back(i % 2 ? i * 7919 : i * 7919 + 1);
+    std::vector<decltype(m)::const_iterator> found(keys.size());
+    EXPECT_EQ(m.find_batch(keys.data(), keys.size(), found.data()), 50u);
+    for (std::size_t i = 0; i < keys.size(); ++i) EXPECT_EQ(found[i], m.find(keys[i]));
+
+    std::unique_ptr<bool[]> flags(new bool[keys.size()]);
+    EXPECT_EQ(m.count_batch(keys.data(), keys.size(), flags.get()), 50u);
+    for (std::size_t i = 0; i < keys.size(); ++i) EXPECT_EQ(flags[i], i % 2 == 1);
+
+    const int hits[] = {7919, 7919 * 2, 7919 * 20};
+    int values[3]{};
+    m.at_batch(hits, 3, values);
+    EXPECT_EQ(values[2], 400);
+    EXPECT_THROW(m.at_batch(keys.data(), keys.size(), std::vector<int>(keys.size()).data()), std::out_of_range);
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,168 @@
+// Copyright (c) 2020. Mohit Deshpande.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+// the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#include <gtest/gtest.h>
+#include <random>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "cx/cx_radix_map.h"
+
+static constexpr cx::radix_map<int, 7> kRoutes{
+        {"/", 0},
+        {"/api", 1},
+        {"/api/v1/users", 2},
+        {"/api/v1/user", 3},
+        {"/api/v2", 4},
+        {"/static/", 5},
+        {"/status", 6},
+};
+
+// byte-aligned IPv4 prefixes, with a '\0' byte in 10.0/16
+static constexpr cx::radix_map<const char*, 4> kNetworks{
+        {"\x0a", "10/8"},
+        {"\x0a\x00", "10.0/16"},
+        {"\xc0\xa8", "192.168/16"},
+        {"\xc0\xa8\x01", "192.168.1/24"},
+};
+
+TEST(Constructors, Layout) {
+    static_assert(kRoutes.size() == 7, "");
+    // root "/", then "api", "sta"; under "api": "/v"; under "/v": "1/user", "2"; under "1/user": "s"; "tic/", "tus"
+    static_assert(kRoutes.node_count() == 9, "");
+    static_assert(kRoutes.begin()->second == 0, "");
+    static_assert((kRoutes.begin() + 1)->second == 1, "");
+    static_assert((kRoutes.begin() + 2)->second == 3, "");
+    static_assert((kRoutes.end() - 1)->second == 6, "");
+
+    constexpr cx::radix_map<int, 1> single{{"only", 1}};
+    static_assert(single.node_count() == 1, "");
+    static_assert(single.at("only") == 1, "");
+    static_assert(single.count("onl") == 0, "");
+}
+
+TEST(Constructors, BadEntries) {
+    EXPECT_THROW((cx::radix_map<int, 3>{{"a", 1}, {"b", 2}, {"a", 3}}), std::invalid_argument);
+    EXPECT_THROW((cx::radix_map<int, 3>{{"a", 1}, {"b", 2}}), std::invalid_argument);
+}
+
+// the map views its keys, so cx::string keys have to live in variables of their own
+static constexpr auto kApi = cx::lit("/api");
+static constexpr auto kApiV1 = cx::lit("/api/v1");
+
+TEST(Constructors, StringKeys) {
+    static constexpr cx::radix_map<int, 2> kApis{{kApi, 1}, {kApiV1, 2}};
+    static_assert(kApis.longest_prefix("/api/v1/users")->second == 2, "");
+    static_assert(kApis.at(cx::lit("/api")) == 1, "");
+    static_assert(kApis.begin()->first == "/api", "");
+
+    const cx::radix_map<int, 2> apis{{kApiV1, 2}, {kApi, 1}};
+    EXPECT_EQ(apis.longest_prefix(std::string("/api/v2"))->second, 1);
+    EXPECT_EQ(apis.longest_prefix(std::string("/ap")), apis.end());
+
+    // a temporary cx::string key would dangle
+    static_assert(!std::is_constructible<cx::detail::radix_entry<int>, cx::string<4>, int>::value, "");
+    static_assert(std::is_constructible<cx::detail::radix_entry<int>, const cx::string<4>&, int>::value, "");
+}
+
+TEST(Lookup, Find) {
+    static_assert(kRoutes.at("/api") == 1, "");
+    static_assert(kRoutes.at(cx::lit("/api/v1/users")) == 2, "");
+    static_assert(kRoutes["/api/v1/user"] == 3, "");
+    static_assert(kRoutes.count("/api/v1") == 0, "");
+    static_assert(kRoutes.count("/api/v1/usersx") == 0, "");
+    static_assert(kRoutes.count("") == 0, "");
+    static_assert(kNetworks.at("\x0a\x00") == kNetworks.begin()[1].second, "");
+
+    EXPECT_EQ(kRoutes.at(std::string("/status")), 6);
+    EXPECT_EQ(kRoutes.find(std::string("/stat")), kRoutes.end());
+    EXPECT_THROW(kRoutes.at("/missing"), std::out_of_range);
+    EXPECT_STREQ(kNetworks.at(cx::string_ref("\x0a\x00", 2)), "10.0/16");
+    EXPECT_EQ(kNetworks.count(cx::string_ref("\x0a\x01", 2)), 0u);
+}
+
+TEST(Lookup, LongestPrefix) {
+    static_assert(kRoutes.longest_prefix("/api/v1/users/42")->second == 2, "");
+    static_assert(kRoutes.longest_prefix("/api/v1/use")->second == 1, "");
+    static_assert(kRoutes.longest_prefix("/api/v2")->second == 4, "");
+    static_assert(kRoutes.longest_prefix("/static/app.js")->second == 5, "");
+    static_assert(kRoutes.longest_prefix("/stat")->second == 0, "");
+    static_assert(kRoutes.longest_prefix("api") == kRoutes.end(), "");
+
+    const std::string ip("\xc0\xa8\x01\x07", 4);
+    EXPECT_STREQ(kNetworks.longest_prefix(ip)->second, "192.168.1/24");
+    EXPECT_STREQ(kNetworks.longest_prefix(std::string("\xc0\xa8\x02\x07", 4))->second, "192.168/16");
+    EXPECT_STREQ(kNetworks.longest_prefix(std::string("\x0a\x00\x00\x01", 4))->second, "10.0/16");
+    EXPECT_STREQ(kNetworks.longest_prefix(std::string("\x0a\x01\x00\x01", 4))->second, "10/8");
+    EXPECT_EQ(kNetworks.longest_prefix(std::string("\x08\x08\x08\x08", 4)), kNetworks.end());
+}
+
+TEST(Lookup, PrefixRange) {
+    constexpr auto api = kRoutes.prefix_range("/api/v1");
+    static_assert(api.second - api.first == 2, "");
+    static_assert(api.first->second == 3, "");
+    static_assert((api.first + 1)->second == 2, "");
+
+    // a prefix that ends partway down an edge
+    constexpr auto st = kRoutes.prefix_range("/st");
+    static_assert(st.second - st.first == 2, "");
+    static_assert(kRoutes.prefix_range("").second - kRoutes.prefix_range("").first == 7, "");
+    static_assert(kRoutes.prefix_range("/x").first == kRoutes.end(), "");
+    static_assert(kRoutes.prefix_range("/api/v1/users/").first == kRoutes.end(), "");
+
+    std::vector<int> values;
+    const auto range = kRoutes.prefix_range(std::string("/api"));
+    for (auto it = range.first; it != range.second; ++it) values.push_back(it->second);
+    EXPECT_EQ(values, (std::vector<int>{1, 3, 2, 4}));
+}
+
+TEST(Lookup, MatchesBruteForce) {
+    static constexpr cx::radix_map<int, 12> kWords{
+            {"a", 0}, {"ab", 1}, {"abc", 2}, {"abd", 3}, {"b", 4}, {"ba", 5},
+            {"bab", 6}, {"cab", 7}, {"cabb", 8}, {"cc", 9}, {"d", 10}, {"dddd", 11},
+    };
+    std::mt19937 gen{11};
+    std::uniform_int_distribution<int> letter{'a', 'e'};
+    std::uniform_int_distribution<std::size_t> length{0, 6};
+    for (int round = 0; round < 500; ++round) {
+        std::string query(length(gen), ' ');
+        for (auto& c : query) c = static_cast<char>(letter(gen));
+
+        int exact = -1, longest = -1;
+        std::size_t longest_length = 0, under = 0;
+        for (const auto& entry : kWords) {
+            const std::string key = entry.first.str();
+            if (key == query) exact = entry.second;
+            if (query.compare(0, key.size(), key) == 0 && key.size() >= longest_length) {
+                longest = entry.second;
+                longest_length = key.size();
+            }
+            if (key.compare(0, query.size(), query) == 0) ++under;
+        }
+        const auto it = kWords.find(query);
+        EXPECT_EQ(it == kWords.end() ? -1 : it->second, exact) << query;
+        const auto best = kWords.longest_prefix(query);
+        EXPECT_EQ(best == kWords.end() ? -1 : best->second, longest) << query;
+        const auto range = kWords.prefix_range(query);
+        EXPECT_EQ(static_cast<std::size_t>(range.second - range.first), under) << query;
+    }
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,125 @@
+// Copyright (c) 2020. Mohit Deshpande.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+// the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#include <gtest/gtest.h>
+#include <random>
+#include <regex>
+#include <string>
+
+#include "cx/cx_regex.h"
+
+namespace {
+
+// random strings over alphabet checked against std::regex_match and std::regex_search
+template<typename Regex>
+void expect_same_as_std(const Regex& re, const char* pattern, const std::string& alphabet) {
+    const std::regex reference(pattern);
+    std::mt19937 gen{3};
+    std::uniform_int_distribution<std::size_t> length{0, 12};
+    std::uniform_int_distribution<std::size_t> letter{0, alphabet.size() - 1};
+    for (int round = 0; round < 2000; ++round) {
+        std::string text(length(gen), ' ');
+        for (auto& c : text) c = alphabet[letter(gen)];
+        EXPECT_EQ(re.match(text), std::regex_match(text, reference)) << pattern << " on " << text;
+        EXPECT_EQ(re.search(text), std::regex_search(text, reference)) << pattern << " in " << text;
+    }
+}
+
+}
+
+static constexpr auto kAbcBuilder = cx::make_regex("abc");
+static constexpr auto kAbc = kAbcBuilder.compact<kAbcBuilder.state_count(), kAbcBuilder.class_count()>();
+
+static constexpr auto kVersionBuilder = cx::make_regex(cx::lit("HTTP/\\d\\.\\d"));
+static constexpr auto kVersion = kVersionBuilder.compact<kVersionBuilder.state_count(),
+                                                         kVersionBuilder.class_count()>();
+
+TEST(Constructors, Compact) {
+    // a, b, c and everything else
+    static_assert(kAbc.class_count() == 4, "");
+    // match: start, a, ab, abc, dead; search: start, a, ab and an absorbing accept
+    static_assert(kAbc.state_count() == 9, "");
+    static_assert(std::is_same<decltype(kAbc)::state_type, std::uint16_t>::value, "");
+
+    constexpr auto empty_builder = cx::make_regex("");
+    constexpr auto empty = empty_builder.compact<empty_builder.state_count(), empty_builder.class_count()>();
+    static_assert(empty.match(""), "");
+    static_assert(!empty.match("a"), "");
+    static_assert(empty.search("a"), "");
+}
+
+TEST(Constructors, BadPatterns) {
+    EXPECT_THROW(cx::make_regex("a(b"), std::invalid_argument);
+    EXPECT_THROW(cx::make_regex("a)b"), std::invalid_argument);
+    EXPECT_THROW(cx::make_regex("*a"), std::invalid_argument);
+    EXPECT_THROW(cx::make_regex("a**"), std::invalid_argument);
+    EXPECT_THROW(cx::make_regex("[abc"), std::invalid_argument);
+    EXPECT_THROW(cx::make_regex("[z-a]"), std::invalid_argument);
+    EXPECT_THROW(cx::make_regex("a{3,1}"), std::invalid_argument);
+    EXPECT_THROW(cx::make_regex("a{2"), std::invalid_argument);
+    EXPECT_THROW(cx::make_regex("^a$"), std::invalid_argument);
+    EXPECT_THROW(cx::make_regex("\\q"), std::invalid_argument);
+    EXPECT_THROW(cx::make_regex("\\x4"), std::invalid_argument);
+    EXPECT_THROW(cx::make_regex("a{100}"), std::length_error);
+    EXPECT_THROW((cx::make_regex<4>("abc")), std::length_error);
+    EXPECT_THROW((kAbcBuilder.compact<8, 4>()), std::length_error);
+}
+
+TEST(Lookup, MatchAndSearch) {
+    static_assert(kAbc.match("abc"), "");
+    static_assert(!kAbc.match("abcd"), "");
+    static_assert(!kAbc.match("ab"), "");
+    static_assert(kAbc.search("xxabcxx"), "");
+    static_assert(!kAbc.search("ab-c"), "");
+
+    static_assert(kVersion.match("HTTP/1.1"), "");
+    static_assert(kVersion.match(cx::lit("HTTP/2.0")), "");
+    static_assert(!kVersion.match("HTTP/1.x"), "");
+    static_assert(kVersion.search("GET / HTTP/1.1\r\n"), "");
+    EXPECT_TRUE(kVersion.match(std::string("HTTP/1.0")));
+    EXPECT_FALSE(kVersion.search(std::string("HTTP/one")));
+}
+
+TEST(Lookup, Classes) {
+    constexpr auto builder = cx::make_regex("[^,\\s]+(,[\\x41-\\x5a_]+)*\\t?.");
+    constexpr auto re = builder.compact<builder.state_count(), builder.class_count()>();
+    static_assert(re.match("abc,FOO_BAR,X\t!"), "");
+    static_assert(re.match("a,B."), "");
+    static_assert(!re.match("a,b."), "");
+    static_assert(!re.match("a b,C!"), "");
+    static_assert(!re.match("abc\n"), "");
+    EXPECT_TRUE(re.match(std::string("\0\1", 2)));
+}
+
+TEST(Lookup, SameAsStdRegex) {
+    constexpr auto b1 = cx::make_regex("(a|b)*abb");
+    expect_same_as_std(b1.compact<b1.state_count(), b1.class_count()>(), "(a|b)*abb", "ab");
+    constexpr auto b2 = cx::make_regex("[a-c]{2,3}d?");
+    expect_same_as_std(b2.compact<b2.state_count(), b2.class_count()>(), "[a-c]{2,3}d?", "abcd");
+    constexpr auto b3 = cx::make_regex("x+y*|z{2,}");
+    expect_same_as_std(b3.compact<b3.state_count(), b3.class_count()>(), "x+y*|z{2,}", "xyz");
+    constexpr auto b4 = cx::make_regex("\\d{3}-\\d{2,4}");
+    expect_same_as_std(b4.compact<b4.state_count(), b4.class_count()>(), "\\d{3}-\\d{2,4}", "01-");
+    constexpr auto b5 = cx::make_regex("(?:ab|ba)+c?|()");
+    expect_same_as_std(b5.compact<b5.state_count(), b5.class_count()>(), "(?:ab|ba)+c?|()", "abc");
+    constexpr auto b6 = cx::make_regex("[^ab]+b.\\w{0,2}");
+    expect_same_as_std(b6.compact<b6.state_count(), b6.class_count()>(), "[^ab]+b.\\w{0,2}", "ab_ .");
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
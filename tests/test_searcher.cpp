@@ -0,0 +1,156 @@
+// Copyright (c) 2020. Mohit Deshpande.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+// the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+
+#include <gtest/gtest.h>
+#include <random>
+#include <string>
+
+#include "cx/cx_searcher.h"
+
+static constexpr auto kMarker = cx::make_searcher("id=");
+
+TEST(Constructors, ShiftTable) {
+    static_assert(kMarker.size() == 3, "");
+    static_assert(kMarker.shift('i') == 2, "");
+    static_assert(kMarker.shift('d') == 1, "");
+    // the last byte only shifts by its earlier occurrences
+    static_assert(kMarker.shift('=') == 3, "");
+    static_assert(kMarker.shift('x') == 3, "");
+    static_assert(std::is_same<decltype(kMarker)::shift_type, std::uint8_t>::value, "");
+
+    constexpr auto needle = cx::make_searcher(cx::lit("abab"));
+    static_assert(needle.shift('a') == 1, "");
+    static_assert(needle.shift('b') == 2, "");
+}
+
+TEST(Lookup, Find) {
+    static_assert(kMarker.find("user=1 id=42") == 7, "");
+    static_assert(kMarker.find("user=1 id=42 id=43", 8) == 13, "");
+    static_assert(kMarker.find("user=1 id") == kMarker.npos, "");
+    static_assert(kMarker.find("id", 5) == kMarker.npos, "");
+    static_assert(kMarker.count("id=id=iid=d=") == 3, "");
+    static_assert(kMarker.contains(cx::lit("xid=")), "");
+
+    constexpr auto empty = cx::make_searcher("");
+    static_assert(empty.find("abc", 2) == 2, "");
+    static_assert(empty.find("abc", 4) == empty.npos, "");
+    constexpr auto one = cx::make_searcher("c");
+    static_assert(one.find("abcabc", 3) == 5, "");
+
+    const std::string log = std::string(1000, '.') + "request id=7";
+    EXPECT_EQ(kMarker.find(log), 1008u);
+    EXPECT_EQ(kMarker.find(log, 1009), kMarker.npos);
+    EXPECT_EQ(one.count(std::string(100, 'c')), 100u);
+}
+
+TEST(Lookup, LongNeedle) {
+    static constexpr auto kLong = cx::make_searcher(
+            "................................................................................................"
+            "................................................................................................"
+            "................................................................................................!");
+    static_assert(kLong.size() == 289, "");
+    static_assert(std::is_same<decltype(kLong)::shift_type, std::uint32_t>::value, "");
+    static_assert(kLong.shift('.') == 1, "");
+    static_assert(kLong.shift('x') == 289, "");
+
+    const std::string text = std::string(1000, '.') + "!" + std::string(50, '.');
+    EXPECT_EQ(kLong.find(text), 1000u - 288u);
+    EXPECT_EQ(kLong.find(text.substr(0, 1000)), kLong.npos);
+}
+
+// matches std::string::find at every offset; a small alphabet makes partial matches common, and text lengths around
+// the vector width exercise the tail
+template<typename Searcher>
+void expect_same_as_std(const Searcher& searcher) {
+    const std::string needle(searcher.needle().c_str(), searcher.size());
+    std::mt19937 gen{5};
+    std::uniform_int_distribution<int> letter{'a', 'c'};
+    std::uniform_int_distribution<std::size_t> length{0, 80};
+    for (int round = 0; round < 500; ++round) {
+        std::string text(length(gen), ' ');
+        for (auto& c : text) c = static_cast<char>(letter(gen));
+        for (std::size_t from = 0; from <= text.size() + 1; ++from) {
+            const auto expected = from > text.size() ? std::string::npos : text.find(needle, from);
+            EXPECT_EQ(searcher.find(text, from), expected) << needle << " in " << text << " from " << from;
+        }
+    }
+}
+
+TEST(Lookup, SameAsStdFind) {
+    expect_same_as_std(cx::make_searcher("a"));
+    expect_same_as_std(cx::make_searcher("ab"));
+    expect_same_as_std(cx::make_searcher("aba"));
+    expect_same_as_std(cx::make_searcher("cabca"));
+    expect_same_as_std(cx::make_searcher("abcabcabcaab"));
+    expect_same_as_std(cx::make_searcher("aaaaaaaaaaaaaaaaaab"));
+}
+
+// N bytes of 'a' with a 'b' at position b (or none when b >= N), built during constant evaluation
+template<std::size_t N>
+constexpr cx::string<N> run_of_a(std::size_t b) {
+    char bytes[N + 1]{};
+    for (std::size_t i = 0; i < N; ++i) bytes[i] = i == b ? 'b' : 'a';
+    const char* data = bytes;
+    return cx::string<N>(data, cx::detail::copy_tag{});
+}
+
+TEST(TwoWay, Factorization) {
+    constexpr auto abab = cx::make_searcher("abab");
+    static_assert(abab.critical_position() == 1 && abab.period() == 2 && abab.periodic(), "");
+    constexpr auto abaab = cx::make_searcher("abaabaab");
+    static_assert(abaab.critical_position() == 2 && abaab.period() == 3 && abaab.periodic(), "");
+    // not periodic: after a full match of the right half the needle moves past the longer half
+    static_assert(kMarker.critical_position() == 2 && kMarker.period() == 3 && !kMarker.periodic(), "");
+    constexpr auto aaaab = cx::make_searcher("aaaab");
+    static_assert(aaaab.critical_position() == 4 && aaaab.period() == 5 && !aaaab.periodic(), "");
+}
+
+TEST(TwoWay, AdversarialText) {
+    // every window of a run of 'a's matches the needle's first and last bytes and half of its middle, so Horspool and
+    // the vector candidates give up on it
+    static constexpr auto kRun = cx::make_searcher(run_of_a<64>(32));
+    static constexpr auto kText = run_of_a<2000>(1500);
+    static_assert(kRun.find(kText) == 1500 - 32, "");
+    static_assert(kRun.find(kText, 1500 - 31) == kRun.npos, "");
+    static_assert(cx::make_searcher(run_of_a<64>(64)).find(kText) == 0, "");
+
+    std::string text(1 << 20, 'a');
+    EXPECT_EQ(kRun.find(text), kRun.npos);
+    text[700000] = 'b';
+    EXPECT_EQ(kRun.find(text), 700000u - 32u);
+    EXPECT_EQ(kRun.find(text, 700000 - 31), kRun.npos);
+    EXPECT_EQ(kRun.count(text), 1u);
+
+    // mostly 'a' with a few 'b's, against periodic needles whose matches keep getting cut short
+    std::mt19937 gen{3};
+    std::bernoulli_distribution is_b{0.02};
+    const auto abaab = cx::make_searcher("aaaaaaaaaaaaaaabaaaaaaaaaaaaaaab");
+    const auto mixed = cx::make_searcher("aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaabaaaaaaaaaaaaaaaa");
+    for (int round = 0; round < 20; ++round) {
+        std::string sample(20000, 'a');
+        for (auto& c : sample) c = is_b(gen) ? 'b' : 'a';
+        for (std::size_t from = 0; from < sample.size(); from += 997) {
+            EXPECT_EQ(kRun.find(sample, from), sample.find(std::string(kRun.needle().c_str(), 64), from));
+            EXPECT_EQ(abaab.find(sample, from), sample.find(abaab.needle().c_str(), from));
+            EXPECT_EQ(mixed.find(sample, from), sample.find(mixed.needle().c_str(), from));
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,118 @@
+// Copyright (c) 2020. Mohit Deshpande.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+// the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstdint>
+
+#include "cx/cx_soa_map.h"
+
+static constexpr double kEpsilon = 1e-6;
+
+enum class Lepton {
+    kElectron,
+    kMuon,
+    kTau,
+    kElectronNeutrino,
+    kMuonNeutrino,
+    kTauNeutrino,
+};
+
+template<typename Key, std::size_t... Indices>
+constexpr auto make_identity(std::index_sequence<Indices...>) {
+    return cx::soa_map<Key, int, sizeof...(Indices)>{{static_cast<Key>(Indices * 3), static_cast<int>(Indices)}...};
+}
+
+template<typename Key>
+void check_every_key() {
+    static constexpr auto m = make_identity<Key>(std::make_index_sequence<67>());
+    for (int i = 0; i < 67; ++i) {
+        EXPECT_EQ(m.at(static_cast<Key>(i * 3)), i);
+        EXPECT_EQ(m.count(static_cast<Key>(i * 3)), 1u);
+        EXPECT_EQ(m.count(static_cast<Key>(i * 3 + 1)), 0u);
+        EXPECT_EQ(m.find(static_cast<Key>(i * 3 + 1)), m.end());
+    }
+}
+
+TEST(Constructors, EmptyMap) {
+    constexpr cx::soa_map<Lepton, const char*, 0> lepton_name = {};
+    static_assert(lepton_name.empty(), "");
+    EXPECT_EQ(lepton_name.count(Lepton::kMuon), 0u);
+}
+
+TEST(Constructors, InitializerList) {
+    constexpr cx::soa_map<Lepton, const char*, 6> lepton_name = {
+            {Lepton::kElectron, "electron"},
+            {Lepton::kMuon, "muon"},
+            {Lepton::kTau, "tau"},
+            {Lepton::kElectronNeutrino, "electron neutrino"},
+            {Lepton::kMuonNeutrino, "muon neutrino"},
+            {Lepton::kTauNeutrino, "tau neutrino"},
+    };
+    static_assert(lepton_name.size() == 6, "");
+    static_assert(lepton_name.begin()->first == Lepton::kElectron, "");
+    static_assert((*(lepton_name.end() - 1)).first == Lepton::kTauNeutrino, "");
+}
+
+TEST(Constructors, AlignedKeys) {
+    static constexpr auto m = make_identity<std::uint8_t>(std::make_index_sequence<40>());
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(m.keys()) % decltype(m)::key_alignment, 0u);
+}
+
+TEST(ElementAccess, ValidLookup) {
+    constexpr cx::soa_map<Lepton, double, 6> lepton_masses = {
+            {Lepton::kElectron, 0.511},
+            {Lepton::kMuon, 105.66},
+            {Lepton::kTau, 1776.},
+            {Lepton::kElectronNeutrino, 1e-6},
+            {Lepton::kMuonNeutrino, 0.17},
+            {Lepton::kTauNeutrino, 18.2},
+    };
+    constexpr auto x = lepton_masses.at(Lepton::kElectronNeutrino);
+    static_assert(std::abs(x - 1e-6) < kEpsilon, "");
+    EXPECT_NEAR(lepton_masses.at(Lepton::kTauNeutrino), 18.2, kEpsilon);
+}
+
+TEST(ElementAccess, InvalidLookup) {
+    constexpr cx::soa_map<Lepton, const char*, 3> lepton_name = {
+            {Lepton::kElectron, "electron"},
+            {Lepton::kMuon, "muon"},
+            {Lepton::kTau, "tau"},
+    };
+    //constexpr auto x = lepton_name.at(Lepton::kTauNeutrino);
+    EXPECT_THROW(lepton_name.at(Lepton::kTauNeutrino), std::out_of_range);
+}
+
+TEST(Lookup, TwoElements) {
+    constexpr cx::soa_map<int, double, 2> m = {
+            {3, 3.14},
+            {3, 2.72}
+    };
+    static_assert(m.count(3) == 2, "");
+    EXPECT_EQ(m.count(3), 2u);
+    EXPECT_NEAR(m.at(3), 3.14, kEpsilon);
+}
+
+TEST(Lookup, EveryKeyWidth) {
+    check_every_key<std::uint8_t>();
+    check_every_key<std::int16_t>();
+    check_every_key<std::uint32_t>();
+    check_every_key<std::int64_t>();
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
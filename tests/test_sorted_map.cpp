@@ -0,0 +1,151 @@
+// Copyright (c) 2020. Mohit Deshpande.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+// the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include "cx/cx_sorted_map.h"
+
+static constexpr double kEpsilon = 1e-6;
+
+enum class Lepton {
+    kElectron,
+    kMuon,
+    kTau,
+    kElectronNeutrino,
+    kMuonNeutrino,
+    kTauNeutrino,
+};
+
+template<std::size_t... Indices>
+constexpr auto make_multiples(std::index_sequence<Indices...>) {
+    // inserted in reverse so the constructor has to sort
+    return cx::sorted_map<int, int, sizeof...(Indices)>{{static_cast<int>((sizeof...(Indices) - Indices) * 10), static_cast<int>(Indices)}...};
+}
+
+TEST(Constructors, EmptyMap) {
+    constexpr cx::sorted_map<Lepton, const char*, 0> lepton_name = {};
+    static_assert(lepton_name.empty(), "");
+    static_assert(lepton_name.begin() == lepton_name.end(), "");
+    static_assert(lepton_name.lower_bound(Lepton::kMuon) == lepton_name.end(), "");
+}
+
+TEST(Constructors, InitializerList) {
+    constexpr cx::sorted_map<Lepton, const char*, 6> lepton_name = {
+            {Lepton::kTauNeutrino, "tau neutrino"},
+            {Lepton::kElectron, "electron"},
+            {Lepton::kMuonNeutrino, "muon neutrino"},
+            {Lepton::kMuon, "muon"},
+            {Lepton::kElectronNeutrino, "electron neutrino"},
+            {Lepton::kTau, "tau"},
+    };
+    static_assert(lepton_name.size() == 6, "");
+    static_assert(lepton_name.begin()->first == Lepton::kElectron, "");
+    EXPECT_EQ(lepton_name.rbegin()->first, Lepton::kTauNeutrino);
+}
+
+TEST(Iterators, SortedOrder) {
+    constexpr auto m = make_multiples(std::make_index_sequence<100>());
+    int expected = 10;
+    for (const auto& entry : m) {
+        EXPECT_EQ(entry.first, expected);
+        expected += 10;
+    }
+    EXPECT_EQ(expected, 1010);
+    EXPECT_EQ(std::distance(m.rbegin(), m.rend()), 100);
+    EXPECT_EQ(m.rbegin()->first, 1000);
+}
+
+TEST(ElementAccess, ValidLookup) {
+    constexpr cx::sorted_map<Lepton, double, 6> lepton_masses = {
+            {Lepton::kElectron, 0.511},
+            {Lepton::kMuon, 105.66},
+            {Lepton::kTau, 1776.},
+            {Lepton::kElectronNeutrino, 1e-6},
+            {Lepton::kMuonNeutrino, 0.17},
+            {Lepton::kTauNeutrino, 18.2},
+    };
+    constexpr auto x = lepton_masses.at(Lepton::kElectronNeutrino);
+    static_assert(std::abs(x - 1e-6) < kEpsilon, "");
+}
+
+TEST(ElementAccess, InvalidLookup) {
+    constexpr cx::sorted_map<Lepton, const char*, 3> lepton_name = {
+            {Lepton::kElectron, "electron"},
+            {Lepton::kMuon, "muon"},
+            {Lepton::kTau, "tau"},
+    };
+    //constexpr auto x = lepton_name.at(Lepton::kTauNeutrino);
+    EXPECT_THROW(lepton_name.at(Lepton::kTauNeutrino), std::out_of_range);
+}
+
+TEST(Lookup, Bounds) {
+    constexpr auto m = make_multiples(std::make_index_sequence<100>());
+    static_assert(m.lower_bound(15)->first == 20, "");
+    static_assert(m.lower_bound(20)->first == 20, "");
+    static_assert(m.upper_bound(20)->first == 30, "");
+    static_assert(m.lower_bound(0) == m.begin(), "");
+    static_assert(m.lower_bound(1001) == m.end(), "");
+    static_assert(m.upper_bound(1000) == m.end(), "");
+    static_assert(m.find(15) == m.end(), "");
+    static_assert(m.find(500)->second == 50, "");
+    for (int key = 1; key <= 1000; ++key) {
+        EXPECT_EQ(m.lower_bound(key)->first, (key + 9) / 10 * 10);
+    }
+}
+
+TEST(Lookup, EqualRange) {
+    static constexpr cx::sorted_map<int, double, 4> m = {
+            {3, 3.14},
+            {1, 1.0},
+            {3, 2.72},
+            {5, 5.0},
+    };
+    constexpr auto range = m.equal_range(3);
+    static_assert(std::abs(range.first->second - 3.14) < kEpsilon, "");
+    EXPECT_EQ(std::distance(range.first, range.second), 2);
+    static_assert(m.count(3) == 2, "");
+    static_assert(m.count(4) == 0, "");
+}
+
+TEST(Lookup, Batch) {
+    constexpr auto m = make_multiples(std::make_index_sequence<100>());
+    std::vector<int> keys;
+    for (int key = -5; key <= 1010; key += 5) keys.push_back(key);
+    std::vector<decltype(m)::const_iterator> found(keys.size());
+    EXPECT_EQ(m.find_batch(keys.data(), keys.size(), found.data()), 100u);
+    for (std::size_t i = 0; i < keys.size(); ++i) EXPECT_EQ(found[i], m.find(keys[i]));
+
+    std::unique_ptr<bool[]> flags(new bool[keys.size()]);
+    EXPECT_EQ(m.count_batch(keys.data(), keys.size(), flags.get()), 100u);
+    for (std::size_t i = 0; i < keys.size(); ++i) EXPECT_EQ(flags[i], m.count(keys[i]) != 0);
+
+    const int hits[] = {10, 1000, 500};
+    int values[3]{};
+    m.at_batch(hits, 3, values);
+    EXPECT_EQ(values[0], 99);
+    EXPECT_EQ(values[1], 0);
+    EXPECT_EQ(values[2], 50);
+    EXPECT_THROW(m.at_batch(keys.data(), 2, values), std::out_of_range);
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -121,6 +121,68 @@ TEST(LiteralCreation, NonemptyString) {
     static_assert(x == "Test", "");
 }
 
+#define CX_TEST_X8(s) s s s s s s s s
+
+TEST(LiteralCreation, LongString) {
+    // 4096 characters, far past what one-argument-per-character construction handled comfortably
+    constexpr auto x = cx::lit(CX_TEST_X8(CX_TEST_X8(CX_TEST_X8("abcdefgh"))));
+    static_assert(x.size() == 4096, "");
+    static_assert(x[4095] == 'h', "");
+
+    constexpr auto y = x + x;
+    static_assert(y.size() == 8192, "");
+    static_assert(y[4096] == 'a' && y[8191] == 'h', "");
+}
+
+#undef CX_TEST_X8
+
+TEST(Hashing, Fnv1aKnownValues) {
+    static_assert(cx::fnv1a("") == 0xcbf29ce484222325ULL, "");
+    static_assert(cx::fnv1a("a") == 0xaf63dc4c8601ec8cULL, "");
+    static_assert(cx::fnv1a(cx::lit("a")) == cx::fnv1a("a"), "");
+}
+
+TEST(Hashing, WyhashConsistency) {
+    constexpr auto x = cx::lit("Test");
+    constexpr auto y = cx::lit("Tesu");
+    static_assert(cx::wyhash(x) == cx::wyhash("Test"), "");
+    static_assert(cx::wyhash(x) != cx::wyhash(y), "");
+    static_assert(cx::wyhash(x) != cx::wyhash(x, 1), "");
+    static_assert(cx::hash<cx::string<4>>{}(x) == cx::wyhash(x), "");
+
+    // every length class (0-3, 4-16, 17-48, > 48) agrees between constant evaluation and runtime
+    constexpr const char text[] = "The quick brown fox jumps over the lazy dog, then naps in the sun.";
+    constexpr std::uint64_t expected[] = {
+            cx::wyhash(text, 0), cx::wyhash(text, 3), cx::wyhash(text, 4), cx::wyhash(text, 16),
+            cx::wyhash(text, 17), cx::wyhash(text, 48), cx::wyhash(text, 49), cx::wyhash(text, sizeof(text) - 1),
+    };
+    const std::size_t sizes[] = {0, 3, 4, 16, 17, 48, 49, sizeof(text) - 1};
+    const char* runtime_text = text;
+    for (std::size_t i = 0; i < 8; ++i) {
+        EXPECT_EQ(cx::wyhash(runtime_text, sizes[i]), expected[i]);
+        for (std::size_t j = 0; j < i; ++j) EXPECT_NE(expected[i], expected[j]);
+    }
+}
+
+TEST(HashedString, Construction) {
+    constexpr auto x = cx::hashed_lit("Test");
+    static_assert(x.size() == 4, "");
+    static_assert(x.hash() == cx::wyhash("Test"), "");
+    static_assert(x == "Test", "");
+    static_assert(cx::hash<cx::hashed_string<4>>{}(x) == x.hash(), "");
+    EXPECT_EQ(x.str(), "Test");
+}
+
+TEST(HashedString, Equality) {
+    constexpr cx::hashed_string<4> x{"Test"};
+    constexpr cx::hashed_string<4> y{cx::lit("Test")};
+    constexpr cx::hashed_string<4> z{"T4st"};
+    constexpr cx::hashed_string<5> w{"Test2"};
+    static_assert(x == y, "");
+    static_assert(!(x == z), "");
+    static_assert(!(x == w), "");
+}
+
 int main(int argc, char** argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
@@ -0,0 +1,96 @@
+// Copyright (c) 2020. Mohit Deshpande.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+// the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include <gtest/gtest.h>
+#include <string>
+
+#include "cx/cx_string_map.h"
+
+enum class Header {
+    kHost,
+    kDate,
+    kContentType,
+    kContentLength,
+    kTransferEncoding,
+    kAccessControlAllowCredentials,
+};
+
+static constexpr cx::string_map<Header, 6> kHeaders = {
+        {"host", Header::kHost},
+        {"date", Header::kDate},
+        {"content-type", Header::kContentType},
+        {"content-length", Header::kContentLength},
+        {"transfer-encoding", Header::kTransferEncoding},
+        {"access-control-allow-credentials", Header::kAccessControlAllowCredentials},
+};
+
+// a minimal stand-in for std::string_view so the test also builds as C++14
+struct view {
+    const char* ptr;
+    std::size_t len;
+    constexpr const char* data() const { return ptr; }
+    constexpr std::size_t size() const { return len; }
+};
+
+TEST(Constructors, EmptyMap) {
+    constexpr cx::string_map<int, 0> m = {};
+    static_assert(m.empty(), "");
+    static_assert(m.count("host") == 0, "");
+}
+
+TEST(Constructors, InvalidEntries) {
+    auto make_duplicate = [] {
+        return cx::string_map<int, 2>{{"host", 1}, {"host", 2}};
+    };
+    EXPECT_THROW(make_duplicate(), std::invalid_argument);
+
+    auto make_too_long = [] {
+        return cx::string_map<int, 1, 4>{{"hosts", 1}};
+    };
+    EXPECT_THROW(make_too_long(), std::invalid_argument);
+}
+
+TEST(Iterators, OrderedByLength) {
+    static_assert(kHeaders.size() == 6, "");
+    std::size_t previous = 0;
+    for (const auto& entry : kHeaders) {
+        EXPECT_LE(previous, std::strlen(entry.first));
+        previous = std::strlen(entry.first);
+    }
+}
+
+TEST(ElementAccess, CompileTimeLookup) {
+    static_assert(kHeaders.at("date") == Header::kDate, "");
+    static_assert(kHeaders.at(cx::lit("content-length")) == Header::kContentLength, "");
+    static_assert(kHeaders.at("access-control-allow-credentials") == Header::kAccessControlAllowCredentials, "");
+    static_assert(kHeaders.count("content-lengtx") == 0, "");
+    static_assert(kHeaders.count("dat") == 0, "");
+}
+
+TEST(ElementAccess, RuntimeLookup) {
+    const std::string request = "Host: x\r\ncontent-type: y\r\ntransfer-encoding: chunked";
+    EXPECT_EQ(kHeaders.count(view{request.data(), 4}), 0u);
+    EXPECT_EQ(kHeaders.at(view{request.data() + 9, 12}), Header::kContentType);
+    EXPECT_EQ(kHeaders.at(request.data() + 26, 17), Header::kTransferEncoding);
+    EXPECT_EQ(kHeaders.at(std::string("host")), Header::kHost);
+    EXPECT_EQ(kHeaders.count(std::string("access-control-allow-credentialz")), 0u);
+    EXPECT_EQ(kHeaders.count(std::string("access-control-allow-credentials-and-more-than-sixty-four-bytes-long!")), 0u);
+    EXPECT_THROW(kHeaders.at(std::string("etag")), std::out_of_range);
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
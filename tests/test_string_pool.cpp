@@ -0,0 +1,69 @@
+// Copyright (c) 2020. Mohit Deshpande.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+// persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions of
+// the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE
+// WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+// OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include <gtest/gtest.h>
+#include <cstring>
+
+#include "cx/cx_string_pool.h"
+
+constexpr bool equal(const char* x, const char* y) {
+    for (; *x && *x == *y; ++x, ++y) {}
+    return *x == *y;
+}
+
+static constexpr auto kLeptonNamesBuilder = cx::make_string_pool(
+        "electron", "muon", "tau", "electron neutrino", "muon neutrino", "tau neutrino", cx::lit("neutrino"), "muon");
+static constexpr auto kLeptonNames = kLeptonNamesBuilder.compact<kLeptonNamesBuilder.blob_size()>();
+
+TEST(Constructors, EmptyPool) {
+    constexpr auto pool = cx::make_string_pool();
+    static_assert(pool.empty(), "");
+    static_assert(pool.blob_size() == 0, "");
+}
+
+TEST(Constructors, Compact) {
+    static_assert(kLeptonNames.size() == 8, "");
+    static_assert(kLeptonNamesBuilder.capacity() == 77, "");
+    // "tau neutrino" holds "neutrino", "muon neutrino" holds nothing else, "muon" and "tau" are stored once each
+    static_assert(kLeptonNames.blob_size() == sizeof("electron") + sizeof("muon") + sizeof("tau")
+                                              + sizeof("electron neutrino") + sizeof("muon neutrino")
+                                              + sizeof("tau neutrino"), "");
+    static_assert(kLeptonNames.capacity() == kLeptonNames.blob_size(), "");
+    static_assert(std::is_same<decltype(kLeptonNames)::handle_type, std::uint16_t>::value, "");
+}
+
+TEST(ElementAccess, Strings) {
+    static_assert(equal(kLeptonNames[0], "electron"), "");
+    static_assert(equal(kLeptonNames[3], "electron neutrino"), "");
+    static_assert(equal(kLeptonNames[6], "neutrino"), "");
+    static_assert(equal(kLeptonNames.c_str(kLeptonNames.handle(2)), "tau"), "");
+    for (std::size_t i = 0; i < kLeptonNames.size(); ++i) {
+        EXPECT_STREQ(kLeptonNames[i], kLeptonNamesBuilder[i]);
+    }
+    EXPECT_THROW(kLeptonNames.at(8), std::out_of_range);
+}
+
+TEST(ElementAccess, SharedStorage) {
+    // duplicates share one copy and suffixes point into the longer string
+    EXPECT_EQ(kLeptonNames[1], kLeptonNames[7]);
+    EXPECT_GE(kLeptonNames[6], kLeptonNames.data());
+    EXPECT_TRUE(kLeptonNames[6] == kLeptonNames[3] + 9 || kLeptonNames[6] == kLeptonNames[4] + 5
+                || kLeptonNames[6] == kLeptonNames[5] + 4);
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}